@@ -0,0 +1,257 @@
+#include "benchmark.h"
+#include "config.h"
+#include <QColor>
+#include <QPoint>
+#include <QString>
+#include <QThread>
+#include <QVector>
+#include <atomic>
+
+// Setter followed by the getter that reads the same key back, the pattern a
+// drag or a settings dialog edit produces. Values alternate so every setter
+// stores a real change.
+
+namespace {
+
+constexpr int CHARACTER_COUNT = 40;
+constexpr int READER_THREADS = 3;
+
+const QVector<QString>& characterNames()
+{
+    static const QVector<QString> names = [] {
+        QVector<QString> list;
+        for (int i = 0; i < CHARACTER_COUNT; ++i) {
+            list.append(QString("Bench Character %1").arg(i));
+        }
+        return list;
+    }();
+    return names;
+}
+
+// Gives every per-character group a realistic population to reload
+void populateCharacters(Config& config)
+{
+    Config::Transaction transaction(config);
+    for (int i = 0; i < CHARACTER_COUNT; ++i) {
+        config.setThumbnailPosition(characterNames()[i], QPoint(i * 10, i * 5));
+        config.setCharacterBorderColor(characterNames()[i], QColor::fromHsv(i * 9, 200, 200));
+    }
+}
+
+}
+
+EVEAPM_BENCHMARK(config_scalarSetGet)
+{
+    Config& config = Config::instance();
+    populateCharacters(config);
+    int width = config.thumbnailWidth();
+    state.measure([&] {
+        width = width == 240 ? 241 : 240;
+        config.setThumbnailWidth(width);
+        Q_UNUSED(config.thumbnailWidth());
+    });
+    config.setThumbnailWidth(Config::DEFAULT_THUMBNAIL_WIDTH);
+}
+
+EVEAPM_BENCHMARK(config_thumbnailPositionSetGet)
+{
+    Config& config = Config::instance();
+    populateCharacters(config);
+    int step = 0;
+    state.measure([&] {
+        const QString& name = characterNames()[step % CHARACTER_COUNT];
+        config.setThumbnailPosition(name, QPoint(step & 0xFF, step & 0x7F));
+        Q_UNUSED(config.getThumbnailPosition(name));
+        ++step;
+    });
+}
+
+EVEAPM_BENCHMARK(config_borderColorSetGet)
+{
+    Config& config = Config::instance();
+    populateCharacters(config);
+    int step = 0;
+    state.measure([&] {
+        const QString& name = characterNames()[step % CHARACTER_COUNT];
+        config.setCharacterBorderColor(name, QColor::fromHsv(step % 360, 200, 200));
+        Q_UNUSED(config.getCharacterBorderColor(name));
+        ++step;
+    });
+}
+
+EVEAPM_BENCHMARK(config_combatEventColorSetGet)
+{
+    Config& config = Config::instance();
+    populateCharacters(config);
+    int step = 0;
+    state.measure([&] {
+        config.setCombatEventColor("fleet_invite", QColor::fromHsv(step % 360, 200, 200));
+        Q_UNUSED(config.combatEventColor("fleet_invite"));
+        ++step;
+    });
+}
+
+// A scalar setter between per-character reads, the case where invalidating
+// every cache on each setter made the next position read reload the group
+EVEAPM_BENCHMARK(config_scalarSetThenPositionGet)
+{
+    Config& config = Config::instance();
+    populateCharacters(config);
+    int step = 0;
+    state.measure([&] {
+        config.setSnapDistance(10 + (step & 1));
+        Q_UNUSED(config.getThumbnailPosition(characterNames()[step % CHARACTER_COUNT]));
+        ++step;
+    });
+    config.setSnapDistance(Config::DEFAULT_POSITION_SNAP_DISTANCE);
+}
+
+// The reads one overlay paint makes, once through the getters and once
+// through a snapshot pinned for the whole paint
+EVEAPM_BENCHMARK(config_paintReads_getters)
+{
+    const Config& config = Config::instance();
+    state.measure([&] {
+        Q_UNUSED(config.highlightActiveWindow());
+        Q_UNUSED(config.highlightBorderWidth());
+        Q_UNUSED(config.highlightColor());
+        Q_UNUSED(config.showOverlayBackground());
+        Q_UNUSED(config.overlayBackgroundColor());
+        Q_UNUSED(config.overlayBackgroundOpacity());
+        Q_UNUSED(config.characterNameFont());
+    });
+}
+
+EVEAPM_BENCHMARK(config_paintReads_pinned)
+{
+    const Config& config = Config::instance();
+    state.measure([&] {
+        const Config::Values values = config.values();
+        Q_UNUSED(values.get<Config::Setting::HighlightActive>());
+        Q_UNUSED(values.get<Config::Setting::HighlightBorderWidth>());
+        Q_UNUSED(values.get<Config::Setting::HighlightColor>());
+        Q_UNUSED(values.get<Config::Setting::ShowOverlayBackground>());
+        Q_UNUSED(values.get<Config::Setting::OverlayBackgroundColor>());
+        Q_UNUSED(values.get<Config::Setting::OverlayBackgroundOpacity>());
+        Q_UNUSED(values.get<Config::Setting::CharacterNameFont>());
+    });
+}
+
+// Switching between two preloaded profiles that share positions and bindings
+// but differ in a few scalars, the PvP/mining layout swap
+EVEAPM_BENCHMARK(config_profileSwitch)
+{
+    Config& config = Config::instance();
+    populateCharacters(config);
+    const QString home = config.getCurrentProfileName();
+    const QString other = "bench-switch";
+    if (!config.profileExists(other)) {
+        config.cloneProfile(home, other);
+    }
+    config.loadProfile(other);
+    config.setThumbnailOpacity(80);
+    config.setShowSystemName(!config.showSystemName());
+    config.loadProfile(home);
+
+    bool atHome = true;
+    state.measure([&] {
+        config.loadProfile(atHome ? other : home);
+        atHome = !atHome;
+    });
+    config.loadProfile(home);
+}
+
+// What one refresh asks of Config per thumbnail: the overlay paint reads, the
+// saved position and client rect, and the border colour
+EVEAPM_BENCHMARK(config_getterMix)
+{
+    Config& config = Config::instance();
+    populateCharacters(config);
+    int step = 0;
+    state.measure([&] {
+        const QString& name = characterNames()[step % CHARACTER_COUNT];
+        Q_UNUSED(config.highlightActiveWindow());
+        Q_UNUSED(config.highlightBorderWidth());
+        Q_UNUSED(config.highlightColor());
+        Q_UNUSED(config.thumbnailOpacity());
+        Q_UNUSED(config.getThumbnailPosition(name));
+        Q_UNUSED(config.getClientWindowRect(name));
+        Q_UNUSED(config.getCharacterBorderColor(name));
+        ++step;
+    });
+}
+
+// A settings dialog Apply: a burst of scalar and per-character setters in one
+// transaction, followed by a single notification and scheduled save
+EVEAPM_BENCHMARK(config_setterBurst)
+{
+    Config& config = Config::instance();
+    populateCharacters(config);
+    const int width = config.thumbnailWidth();
+    const int height = config.thumbnailHeight();
+    const int opacity = config.thumbnailOpacity();
+    const int borderWidth = config.highlightBorderWidth();
+    const QColor color = config.highlightColor();
+    const bool showSystem = config.showSystemName();
+
+    bool flip = false;
+    state.measure([&] {
+        flip = !flip;
+        Config::Transaction transaction(config);
+        config.setThumbnailWidth(flip ? 241 : 240);
+        config.setThumbnailHeight(flip ? 136 : 135);
+        config.setThumbnailOpacity(flip ? 90 : 95);
+        config.setHighlightBorderWidth(flip ? 3 : 2);
+        config.setHighlightColor(flip ? QColor(Qt::red) : QColor(Qt::yellow));
+        config.setShowSystemName(flip);
+        for (int i = 0; i < 8; ++i) {
+            config.setThumbnailPosition(characterNames()[i], QPoint(flip ? i : i + 1, i));
+        }
+    });
+
+    Config::Transaction transaction(config);
+    config.setThumbnailWidth(width);
+    config.setThumbnailHeight(height);
+    config.setThumbnailOpacity(opacity);
+    config.setHighlightBorderWidth(borderWidth);
+    config.setHighlightColor(color);
+    config.setShowSystemName(showSystem);
+}
+
+// Worker threads reading scalars and pinning snapshots while the owner thread
+// keeps changing them. Timed on the owner side; the readers stick to reads
+// that don't allocate, so allocs/op stay the owner's. Under ThreadSanitizer
+// this is the case that catches a getter reaching past the snapshot.
+EVEAPM_BENCHMARK(config_crossThreadReads)
+{
+    Config& config = Config::instance();
+    std::atomic<bool> stop{false};
+    QVector<QThread*> readers;
+    for (int i = 0; i < READER_THREADS; ++i) {
+        QThread* reader = QThread::create([&config, &stop] {
+            while (!stop.load(std::memory_order_relaxed)) {
+                Q_UNUSED(config.thumbnailWidth());
+                Q_UNUSED(config.highlightColor());
+                const Config::Values values = config.values();
+                Q_UNUSED(values.get<Config::Setting::ThumbnailOpacity>());
+                Q_UNUSED(values.get<Config::Setting::HighlightBorderWidth>());
+            }
+        });
+        reader->start();
+        readers.append(reader);
+    }
+
+    int width = config.thumbnailWidth();
+    state.measure([&] {
+        width = width == 240 ? 241 : 240;
+        config.setThumbnailWidth(width);
+        Q_UNUSED(config.thumbnailWidth());
+    });
+
+    stop.store(true, std::memory_order_relaxed);
+    for (QThread* reader : readers) {
+        reader->wait();
+        delete reader;
+    }
+    config.setThumbnailWidth(Config::DEFAULT_THUMBNAIL_WIDTH);
+}
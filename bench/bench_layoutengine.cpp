@@ -0,0 +1,62 @@
+#include "benchmark.h"
+#include "layoutengine.h"
+#include <QRect>
+#include <QVector>
+
+// A full default layout of a large boxing setup, as MainWindow computes it
+// on every refresh. Three 1440p monitors, every fourth client has a saved
+// position and clients fall into four cycle groups.
+
+namespace {
+
+constexpr int CLIENT_COUNT = 200;
+
+QVector<LayoutEngine::Item> clientItems()
+{
+    QVector<LayoutEngine::Item> items(CLIENT_COUNT);
+    for (int i = 0; i < CLIENT_COUNT; ++i) {
+        items[i].group = i % 4;
+        items[i].notLoggedIn = i % 50 == 49;
+        if (i % 4 == 0) {
+            items[i].savedPosition = QPoint(-2550 + (i % 40) * 60, 20 + (i / 40) * 150);
+        }
+    }
+    return items;
+}
+
+LayoutEngine::Parameters parametersFor(LayoutEngine::Strategy strategy)
+{
+    LayoutEngine::Parameters parameters;
+    parameters.strategy = strategy;
+    parameters.thumbnailSize = QSize(240, 135);
+    parameters.screens = { QRect(0, 0, 2560, 1440), QRect(-2560, 0, 2560, 1440), QRect(2560, -200, 2560, 1440) };
+    parameters.notLoggedInOrigin = QPoint(10, 1280);
+    return parameters;
+}
+
+void measureLayout(Benchmark::State& state, LayoutEngine::Strategy strategy)
+{
+    const QVector<LayoutEngine::Item> items = clientItems();
+    const LayoutEngine::Parameters parameters = parametersFor(strategy);
+    state.measure([&] {
+        const QVector<QRect> rects = LayoutEngine::layout(items, parameters);
+        Q_UNUSED(rects);
+    });
+}
+
+}
+
+EVEAPM_BENCHMARK(layout_grid200)
+{
+    measureLayout(state, LayoutEngine::Strategy::Grid);
+}
+
+EVEAPM_BENCHMARK(layout_monitorColumns200)
+{
+    measureLayout(state, LayoutEngine::Strategy::MonitorColumns);
+}
+
+EVEAPM_BENCHMARK(layout_packAroundSaved200)
+{
+    measureLayout(state, LayoutEngine::Strategy::PackAroundSaved);
+}
@@ -0,0 +1,74 @@
+#include "benchmark.h"
+#include "config.h"
+#include "snapindex.h"
+#include <QPoint>
+#include <QRect>
+#include <QVector>
+
+// Dragging one thumbnail past 100 others tiled across two monitors. The
+// index is built once when the drag starts, then every mouse move snaps.
+
+namespace {
+
+constexpr int THUMBNAIL_COUNT = 100;
+constexpr int DRAG_STEPS = 512;
+const QSize THUMBNAIL_SIZE(240, 135);
+
+const QVector<QRect>& screens()
+{
+    static const QVector<QRect> geometry = { QRect(0, 0, 2560, 1400), QRect(2560, 0, 2560, 1400) };
+    return geometry;
+}
+
+// 10 x 10 per screen at the default margin, the dragged thumbnail excluded
+const QVector<QRect>& otherThumbnails()
+{
+    static const QVector<QRect> rects = [] {
+        QVector<QRect> list;
+        for (int i = 0; i < THUMBNAIL_COUNT; ++i) {
+            const QRect& screen = screens()[i / 50];
+            const int cell = i % 50;
+            list.append(QRect(screen.left() + 10 + (cell % 10) * 250, screen.top() + 10 + (cell / 10) * 145,
+                              THUMBNAIL_SIZE.width(), THUMBNAIL_SIZE.height()));
+        }
+        return list;
+    }();
+    return rects;
+}
+
+// A diagonal sweep across both screens with some jitter, so moves land
+// both within and outside the snap distance of an edge
+const QVector<QPoint>& dragPath()
+{
+    static const QVector<QPoint> path = [] {
+        QVector<QPoint> points;
+        for (int i = 0; i < DRAG_STEPS; ++i) {
+            points.append(QPoint(i * 5000 / DRAG_STEPS + (i * 7) % 13, i * 1300 / DRAG_STEPS + (i * 11) % 9));
+        }
+        return points;
+    }();
+    return path;
+}
+
+}
+
+EVEAPM_BENCHMARK(snap_buildIndex100)
+{
+    SnapIndex index;
+    state.measure([&] {
+        index.build(otherThumbnails(), screens(), THUMBNAIL_SIZE, Config::DEFAULT_POSITION_SNAP_DISTANCE);
+    });
+}
+
+EVEAPM_BENCHMARK(snap_dragMove100)
+{
+    SnapIndex index;
+    index.build(otherThumbnails(), screens(), THUMBNAIL_SIZE, Config::DEFAULT_POSITION_SNAP_DISTANCE);
+    int step = 0;
+    QPoint snapped;
+    state.measure([&] {
+        snapped = index.snap(dragPath()[step % DRAG_STEPS]);
+        ++step;
+    });
+    Q_UNUSED(snapped);
+}
@@ -0,0 +1,206 @@
+#include "benchmark.h"
+#include "config.h"
+#include <QCommandLineParser>
+#include <QFile>
+#include <QGuiApplication>
+#include <QHash>
+#include <QLoggingCategory>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QVector>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<quint64> s_allocations{0};
+
+struct Case {
+    const char* name;
+    Benchmark::Function function;
+};
+
+QVector<Case>& cases()
+{
+    static QVector<Case> registered;
+    return registered;
+}
+
+// Function static so it outlives Config, whose destructor still saves
+QTemporaryDir& scratchDirectory()
+{
+    static QTemporaryDir directory;
+    return directory;
+}
+
+void* countedAllocate(std::size_t size)
+{
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+// name -> ns/op of a previous --csv run
+QHash<QString, double> readBaseline(const QString& path)
+{
+    QHash<QString, double> baseline;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        std::fprintf(stderr, "Cannot read baseline %s\n", qPrintable(path));
+        return baseline;
+    }
+    QTextStream stream(&file);
+    while (!stream.atEnd()) {
+        const QStringList fields = stream.readLine().split(',');
+        bool ok = false;
+        const double nsPerOp = fields.value(1).toDouble(&ok);
+        if (ok) {
+            baseline.insert(fields.first(), nsPerOp);
+        }
+    }
+    return baseline;
+}
+
+}
+
+void* operator new(std::size_t size)
+{
+    return countedAllocate(size);
+}
+
+void* operator new[](std::size_t size)
+{
+    return countedAllocate(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+quint64 Benchmark::State::allocationCount()
+{
+    return s_allocations.load(std::memory_order_relaxed);
+}
+
+int Benchmark::registerCase(const char* name, Function function)
+{
+    cases().append(Case{name, function});
+    return int(cases().size());
+}
+
+QString Benchmark::workDirectory()
+{
+    return scratchDirectory().path();
+}
+
+int main(int argc, char* argv[])
+{
+    // Fonts and colours in Config need a GUI application, but no display
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QGuiApplication app(argc, argv);
+    // Debug output from the code under test would dominate the timings
+    QLoggingCategory::setFilterRules("*.debug=false");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("EVE-APM Preview micro-benchmarks");
+    parser.addHelpOption();
+    QCommandLineOption filterOption("filter", "Only run cases whose name contains <text>.", "text");
+    QCommandLineOption minTimeOption("min-time", "Minimum measured time per case in ms (default 200).", "ms", "200");
+    QCommandLineOption csvOption("csv", "Write name,ns/op,allocs/op rows to <file>.", "file");
+    QCommandLineOption baselineOption("baseline", "Compare ns/op against a file written by --csv.", "file");
+    QCommandLineOption listOption("list", "List the cases and exit.");
+    parser.addOptions({ filterOption, minTimeOption, csvOption, baselineOption, listOption });
+    parser.process(app);
+
+    if (parser.isSet(listOption)) {
+        for (const Case& benchmarkCase : cases()) {
+            std::printf("%s\n", benchmarkCase.name);
+        }
+        return 0;
+    }
+
+    // Config and everything else that persists state writes here
+    if (!scratchDirectory().isValid()) {
+        std::fprintf(stderr, "Cannot create a scratch directory\n");
+        return 1;
+    }
+    Config::setBaseDirectory(scratchDirectory().path());
+
+    const QString filter = parser.value(filterOption);
+    const qint64 minimumNs = qMax(1, parser.value(minTimeOption).toInt()) * qint64(1000000);
+    const QHash<QString, double> baseline = parser.isSet(baselineOption)
+        ? readBaseline(parser.value(baselineOption)) : QHash<QString, double>();
+
+    QFile csvFile;
+    QTextStream csv;
+    if (parser.isSet(csvOption)) {
+        csvFile.setFileName(parser.value(csvOption));
+        if (!csvFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+            std::fprintf(stderr, "Cannot write %s\n", qPrintable(csvFile.fileName()));
+            return 1;
+        }
+        csv.setDevice(&csvFile);
+        csv << "name,ns_per_op,allocs_per_op,iterations\n";
+    }
+
+    std::printf("%-48s %14s %12s %12s %10s\n", "case", "ns/op", "allocs/op", "iterations", "vs base");
+    for (const Case& benchmarkCase : cases()) {
+        const QString name = QString::fromLatin1(benchmarkCase.name);
+        if (!filter.isEmpty() && !name.contains(filter)) {
+            continue;
+        }
+
+        Benchmark::State state(minimumNs);
+        benchmarkCase.function(state);
+
+        QString comparison;
+        const auto base = baseline.constFind(name);
+        if (base != baseline.constEnd() && *base > 0.0) {
+            comparison = QString("%1%2%").arg(state.nsPerOp() >= *base ? "+" : "")
+                                         .arg((state.nsPerOp() - *base) / *base * 100.0, 0, 'f', 1);
+        }
+        std::printf("%-48s %14.1f %12.2f %12lld %10s\n", benchmarkCase.name, state.nsPerOp(),
+                    state.allocationsPerOp(), static_cast<long long>(state.iterations()), qPrintable(comparison));
+        std::fflush(stdout);
+
+        if (csv.device()) {
+            csv << name << ',' << state.nsPerOp() << ',' << state.allocationsPerOp() << ',' << state.iterations() << '\n';
+        }
+    }
+
+    return 0;
+}
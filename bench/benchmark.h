@@ -0,0 +1,72 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <QElapsedTimer>
+#include <QString>
+#include <QtGlobal>
+
+// Minimal harness shared by every micro-benchmark in this directory. A case
+// does its setup, then hands the operation under test to State::measure(),
+// which repeats it in growing batches until a batch runs for the minimum time
+// and reports nanoseconds and heap allocations per call.
+namespace Benchmark {
+
+class State
+{
+public:
+    explicit State(qint64 minimumNs) : m_minimumNs(minimumNs) {}
+
+    template <typename Body>
+    void measure(Body&& body)
+    {
+        body();
+
+        for (qint64 batch = 1;; batch *= 2) {
+            const quint64 allocationsBefore = allocationCount();
+            QElapsedTimer timer;
+            timer.start();
+            for (qint64 i = 0; i < batch; ++i) {
+                body();
+            }
+            const qint64 elapsedNs = timer.nsecsElapsed();
+            const quint64 allocations = allocationCount() - allocationsBefore;
+
+            if (elapsedNs >= m_minimumNs || batch >= (qint64(1) << 30)) {
+                m_iterations = batch;
+                m_nsPerOp = double(elapsedNs) / double(batch);
+                m_allocationsPerOp = double(allocations) / double(batch);
+                return;
+            }
+        }
+    }
+
+    qint64 iterations() const { return m_iterations; }
+    double nsPerOp() const { return m_nsPerOp; }
+    double allocationsPerOp() const { return m_allocationsPerOp; }
+
+    // Heap allocations made through operator new by any thread so far
+    static quint64 allocationCount();
+
+private:
+    qint64 m_minimumNs;
+    qint64 m_iterations = 0;
+    double m_nsPerOp = 0.0;
+    double m_allocationsPerOp = 0.0;
+};
+
+using Function = void (*)(State& state);
+
+int registerCase(const char* name, Function function);
+
+// Scratch directory of the running benchmark, removed on exit
+QString workDirectory();
+
+}
+
+// Defines and registers a case, e.g. EVEAPM_BENCHMARK(config_scalarGetter)
+#define EVEAPM_BENCHMARK(name)                                                  \
+    static void name(Benchmark::State& state);                                  \
+    static const int name##Registered = Benchmark::registerCase(#name, &name);  \
+    static void name(Benchmark::State& state)
+
+#endif
@@ -0,0 +1,155 @@
+# Bundles the stargate graph StarMap reads from :/starmap/starmap.txt.
+#
+# The graph is checked in as resources/starmap/starmap.txt, so a configure
+# never touches the network and every build bundles the same data. It is
+# generated from two tables of the EVE static data export,
+# mapSolarSystems.csv and mapSolarSystemJumps.csv, in the line format
+# StarMap::loadFromFile() expects:
+#   S <tab> <systemId> <tab> <name>
+#   G <tab> <fromSystemId> <tab> <toSystemId>
+# Only known space is kept, wormhole systems have no gates. Each gate pair is
+# listed once.
+#
+# To refresh the checked-in file after a static data release:
+#   cmake -DEVEAPM_STARMAP_CSV_DIR=<dir with both CSVs> -P cmake/StarMapData.cmake
+#
+# A build can bundle other data instead, in order of precedence:
+#   EVEAPM_STARMAP_FILE     a prebuilt starmap.txt
+#   EVEAPM_STARMAP_CSV_DIR  the two CSVs, converted at configure time
+#   EVEAPM_DOWNLOAD_STARMAP the two CSVs downloaded from a pinned dump. Opt-in,
+#                           and both SHA-256 hashes must be given so the
+#                           download is checked against a known snapshot.
+
+set(EVEAPM_STARMAP_CHECKED_IN "${CMAKE_CURRENT_LIST_DIR}/../resources/starmap/starmap.txt")
+
+function(eveapm_convert_starmap csv_dir output)
+    file(STRINGS "${csv_dir}/mapSolarSystems.csv" system_lines)
+    file(STRINGS "${csv_dir}/mapSolarSystemJumps.csv" jump_lines)
+
+    set(content "# Generated by cmake/StarMapData.cmake from the EVE static data export\n")
+    set(system_count 0)
+    foreach(line IN LISTS system_lines)
+        # regionID,constellationID,solarSystemID,solarSystemName,...
+        if(line MATCHES "^[0-9]+,[0-9]+,(30[0-9][0-9][0-9][0-9][0-9][0-9]),\"?([^,\"]+)\"?,")
+            string(APPEND content "S\t${CMAKE_MATCH_1}\t${CMAKE_MATCH_2}\n")
+            math(EXPR system_count "${system_count} + 1")
+        endif()
+    endforeach()
+
+    set(gate_count 0)
+    foreach(line IN LISTS jump_lines)
+        # fromRegionID,fromConstellationID,fromSolarSystemID,toSolarSystemID,...
+        if(line MATCHES "^[0-9]+,[0-9]+,(30[0-9]+),(30[0-9]+),")
+            set(from "${CMAKE_MATCH_1}")
+            set(to "${CMAKE_MATCH_2}")
+            # The export lists both directions of every gate
+            if(from LESS to)
+                string(APPEND content "G\t${from}\t${to}\n")
+                math(EXPR gate_count "${gate_count} + 1")
+            endif()
+        endif()
+    endforeach()
+
+    if(system_count EQUAL 0 OR gate_count EQUAL 0)
+        message(WARNING "StarMap: ${csv_dir} holds no systems or gates")
+        return()
+    endif()
+
+    file(WRITE "${output}" "${content}")
+    message(STATUS "StarMap: Wrote ${system_count} systems and ${gate_count} gates to ${output}")
+endfunction()
+
+# Script mode regenerates the checked-in file
+if(CMAKE_SCRIPT_MODE_FILE)
+    if(NOT EVEAPM_STARMAP_CSV_DIR)
+        message(FATAL_ERROR "StarMap: Pass -DEVEAPM_STARMAP_CSV_DIR=<dir with mapSolarSystems.csv and mapSolarSystemJumps.csv>")
+    endif()
+    eveapm_convert_starmap("${EVEAPM_STARMAP_CSV_DIR}" "${EVEAPM_STARMAP_CHECKED_IN}")
+    return()
+endif()
+
+option(EVEAPM_BUNDLE_STARMAP "Bundle the stargate graph used for jump distances and intel ranges" ON)
+set(EVEAPM_STARMAP_FILE "" CACHE FILEPATH "Prebuilt starmap.txt to bundle instead of the checked-in one")
+set(EVEAPM_STARMAP_CSV_DIR "" CACHE PATH "Directory holding mapSolarSystems.csv and mapSolarSystemJumps.csv")
+option(EVEAPM_DOWNLOAD_STARMAP "Download the static data CSVs at configure time (needs the URL and hashes below)" OFF)
+set(EVEAPM_STARMAP_CSV_URL "" CACHE STRING "Pinned static data dump holding the two CSVs, not a 'latest' alias")
+set(EVEAPM_STARMAP_SYSTEMS_SHA256 "" CACHE STRING "Expected SHA-256 of mapSolarSystems.csv")
+set(EVEAPM_STARMAP_JUMPS_SHA256 "" CACHE STRING "Expected SHA-256 of mapSolarSystemJumps.csv")
+
+# Downloads both tables into csv_dir, false with a warning when that fails
+function(eveapm_download_starmap csv_dir out_var)
+    set(${out_var} FALSE PARENT_SCOPE)
+    if(NOT EVEAPM_STARMAP_CSV_URL OR NOT EVEAPM_STARMAP_SYSTEMS_SHA256 OR NOT EVEAPM_STARMAP_JUMPS_SHA256)
+        message(WARNING "StarMap: EVEAPM_DOWNLOAD_STARMAP needs EVEAPM_STARMAP_CSV_URL, "
+                        "EVEAPM_STARMAP_SYSTEMS_SHA256 and EVEAPM_STARMAP_JUMPS_SHA256")
+        return()
+    endif()
+
+    foreach(table mapSolarSystems mapSolarSystemJumps)
+        if(table STREQUAL "mapSolarSystems")
+            set(hash "${EVEAPM_STARMAP_SYSTEMS_SHA256}")
+        else()
+            set(hash "${EVEAPM_STARMAP_JUMPS_SHA256}")
+        endif()
+        # EXPECTED_HASH also accepts a file already downloaded by an earlier configure
+        file(DOWNLOAD "${EVEAPM_STARMAP_CSV_URL}/${table}.csv" "${csv_dir}/${table}.csv"
+             TIMEOUT 120 EXPECTED_HASH SHA256=${hash} STATUS status)
+        list(GET status 0 status_code)
+        if(NOT status_code EQUAL 0)
+            list(GET status 1 status_message)
+            file(REMOVE "${csv_dir}/${table}.csv")
+            message(WARNING "StarMap: Could not download ${table}.csv (${status_message})")
+            return()
+        endif()
+    endforeach()
+    set(${out_var} TRUE PARENT_SCOPE)
+endfunction()
+
+# Sets out_var to a generated .qrc holding starmap.txt, or to an empty string
+# when no data could be found. The app then runs with jump distances disabled.
+function(eveapm_starmap_resource out_var)
+    set(${out_var} "" PARENT_SCOPE)
+    if(NOT EVEAPM_BUNDLE_STARMAP)
+        return()
+    endif()
+
+    set(data_dir "${CMAKE_BINARY_DIR}/starmap")
+    set(output "${data_dir}/starmap.txt")
+    set(converted "${data_dir}/converted/starmap.txt")
+    file(REMOVE "${converted}")
+
+    set(source "")
+    if(EVEAPM_STARMAP_FILE)
+        set(source "${EVEAPM_STARMAP_FILE}")
+    elseif(EVEAPM_STARMAP_CSV_DIR)
+        eveapm_convert_starmap("${EVEAPM_STARMAP_CSV_DIR}" "${converted}")
+        set(source "${converted}")
+    elseif(EVEAPM_DOWNLOAD_STARMAP)
+        eveapm_download_starmap("${data_dir}/csv" downloaded)
+        if(downloaded)
+            eveapm_convert_starmap("${data_dir}/csv" "${converted}")
+            set(source "${converted}")
+        endif()
+    else()
+        set(source "${EVEAPM_STARMAP_CHECKED_IN}")
+    endif()
+
+    if(NOT source OR NOT EXISTS "${source}")
+        file(REMOVE "${output}")
+        message(STATUS "StarMap: No star map data, building without jump distances")
+        return()
+    endif()
+    # Only rewritten when the content changes, so the resource isn't rebuilt
+    configure_file("${source}" "${output}" COPYONLY)
+
+    # Written through configure_file for the same reason
+    file(WRITE "${data_dir}/starmap.qrc.in"
+        "<!DOCTYPE RCC>\n"
+        "<RCC version=\"1.0\">\n"
+        "    <qresource prefix=\"/starmap\">\n"
+        "        <file>starmap.txt</file>\n"
+        "    </qresource>\n"
+        "</RCC>\n")
+    configure_file("${data_dir}/starmap.qrc.in" "${data_dir}/starmap.qrc" COPYONLY)
+    set(${out_var} "${data_dir}/starmap.qrc" PARENT_SCOPE)
+endfunction()
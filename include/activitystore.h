@@ -0,0 +1,108 @@
+#ifndef ACTIVITYSTORE_H
+#define ACTIVITYSTORE_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QFile>
+#include <QMutex>
+#include <vector>
+
+enum class ActivityType : quint16 {
+    SystemVisit = 1,
+    Event = 2,
+    MiningSession = 3
+};
+
+struct ActivityEntry {
+    qint64 timestamp = 0;
+    ActivityType type = ActivityType::Event;
+    QString characterName;
+    QString subject;     // system name for visits, event type for events
+    qint32 value = 0;    // aggregate value, e.g. mining session length in seconds
+};
+
+struct ActivityLocation {
+    QString systemName;
+    qint64 timestamp = 0;
+};
+
+// Per-profile activity history kept as a fixed-size ring of records in a
+// memory-mapped file. Names are interned into a table in the same file, so
+// appending a record for a known character never touches the heap. Records
+// are kept ordered by their own timestamp, and appending a record that is
+// already stored (same type and names within a second) is a no-op so log
+// rescans can replay old lines safely.
+class ActivityStore
+{
+public:
+    // Holds appends back until the outermost Batch ends, then sorts them and
+    // merges them into the ring in one pass. A rescan replays old lines out
+    // of order, merged one by one each would shift the newer records.
+    class Batch
+    {
+    public:
+        explicit Batch(ActivityStore* store);
+        ~Batch();
+
+        Batch(const Batch&) = delete;
+        Batch& operator=(const Batch&) = delete;
+
+    private:
+        ActivityStore* m_store;
+    };
+
+    ActivityStore();
+    ~ActivityStore();
+
+    bool open(const QString& filePath);
+    void close();
+    bool isOpen() const;
+    QString filePath() const;
+
+    void append(ActivityType type, const QString& characterName, const QString& subject, qint32 value, qint64 timestamp);
+
+    // Entries with fromMs <= timestamp <= toMs, oldest first. An empty
+    // characterName matches every character.
+    QVector<ActivityEntry> query(const QString& characterName, qint64 fromMs, qint64 toMs) const;
+    QHash<QString, ActivityLocation> lastKnownSystems(qint64 sinceMs) const;
+
+    static QString storePathForProfile(const QString& profileName);
+
+    static constexpr quint32 RECORD_CAPACITY = 65536;
+    static constexpr quint32 NAME_CAPACITY = 4096;
+
+private:
+    struct FileHeader;
+    struct NameSlot;
+    struct Record;
+
+    static qint64 fileSize();
+    static QString storedName(const QString& name);
+    void closeLocked();
+    quint16 internName(const QString& name);
+    QString nameAt(quint16 id) const;
+    void mergeLocked(std::vector<Record>& incoming);
+    bool isDuplicate(const Record& record, const std::vector<Record>& merged, const std::vector<Record>& tail, size_t tailIndex) const;
+    quint64 firstSequenceAtOrAfter(qint64 timestamp) const;
+    const Record& recordAt(quint64 sequence) const;
+    ActivityEntry toEntry(const Record& record) const;
+
+    mutable QMutex m_mutex;
+    QFile m_file;
+    uchar *m_data = nullptr;
+    FileHeader *m_header = nullptr;
+    NameSlot *m_names = nullptr;
+    Record *m_records = nullptr;
+    QHash<QString, quint16> m_nameIds;
+    bool m_nameTableFullLogged = false;
+    int m_batchDepth = 0;
+    // Records are only complete in activitystore.cpp, which std::vector allows
+    std::vector<Record> m_pending;
+
+    static constexpr quint16 NO_NAME = 0xFFFF;
+    // Log lines carry whole seconds, a replayed line lands within one
+    static constexpr qint64 DUPLICATE_WINDOW_MS = 1000;
+};
+
+#endif
@@ -0,0 +1,218 @@
+#ifndef BOUNDEDCACHE_H
+#define BOUNDEDCACHE_H
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <atomic>
+#include <iterator>
+#include <list>
+#include <type_traits>
+#include <utility>
+
+// Statistics and the process-wide registry behind the memory report. Counters
+// are atomics so the report can be taken from any thread while the owning
+// thread keeps using its cache.
+class BoundedCacheBase
+{
+public:
+    // Capacity for caches constructed without one, read on every insert so a
+    // change applies to caches that already exist
+    static int defaultCapacity();
+    static void setDefaultCapacity(int capacity);
+
+    static QStringList memoryReport();
+
+    const char* name() const { return m_name; }
+
+protected:
+    BoundedCacheBase(const char* name, int capacity, qsizetype entryBytes);
+    ~BoundedCacheBase();
+
+    BoundedCacheBase(const BoundedCacheBase&) = delete;
+    BoundedCacheBase& operator=(const BoundedCacheBase&) = delete;
+
+    int effectiveCapacity() const
+    {
+        int capacity = m_capacity.load(std::memory_order_relaxed);
+        return capacity > 0 ? capacity : defaultCapacity();
+    }
+
+    const char* const m_name;
+    const qsizetype m_entryBytes;
+    std::atomic<int> m_capacity;
+    std::atomic<qsizetype> m_entryCount{0};
+    std::atomic<qsizetype> m_payloadBytes{0};
+    std::atomic<quint64> m_evictions{0};
+
+    static constexpr int DEFAULT_CAPACITY = 500;
+};
+
+// Hash map with least-recently-used eviction. Lookups through value(), find()
+// and operator[] count as uses and reorder the entries, so they are non-const;
+// contains() and iteration do not. Each cache belongs to one thread, or to
+// whoever holds the lock guarding it.
+template <typename Key, typename T>
+class BoundedCache : public BoundedCacheBase
+{
+public:
+    using Entry = std::pair<Key, T>;
+    using const_iterator = typename std::list<Entry>::const_iterator;
+
+    // A capacity of 0 follows defaultCapacity(). Entries are costed as a list
+    // node plus the hash node pointing at it.
+    explicit BoundedCache(const char* name, int capacity = 0)
+        : BoundedCacheBase(name, capacity, qsizetype(sizeof(Entry) + 3 * sizeof(void*) + sizeof(Key) + sizeof(void*)))
+    {
+    }
+
+    qsizetype size() const { return qsizetype(m_entries.size()); }
+    bool isEmpty() const { return m_entries.empty(); }
+    int capacity() const { return effectiveCapacity(); }
+
+    void setCapacity(int capacity)
+    {
+        m_capacity.store(capacity, std::memory_order_relaxed);
+        evictOverflow();
+    }
+
+    bool contains(const Key& key) const
+    {
+        return m_index.contains(key);
+    }
+
+    const T* find(const Key& key)
+    {
+        auto it = m_index.constFind(key);
+        if (it == m_index.constEnd()) {
+            return nullptr;
+        }
+        touch(it.value());
+        return &it.value()->second;
+    }
+
+    T value(const Key& key, const T& defaultValue = T())
+    {
+        const T* found = find(key);
+        return found ? *found : defaultValue;
+    }
+
+    T& operator[](const Key& key)
+    {
+        auto it = m_index.find(key);
+        if (it != m_index.end()) {
+            touch(it.value());
+            return it.value()->second;
+        }
+        return insertFront(key, T())->second;
+    }
+
+    void insert(const Key& key, const T& value)
+    {
+        auto it = m_index.find(key);
+        if (it != m_index.end()) {
+            m_payloadBytes.fetch_add(payloadBytes(value) - payloadBytes(it.value()->second), std::memory_order_relaxed);
+            it.value()->second = value;
+            touch(it.value());
+            return;
+        }
+        insertFront(key, value);
+    }
+
+    bool remove(const Key& key)
+    {
+        auto it = m_index.find(key);
+        if (it == m_index.end()) {
+            return false;
+        }
+        erase(it.value());
+        return true;
+    }
+
+    void clear()
+    {
+        m_entries.clear();
+        m_index.clear();
+        m_entryCount.store(0, std::memory_order_relaxed);
+        m_payloadBytes.store(0, std::memory_order_relaxed);
+    }
+
+    QList<Key> keys() const
+    {
+        QList<Key> result;
+        result.reserve(size());
+        for (const Entry& entry : m_entries) {
+            result.append(entry.first);
+        }
+        return result;
+    }
+
+    QHash<Key, T> toHash() const
+    {
+        QHash<Key, T> result;
+        result.reserve(size());
+        for (const Entry& entry : m_entries) {
+            result.insert(entry.first, entry.second);
+        }
+        return result;
+    }
+
+    // Most recently used first
+    const_iterator begin() const { return m_entries.cbegin(); }
+    const_iterator end() const { return m_entries.cend(); }
+
+private:
+    using ListIterator = typename std::list<Entry>::iterator;
+
+    // Heap storage behind string keys and values, everything else is counted
+    // per entry from the node layout
+    template <typename V>
+    static qsizetype payloadBytes(const V& value)
+    {
+        if constexpr (std::is_same_v<V, QString>) {
+            return value.capacity() * qsizetype(sizeof(QChar));
+        } else {
+            Q_UNUSED(value);
+            return 0;
+        }
+    }
+
+    void touch(ListIterator it)
+    {
+        if (it != m_entries.begin()) {
+            m_entries.splice(m_entries.begin(), m_entries, it);
+        }
+    }
+
+    ListIterator insertFront(const Key& key, const T& value)
+    {
+        m_entries.emplace_front(key, value);
+        m_index.insert(key, m_entries.begin());
+        m_entryCount.store(size(), std::memory_order_relaxed);
+        m_payloadBytes.fetch_add(payloadBytes(key) + payloadBytes(value), std::memory_order_relaxed);
+        evictOverflow();
+        return m_entries.begin();
+    }
+
+    void erase(ListIterator it)
+    {
+        m_payloadBytes.fetch_sub(payloadBytes(it->first) + payloadBytes(it->second), std::memory_order_relaxed);
+        m_index.remove(it->first);
+        m_entries.erase(it);
+        m_entryCount.store(size(), std::memory_order_relaxed);
+    }
+
+    void evictOverflow()
+    {
+        int limit = effectiveCapacity();
+        while (size() > limit && size() > 1) {
+            erase(std::prev(m_entries.end()));
+            m_evictions.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    std::list<Entry> m_entries;
+    QHash<Key, ListIterator> m_index;
+};
+
+#endif
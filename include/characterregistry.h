@@ -0,0 +1,36 @@
+#ifndef CHARACTERREGISTRY_H
+#define CHARACTERREGISTRY_H
+
+#include <QString>
+#include <QHash>
+#include <QVector>
+#include <QReadWriteLock>
+
+using CharacterId = quint32;
+
+// Process-wide interning of character names into stable IDs. EVE treats
+// names case-insensitively, so "alice" and "Alice" share an ID; the first
+// spelling interned is the one name() returns. IDs are never reused.
+class CharacterRegistry
+{
+public:
+    static constexpr CharacterId INVALID_ID = 0;
+
+    static CharacterRegistry& instance();
+
+    CharacterId intern(const QString& characterName);
+    // Lookup without registering, INVALID_ID for names never interned
+    CharacterId find(const QString& characterName) const;
+    QString name(CharacterId id) const;
+
+private:
+    CharacterRegistry() = default;
+
+    mutable QReadWriteLock m_lock;
+    // Exact spellings hit first so the common lookup never folds case
+    QHash<QString, CharacterId> m_exactIds;
+    QHash<QString, CharacterId> m_foldedIds;
+    QVector<QString> m_names;
+};
+
+#endif
@@ -11,6 +11,11 @@
 #include <QDir>
 #include <QMutex>
 #include <QSet>
+#include <QMetaType>
+#include "systemnamematcher.h"
+#include "activitystore.h"
+#include "boundedcache.h"
+#include "config.h"
 
 struct CharacterLocation {
     QString characterName;
@@ -22,6 +27,17 @@ struct CharacterLocation {
         : characterName(name), systemName(system), lastUpdate(time) {}
 };
 
+struct IntelReport {
+    QString channel;
+    QString reporter;
+    QString systemName;
+    QString message;
+    qint64 timestamp = 0;
+    QHash<QString, int> jumpsByCharacter;
+};
+
+Q_DECLARE_METATYPE(IntelReport)
+
 class ChatLogWorker : public QObject
 {
     Q_OBJECT
@@ -35,6 +51,8 @@ public:
     void setGameLogDirectory(const QString& directory);
     void setEnableChatLogMonitoring(bool enabled);
     void setEnableGameLogMonitoring(bool enabled);
+    void setIntelChannels(const QStringList& channels);
+    void setActivityStore(ActivityStore* store);
 
 signals:
     void systemChanged(const QString& characterName, const QString& systemName);
@@ -42,6 +60,7 @@ signals:
     void characterLoggedOut(const QString& characterName);
     void combatEventDetected(const QString& characterName, const QString& eventType, const QString& eventText);
     void combatDetected(const QString& characterName, const QString& combatData);  
+    void intelReported(const IntelReport& report);
 
 public slots:
     void startMonitoring();
@@ -62,8 +81,11 @@ private:
     QString sanitizeSystemName(const QString& system);
     QString extractCharacterFromLogFile(const QString& filePath);
     void parseLogLine(const QString& line, const QString& characterName);
+    void parseIntelLine(const QString& line, const QString& channel);
+    QString findIntelLogFile(const QDir& dir, const QString& channel);
+    void scanIntelChannels();
     void scanExistingLogs();
-    void handleMiningEvent(const QString& characterName, const QString& ore);
+    void handleMiningEvent(const QString& characterName, const QString& ore, qint64 timestamp);
     void onMiningTimeout(const QString& characterName);
     
     QString m_logDirectory;
@@ -73,7 +95,7 @@ private:
     QHash<QString, qint64> m_filePositions;
     QHash<QString, qint64> m_fileLastModified;  
     QHash<QString, qint64> m_fileLastSize;      
-    QHash<QString, CharacterLocation> m_characterLocations;
+    BoundedCache<QString, CharacterLocation> m_characterLocations{"ChatLog character locations"};
     QHash<QString, QString> m_fileToKeyMap; 
     QFileSystemWatcher *m_fileWatcher;
     QTimer *m_scanTimer;
@@ -91,7 +113,16 @@ private:
     QHash<QString, QString> m_cachedChatListenerMap;  
     QHash<QString, QString> m_cachedGameListenerMap;  
     QHash<QString, QTimer*> m_miningTimers;
-    QHash<QString, bool> m_miningActiveState;
+    BoundedCache<QString, bool> m_miningActiveState{"ChatLog mining state"};
+    QHash<QString, qint64> m_miningStartTimes;
+    QHash<QString, qint64> m_miningLastTimes;
+    ActivityStore *m_activityStore = nullptr;
+    // Log time of the line or session being reported, 0 when there is none
+    qint64 m_lineTimestamp = 0;
+    // Configured channel names keyed by their lower-cased form, which is also
+    // what their "_intel" log keys are built from
+    QHash<QString, QString> m_intelChannels;
+    SystemNameMatcher m_systemMatcher;
 };
 
 class ChatLogReader : public QObject
@@ -107,31 +138,40 @@ public:
     void setGameLogDirectory(const QString& directory);
     void setEnableChatLogMonitoring(bool enabled);
     void setEnableGameLogMonitoring(bool enabled);
+    void setIntelChannels(const QStringList& channels);
+    void setActivityProfile(const QString& profileName);
     void start();
     void stop();
     void refreshMonitoring();
     
     QString getSystemForCharacter(const QString& characterName) const;
     bool isMonitoring() const;
+    QVector<ActivityEntry> activityHistory(const QString& characterName, qint64 fromMs, qint64 toMs) const;
 
 signals:
     void systemChanged(const QString& characterName, const QString& systemName);
     void characterLoggedIn(const QString& characterName);
     void characterLoggedOut(const QString& characterName);
     void combatEventDetected(const QString& characterName, const QString& eventType, const QString& eventText);
+    void intelReported(const IntelReport& report);
     void monitoringStarted();
     void monitoringStopped();
 
 private slots:
     void handleSystemChanged(const QString& characterName, const QString& systemName);
+    void onConfigChanged(Config::ChangeGroups groups, const Config::SettingSet& changed);
 
 private:
     QThread *m_workerThread;
     ChatLogWorker *m_worker;
     mutable QMutex m_locationMutex;
-    QHash<QString, QString> m_characterSystems;
+    // Lookups reorder the cache, const getters hold m_locationMutex around them
+    mutable BoundedCache<QString, QString> m_characterSystems{"ChatLog character systems"};
     bool m_monitoring;
     QSet<QString> m_lastCharacterSet;
+    ActivityStore m_activityStore;
+
+    static constexpr qint64 ACTIVITY_RESTORE_WINDOW_MS = 24 * 60 * 60 * 1000;
 };
 
 #endif 
@@ -0,0 +1,110 @@
+#ifndef CLIENTREGISTRY_H
+#define CLIENTREGISTRY_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QVector>
+#include <QPoint>
+#include "characterregistry.h"
+#include "windowsystem.h"
+
+using ClientSlot = int;
+
+// The part of a client's thumbnail that ClientTracker drives. ThumbnailWidget
+// is the real one, tests stand in their own so no widget is needed.
+class ClientThumbnail
+{
+public:
+    virtual ~ClientThumbnail() = default;
+
+    virtual void setTitle(const QString& title) = 0;
+    virtual void setCharacterName(const QString& characterName) = 0;
+    virtual void setSystemName(const QString& systemName) = 0;
+    virtual void placeAt(const QPoint& position) = 0;
+    // Deleted once control is back in the event loop
+    virtual void dispose() = 0;
+};
+
+// Every tracked client window, one dense column per field indexed by slot.
+// A slot belongs to its window until remove() and is then reused. The
+// lookups by window, by character and the creation-ordered lists are kept
+// current on every change rather than rebuilt.
+class ClientRegistry
+{
+public:
+    static constexpr ClientSlot INVALID_SLOT = -1;
+
+    enum class Kind : quint8 {
+        LoggedIn,
+        NotLoggedIn,
+        NonEVE
+    };
+
+    // The client starts out untitled, setTitle() assigns its character
+    ClientSlot add(WindowId hwnd, const QString& processName, qint64 creationTime, ClientThumbnail* thumbnail);
+    void remove(ClientSlot slot);
+    // Returns true when the client's kind or position key changed
+    bool setTitle(ClientSlot slot, const QString& title);
+
+    int size() const { return m_slotByWindow.size(); }
+    bool isEmpty() const { return m_slotByWindow.isEmpty(); }
+    ClientSlot slotFor(WindowId hwnd) const { return m_slotByWindow.value(hwnd, INVALID_SLOT); }
+    ClientSlot slotFor(CharacterId characterId) const { return m_slotByCharacter.value(characterId, INVALID_SLOT); }
+    ClientThumbnail* thumbnailFor(WindowId hwnd) const;
+
+    WindowId window(ClientSlot slot) const { return m_windows[slot]; }
+    ClientThumbnail* thumbnail(ClientSlot slot) const { return m_thumbnails[slot]; }
+    const QString& title(ClientSlot slot) const { return m_titles[slot]; }
+    const QString& processName(ClientSlot slot) const { return m_processNames[slot]; }
+    qint64 creationTime(ClientSlot slot) const { return m_creationTimes[slot]; }
+    Kind kind(ClientSlot slot) const { return m_kinds[slot]; }
+    CharacterId character(ClientSlot slot) const { return m_characters[slot]; }
+    // Empty unless logged in
+    const QString& characterName(ClientSlot slot) const { return m_characterNames[slot]; }
+    // Name the thumbnail position is saved under, empty when it has none
+    QString positionKey(ClientSlot slot) const;
+
+    const QString& systemName(ClientSlot slot) const { return m_systemNames[slot]; }
+    void setSystemName(ClientSlot slot, const QString& systemName) { m_systemNames[slot] = systemName; }
+    bool locationMoveAttempted(ClientSlot slot) const { return m_locationMoveAttempted[slot]; }
+    void setLocationMoveAttempted(ClientSlot slot, bool attempted) { m_locationMoveAttempted[slot] = attempted; }
+    void clearLocationMoveAttempted();
+    QPoint dragOrigin(ClientSlot slot) const { return m_dragOrigins[slot]; }
+    void setDragOrigin(ClientSlot slot, const QPoint& origin) { m_dragOrigins[slot] = origin; }
+
+    // Live slots, oldest client first
+    const QVector<ClientSlot>& clients() const { return m_creationOrder; }
+    const QVector<ClientSlot>& notLoggedInClients() const { return m_notLoggedIn; }
+    const QVector<ClientSlot>& nonEVEClients() const { return m_nonEVE; }
+
+    QHash<CharacterId, WindowId> characterWindows() const;
+    QStringList characterNames() const;
+
+private:
+    void insertOrdered(QVector<ClientSlot>& index, ClientSlot slot);
+    void indexKind(ClientSlot slot);
+    void unindexKind(ClientSlot slot);
+
+    QVector<WindowId> m_windows;
+    QVector<ClientThumbnail*> m_thumbnails;
+    QVector<QString> m_titles;
+    QVector<QString> m_processNames;
+    QVector<qint64> m_creationTimes;
+    QVector<Kind> m_kinds;
+    QVector<CharacterId> m_characters;
+    QVector<QString> m_characterNames;
+    QVector<QString> m_systemNames;
+    QVector<bool> m_locationMoveAttempted;
+    QVector<QPoint> m_dragOrigins;
+    QVector<bool> m_isEVE;
+    QVector<ClientSlot> m_freeSlots;
+
+    QHash<WindowId, ClientSlot> m_slotByWindow;
+    QHash<CharacterId, ClientSlot> m_slotByCharacter;
+    QVector<ClientSlot> m_creationOrder;
+    QVector<ClientSlot> m_notLoggedIn;
+    QVector<ClientSlot> m_nonEVE;
+};
+
+#endif
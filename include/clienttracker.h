@@ -0,0 +1,116 @@
+#ifndef CLIENTTRACKER_H
+#define CLIENTTRACKER_H
+
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+#include <QPoint>
+#include <functional>
+#include "boundedcache.h"
+#include "clientregistry.h"
+#include "windowsystem.h"
+
+class WindowCapture;
+class HotkeyManager;
+struct WindowInfo;
+
+// Keeps the client registry in line with the desktop and owns the cycle
+// tables built from it. Everything visual goes through ClientThumbnail and
+// the signals below, so this runs against any WindowSystem without widgets.
+class ClientTracker : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Makes the thumbnail for a newly tracked window
+    using ThumbnailFactory = std::function<ClientThumbnail*(const WindowInfo& window, const QString& displayName)>;
+
+    ClientTracker(WindowCapture& windowCapture, HotkeyManager& hotkeyManager,
+                  ThumbnailFactory createThumbnail, QObject *parent = nullptr);
+    ~ClientTracker();
+
+    const ClientRegistry& clients() const { return m_clients; }
+    ClientRegistry& clients() { return m_clients; }
+
+    // Enumerates every client and drops the ones that are gone
+    void refresh();
+
+    // Cached for clients that log in later. Returns the character's slot, if it has a client.
+    ClientSlot setCharacterSystem(const QString& characterName, const QString& systemName);
+    // System of the active client, jump distances and system grouping count from it
+    const QString& referenceSystem() const { return m_referenceSystem; }
+    void setReferenceSystem(const QString& systemName) { m_referenceSystem = systemName; }
+    QHash<QString, QString> liveCharacterSystems() const;
+    QHash<ClientSlot, QPoint> layoutTargets() const;
+
+    // Window the cycle moves to, 0 when it has nowhere to go
+    WindowId cycleForward(const QString& groupName);
+    WindowId cycleBackward(const QString& groupName);
+    WindowId cycleNotLoggedInForward();
+    WindowId cycleNotLoggedInBackward();
+    WindowId cycleNonEVEForward();
+    WindowId cycleNonEVEBackward();
+    // A client activated directly, the cycles it is in continue from it
+    void setActivated(WindowId hwnd);
+    void resetCycleState();
+    // Live clients of the group in cycle order
+    QVector<ClientSlot> cycleClients(const QString& groupName) const;
+    // Neighbours of target in the last cycled group, they are restored behind it
+    QSet<WindowId> preRestoreTargets(WindowId target) const;
+
+signals:
+    // The thumbnail exists and the client is registered, not yet placed
+    void clientAdded(ClientSlot slot);
+    // The slot is still registered and is freed right after
+    void clientRemoved(ClientSlot slot);
+    // After every refresh or removal, membershipChanged when clients came or went
+    void clientsChanged(bool membershipChanged);
+    void characterNamesChanged(const QStringList& characterNames);
+
+public slots:
+    void rebuildCycleTables();
+
+private slots:
+    void onWindowEvent(WindowSystem::Event event, quintptr windowId);
+
+private:
+    void trackWindow(WindowId hwnd);
+    void removeWindow(WindowId hwnd);
+    void applyWindows(QVector<WindowInfo> windows, bool removeMissing);
+    void updateCharacterMappings();
+    QVector<int> layoutGroups() const;
+    int cycleIndexOf(ClientSlot slot, const QString& groupName) const;
+    bool tryRestoreClientLocation(ClientSlot slot);
+
+    WindowCapture& m_windowCapture;
+    HotkeyManager& m_hotkeyManager;
+    ThumbnailFactory m_createThumbnail;
+    ClientRegistry m_clients;
+    bool m_needsMappingUpdate = false;
+
+    // Last known system of every character seen, including ones without a client
+    BoundedCache<QString, QString> m_characterSystems{"ClientTracker character systems"};
+    QString m_referenceSystem;
+
+    // Live clients of each cycle group in cycle order, rebuilt when clients
+    // or cycle groups change so a cycle hotkey is only an index step
+    struct CycleTable {
+        QVector<ClientSlot> clients;
+        bool noLoop = false;
+    };
+    struct CyclePosition {
+        QString groupName;
+        int index;
+    };
+    QHash<QString, CycleTable> m_cycleTables;
+    QHash<ClientSlot, QVector<CyclePosition>> m_cyclePositions;
+    QHash<QString, int> m_cycleIndexByGroup;
+    QHash<QString, WindowId> m_lastActivatedWindowByGroup;
+    // Group of the last cycle hotkey, its neighbours of the active client are pre-restored
+    QString m_lastCycleGroup;
+    int m_notLoggedInCycleIndex = -1;
+    int m_nonEVECycleIndex = -1;
+};
+
+#endif
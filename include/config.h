@@ -1,6 +1,7 @@
 #ifndef CONFIG_H
 #define CONFIG_H
 
+#include <QObject>
 #include <QSettings>
 #include <QString>
 #include <QStringList>
@@ -11,13 +12,148 @@
 #include <QPair>
 #include <QColor>
 #include <QFont>
+#include <QVariant>
+#include <QSet>
+#include <QThread>
+#include "boundedcache.h"
+#include <atomic>
+#include <bitset>
+#include <map>
 #include <memory>
+#include <tuple>
+#include <utility>
 
-class Config
+class ConfigSyncer;
+class ProfileWatcher;
+
+enum class ConfigValueType { Bool, Int, String, StringList, Color, Font, Point };
+
+template <ConfigValueType T> struct ConfigValueTraits;
+template <> struct ConfigValueTraits<ConfigValueType::Bool> { using Type = bool; };
+template <> struct ConfigValueTraits<ConfigValueType::Int> { using Type = int; };
+template <> struct ConfigValueTraits<ConfigValueType::String> { using Type = QString; };
+template <> struct ConfigValueTraits<ConfigValueType::StringList> { using Type = QStringList; };
+template <> struct ConfigValueTraits<ConfigValueType::Color> { using Type = QColor; };
+template <> struct ConfigValueTraits<ConfigValueType::Font> { using Type = QFont; };
+template <> struct ConfigValueTraits<ConfigValueType::Point> { using Type = QPoint; };
+
+class Config : public QObject
 {
+    Q_OBJECT
+
 public:
     static Config& instance();
     
+    // Directory holding settings.global.ini and profiles/, the executable's
+    // own by default. Only has an effect before instance() is first used.
+    static void setBaseDirectory(const QString& path);
+    
+    class Values;
+    Values values() const;
+    
+    // Groups a run of setters so the write to disk is scheduled once, when
+    // the outermost transaction ends
+    class Transaction
+    {
+    public:
+        explicit Transaction(Config& config = Config::instance());
+        ~Transaction();
+        
+        Transaction(const Transaction&) = delete;
+        Transaction& operator=(const Transaction&) = delete;
+        
+    private:
+        Config& m_config;
+    };
+    
+    enum class Setting : int {
+        HighlightActive,
+        HideActiveThumbnail,
+        HighlightColor,
+        HighlightBorderWidth,
+        ThumbnailWidth,
+        ThumbnailHeight,
+        RefreshInterval,
+        ThumbnailOpacity,
+        ShowNotLoggedIn,
+        NotLoggedInStackMode,
+        NotLoggedInReferencePosition,
+        ShowNotLoggedInOverlay,
+        ShowNonEVEOverlay,
+        ProcessNames,
+        AlwaysOnTop,
+        MinimizeInactive,
+        MinimizeDelay,
+        PreRestoreCount,
+        NeverMinimizeCharacters,
+        SaveClientLocation,
+        RememberPositions,
+        PreserveLogoutPositions,
+        LayoutStrategy,
+        LayoutGrouping,
+        EnableSnapping,
+        SnapDistance,
+        LockPositions,
+        WildcardHotkeys,
+        HotkeysOnlyWhenEVEFocused,
+        ShowCharacterName,
+        CharacterNameColor,
+        CharacterNamePosition,
+        CharacterNameFont,
+        ShowSystemName,
+        SystemNameColor,
+        SystemNamePosition,
+        SystemNameFont,
+        ShowJumpDistance,
+        GroupByJumpDistance,
+        ShowOverlayBackground,
+        OverlayBackgroundColor,
+        OverlayBackgroundOpacity,
+        OverlayFont,
+        EnableChatLogMonitoring,
+        ChatLogDirectory,
+        EnableGameLogMonitoring,
+        GameLogDirectory,
+        FileChangeDebounceMs,
+        IntelChannels,
+        IntelAlertJumps,
+        ShowIntelAlerts,
+        EnableLogIndexing,
+        EnableDebugLogging,
+        WriteLogToFile,
+        ShowCombatMessages,
+        CombatMessagePosition,
+        CombatMessageFont,
+        EnabledCombatEventTypes,
+        MiningTimeoutSeconds,
+        Count
+    };
+    static constexpr int SETTING_COUNT = static_cast<int>(Setting::Count);
+    using SettingSet = std::bitset<SETTING_COUNT>;
+    
+    // Every Setting belongs to exactly one group. Subscribers to
+    // settingsChanged() look at the groups they care about and, where they
+    // need finer detail, at the individual bits of the SettingSet.
+    // HotkeyBindingChanges has no Setting, it reports edited key bindings.
+    enum ChangeGroup {
+        LayoutChanges = 0x0001,
+        ThumbnailChanges = 0x0002,
+        BorderChanges = 0x0004,
+        OverlayChanges = 0x0008,
+        CombatMessageChanges = 0x0010,
+        WindowBehaviorChanges = 0x0020,
+        HotkeyChanges = 0x0040,
+        LogMonitoringChanges = 0x0080,
+        LogIndexChanges = 0x0100,
+        DiagnosticsChanges = 0x0200,
+        ProfileChanges = 0x0400,
+        HotkeyBindingChanges = 0x0800
+    };
+    Q_DECLARE_FLAGS(ChangeGroups, ChangeGroup)
+    Q_FLAG(ChangeGroups)
+    
+    static ChangeGroup changeGroup(Setting setting);
+    
     bool highlightActiveWindow() const;
     void setHighlightActiveWindow(bool enabled);
     
@@ -71,6 +207,10 @@ public:
     int minimizeDelay() const;
     void setMinimizeDelay(int delayMs);
     
+    // Cycle neighbours of the active client kept restored behind it, 0 disables
+    int preRestoreCount() const;
+    void setPreRestoreCount(int count);
+    
     QStringList neverMinimizeCharacters() const;
     void setNeverMinimizeCharacters(const QStringList& characters);
     void addNeverMinimizeCharacter(const QString& characterName);
@@ -89,6 +229,13 @@ public:
     bool preserveLogoutPositions() const;
     void setPreserveLogoutPositions(bool enabled);
     
+    // LayoutEngine::Strategy and LayoutEngine::Grouping for thumbnails without a saved position
+    int layoutStrategy() const;
+    void setLayoutStrategy(int strategy);
+    
+    int layoutGrouping() const;
+    void setLayoutGrouping(int grouping);
+    
     QPoint getThumbnailPosition(const QString& characterName) const;
     void setThumbnailPosition(const QString& characterName, const QPoint& pos);
     
@@ -139,6 +286,12 @@ public:
     QFont systemNameFont() const;
     void setSystemNameFont(const QFont& font);
     
+    bool showJumpDistance() const;
+    void setShowJumpDistance(bool enabled);
+    
+    bool groupThumbnailsByJumpDistance() const;
+    void setGroupThumbnailsByJumpDistance(bool enabled);
+    
     bool showOverlayBackground() const;
     void setShowOverlayBackground(bool enabled);
     
@@ -194,9 +347,33 @@ public:
     int fileChangeDebounceMs() const;
     void setFileChangeDebounceMs(int milliseconds);
 
+    QStringList intelChannels() const;
+    void setIntelChannels(const QStringList& channels);
+
+    int intelAlertJumps() const;
+    void setIntelAlertJumps(int jumps);
+
+    // Intel alerts are styled through the per-event colour, duration and
+    // border settings under INTEL_EVENT_TYPE, but are not combat messages
+    bool showIntelAlerts() const;
+    void setShowIntelAlerts(bool enabled);
+
+    bool enableLogIndexing() const;
+    void setEnableLogIndexing(bool enabled);
+
+    bool enableDebugLogging() const;
+    void setEnableDebugLogging(bool enabled);
+
+    bool writeLogToFile() const;
+    void setWriteLogToFile(bool enabled);
+
     QString configFilePath() const;
     
     void save();
+    void scheduleSave();
+    // Called after HotkeyManager writes the bindings, which it does with its
+    // own QSettings, so the watcher doesn't report them back as edits
+    void noteHotkeyBindingsSaved();
     
     QStringList listProfiles() const;
     QString getCurrentProfileName() const;
@@ -211,6 +388,25 @@ public:
     void setProfileHotkey(const QString& profileName, int key, int modifiers);
     void clearProfileHotkey(const QString& profileName);
     QMap<QString, QPair<int, int>> getAllProfileHotkeys() const;
+    
+    // Entries kept per bounded per-character cache across the app
+    int characterCacheLimit() const;
+    void setCharacterCacheLimit(int limit);
+    
+    // Window tracking follows window events, this full re-enumeration only
+    // catches anything the events missed
+    int windowReconcileSeconds() const;
+    void setWindowReconcileSeconds(int seconds);
+    
+    bool useBinaryProfiles() const;
+    // Converts every profile file to the chosen format before switching to it
+    bool setUseBinaryProfiles(bool enabled);
+    bool exportProfileToIni(const QString& profileName, const QString& filePath) const;
+    bool importProfileFromIni(const QString& filePath, const QString& profileName);
+    
+    // Stamps the character's last-seen day, positions and client rects of
+    // characters not seen for STALE_CHARACTER_DAYS are dropped on load
+    void markCharacterSeen(const QString& characterName);
 
     static constexpr const char* DEFAULT_OVERLAY_FONT_FAMILY = "Segoe UI";
     static constexpr int DEFAULT_OVERLAY_FONT_SIZE = 10;
@@ -218,8 +414,21 @@ public:
     static constexpr const char* DEFAULT_GLOBAL_LAST_USED_PROFILE = "default";
     static constexpr const char* KEY_UI_SKIP_PROFILE_SWITCH_CONFIRMATION = "ui/skipProfileSwitchConfirmation";
     static constexpr bool DEFAULT_UI_SKIP_PROFILE_SWITCH_CONFIRMATION = false;
+    static constexpr const char* KEY_GLOBAL_BINARY_PROFILES = "global/binaryProfiles";
+    static constexpr bool DEFAULT_GLOBAL_BINARY_PROFILES = false;
+    static constexpr const char* KEY_GLOBAL_CHARACTER_CACHE_LIMIT = "global/characterCacheLimit";
+    static constexpr int DEFAULT_GLOBAL_CHARACTER_CACHE_LIMIT = 500;
+    static constexpr int MIN_CHARACTER_CACHE_LIMIT = 50;
+    static constexpr int MAX_CHARACTER_CACHE_LIMIT = 100000;
+    static constexpr const char* KEY_GLOBAL_WINDOW_RECONCILE_SECONDS = "global/windowReconcileSeconds";
+    static constexpr int DEFAULT_GLOBAL_WINDOW_RECONCILE_SECONDS = 30;
+    static constexpr int MIN_WINDOW_RECONCILE_SECONDS = 5;
+    static constexpr int MAX_WINDOW_RECONCILE_SECONDS = 600;
     
     static constexpr const char* CONFIG_VERSION = "1.0";
+    // Bump together with a new step in migrateProfile()
+    static constexpr int PROFILE_SCHEMA_VERSION = 2;
+    static constexpr int STALE_CHARACTER_DAYS = 90;
     
     static constexpr bool DEFAULT_UI_HIGHLIGHT_ACTIVE = true;
     static constexpr const char* DEFAULT_UI_HIGHLIGHT_COLOR = "#FFFFFF";
@@ -241,10 +450,13 @@ public:
     static constexpr bool DEFAULT_WINDOW_ALWAYS_ON_TOP = true;
     static constexpr bool DEFAULT_WINDOW_MINIMIZE_INACTIVE = false;
     static constexpr int DEFAULT_WINDOW_MINIMIZE_DELAY = 100;
+    static constexpr int DEFAULT_WINDOW_PRE_RESTORE_COUNT = 0;
     static constexpr bool DEFAULT_WINDOW_SAVE_CLIENT_LOCATION = false;
     
     static constexpr bool DEFAULT_POSITION_REMEMBER = true;
     static constexpr bool DEFAULT_POSITION_PRESERVE_LOGOUT = false;
+    static constexpr int DEFAULT_POSITION_LAYOUT_STRATEGY = 0;
+    static constexpr int DEFAULT_POSITION_LAYOUT_GROUPING = 0;
     static constexpr bool DEFAULT_POSITION_ENABLE_SNAPPING = true;
     static constexpr int DEFAULT_POSITION_SNAP_DISTANCE = 10;
     static constexpr bool DEFAULT_POSITION_LOCK = false;
@@ -258,6 +470,8 @@ public:
     static constexpr bool DEFAULT_OVERLAY_SHOW_SYSTEM = false;
     static constexpr const char* DEFAULT_OVERLAY_SYSTEM_COLOR = "#C8C8C8";
     static constexpr int DEFAULT_OVERLAY_SYSTEM_POSITION = 3;
+    static constexpr bool DEFAULT_OVERLAY_SHOW_JUMP_DISTANCE = false;
+    static constexpr bool DEFAULT_THUMBNAIL_GROUP_BY_JUMP_DISTANCE = false;
     static constexpr bool DEFAULT_OVERLAY_SHOW_BACKGROUND = true;
     static constexpr const char* DEFAULT_OVERLAY_BACKGROUND_COLOR = "#000000";
     static constexpr int DEFAULT_OVERLAY_BACKGROUND_OPACITY = 70;
@@ -267,7 +481,12 @@ public:
     
     static constexpr bool DEFAULT_CHATLOG_ENABLE_MONITORING = false;
     static constexpr int DEFAULT_CHATLOG_FILEDEBOUNCE_MS = 200;
+    static constexpr int DEFAULT_CHATLOG_INTEL_ALERT_JUMPS = 5;
+    static constexpr bool DEFAULT_CHATLOG_SHOW_INTEL_ALERTS = true;
     static constexpr bool DEFAULT_GAMELOG_ENABLE_MONITORING = false;
+    static constexpr bool DEFAULT_LOGINDEX_ENABLED = false;
+    static constexpr bool DEFAULT_LOGGING_DEBUG_ENABLED = false;
+    static constexpr bool DEFAULT_LOGGING_WRITE_TO_FILE = false;
     
     static constexpr bool DEFAULT_COMBAT_MESSAGES_ENABLED = false;
     static constexpr int DEFAULT_COMBAT_MESSAGE_DURATION = 5000;
@@ -275,7 +494,20 @@ public:
     static constexpr const char* DEFAULT_COMBAT_MESSAGE_COLOR = "#FFFFFF";
     static constexpr int DEFAULT_MINING_TIMEOUT_SECONDS = 30;
     static constexpr bool DEFAULT_COMBAT_EVENT_BORDER_HIGHLIGHT = false;
-    static inline QStringList DEFAULT_COMBAT_MESSAGE_EVENT_TYPES() { return QStringList{ "fleet_invite", "follow_warp", "regroup", "compression", "mining_started", "mining_stopped" }; }
+    static constexpr const char* DEFAULT_COMBAT_MESSAGE_EVENT_TYPE_LIST = "fleet_invite,follow_warp,regroup,compression,mining_started,mining_stopped";
+    static inline QStringList DEFAULT_COMBAT_MESSAGE_EVENT_TYPES() { return QString(DEFAULT_COMBAT_MESSAGE_EVENT_TYPE_LIST).split(','); }
+    static constexpr const char* INTEL_EVENT_TYPE = "intel";
+    
+signals:
+    // Emitted once per setter outside a transaction, or once when the
+    // outermost transaction ends. Setters that store an unchanged value and
+    // per-character positions or client rects do not notify.
+    void settingsChanged(Config::ChangeGroups groups, const Config::SettingSet& changed);
+    
+private slots:
+    // Edits made outside the app are applied key by key through settingsChanged
+    void onProfileFileChanged(const QString& filePath, const QStringList& changedKeys, qint64 elapsedMs);
+    void onProfileFileRemoved(const QString& filePath);
     
 private:
     Config();
@@ -283,91 +515,106 @@ private:
     
     std::unique_ptr<QSettings> m_settings;
     
-    mutable bool m_cacheValid = false;
-    mutable bool m_cachedHighlightActive;
-    mutable bool m_cachedHideActiveThumbnail;
-    mutable QColor m_cachedHighlightColor;
-    mutable int m_cachedHighlightBorderWidth;
-    
-    mutable int m_cachedThumbnailWidth;
-    mutable int m_cachedThumbnailHeight;
-    mutable int m_cachedRefreshInterval;
-    mutable int m_cachedThumbnailOpacity;
-    
-    mutable bool m_cachedShowNotLoggedIn;
-    mutable int m_cachedNotLoggedInStackMode;
-    mutable QPoint m_cachedNotLoggedInReferencePosition;
-    mutable bool m_cachedShowNotLoggedInOverlay;
-    mutable bool m_cachedShowNonEVEOverlay;
-    
-    mutable QStringList m_cachedProcessNames;
-    
-    mutable bool m_cachedAlwaysOnTop;
-    mutable bool m_cachedMinimizeInactive;
-    mutable int m_cachedMinimizeDelay;
-    mutable QStringList m_cachedNeverMinimizeCharacters;
-    mutable bool m_cachedSaveClientLocation;
-    
-    mutable bool m_cachedRememberPositions;
-    mutable bool m_cachedPreserveLogoutPositions;
-    mutable bool m_cachedEnableSnapping;
-    mutable int m_cachedSnapDistance;
-    mutable bool m_cachedLockPositions;
-    
-    mutable bool m_cachedWildcardHotkeys;
-    mutable bool m_cachedHotkeysOnlyWhenEVEFocused;
-    
-    mutable bool m_cachedShowCharacterName;
-    mutable QColor m_cachedCharacterNameColor;
-    mutable int m_cachedCharacterNamePosition;
-    mutable QFont m_cachedCharacterNameFont;
-    mutable bool m_cachedShowSystemName;
-    mutable QColor m_cachedSystemNameColor;
-    mutable int m_cachedSystemNamePosition;
-    mutable QFont m_cachedSystemNameFont;
-    mutable bool m_cachedShowOverlayBackground;
-    mutable QColor m_cachedOverlayBackgroundColor;
-    mutable int m_cachedOverlayBackgroundOpacity;
-    mutable QFont m_cachedOverlayFont;  
-    
-    mutable bool m_cachedEnableChatLogMonitoring;
-    mutable QString m_cachedChatLogDirectory;
-    mutable bool m_cachedEnableGameLogMonitoring;
-    mutable QString m_cachedGameLogDirectory;
-    mutable int m_cachedFileChangeDebounceMs;
-    
-    mutable bool m_cachedShowCombatMessages;
-    mutable int m_cachedCombatMessagePosition;
-    mutable QFont m_cachedCombatMessageFont;
+    mutable int m_validCaches = 0;
+    // Defined after SCHEMA, which gives each slot its type
+    struct ProfileSnapshot;
+    using SnapshotPtr = std::shared_ptr<const ProfileSnapshot>;
+    
+    struct PreloadedProfile {
+        std::unique_ptr<QSettings> settings;
+        SnapshotPtr snapshot;
+    };
+    
+    std::atomic<SnapshotPtr> m_snapshot;
+    std::map<QString, PreloadedProfile> m_preloadedProfiles;
+    
     mutable QMap<QString, QColor> m_cachedCombatEventColors;
     mutable QMap<QString, int> m_cachedCombatEventDurations;
     mutable QMap<QString, bool> m_cachedCombatEventBorderHighlights;
-    mutable QStringList m_cachedEnabledCombatEventTypes;
-    mutable int m_cachedMiningTimeoutSeconds;
     
+    // Border colours are picked by hand and handed out as a whole, so they
+    // stay fully loaded. Positions and rects accumulate for every character
+    // ever seen and are read through a bounded cache instead.
     mutable QHash<QString, QColor> m_cachedCharacterBorderColors;
-    mutable QHash<QString, QPoint> m_cachedThumbnailPositions;
-    mutable QHash<QString, QRect> m_cachedClientWindowRects;
+    mutable BoundedCache<QString, QPoint> m_cachedThumbnailPositions{"Config thumbnail positions"};
+    mutable BoundedCache<QString, QRect> m_cachedClientWindowRects{"Config client rects"};
     
     bool m_configDialogOpen = false;
     
     QString m_currentProfileName;
     std::unique_ptr<QSettings> m_globalSettings;
+    bool m_binaryProfiles = DEFAULT_GLOBAL_BINARY_PROFILES;
+    int m_windowReconcileSeconds = DEFAULT_GLOBAL_WINDOW_RECONCILE_SECONDS;
+    QSet<QString> m_seenCharacters;
+    QSettings::SettingsMap m_hotkeyBindings;
+    
+    std::unique_ptr<ConfigSyncer> m_syncer;
+    std::unique_ptr<ProfileWatcher> m_profileWatcher;
+    int m_transactionDepth = 0;
+    bool m_saveRequested = false;
+    ChangeGroups m_pendingGroups;
+    SettingSet m_pendingSettings;
+    
+    void noteChange(Setting setting);
+    void noteChange(ChangeGroups groups);
+    void notifyChanges();
+    
+    // Only the snapshot-backed scalar getters are safe from worker threads.
+    // QSettings, the per-character caches and change tracking belong to the
+    // thread Config lives on; debug builds assert that on every entry point,
+    // and the benchmark builds check it whatever the build type.
+    void assertOwnerThread() const
+    {
+#ifdef EVEAPM_CHECK_CONFIG_THREAD
+        if (QThread::currentThread() != thread()) {
+            qFatal("Config: QSettings-backed state used off the owning thread");
+        }
+#else
+        Q_ASSERT_X(QThread::currentThread() == thread(), "Config", "QSettings-backed state used off the owning thread");
+#endif
+    }
     
-    void refreshCache() const;
-    void invalidateCache();
+    // Per-character and per-event groups reload from QSettings only when their
+    // bit has been cleared, setters keep the loaded slots current themselves.
+    // Clearing the position or rect bit empties its read-through cache.
+    enum CacheGroup {
+        CombatEventCache = 0x01,
+        BorderColorCache = 0x02,
+        ThumbnailPositionCache = 0x04,
+        ClientRectCache = 0x08,
+        AllCaches = 0x0F
+    };
+    
+    void refreshCombatEventCache() const;
+    void refreshBorderColorCache() const;
+    QPoint readThumbnailPosition(const QString& characterName) const;
+    QRect readClientWindowRect(const QString& characterName) const;
+    void invalidateCache(int groups = AllCaches);
+    
+    // Binding entries as HotkeyManager last loaded or saved them
+    void recordHotkeyBindings();
+    void noteOwnWrite(const QString& filePath);
     
     QString getProfilesDirectory() const;
     QString getProfileFilePath(const QString& profileName) const;
+    QSettings::Format profileFormat() const;
+    bool convertProfiles();
     QString getGlobalSettingsPath() const;
     void ensureProfilesDirectoryExists() const;
     void migrateToProfileSystem();
-    void migrateLegacyCombatKeys();
+    static void migrateProfile(QSettings& settings);
+    static void migrateLegacyCombatKeys(QSettings& settings);
+    static void stampCharacterLastSeen(QSettings& settings);
+    static void compactStaleCharacters(QSettings& settings);
+    static void typeSchemaValues(QSettings& settings);
+    PreloadedProfile parseProfile(const QString& profileName) const;
+    void preloadProfiles();
     void initializeDefaultProfile();
     void loadGlobalSettings();
     void saveGlobalSettings();
     
     static constexpr const char* KEY_CONFIG_VERSION = "config/version";
+    static constexpr const char* KEY_PROFILE_SCHEMA_VERSION = "config/schemaVersion";
 
     static constexpr const char* KEY_UI_HIGHLIGHT_ACTIVE = "ui/highlightActiveWindow";
     static constexpr const char* KEY_UI_HIGHLIGHT_COLOR = "ui/highlightColor";
@@ -388,11 +635,14 @@ private:
     static constexpr const char* KEY_WINDOW_ALWAYS_ON_TOP = "window/alwaysOnTop";
     static constexpr const char* KEY_WINDOW_MINIMIZE_INACTIVE = "window/minimizeInactiveClients";
     static constexpr const char* KEY_WINDOW_MINIMIZE_DELAY = "window/minimizeDelay";
+    static constexpr const char* KEY_WINDOW_PRE_RESTORE_COUNT = "window/preRestoreCount";
     static constexpr const char* KEY_WINDOW_NEVER_MINIMIZE_CHARACTERS = "window/neverMinimizeCharacters";
     static constexpr const char* KEY_WINDOW_SAVE_CLIENT_LOCATION = "window/saveClientLocation";
 
     static constexpr const char* KEY_POSITION_REMEMBER = "position/rememberPositions";
     static constexpr const char* KEY_POSITION_PRESERVE_LOGOUT = "position/preserveLogoutPositions";
+    static constexpr const char* KEY_POSITION_LAYOUT_STRATEGY = "position/layoutStrategy";
+    static constexpr const char* KEY_POSITION_LAYOUT_GROUPING = "position/layoutGrouping";
     static constexpr const char* KEY_POSITION_ENABLE_SNAPPING = "position/enableSnapping";
     static constexpr const char* KEY_POSITION_SNAP_DISTANCE = "position/snapDistance";
     static constexpr const char* KEY_POSITION_LOCK = "position/lockPositions";
@@ -408,6 +658,8 @@ private:
     static constexpr const char* KEY_OVERLAY_SYSTEM_COLOR = "overlay/systemNameColor";
     static constexpr const char* KEY_OVERLAY_SYSTEM_POSITION = "overlay/systemNamePosition";
     static constexpr const char* KEY_OVERLAY_SYSTEM_FONT = "overlay/systemNameFont";
+    static constexpr const char* KEY_OVERLAY_SHOW_JUMP_DISTANCE = "overlay/showJumpDistance";
+    static constexpr const char* KEY_THUMBNAIL_GROUP_BY_JUMP_DISTANCE = "thumbnail/groupByJumpDistance";
     static constexpr const char* KEY_OVERLAY_SHOW_BACKGROUND = "overlay/showBackground";
     static constexpr const char* KEY_OVERLAY_BACKGROUND_COLOR = "overlay/backgroundColor";
     static constexpr const char* KEY_OVERLAY_BACKGROUND_OPACITY = "overlay/backgroundOpacity";
@@ -416,10 +668,18 @@ private:
     static constexpr const char* KEY_CHATLOG_ENABLE_MONITORING = "chatlog/enableMonitoring";
     static constexpr const char* KEY_CHATLOG_DIRECTORY = "chatlog/directory";
     static constexpr const char* KEY_CHATLOG_FILEDEBOUNCE_MS = "chatlog/fileDebounceMs";
+    static constexpr const char* KEY_CHATLOG_INTEL_CHANNELS = "chatlog/intelChannels";
+    static constexpr const char* KEY_CHATLOG_INTEL_ALERT_JUMPS = "chatlog/intelAlertJumps";
+    static constexpr const char* KEY_CHATLOG_SHOW_INTEL_ALERTS = "chatlog/showIntelAlerts";
 
     static constexpr const char* KEY_GAMELOG_ENABLE_MONITORING = "gamelog/enableMonitoring";
     static constexpr const char* KEY_GAMELOG_DIRECTORY = "gamelog/directory";
 
+    static constexpr const char* KEY_LOGINDEX_ENABLED = "logindex/enabled";
+
+    static constexpr const char* KEY_LOGGING_DEBUG_ENABLED = "logging/debugEnabled";
+    static constexpr const char* KEY_LOGGING_WRITE_TO_FILE = "logging/writeToFile";
+
     static constexpr const char* KEY_COMBAT_ENABLED = "combatMessages/enabled";
     static constexpr const char* KEY_COMBAT_DURATION = "combatMessages/duration";
     static constexpr const char* KEY_COMBAT_POSITION = "combatMessages/position";
@@ -438,11 +698,148 @@ private:
             {"regroup", "#FF8C42"},
             {"compression", "#7FFF00"},
             {"mining_started", "#FFD700"},
-            {"mining_stopped", "#FF6B6B"}
+            {"mining_stopped", "#FF6B6B"},
+            {INTEL_EVENT_TYPE, "#FF4040"}
         };
     }
     
     static constexpr const char* KEY_MINING_TIMEOUT_SECONDS = "miningMode/timeoutSeconds";
+    
+    // One row per scalar setting, in Setting order. number holds the Bool/Int
+    // default, the Font point size or the Point x; extra holds the Point y or
+    // a bold flag for Font. Int settings with minimum < maximum are clamped.
+    struct SettingSpec {
+        Setting id;
+        const char* path;
+        ConfigValueType type;
+        int number;
+        const char* text;
+        int minimum;
+        int maximum;
+        int extra;
+        QString (*resolveDefault)();
+    };
+    
+    static constexpr SettingSpec SCHEMA[SETTING_COUNT] = {
+        { Setting::HighlightActive, KEY_UI_HIGHLIGHT_ACTIVE, ConfigValueType::Bool, DEFAULT_UI_HIGHLIGHT_ACTIVE },
+        { Setting::HideActiveThumbnail, KEY_UI_HIDE_ACTIVE_THUMBNAIL, ConfigValueType::Bool, DEFAULT_UI_HIDE_ACTIVE_THUMBNAIL },
+        { Setting::HighlightColor, KEY_UI_HIGHLIGHT_COLOR, ConfigValueType::Color, 0, DEFAULT_UI_HIGHLIGHT_COLOR },
+        { Setting::HighlightBorderWidth, KEY_UI_HIGHLIGHT_BORDER_WIDTH, ConfigValueType::Int, DEFAULT_UI_HIGHLIGHT_BORDER_WIDTH },
+        { Setting::ThumbnailWidth, KEY_THUMBNAIL_WIDTH, ConfigValueType::Int, DEFAULT_THUMBNAIL_WIDTH },
+        { Setting::ThumbnailHeight, KEY_THUMBNAIL_HEIGHT, ConfigValueType::Int, DEFAULT_THUMBNAIL_HEIGHT },
+        { Setting::RefreshInterval, KEY_THUMBNAIL_REFRESH_INTERVAL, ConfigValueType::Int, DEFAULT_THUMBNAIL_REFRESH_INTERVAL },
+        { Setting::ThumbnailOpacity, KEY_THUMBNAIL_OPACITY, ConfigValueType::Int, DEFAULT_THUMBNAIL_OPACITY, nullptr, OPACITY_MIN, OPACITY_MAX },
+        { Setting::ShowNotLoggedIn, KEY_THUMBNAIL_SHOW_NOT_LOGGED_IN, ConfigValueType::Bool, DEFAULT_THUMBNAIL_SHOW_NOT_LOGGED_IN },
+        { Setting::NotLoggedInStackMode, KEY_THUMBNAIL_NOT_LOGGED_IN_STACK_MODE, ConfigValueType::Int, DEFAULT_THUMBNAIL_NOT_LOGGED_IN_STACK_MODE },
+        { Setting::NotLoggedInReferencePosition, KEY_THUMBNAIL_NOT_LOGGED_IN_REF_POSITION, ConfigValueType::Point, DEFAULT_THUMBNAIL_NOT_LOGGED_IN_REF_X, nullptr, 0, 0, DEFAULT_THUMBNAIL_NOT_LOGGED_IN_REF_Y },
+        { Setting::ShowNotLoggedInOverlay, KEY_THUMBNAIL_SHOW_NOT_LOGGED_IN_OVERLAY, ConfigValueType::Bool, DEFAULT_THUMBNAIL_SHOW_NOT_LOGGED_IN_OVERLAY },
+        { Setting::ShowNonEVEOverlay, KEY_THUMBNAIL_SHOW_NON_EVE_OVERLAY, ConfigValueType::Bool, DEFAULT_THUMBNAIL_SHOW_NON_EVE_OVERLAY },
+        { Setting::ProcessNames, KEY_THUMBNAIL_PROCESS_NAMES, ConfigValueType::StringList, 0, DEFAULT_THUMBNAIL_PROCESS_NAME },
+
+        { Setting::AlwaysOnTop, KEY_WINDOW_ALWAYS_ON_TOP, ConfigValueType::Bool, DEFAULT_WINDOW_ALWAYS_ON_TOP },
+        { Setting::MinimizeInactive, KEY_WINDOW_MINIMIZE_INACTIVE, ConfigValueType::Bool, DEFAULT_WINDOW_MINIMIZE_INACTIVE },
+        { Setting::MinimizeDelay, KEY_WINDOW_MINIMIZE_DELAY, ConfigValueType::Int, DEFAULT_WINDOW_MINIMIZE_DELAY },
+        { Setting::PreRestoreCount, KEY_WINDOW_PRE_RESTORE_COUNT, ConfigValueType::Int, DEFAULT_WINDOW_PRE_RESTORE_COUNT },
+        { Setting::NeverMinimizeCharacters, KEY_WINDOW_NEVER_MINIMIZE_CHARACTERS, ConfigValueType::StringList },
+        { Setting::SaveClientLocation, KEY_WINDOW_SAVE_CLIENT_LOCATION, ConfigValueType::Bool, DEFAULT_WINDOW_SAVE_CLIENT_LOCATION },
+
+        { Setting::RememberPositions, KEY_POSITION_REMEMBER, ConfigValueType::Bool, DEFAULT_POSITION_REMEMBER },
+        { Setting::PreserveLogoutPositions, KEY_POSITION_PRESERVE_LOGOUT, ConfigValueType::Bool, DEFAULT_POSITION_PRESERVE_LOGOUT },
+        { Setting::LayoutStrategy, KEY_POSITION_LAYOUT_STRATEGY, ConfigValueType::Int, DEFAULT_POSITION_LAYOUT_STRATEGY },
+        { Setting::LayoutGrouping, KEY_POSITION_LAYOUT_GROUPING, ConfigValueType::Int, DEFAULT_POSITION_LAYOUT_GROUPING },
+        { Setting::EnableSnapping, KEY_POSITION_ENABLE_SNAPPING, ConfigValueType::Bool, DEFAULT_POSITION_ENABLE_SNAPPING },
+        { Setting::SnapDistance, KEY_POSITION_SNAP_DISTANCE, ConfigValueType::Int, DEFAULT_POSITION_SNAP_DISTANCE },
+        { Setting::LockPositions, KEY_POSITION_LOCK, ConfigValueType::Bool, DEFAULT_POSITION_LOCK },
+
+        { Setting::WildcardHotkeys, KEY_HOTKEY_WILDCARD, ConfigValueType::Bool, DEFAULT_HOTKEY_WILDCARD },
+        { Setting::HotkeysOnlyWhenEVEFocused, KEY_HOTKEY_ONLY_WHEN_EVE_FOCUSED, ConfigValueType::Bool, DEFAULT_HOTKEY_ONLY_WHEN_EVE_FOCUSED },
+
+        { Setting::ShowCharacterName, KEY_OVERLAY_SHOW_CHARACTER, ConfigValueType::Bool, DEFAULT_OVERLAY_SHOW_CHARACTER },
+        { Setting::CharacterNameColor, KEY_OVERLAY_CHARACTER_COLOR, ConfigValueType::Color, 0, DEFAULT_OVERLAY_CHARACTER_COLOR },
+        { Setting::CharacterNamePosition, KEY_OVERLAY_CHARACTER_POSITION, ConfigValueType::Int, DEFAULT_OVERLAY_CHARACTER_POSITION },
+        { Setting::CharacterNameFont, KEY_OVERLAY_CHARACTER_FONT, ConfigValueType::Font, DEFAULT_OVERLAY_FONT_SIZE, DEFAULT_OVERLAY_FONT_FAMILY },
+        { Setting::ShowSystemName, KEY_OVERLAY_SHOW_SYSTEM, ConfigValueType::Bool, DEFAULT_OVERLAY_SHOW_SYSTEM },
+        { Setting::SystemNameColor, KEY_OVERLAY_SYSTEM_COLOR, ConfigValueType::Color, 0, DEFAULT_OVERLAY_SYSTEM_COLOR },
+        { Setting::SystemNamePosition, KEY_OVERLAY_SYSTEM_POSITION, ConfigValueType::Int, DEFAULT_OVERLAY_SYSTEM_POSITION },
+        { Setting::SystemNameFont, KEY_OVERLAY_SYSTEM_FONT, ConfigValueType::Font, DEFAULT_OVERLAY_FONT_SIZE, DEFAULT_OVERLAY_FONT_FAMILY },
+        { Setting::ShowJumpDistance, KEY_OVERLAY_SHOW_JUMP_DISTANCE, ConfigValueType::Bool, DEFAULT_OVERLAY_SHOW_JUMP_DISTANCE },
+        { Setting::GroupByJumpDistance, KEY_THUMBNAIL_GROUP_BY_JUMP_DISTANCE, ConfigValueType::Bool, DEFAULT_THUMBNAIL_GROUP_BY_JUMP_DISTANCE },
+        { Setting::ShowOverlayBackground, KEY_OVERLAY_SHOW_BACKGROUND, ConfigValueType::Bool, DEFAULT_OVERLAY_SHOW_BACKGROUND },
+        { Setting::OverlayBackgroundColor, KEY_OVERLAY_BACKGROUND_COLOR, ConfigValueType::Color, 0, DEFAULT_OVERLAY_BACKGROUND_COLOR },
+        { Setting::OverlayBackgroundOpacity, KEY_OVERLAY_BACKGROUND_OPACITY, ConfigValueType::Int, DEFAULT_OVERLAY_BACKGROUND_OPACITY, nullptr, OPACITY_MIN, OPACITY_MAX },
+        { Setting::OverlayFont, KEY_OVERLAY_FONT, ConfigValueType::Font, DEFAULT_OVERLAY_FONT_SIZE, DEFAULT_OVERLAY_FONT_FAMILY },
+
+        { Setting::EnableChatLogMonitoring, KEY_CHATLOG_ENABLE_MONITORING, ConfigValueType::Bool, DEFAULT_CHATLOG_ENABLE_MONITORING },
+        { Setting::ChatLogDirectory, KEY_CHATLOG_DIRECTORY, ConfigValueType::String, 0, nullptr, 0, 0, 0, &getDefaultChatLogDirectory },
+        { Setting::EnableGameLogMonitoring, KEY_GAMELOG_ENABLE_MONITORING, ConfigValueType::Bool, DEFAULT_GAMELOG_ENABLE_MONITORING },
+        { Setting::GameLogDirectory, KEY_GAMELOG_DIRECTORY, ConfigValueType::String, 0, nullptr, 0, 0, 0, &getDefaultGameLogDirectory },
+        { Setting::FileChangeDebounceMs, KEY_CHATLOG_FILEDEBOUNCE_MS, ConfigValueType::Int, DEFAULT_CHATLOG_FILEDEBOUNCE_MS },
+        { Setting::IntelChannels, KEY_CHATLOG_INTEL_CHANNELS, ConfigValueType::StringList },
+        { Setting::IntelAlertJumps, KEY_CHATLOG_INTEL_ALERT_JUMPS, ConfigValueType::Int, DEFAULT_CHATLOG_INTEL_ALERT_JUMPS },
+        { Setting::ShowIntelAlerts, KEY_CHATLOG_SHOW_INTEL_ALERTS, ConfigValueType::Bool, DEFAULT_CHATLOG_SHOW_INTEL_ALERTS },
+        { Setting::EnableLogIndexing, KEY_LOGINDEX_ENABLED, ConfigValueType::Bool, DEFAULT_LOGINDEX_ENABLED },
+        { Setting::EnableDebugLogging, KEY_LOGGING_DEBUG_ENABLED, ConfigValueType::Bool, DEFAULT_LOGGING_DEBUG_ENABLED },
+        { Setting::WriteLogToFile, KEY_LOGGING_WRITE_TO_FILE, ConfigValueType::Bool, DEFAULT_LOGGING_WRITE_TO_FILE },
+
+        { Setting::ShowCombatMessages, KEY_COMBAT_ENABLED, ConfigValueType::Bool, DEFAULT_COMBAT_MESSAGES_ENABLED },
+        { Setting::CombatMessagePosition, KEY_COMBAT_POSITION, ConfigValueType::Int, DEFAULT_COMBAT_MESSAGE_POSITION },
+        { Setting::CombatMessageFont, KEY_COMBAT_FONT, ConfigValueType::Font, DEFAULT_OVERLAY_FONT_SIZE, DEFAULT_OVERLAY_FONT_FAMILY, 0, 0, 1 },
+        { Setting::EnabledCombatEventTypes, KEY_COMBAT_ENABLED_EVENT_TYPES, ConfigValueType::StringList, 0, DEFAULT_COMBAT_MESSAGE_EVENT_TYPE_LIST },
+        { Setting::MiningTimeoutSeconds, KEY_MINING_TIMEOUT_SECONDS, ConfigValueType::Int, DEFAULT_MINING_TIMEOUT_SECONDS },
+    };
+    
+    template <Setting S>
+    using SettingValue = typename ConfigValueTraits<SCHEMA[static_cast<int>(S)].type>::Type;
+    
+    template <typename Indices>
+    struct SnapshotValues;
+    template <std::size_t... I>
+    struct SnapshotValues<std::index_sequence<I...>> {
+        using Type = std::tuple<typename ConfigValueTraits<SCHEMA[I].type>::Type...>;
+    };
+    
+    // One typed slot per Setting. Immutable once published: setters copy,
+    // modify and swap, so readers on other threads only ever see a complete
+    // snapshot.
+    struct ProfileSnapshot {
+        SnapshotValues<std::make_index_sequence<SETTING_COUNT>>::Type values;
+    };
+    
+    template <Setting S>
+    SettingValue<S> settingValue() const;
+    template <Setting S>
+    void setSettingValue(const SettingValue<S>& value);
+    
+    static constexpr bool schemaInSettingOrder();
+    static QVariant defaultValue(const SettingSpec& spec);
+    static QVariant normalizeValue(const SettingSpec& spec, const QVariant& value);
+    static QVariant storedValue(const SettingSpec& spec, const QVariant& value);
+    static void writeDefaults(QSettings& settings);
+    static bool assignSetting(ProfileSnapshot& snapshot, int index, const QVariant& value);
+    static SnapshotPtr buildSnapshot(const QSettings& settings);
+    static SettingSet diffSnapshots(const ProfileSnapshot& before, const ProfileSnapshot& after);
 };
 
+// Settings pinned for a batch of reads, e.g. one paint. Reads return
+// references into the pinned snapshot, so they neither touch the shared
+// snapshot pointer again nor copy fonts, colours and lists. Safe to take on
+// any thread; later changes are not seen until values() is called again.
+class Config::Values
+{
+public:
+    template <Config::Setting S>
+    const Config::SettingValue<S>& get() const
+    {
+        return std::get<static_cast<int>(S)>(m_snapshot->values);
+    }
+    
+private:
+    friend class Config;
+    explicit Values(Config::SnapshotPtr snapshot) : m_snapshot(std::move(snapshot)) {}
+    
+    Config::SnapshotPtr m_snapshot;
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(Config::ChangeGroups)
+
 #endif 
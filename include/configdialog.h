@@ -78,6 +78,10 @@ private slots:
     void onCloneProfile();
     void onRenameProfile();
     void onDeleteProfile();
+    void onShowMemoryReport();
+    void onBinaryProfilesToggled(bool enabled);
+    void onExportProfile();
+    void onImportProfile();
     void onTestOverlays();
 
 private:
@@ -97,6 +101,7 @@ private:
     
     QWidget* createColorButton(const QColor& color);
     void updateColorButton(QPushButton* button, const QColor& color);
+    void updateIntelAlertControls();
     void performGlobalSearch(const QString& searchText);
     void tagWidget(QWidget* widget, const QStringList& keywords);
     
@@ -139,6 +144,8 @@ private:
     QCheckBox *m_alwaysOnTopCheck;
     QCheckBox *m_rememberPositionsCheck;
     QCheckBox *m_preserveLogoutPositionsCheck;
+    QComboBox *m_layoutStrategyCombo;
+    QComboBox *m_layoutGroupingCombo;
     QCheckBox *m_enableSnappingCheck;
     QSpinBox *m_snapDistanceSpin;
     QLabel *m_snapDistanceLabel;
@@ -150,6 +157,10 @@ private:
     QPushButton *m_aspectRatio21_9Button;
     QPushButton *m_aspectRatio4_3Button;
     QSpinBox *m_refreshIntervalSpin;
+    QSpinBox *m_characterCacheLimitSpin;
+    QCheckBox *m_enableDebugLoggingCheck;
+    QCheckBox *m_writeLogToFileCheck;
+    QCheckBox *m_binaryProfilesCheck;
     QSpinBox *m_opacitySpin;
     QCheckBox *m_showNotLoggedInClientsCheck;
     QLabel *m_notLoggedInPositionLabel;
@@ -167,6 +178,8 @@ private:
     QCheckBox *m_minimizeInactiveCheck;
     QSpinBox *m_minimizeDelaySpin;
     QLabel *m_minimizeDelayLabel;
+    QSpinBox *m_preRestoreCountSpin;
+    QLabel *m_preRestoreCountLabel;
     QTableWidget *m_neverMinimizeTable;
     QPushButton *m_addNeverMinimizeButton;
     QPushButton *m_populateNeverMinimizeButton;
@@ -200,6 +213,8 @@ private:
     QLabel *m_systemNamePositionLabel;
     QPushButton *m_systemNameFontButton;
     QLabel *m_systemNameFontLabel;
+    QCheckBox *m_showJumpDistanceCheck;
+    QCheckBox *m_groupByJumpDistanceCheck;
     
     QCheckBox *m_showBackgroundCheck;
     QPushButton *m_backgroundColorButton;
@@ -221,11 +236,21 @@ private:
     QLineEdit *m_chatLogDirectoryEdit;
     QPushButton *m_chatLogBrowseButton;
     QLabel *m_chatLogDirectoryLabel;
+    QLineEdit *m_intelChannelsEdit;
+    QLabel *m_intelChannelsLabel;
+    QSpinBox *m_intelAlertJumpsSpin;
+    QLabel *m_intelAlertJumpsLabel;
+    QCheckBox *m_showIntelAlertsCheck;
+    QPushButton *m_intelAlertColorButton;
+    QLabel *m_intelAlertDurationLabel;
+    QSpinBox *m_intelAlertDurationSpin;
+    QCheckBox *m_intelAlertBorderCheck;
     QSpinBox *m_fileChangeDebounceSpin;
     QCheckBox *m_enableGameLogMonitoringCheck;
     QLineEdit *m_gameLogDirectoryEdit;
     QPushButton *m_gameLogBrowseButton;
     QLabel *m_gameLogDirectoryLabel;
+    QCheckBox *m_enableLogIndexingCheck;
     
     QCheckBox *m_showCombatMessagesCheck;
     QComboBox *m_combatMessagePositionCombo;
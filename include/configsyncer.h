@@ -0,0 +1,69 @@
+#ifndef CONFIGSYNCER_H
+#define CONFIGSYNCER_H
+
+#include <QObject>
+#include <QString>
+#include <QDateTime>
+#include <QSettings>
+#include <QThread>
+#include <QTimer>
+#include <memory>
+
+// Profile QSettings used by Config on the GUI thread. A plain QSettings
+// writes its own changes back on the next event loop pass; this one leaves
+// them in the in-memory store that all QSettings on the file share, for
+// ConfigSyncWorker to write. sync() and the destructor still write directly.
+class ProfileSettings : public QSettings
+{
+public:
+    ProfileSettings(const QString& fileName, Format format, QObject *parent = nullptr);
+
+protected:
+    bool event(QEvent *event) override;
+};
+
+// Writes out the shared store of a profile from its own QSettings on the
+// worker thread. Config schedules a sync after each change it makes, and the
+// worker reports the file stamp it left so the watcher can skip its own writes.
+class ConfigSyncWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ConfigSyncWorker(QObject *parent = nullptr);
+
+public slots:
+    void scheduleSync(const QString& filePath);
+    void syncNow();
+
+signals:
+    void synced(const QString& filePath, const QDateTime& modified, qint64 size);
+
+private:
+    std::unique_ptr<QSettings> m_settings;
+    QTimer *m_debounceTimer;
+
+    static constexpr int SYNC_DEBOUNCE_MS = 750;
+};
+
+class ConfigSyncer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ConfigSyncer(QObject *parent = nullptr);
+    ~ConfigSyncer();
+
+    void scheduleSync(const QString& filePath);
+    void flush();
+
+signals:
+    // Stamp of the file as this write left it, so the watcher can skip it
+    void synced(const QString& filePath, const QDateTime& modified, qint64 size);
+
+private:
+    QThread *m_workerThread;
+    ConfigSyncWorker *m_worker;
+};
+
+#endif
@@ -5,7 +5,9 @@
 #include <QHash>
 #include <QVector>
 #include <QString>
-#include <Windows.h>
+#include "config.h"
+#include "characterregistry.h"
+#include "windowsystem.h"
 
 struct HotkeyBinding
 {
@@ -31,12 +33,12 @@ struct HotkeyBinding
         , enabled(en)
     {}
     
-    UINT getModifiers() const
+    quint32 getModifiers() const
     {
-        UINT mods = 0;
-        if (ctrl) mods |= MOD_CONTROL;
-        if (alt) mods |= MOD_ALT;
-        if (shift) mods |= MOD_SHIFT;
+        quint32 mods = 0;
+        if (ctrl) mods |= WindowSystem::HotkeyControl;
+        if (alt) mods |= WindowSystem::HotkeyAlt;
+        if (shift) mods |= WindowSystem::HotkeyShift;
         return mods;
     }
     
@@ -129,14 +131,13 @@ public:
     void loadFromConfig();
     void saveToConfig();
     
-    void updateCharacterWindows(const QHash<QString, HWND>& characterWindows);
-    HWND getWindowForCharacter(const QString& characterName) const;
-    QString getCharacterForWindow(HWND hwnd) const;
-    
-    static bool nativeEventFilter(void* message, long* result);
+    void updateCharacterWindows(const QHash<CharacterId, WindowId>& characterWindows);
+    WindowId getWindowForCharacter(CharacterId characterId) const;
+    WindowId getWindowForCharacter(const QString& characterName) const;
+    CharacterId getCharacterForWindow(WindowId hwnd) const;
     
 signals:
-    void characterHotkeyPressed(QString characterName);
+    void characterHotkeyPressed(CharacterId characterId);
     void namedCycleForwardPressed(QString groupName);
     void namedCycleBackwardPressed(QString groupName);
     void notLoggedInCycleForwardPressed();  
@@ -146,17 +147,22 @@ signals:
     void suspendedChanged(bool suspended);
     void profileSwitchRequested(QString profileName);
     void closeAllClientsRequested();
+    void cycleGroupsChanged();
+
+private slots:
+    void onConfigChanged(Config::ChangeGroups groups, const Config::SettingSet& changed);
+    void onHotkeyPressed(int hotkeyId);
 
 private:
     QHash<QString, HotkeyBinding> m_characterHotkeys;  // Legacy: First hotkey per character
     QHash<QString, QVector<HotkeyBinding>> m_characterMultiHotkeys;  // New: All hotkeys per character
-    QHash<int, QString> m_hotkeyIdToCharacter;  
+    QHash<int, CharacterId> m_hotkeyIdToCharacter;
     QHash<int, QString> m_hotkeyIdToCycleGroup;  
     QHash<int, bool> m_hotkeyIdIsForward;  
     QHash<int, int> m_wildcardAliases;  
     QHash<int, QString> m_hotkeyIdToProfile;  
     
-    QHash<QString, HWND> m_characterWindows;  
+    QHash<CharacterId, WindowId> m_characterWindows;
     QHash<QString, CycleGroup> m_cycleGroups;  
     
     HotkeyBinding m_suspendHotkey;  // Legacy: first hotkey
@@ -0,0 +1,58 @@
+#ifndef LAYOUTENGINE_H
+#define LAYOUTENGINE_H
+
+#include <QPoint>
+#include <QRect>
+#include <QSize>
+#include <QVector>
+
+// Default thumbnail placement as a pure function of the clients, their saved
+// positions and the screen geometry. Nothing here touches a widget, callers
+// compare the result against where thumbnails are and move only what differs.
+class LayoutEngine
+{
+public:
+    enum class Strategy {
+        // Rows across the primary screen
+        Grid,
+        // Top-to-bottom columns, filling each screen before the next
+        MonitorColumns,
+        // Grid cells on every screen, skipping any a saved position covers
+        PackAroundSaved
+    };
+
+    enum class Grouping {
+        None,
+        CycleGroup,
+        System
+    };
+
+    struct Item {
+        // Sentinel matching Config::getThumbnailPosition() for "never saved"
+        QPoint savedPosition{-1, -1};
+        bool notLoggedIn = false;
+        // Lower groups are placed first, each group starts a new row or column
+        int group = 0;
+    };
+
+    struct Parameters {
+        Strategy strategy = Strategy::Grid;
+        QSize thumbnailSize;
+        int margin = 10;
+        // Primary screen first
+        QVector<QRect> screens;
+        // Logged-out clients stack from here, see Config::notLoggedInStackMode()
+        QPoint notLoggedInOrigin;
+        int notLoggedInStackMode = 0;
+    };
+
+    // One rect per item, in item order
+    static QVector<QRect> layout(const QVector<Item>& items, const Parameters& parameters);
+
+    static bool isOnScreen(const QRect& rect, const QVector<QRect>& screens);
+
+private:
+    static QPoint notLoggedInPosition(int index, const Parameters& parameters);
+};
+
+#endif
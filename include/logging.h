@@ -0,0 +1,73 @@
+#ifndef LOGGING_H
+#define LOGGING_H
+
+#include <QLoggingCategory>
+#include <QString>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QFile>
+#include <atomic>
+#include <memory>
+
+class QThread;
+
+// Debug output is off by default for these categories, so a disabled
+// qCDebug() costs one flag check and never formats its arguments. Building
+// with EVEAPM_DEBUG_LOGGING=OFF removes the debug statements entirely.
+Q_DECLARE_LOGGING_CATEGORY(lcLog)
+Q_DECLARE_LOGGING_CATEGORY(lcOverlay)
+Q_DECLARE_LOGGING_CATEGORY(lcHotkey)
+Q_DECLARE_LOGGING_CATEGORY(lcWindow)
+
+// Message handler that copies each message into a preallocated ring and lets
+// a background thread write it to a rotating log file. The calling thread
+// never blocks on file I/O and never allocates; messages are dropped (and
+// counted) if the writer falls a full ring behind.
+class LogSink
+{
+public:
+    static LogSink& instance();
+
+    void setDebugEnabled(bool enabled);
+    void setFileEnabled(bool enabled);
+    bool isFileEnabled() const { return m_fileEnabled; }
+    void shutdown();
+
+    static QString logDirectory();
+
+private:
+    LogSink();
+    ~LogSink();
+    LogSink(const LogSink&) = delete;
+    LogSink& operator=(const LogSink&) = delete;
+
+    struct Slot;
+
+    static void messageHandler(QtMsgType type, const QMessageLogContext& context, const QString& message);
+    bool push(QtMsgType type, const char* category, const QString& message);
+    void flushLoop();
+    int drain();
+    void writeSlot(const Slot& slot);
+    void rotateIfNeeded();
+
+    std::unique_ptr<Slot[]> m_slots;
+    alignas(64) std::atomic<quint64> m_enqueuePosition{0};
+    alignas(64) quint64 m_dequeuePosition = 0;
+    std::atomic<quint64> m_dropped{0};
+
+    QtMessageHandler m_previousHandler = nullptr;
+    QThread *m_flushThread = nullptr;
+    QMutex m_wakeMutex;
+    QWaitCondition m_wakeCondition;
+    std::atomic<bool> m_stopping{false};
+    bool m_fileEnabled = false;
+    QFile m_file;
+
+    static constexpr quint64 RING_CAPACITY = 2048;  // power of two
+    static constexpr int MAX_MESSAGE_CHARS = 256;
+    static constexpr int FLUSH_INTERVAL_MS = 250;
+    static constexpr qint64 MAX_FILE_BYTES = 5 * 1024 * 1024;
+    static constexpr int MAX_ROTATED_FILES = 3;
+};
+
+#endif
@@ -0,0 +1,138 @@
+#ifndef LOGINDEX_H
+#define LOGINDEX_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QDateTime>
+#include <QThread>
+#include <QTimer>
+#include <QMutex>
+#include <memory>
+#include <vector>
+
+// A file that was deleted or truncated keeps its id with an empty path, so
+// the blocks still naming it in older segments are skipped until compacted
+struct LogIndexedFile {
+    QString path;
+    QString channel;
+    QString listener;
+    qint64 indexedBytes = 0;
+    bool utf16 = false;
+
+    bool isRemoved() const { return path.isEmpty(); }
+};
+
+struct LogSearchQuery {
+    QString phrase;
+    QString channel;
+    QString character;
+    QDateTime from;
+    QDateTime to;
+    int maxResults = 500;
+};
+
+struct LogSearchHit {
+    QString filePath;
+    QString channel;
+    QString character;
+    QDateTime timestamp;
+    QString line;
+};
+
+struct MappedLogSegment;
+
+// Read-only view of the trigram index. Segments are memory-mapped, so opening
+// is cheap and postings are never copied to the heap.
+class LogIndexReader
+{
+public:
+    explicit LogIndexReader(const QString& indexDirectory);
+    ~LogIndexReader();
+
+    bool isValid() const { return !m_segments.empty(); }
+    int fileCount() const { return m_files.size(); }
+    QVector<LogSearchHit> search(const LogSearchQuery& query) const;
+
+private:
+    QVector<LogIndexedFile> m_files;
+    std::vector<std::unique_ptr<MappedLogSegment>> m_segments;
+};
+
+class LogIndexWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LogIndexWorker(QObject *parent = nullptr);
+
+    void setDirectories(const QString& chatLogDirectory, const QString& gameLogDirectory);
+
+signals:
+    void passFinished(int newBlocks, qint64 elapsedMs);
+
+public slots:
+    void startIndexing();
+    void stopIndexing();
+    void runPass();
+
+private:
+    struct SegmentBuilder;
+
+    bool loadCatalog();
+    bool saveCatalog();
+    bool indexFile(int fileId, SegmentBuilder& builder, qint64& byteBudget);
+    void removeFile(int fileId);
+    bool isFileRemoved(quint32 fileId) const;
+    int appendLiveBlocks(const MappedLogSegment& segment, SegmentBuilder& builder) const;
+    void compactSegments();
+    void readFileHeader(LogIndexedFile& file, bool isGameLog);
+    bool writeSegment(const SegmentBuilder& builder, const QString& fileName);
+    void mergeSmallSegments();
+    void removeOrphanedSegments();
+    QString nextSegmentName();
+
+    QString m_chatLogDirectory;
+    QString m_gameLogDirectory;
+    QString m_indexDirectory;
+    QVector<LogIndexedFile> m_files;
+    QHash<QString, int> m_fileIds;
+    QStringList m_segmentNames;
+    quint32 m_nextSegmentId = 0;
+    QTimer *m_passTimer;
+    QMutex m_mutex;
+    bool m_running = false;
+
+    static constexpr int PASS_INTERVAL_MS = 300000;
+    static constexpr int BACKLOG_PASS_INTERVAL_MS = 1000;
+    static constexpr qint64 PASS_BYTE_BUDGET = 64 * 1024 * 1024;
+    static constexpr int MAX_SEGMENTS = 8;
+    static constexpr int SEGMENTS_PER_MERGE = 4;
+    // A segment is rewritten once this share of its blocks names removed files
+    static constexpr int COMPACT_REMOVED_PERCENT = 25;
+};
+
+class LogIndexer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LogIndexer(QObject *parent = nullptr);
+    ~LogIndexer();
+
+    void setDirectories(const QString& chatLogDirectory, const QString& gameLogDirectory);
+    void start();
+    void stop();
+    bool isRunning() const { return m_running; }
+
+    static QString indexDirectory();
+
+private:
+    QThread *m_workerThread;
+    LogIndexWorker *m_worker;
+    bool m_running = false;
+};
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef LOGSEARCHDIALOG_H
+#define LOGSEARCHDIALOG_H
+
+#include <QDialog>
+#include <QLineEdit>
+#include <QCheckBox>
+#include <QDateTimeEdit>
+#include <QPushButton>
+#include <QLabel>
+#include <QTableWidget>
+#include <QFutureWatcher>
+#include "logindex.h"
+
+class LogSearchDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit LogSearchDialog(QWidget *parent = nullptr);
+
+private slots:
+    void onSearchClicked();
+    void onSearchFinished();
+
+private:
+    struct SearchResult {
+        bool indexValid = false;
+        QVector<LogSearchHit> hits;
+        qint64 elapsedMs = 0;
+        int maxResults = 0;
+    };
+
+    void setupUi();
+    static SearchResult runSearch(const LogSearchQuery& query);
+
+    QLineEdit *m_phraseEdit;
+    QLineEdit *m_channelEdit;
+    QLineEdit *m_characterEdit;
+    QCheckBox *m_fromCheck;
+    QDateTimeEdit *m_fromEdit;
+    QCheckBox *m_toCheck;
+    QDateTimeEdit *m_toEdit;
+    QPushButton *m_searchButton;
+    QLabel *m_statusLabel;
+    QTableWidget *m_resultsTable;
+    QFutureWatcher<SearchResult> *m_searchWatcher;
+};
+
+#endif
@@ -4,19 +4,28 @@
 #include <QObject>
 #include <QTimer>
 #include <QHash>
+#include <QSet>
+#include <QElapsedTimer>
 #include <QVector>
 #include <QPoint>
 #include <QSystemTrayIcon>
 #include <QMenu>
 #include <memory>
-#include <Windows.h>
+#include <optional>
+#include "config.h"
+#include "characterregistry.h"
+#include "clienttracker.h"
+#include "windowsystem.h"
 
 class ThumbnailWidget;
 class WindowCapture;
+struct WindowInfo;
 class HotkeyManager;
 class ConfigDialog;
 class ChatLogReader;
-struct CycleGroup;
+class LogIndexer;
+class LogSearchDialog;
+struct IntelReport;
 
 class MainWindow : public QObject
 {
@@ -25,8 +34,6 @@ class MainWindow : public QObject
 public:
     explicit MainWindow(QObject *parent = nullptr);
     ~MainWindow();
-    
-    void applySettings();
 
 signals:
     void profileSwitchedExternally(const QString& profileName);
@@ -41,6 +48,7 @@ private slots:
     void onGroupDragEnded(quintptr windowId);
     void minimizeInactiveWindows();
     void showSettings();
+    void showLogSearch();
     void exitApplication();
     void activateProfile();
     void onCharacterSystemChanged(const QString& characterName, const QString& systemName);
@@ -48,61 +56,50 @@ private slots:
     void onHotkeysSuspendedChanged(bool suspended);
     void toggleSuspendHotkeys();
     void closeAllEVEClients();
+    void onConfigChanged(Config::ChangeGroups groups, const Config::SettingSet& changed);
+    void logCacheReport();
+    void onWindowEvent(WindowSystem::Event event, quintptr windowId);
+    void onClientAdded(ClientSlot slot);
+    void onClientRemoved(ClientSlot slot);
+    void onClientsChanged(bool membershipChanged);
 
 private:
-    QTimer *refreshTimer;
+    QTimer *m_reconcileTimer;
     QTimer *minimizeTimer;
+    QTimer *m_groupDragTimer;
+    QTimer *m_cacheReportTimer;
     QSystemTrayIcon *m_trayIcon;
     QMenu *m_trayMenu;
     QMenu *m_profilesMenu;
     QAction *m_suspendHotkeysAction;
     ConfigDialog *m_configDialog = nullptr;
+    LogSearchDialog *m_logSearchDialog = nullptr;
     
     std::unique_ptr<WindowCapture> windowCapture;
     std::unique_ptr<HotkeyManager> hotkeyManager;
     std::unique_ptr<ChatLogReader> m_chatLogReader;
-    QHash<HWND, ThumbnailWidget*> thumbnails;
-    QHash<QString, HWND> m_characterToWindow;
-    QHash<HWND, QString> m_windowToCharacter;
-    QHash<QString, QString> m_characterSystems;  
-    QHash<QString, int> m_cycleIndexByGroup;
-    QHash<QString, HWND> m_lastActivatedWindowByGroup;  
-    QHash<HWND, qint64> m_windowCreationTimes;
-    
-    QHash<HWND, bool> m_clientLocationMoveAttempted;
-    
-    QVector<HWND> m_notLoggedInWindows;
-    int m_notLoggedInCycleIndex;
-    
-    QVector<HWND> m_nonEVEWindows;
-    int m_nonEVECycleIndex;
+    std::unique_ptr<LogIndexer> m_logIndexer;
+    std::unique_ptr<ClientTracker> m_tracker;
     
-    HWND m_hwndToActivate = nullptr;
-    HWND m_hwndJustRestored = nullptr;  
-    HWND m_hwndPendingRefresh = nullptr;  
+    WindowId m_hwndToActivate = 0;
+    WindowId m_hwndJustRestored = 0;  
+    WindowId m_hwndPendingRefresh = 0;  
+    // Foreground window the thumbnails currently show as active
+    WindowId m_activeWindow = 0;
     
-    HWINEVENTHOOK m_eventHook = nullptr;
-    HWINEVENTHOOK m_createHook = nullptr;
-    HWINEVENTHOOK m_destroyHook = nullptr;
-    HWINEVENTHOOK m_showHook = nullptr;  
-    
-    bool m_needsEnumeration = true;
-    int m_enumerationCounter = 0;
-    bool m_needsMappingUpdate = false;  
-    
-    QHash<HWND, QString> m_lastKnownTitles;
-    QHash<HWND, QString> m_windowProcessNames;  
+    // Activation-to-foreground latency, logged when the target comes forward
+    QElapsedTimer m_activationTimer;
+    WindowId m_activationTarget = 0;
+    bool m_activationTargetMinimized = false;
     
     QVector<ThumbnailWidget*> m_cachedThumbnailList;
-    int m_lastThumbnailListSize = 0;
-    
-    QHash<quintptr, QPoint> m_groupDragInitialPositions;
+    bool m_snappingListDirty = false;
     
-    static MainWindow* s_instance;
-    static void CALLBACK WinEventProc(HWINEVENTHOOK hWinEventHook, DWORD event, HWND hwnd, 
-                                      LONG idObject, LONG idChild, DWORD dwEventThread, DWORD dwmsEventTime);
-    static void CALLBACK WindowEventProc(HWINEVENTHOOK hWinEventHook, DWORD event, HWND hwnd,
-                                         LONG idObject, LONG idChild, DWORD dwEventThread, DWORD dwmsEventTime);
+    // Thumbnails following the current group drag, with their native top-left
+    // at drag start. Hidden ones have none and are moved as widgets.
+    QHash<ClientSlot, std::optional<QPoint>> m_groupDragMembers;
+    QPoint m_groupDragDelta;
+    bool m_groupDragPending = false;
     
     void handleNamedCycleForward(const QString& groupName);
     void handleNamedCycleBackward(const QString& groupName);
@@ -111,17 +108,21 @@ private:
     void handleNonEVECycleForward();
     void handleNonEVECycleBackward();
     void handleProfileSwitch(const QString& profileName);
-    void activateWindow(HWND hwnd);
-    void activateCharacter(const QString& characterName);
-    void updateCharacterMappings();
+    void activateWindow(WindowId hwnd);
+    void applyActiveState(ClientSlot slot, bool active);
+    void refreshActiveStates();
+    ClientThumbnail* createThumbnail(const WindowInfo& window, const QString& displayName);
+    ClientRegistry& clients() { return m_tracker->clients(); }
+    const ClientRegistry& clients() const { return m_tracker->clients(); }
+    ThumbnailWidget* thumbnailWidget(ClientSlot slot) const;
+    void activateCharacter(CharacterId characterId);
     void updateSnappingLists();
-    void refreshSingleThumbnail(HWND hwnd);  
-    QPoint calculateNotLoggedInPosition(int index);
+    void applyGroupDrag();
+    void updateJumpDistances();
+    void onIntelReported(const IntelReport& report);
+    void refreshSingleThumbnail(WindowId hwnd);  
     void updateProfilesMenu();  
-    QVector<HWND> buildCycleWindowList(const CycleGroup& group);
     void saveCurrentClientLocations();
-    bool tryRestoreClientLocation(HWND hwnd, const QString& characterName);
-    bool isWindowRectValid(const QRect& rect);
 };
 
 #endif 
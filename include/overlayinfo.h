@@ -6,6 +6,7 @@
 #include <QFont>
 #include <QRect>
 #include <QHash>
+#include "boundedcache.h"
 
 enum class OverlayPosition {
     TopLeft,
@@ -58,7 +59,7 @@ public:
     static void clearCache();
 
 private:
-    static QHash<QString, QString> s_characterNameCache;
+    static BoundedCache<QString, QString> s_characterNameCache;
 };
 
 #endif 
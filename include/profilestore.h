@@ -0,0 +1,34 @@
+#ifndef PROFILESTORE_H
+#define PROFILESTORE_H
+
+#include <QSettings>
+#include <QString>
+#include <QIODevice>
+
+// Binary QSettings backend for profiles. The file is read with a single call
+// and decoded from a string table plus one typed section per value kind, so
+// loading never parses individual keys as text the way INI files do.
+class ProfileStore
+{
+public:
+    static QSettings::Format binaryFormat();
+    static QSettings::Format formatForPath(const QString& filePath);
+
+    // Copies every key, used for INI import/export and format conversion
+    static bool copySettings(const QSettings& source, QSettings& destination);
+
+    // Reads a profile file straight from disk, never through a QSettings, so
+    // nothing the app has pending on that path is flushed. INI values are kept
+    // as their raw text, which is enough to tell whether an entry changed.
+    static bool readEntries(const QString& filePath, QSettings::SettingsMap& map);
+
+    static constexpr const char* BINARY_EXTENSION = "profile";
+    static constexpr const char* INI_EXTENSION = "ini";
+
+private:
+    static bool read(QIODevice& device, QSettings::SettingsMap& map);
+    static bool write(QIODevice& device, const QSettings::SettingsMap& map);
+    static bool readIniEntries(QIODevice& device, QSettings::SettingsMap& map);
+};
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef PROFILEWATCHER_H
+#define PROFILEWATCHER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QDateTime>
+#include <QThread>
+#include <QTimer>
+#include <QFileSystemWatcher>
+#include <QSettings>
+
+// Reads a profile file from disk and reports the keys that differ from the
+// last contents it saw. Saves the app announced through noteOwnWrite() are
+// skipped, anything else may still carry our own keys, so receivers compare
+// against what they already hold before acting on a key.
+class ProfileReloadWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ProfileReloadWorker(QObject *parent = nullptr);
+
+public slots:
+    void track(const QStringList& filePaths);
+    void reload(const QString& filePath);
+    void forget(const QString& filePath);
+
+signals:
+    void reloaded(const QString& filePath, const QStringList& changedKeys, qint64 elapsedMs);
+
+private:
+    static QSettings::SettingsMap readContents(const QString& filePath);
+
+    QHash<QString, QSettings::SettingsMap> m_lastContents;
+};
+
+class ProfileWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ProfileWatcher(const QString& profilesDirectory, QObject *parent = nullptr);
+    ~ProfileWatcher();
+
+    // A file the app just wrote, with the timestamp and size it left behind
+    void noteOwnWrite(const QString& filePath, const QDateTime& modified, qint64 size);
+
+signals:
+    void profileChanged(const QString& filePath, const QStringList& changedKeys, qint64 elapsedMs);
+    void profileRemoved(const QString& filePath);
+
+private slots:
+    void onPathChanged(const QString& path);
+    void scanProfiles();
+
+private:
+    struct FileStamp {
+        QDateTime modified;
+        qint64 size = -1;
+    };
+
+    QHash<QString, FileStamp> currentStamps() const;
+
+    QString m_profilesDirectory;
+    QFileSystemWatcher *m_fileWatcher;
+    QTimer *m_debounceTimer;
+    QHash<QString, FileStamp> m_fileStamps;
+    QHash<QString, FileStamp> m_ownWrites;
+
+    QThread *m_workerThread;
+    ProfileReloadWorker *m_worker;
+
+    // Editors and sync tools often write a file in several steps
+    static constexpr int RELOAD_DEBOUNCE_MS = 300;
+};
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef SNAPINDEX_H
+#define SNAPINDEX_H
+
+#include <QPoint>
+#include <QRect>
+#include <QSize>
+#include <QVector>
+
+// Snap targets for one dragged thumbnail, built when the drag starts. Every
+// edge is stored as the top-left coordinate that lines the dragged rect up
+// with it, sorted per axis, so a move only looks at the edges within the
+// snap distance instead of at every other thumbnail.
+class SnapIndex
+{
+public:
+    // others are the rects the dragged one snaps to, screens their available area
+    void build(const QVector<QRect>& others, const QVector<QRect>& screens, const QSize& size, int distance);
+    void clear();
+    bool isEmpty() const { return m_xEdges.isEmpty() && m_yEdges.isEmpty(); }
+
+    QPoint snap(const QPoint& pos) const;
+
+private:
+    enum class Rule : quint8 {
+        // Applies while the dragged rect overlaps the span on the other axis
+        Overlap,
+        // Applies while the dragged rect sits against either end of the span
+        Adjacent
+    };
+
+    struct Edge {
+        int target;
+        int low;
+        int high;
+        Rule rule;
+    };
+
+    int nearest(const QVector<Edge>& edges, int position, int crossStart, int crossLength) const;
+
+    QVector<Edge> m_xEdges;
+    QVector<Edge> m_yEdges;
+    QSize m_size;
+    int m_distance = 0;
+};
+
+#endif
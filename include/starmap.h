@@ -0,0 +1,58 @@
+#ifndef STARMAP_H
+#define STARMAP_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QMutex>
+
+class StarMap
+{
+public:
+    static StarMap& instance();
+
+    bool isLoaded() const { return !m_names.isEmpty(); }
+    int systemCount() const { return m_names.size(); }
+
+    int systemIndex(const QString& systemName) const;
+    QString systemName(int index) const;
+    const QStringList& systemNames() const { return m_names; }
+
+    int jumpDistance(int fromIndex, int toIndex) const;
+    int jumpDistance(const QString& fromSystem, const QString& toSystem) const;
+
+    // Distances from one origin to many targets using a single cached BFS row
+    QVector<int> distancesFrom(int originIndex, const QVector<int>& targetIndices) const;
+    QHash<QString, int> distancesFrom(const QString& originSystem, const QHash<QString, QString>& systemsByCharacter) const;
+
+    static constexpr int UNREACHABLE = -1;
+
+private:
+    StarMap();
+    ~StarMap() = default;
+    StarMap(const StarMap&) = delete;
+    StarMap& operator=(const StarMap&) = delete;
+
+    bool loadFromFile(const QString& filePath);
+    QVector<quint16> distanceRow(int originIndex) const;
+
+    QStringList m_names;
+    QHash<QString, int> m_nameToIndex;
+
+    // Compressed sparse row adjacency: neighbours of system i are
+    // m_neighbors[m_rowOffsets[i] .. m_rowOffsets[i + 1])
+    QVector<int> m_rowOffsets;
+    QVector<int> m_neighbors;
+
+    mutable QMutex m_cacheMutex;
+    mutable QHash<int, QVector<quint16>> m_distanceCache;
+    mutable QVector<int> m_cacheOrder;
+
+    static constexpr int MAX_CACHED_ORIGINS = 64;
+    static constexpr quint16 NO_ROUTE = 0xFFFF;
+    static constexpr const char* RESOURCE_PATH = ":/starmap/starmap.txt";
+    static constexpr const char* FILE_NAME = "starmap.txt";
+};
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef SYSTEMNAMEMATCHER_H
+#define SYSTEMNAMEMATCHER_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// Aho-Corasick automaton over solar system names. A message is scanned once
+// regardless of how many names are in the dictionary.
+class SystemNameMatcher
+{
+public:
+    SystemNameMatcher() = default;
+
+    void build(const QStringList& names);
+    bool isEmpty() const { return m_patternLengths.isEmpty(); }
+
+    // Returns indices into the name list passed to build(), in order of
+    // appearance, for whole-word matches only. Overlapping shorter matches
+    // are dropped in favour of the longest one.
+    QVector<int> findAll(const QString& text) const;
+
+private:
+    struct Node {
+        int edgeBegin = 0;
+        int edgeEnd = 0;
+        int fail = 0;
+        int output = -1;      // pattern ending exactly at this node
+        int outputLink = -1;  // nearest node on the fail chain with an output
+    };
+
+    int step(int state, char16_t c) const;
+    int child(int node, char16_t c) const;
+    static bool isNameChar(QChar c);
+
+    QVector<Node> m_nodes;
+    QVector<char16_t> m_edgeLabels;
+    QVector<int> m_edgeTargets;
+    QVector<int> m_patternLengths;
+};
+
+#endif
@@ -6,13 +6,15 @@
 #include <QPixmap>
 #include <QVector>
 #include <QTimer>
-#include <windows.h>
-#include <dwmapi.h>
 #include "overlayinfo.h"
+#include "config.h"
+#include "windowsystem.h"
+#include "clientregistry.h"
+#include "snapindex.h"
 
 class OverlayWidget;
 
-class ThumbnailWidget : public QWidget
+class ThumbnailWidget : public QWidget, public ClientThumbnail
 {
     Q_OBJECT
 
@@ -20,17 +22,23 @@ public:
     explicit ThumbnailWidget(quintptr windowId, const QString& title, QWidget *parent = nullptr);
     ~ThumbnailWidget();
     
-    void setTitle(const QString& title);
+    void setTitle(const QString& title) override;
     void setActive(bool active);
+    bool isActive() const { return m_isActive; }
     void updateOverlays();
     quintptr getWindowId() const { return m_windowId; }
+    // Native handle of the overlay drawn over this thumbnail, 0 while it is hidden
+    WindowId overlayWindow() const;
     
-    void setCharacterName(const QString& characterName);
+    void setCharacterName(const QString& characterName) override;
     QString getCharacterName() const { return m_characterName; }
     
-    void setSystemName(const QString& systemName);
+    void setSystemName(const QString& systemName) override;
     QString getSystemName() const { return m_systemName; }
     
+    void setJumpDistance(int jumps);
+    int getJumpDistance() const { return m_jumpDistance; }
+    
     void setCombatMessage(const QString& message, const QString& eventType = QString());
     QString getCombatMessage() const { return m_combatMessage; }
     bool hasCombatEvent() const { return !m_combatMessage.isEmpty(); }
@@ -41,6 +49,9 @@ public:
     void forceOverlayRender();  
     
     void setOtherThumbnails(const QVector<ThumbnailWidget*>& others) { m_otherThumbnails = others; }
+    
+    void placeAt(const QPoint& position) override { move(position); }
+    void dispose() override { deleteLater(); }
 
 signals:
     void clicked(quintptr windowId);
@@ -61,11 +72,15 @@ protected:
     void hideEvent(QHideEvent *event) override;
     void moveEvent(QMoveEvent *event) override;
 
+private slots:
+    void onConfigChanged(Config::ChangeGroups groups, const Config::SettingSet& changed);
+
 private:
     quintptr m_windowId;
     QString m_title;
     QString m_characterName;
     QString m_systemName;
+    int m_jumpDistance = -1;
     QString m_combatMessage;
     QString m_combatEventType;
     QPoint m_dragPosition;
@@ -75,8 +90,9 @@ private:
     bool m_isActive = false;
     QVector<OverlayElement> m_overlays;
     QVector<ThumbnailWidget*> m_otherThumbnails;
+    SnapIndex m_snapIndex;
     
-    HTHUMBNAIL m_dwmThumbnail = nullptr;
+    WindowSystem::ThumbnailSurface m_dwmThumbnail = 0;
     QTimer* m_updateTimer = nullptr;
     QTimer* m_combatMessageTimer = nullptr;
     
@@ -88,7 +104,9 @@ private:
     void cleanupDwmThumbnail();
     void updateDwmThumbnail();
     void updateOverlayWidget();
-    QPoint snapPosition(const QPoint& pos, const QVector<ThumbnailWidget*>& otherThumbnails);
+    // Built when a drag starts, the other thumbnails hold still until it ends
+    void buildSnapIndex(bool includeThumbnails);
+    QPoint snapPosition(const QPoint& pos) const;
 };
 
 class OverlayWidget : public QWidget
@@ -100,8 +118,8 @@ public:
     
     void setOverlays(const QVector<OverlayElement>& overlays);
     void setActiveState(bool active);
-    void setCharacterName(const QString& characterName);
-    void setSystemName(const QString& systemName);
+    void setCharacterName(const QString& characterName) override;
+    void setSystemName(const QString& systemName) override;
     void setCombatEventState(bool hasCombatEvent, const QString& eventType);
     void updateWindowFlags(bool alwaysOnTop);
     void invalidateCache();
@@ -109,6 +127,9 @@ public:
 protected:
     void paintEvent(QPaintEvent *event) override;
     
+private slots:
+    void onConfigChanged(Config::ChangeGroups groups, const Config::SettingSet& changed);
+    
 private:
     QVector<OverlayElement> m_overlays;
     bool m_isActive = false;
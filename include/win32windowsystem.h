@@ -0,0 +1,83 @@
+#ifndef WIN32WINDOWSYSTEM_H
+#define WIN32WINDOWSYSTEM_H
+
+#include "windowsystem.h"
+#include <QAbstractNativeEventFilter>
+#include <QHash>
+#include <Windows.h>
+
+class QWinEventNotifier;
+
+// The native backend, the only code that hands window ids to the Win32 API
+class Win32WindowSystem : public WindowSystem, public QAbstractNativeEventFilter
+{
+    Q_OBJECT
+
+public:
+    explicit Win32WindowSystem(QObject *parent = nullptr);
+    ~Win32WindowSystem();
+
+    QVector<WindowId> topLevelWindows() const override;
+    bool isWindow(WindowId window) const override;
+    bool isVisible(WindowId window) const override;
+    bool isMinimized(WindowId window) const override;
+    QString windowTitle(WindowId window) const override;
+
+    quint32 processId(WindowId window) const override;
+    QString processName(quint32 processId) const override;
+    qint64 processCreationTime(quint32 processId) const override;
+    bool watchProcessExit(quint32 processId) override;
+    void unwatchProcessExit(quint32 processId) override;
+
+    WindowId foregroundWindow() const override;
+    bool setForegroundWindow(WindowId window) override;
+    void restore(WindowId window, bool wait) override;
+    void restoreBehind(WindowId window, WindowId insertAfter) override;
+    void minimize(WindowId window) override;
+    void close(WindowId window) override;
+
+    QRect windowRect(WindowId window) const override;
+    bool setWindowRect(WindowId window, const QRect& rect) override;
+    bool moveWindows(const QVector<WindowMove>& moves) override;
+    QSize clientSize(WindowId window) const override;
+
+    ThumbnailSurface registerThumbnail(WindowId destination, WindowId source) override;
+    void unregisterThumbnail(ThumbnailSurface surface) override;
+    bool updateThumbnail(ThumbnailSurface surface, const QRect& sourceRect, const QRect& destinationRect) override;
+
+    bool setWindowEventsEnabled(bool enabled) override;
+
+    bool registerHotkey(int id, quint32 modifiers, quint32 keyCode) override;
+    void unregisterHotkey(int id) override;
+
+    // Turns WM_HOTKEY into hotkeyPressed()
+    bool nativeEventFilter(const QByteArray& eventType, void* message, qintptr* result) override;
+
+private:
+    static HWND toHwnd(WindowId window) { return reinterpret_cast<HWND>(window); }
+    static WindowId toWindowId(HWND hwnd) { return reinterpret_cast<WindowId>(hwnd); }
+
+    static BOOL CALLBACK enumWindowsProc(HWND hwnd, LPARAM lParam);
+    static void CALLBACK winEventProc(HWINEVENTHOOK hWinEventHook, DWORD event, HWND hwnd,
+                                      LONG idObject, LONG idChild, DWORD dwEventThread, DWORD dwmsEventTime);
+
+    void removeHooks();
+    void onProcessExited(quint32 processId);
+
+    HWINEVENTHOOK m_foregroundHook = nullptr;
+    HWINEVENTHOOK m_createHook = nullptr;
+    HWINEVENTHOOK m_destroyHook = nullptr;
+    HWINEVENTHOOK m_showHook = nullptr;
+    HWINEVENTHOOK m_nameChangeHook = nullptr;
+
+    // Each notifier keeps its process handle open, which is what holds the ID
+    QHash<quint32, QWinEventNotifier*> m_exitNotifiers;
+
+    // Installed with the first hotkey, the application may not exist earlier
+    bool m_hotkeyFilterInstalled = false;
+
+    // Hook callbacks carry no context pointer
+    static Win32WindowSystem* s_hookOwner;
+};
+
+#endif
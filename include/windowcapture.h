@@ -4,18 +4,18 @@
 #include <QVector>
 #include <QString>
 #include <QHash>
-#include <Windows.h>
+#include "windowsystem.h"
 
 struct WindowInfo {
-    HWND handle;
+    WindowId handle;
     quintptr id;
     QString title;
     QString processName;
     qint64 creationTime;
     
-    WindowInfo() : handle(nullptr), id(0), creationTime(0) {}
-    WindowInfo(HWND h, const QString& t, const QString& p, qint64 ct = 0) 
-        : handle(h), id(reinterpret_cast<quintptr>(h)), title(t), processName(p), creationTime(ct) {}
+    WindowInfo() : handle(0), id(0), creationTime(0) {}
+    WindowInfo(WindowId h, const QString& t, const QString& p, qint64 ct = 0) 
+        : handle(h), id(h), title(t), processName(p), creationTime(ct) {}
     
     WindowInfo(const WindowInfo& other) = default;
     
@@ -28,7 +28,7 @@ struct WindowInfo {
         , processName(std::move(other.processName))
         , creationTime(other.creationTime)
     {
-        other.handle = nullptr;
+        other.handle = 0;
         other.id = 0;
         other.creationTime = 0;
     }
@@ -42,7 +42,7 @@ struct WindowInfo {
             processName = std::move(other.processName);
             creationTime = other.creationTime;
             
-            other.handle = nullptr;
+            other.handle = 0;
             other.id = 0;
             other.creationTime = 0;
         }
@@ -57,23 +57,15 @@ public:
     ~WindowCapture();
     
     QVector<WindowInfo> getEVEWindows();
+    // Single-window form of getEVEWindows(), false when hwnd isn't a client
+    bool captureWindow(WindowId hwnd, WindowInfo& window);
     
-    static void activateWindow(HWND hwnd);
+    static void activateWindow(WindowId hwnd);
     
+    // Drops the process metadata shared by every WindowCapture
     void clearCache();
 
-    QString getWindowTitle(HWND hwnd);
-    
-private:
-    static BOOL CALLBACK enumWindowsProc(HWND hwnd, LPARAM lParam);
-    bool isEVEWindow(HWND hwnd, QString& title, QString& processName);
-    QString getProcessName(HWND hwnd);
-    qint64 getProcessCreationTime(HWND hwnd);
-
-    QHash<HWND, QString> m_processNameCache;
-
-    mutable QHash<HWND, QString>::iterator m_cleanupIterator;
-    mutable bool m_cleanupIteratorInitialized = false;
+    QString getWindowTitle(WindowId hwnd);
 };
 
 #endif 
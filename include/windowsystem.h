@@ -0,0 +1,110 @@
+#ifndef WINDOWSYSTEM_H
+#define WINDOWSYSTEM_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <QRect>
+#include <QPoint>
+#include <QSize>
+#include <QHash>
+
+// Native top-level window, an HWND in the Win32 backend. Kept opaque so this
+// interface, and the backends tests swap in, need no platform headers.
+using WindowId = quintptr;
+
+// The window-manager operations the app relies on: enumeration, titles,
+// owning process, foreground, show/minimize, window events, live thumbnail
+// surfaces and system-wide hotkeys. Everything outside the backend goes
+// through instance(), so another backend can be swapped in with setInstance().
+class WindowSystem : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class Event {
+        Foreground,
+        Created,
+        Destroyed,
+        Shown,
+        NameChanged
+    };
+    Q_ENUM(Event)
+
+    // Opaque handle for a registered thumbnail, 0 when registration failed
+    using ThumbnailSurface = quintptr;
+
+    // Modifiers for registerHotkey(), the values of MOD_ALT, MOD_CONTROL and MOD_SHIFT
+    enum HotkeyModifier : quint32 {
+        HotkeyAlt = 0x0001,
+        HotkeyControl = 0x0002,
+        HotkeyShift = 0x0004
+    };
+
+    struct WindowMove {
+        WindowId window;
+        // Native top-left, size and z-order are kept
+        QPoint position;
+    };
+
+    static WindowSystem& instance();
+    // Replaces the active backend, nullptr restores the native one. The
+    // caller keeps ownership and must reset it before the backend goes away.
+    // Builds without a native backend (tests) must set one before use.
+    static void setInstance(WindowSystem* backend);
+
+    virtual QVector<WindowId> topLevelWindows() const = 0;
+    virtual bool isWindow(WindowId window) const = 0;
+    virtual bool isVisible(WindowId window) const = 0;
+    virtual bool isMinimized(WindowId window) const = 0;
+    virtual QString windowTitle(WindowId window) const = 0;
+
+    virtual quint32 processId(WindowId window) const = 0;
+    virtual QString processName(quint32 processId) const = 0;
+    // Milliseconds since the Unix epoch, 0 when the process can't be opened
+    virtual qint64 processCreationTime(quint32 processId) const = 0;
+    // Emits processExited() once the process ends. A watched process ID is
+    // not reused by the system until that signal has been delivered.
+    virtual bool watchProcessExit(quint32 processId) = 0;
+    virtual void unwatchProcessExit(quint32 processId) = 0;
+
+    virtual WindowId foregroundWindow() const = 0;
+    virtual bool setForegroundWindow(WindowId window) = 0;
+    // Asynchronous unless wait is set, which returns once the window is restored
+    virtual void restore(WindowId window, bool wait) = 0;
+    // Restores without activating, placed directly below insertAfter
+    virtual void restoreBehind(WindowId window, WindowId insertAfter) = 0;
+    virtual void minimize(WindowId window) = 0;
+    virtual void close(WindowId window) = 0;
+
+    // Null rect when the window is gone
+    virtual QRect windowRect(WindowId window) const = 0;
+    virtual bool setWindowRect(WindowId window, const QRect& rect) = 0;
+    // Moves every window in one pass, so they are repositioned together
+    virtual bool moveWindows(const QVector<WindowMove>& moves) = 0;
+    virtual QSize clientSize(WindowId window) const = 0;
+
+    virtual ThumbnailSurface registerThumbnail(WindowId destination, WindowId source) = 0;
+    virtual void unregisterThumbnail(ThumbnailSurface surface) = 0;
+    virtual bool updateThumbnail(ThumbnailSurface surface, const QRect& sourceRect, const QRect& destinationRect) = 0;
+
+    // windowEvent() is only emitted while enabled, delivered on the thread
+    // that enabled it. Created, Shown and NameChanged are limited to
+    // top-level windows; Destroyed can't be, the window is already gone.
+    virtual bool setWindowEventsEnabled(bool enabled) = 0;
+
+    // keyCode is a Windows virtual-key code. hotkeyPressed() carries the id
+    // and is delivered on the thread that registered the hotkey.
+    virtual bool registerHotkey(int id, quint32 modifiers, quint32 keyCode) = 0;
+    virtual void unregisterHotkey(int id) = 0;
+
+signals:
+    void windowEvent(WindowSystem::Event event, WindowId windowId);
+    void processExited(quint32 processId);
+    void hotkeyPressed(int id);
+
+protected:
+    explicit WindowSystem(QObject *parent = nullptr);
+};
+
+#endif
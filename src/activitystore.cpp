@@ -0,0 +1,423 @@
+#include "activitystore.h"
+#include "logging.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QDebug>
+#include <algorithm>
+#include <cstring>
+
+// File layout: FileHeader, NameSlot[NAME_CAPACITY], Record[RECORD_CAPACITY].
+// Record n of the ring lives at slot n % RECORD_CAPACITY and the header keeps
+// the total number of records ever written.
+struct ActivityStore::FileHeader {
+    quint32 magic;
+    quint32 version;
+    quint32 recordSize;
+    quint32 recordCapacity;
+    quint32 nameCapacity;
+    quint32 nameCount;
+    quint64 writeSequence;
+    quint8 reserved[32];
+};
+
+struct ActivityStore::NameSlot {
+    quint16 length;
+    char16_t chars[47];
+};
+
+struct ActivityStore::Record {
+    qint64 timestamp;
+    quint64 sequence;
+    quint16 type;
+    quint16 characterId;
+    quint16 subjectId;
+    quint16 flags;
+    qint32 value;
+    quint32 reserved;
+};
+
+namespace {
+
+constexpr quint32 STORE_MAGIC = 0x54434145;  // "EACT"
+constexpr quint32 STORE_VERSION = 1;
+constexpr int MAX_NAME_LENGTH = 47;
+
+}
+
+qint64 ActivityStore::fileSize()
+{
+    static_assert(sizeof(FileHeader) == 64, "FileHeader layout changed");
+    static_assert(sizeof(NameSlot) == 96, "NameSlot layout changed");
+    static_assert(sizeof(Record) == 32, "Record layout changed");
+
+    return qint64(sizeof(FileHeader))
+        + qint64(NAME_CAPACITY) * sizeof(NameSlot)
+        + qint64(RECORD_CAPACITY) * sizeof(Record);
+}
+
+// Names are keyed in memory exactly as the table stores them, so a name
+// longer than a slot still maps to its own id after a restart
+QString ActivityStore::storedName(const QString& name)
+{
+    return name.left(MAX_NAME_LENGTH);
+}
+
+ActivityStore::ActivityStore() = default;
+
+ActivityStore::~ActivityStore()
+{
+    close();
+}
+
+ActivityStore::Batch::Batch(ActivityStore* store)
+    : m_store(store)
+{
+    if (m_store) {
+        QMutexLocker locker(&m_store->m_mutex);
+        ++m_store->m_batchDepth;
+    }
+}
+
+ActivityStore::Batch::~Batch()
+{
+    if (!m_store) {
+        return;
+    }
+
+    QMutexLocker locker(&m_store->m_mutex);
+    if (--m_store->m_batchDepth == 0 && !m_store->m_pending.empty()) {
+        std::vector<Record> pending;
+        pending.swap(m_store->m_pending);
+        m_store->mergeLocked(pending);
+    }
+}
+
+bool ActivityStore::open(const QString& filePath)
+{
+    QMutexLocker locker(&m_mutex);
+    closeLocked();
+
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::ReadWrite)) {
+        qCWarning(lcLog) << "ActivityStore: Cannot open" << filePath;
+        return false;
+    }
+
+    bool reset = m_file.size() != fileSize();
+    if (reset) {
+        if (m_file.size() > 0) {
+            qCWarning(lcLog) << "ActivityStore: Unexpected size, starting a new history in" << filePath;
+        }
+        if (!m_file.resize(0) || !m_file.resize(fileSize())) {
+            qCWarning(lcLog) << "ActivityStore: Cannot allocate" << filePath;
+            m_file.close();
+            return false;
+        }
+    }
+
+    m_data = m_file.map(0, fileSize());
+    if (!m_data) {
+        qCWarning(lcLog) << "ActivityStore: Cannot map" << filePath;
+        m_file.close();
+        return false;
+    }
+
+    m_header = reinterpret_cast<FileHeader*>(m_data);
+    m_names = reinterpret_cast<NameSlot*>(m_data + sizeof(FileHeader));
+    m_records = reinterpret_cast<Record*>(m_names + NAME_CAPACITY);
+
+    if (!reset && (m_header->magic != STORE_MAGIC || m_header->version != STORE_VERSION
+                   || m_header->recordSize != sizeof(Record) || m_header->recordCapacity != RECORD_CAPACITY
+                   || m_header->nameCapacity != NAME_CAPACITY || m_header->nameCount > NAME_CAPACITY)) {
+        qCWarning(lcLog) << "ActivityStore: Unknown format, starting a new history in" << filePath;
+        reset = true;
+    }
+
+    if (reset) {
+        std::memset(m_data, 0, size_t(fileSize()));
+        m_header->magic = STORE_MAGIC;
+        m_header->version = STORE_VERSION;
+        m_header->recordSize = sizeof(Record);
+        m_header->recordCapacity = RECORD_CAPACITY;
+        m_header->nameCapacity = NAME_CAPACITY;
+    }
+
+    m_nameIds.reserve(m_header->nameCount);
+    for (quint32 i = 0; i < m_header->nameCount; ++i) {
+        m_nameIds.insert(nameAt(quint16(i)), quint16(i));
+    }
+
+    qCDebug(lcLog) << "ActivityStore: Opened" << filePath << "with" << qMin<quint64>(m_header->writeSequence, RECORD_CAPACITY)
+             << "records and" << m_header->nameCount << "names";
+    return true;
+}
+
+void ActivityStore::close()
+{
+    QMutexLocker locker(&m_mutex);
+    closeLocked();
+}
+
+void ActivityStore::closeLocked()
+{
+    if (m_data) {
+        m_file.unmap(m_data);
+    }
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+
+    m_data = nullptr;
+    m_header = nullptr;
+    m_names = nullptr;
+    m_records = nullptr;
+    m_nameIds.clear();
+    m_nameTableFullLogged = false;
+    // Their name ids belong to the closed file
+    m_pending.clear();
+}
+
+bool ActivityStore::isOpen() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_header != nullptr;
+}
+
+QString ActivityStore::filePath() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_header ? m_file.fileName() : QString();
+}
+
+void ActivityStore::append(ActivityType type, const QString& characterName, const QString& subject, qint32 value, qint64 timestamp)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_header) {
+        return;
+    }
+
+    Record record = {};
+    record.timestamp = timestamp;
+    record.type = quint16(type);
+    record.characterId = internName(characterName);
+    record.subjectId = subject.isEmpty() ? NO_NAME : internName(subject);
+    record.value = value;
+
+    if (m_batchDepth > 0) {
+        m_pending.push_back(record);
+        return;
+    }
+
+    std::vector<Record> incoming(1, record);
+    mergeLocked(incoming);
+}
+
+void ActivityStore::mergeLocked(std::vector<Record>& incoming)
+{
+    const quint64 end = m_header->writeSequence;
+    const quint64 begin = end > RECORD_CAPACITY ? end - RECORD_CAPACITY : 0;
+
+    // Older than anything a full ring still holds
+    if (end - begin == RECORD_CAPACITY) {
+        const qint64 oldest = recordAt(begin).timestamp;
+        incoming.erase(std::remove_if(incoming.begin(), incoming.end(),
+            [oldest](const Record& record) { return record.timestamp < oldest; }), incoming.end());
+    }
+    if (incoming.empty()) {
+        return;
+    }
+
+    std::stable_sort(incoming.begin(), incoming.end(), [](const Record& a, const Record& b) {
+        return a.timestamp < b.timestamp;
+    });
+
+    // Only the records from the earliest incoming time on are rewritten, for
+    // live lines that is just the last second of the ring
+    const quint64 start = firstSequenceAtOrAfter(incoming.front().timestamp - DUPLICATE_WINDOW_MS);
+    std::vector<Record> tail;
+    tail.reserve(size_t(end - start));
+    for (quint64 sequence = start; sequence < end; ++sequence) {
+        tail.push_back(recordAt(sequence));
+    }
+
+    std::vector<Record> merged;
+    merged.reserve(tail.size() + incoming.size());
+    size_t tailIndex = 0;
+    for (const Record& record : incoming) {
+        // Stored records go first at equal times, so replays keep their place
+        while (tailIndex < tail.size() && tail[tailIndex].timestamp <= record.timestamp) {
+            merged.push_back(tail[tailIndex++]);
+        }
+        if (!isDuplicate(record, merged, tail, tailIndex)) {
+            merged.push_back(record);
+        }
+    }
+    if (merged.size() == size_t(tailIndex)) {
+        return;
+    }
+    merged.insert(merged.end(), tail.begin() + qsizetype(tailIndex), tail.end());
+
+    // Records that the ring would overwrite straight away are not written
+    const quint64 newEnd = start + merged.size();
+    const quint64 firstKept = qMax(start, newEnd > RECORD_CAPACITY ? newEnd - RECORD_CAPACITY : quint64(0));
+    for (quint64 sequence = firstKept; sequence < newEnd; ++sequence) {
+        Record& slot = m_records[sequence % RECORD_CAPACITY];
+        slot = merged[size_t(sequence - start)];
+        slot.sequence = sequence;
+    }
+    m_header->writeSequence = newEnd;
+}
+
+bool ActivityStore::isDuplicate(const Record& record, const std::vector<Record>& merged, const std::vector<Record>& tail, size_t tailIndex) const
+{
+    auto sameActivity = [&record](const Record& other) {
+        return other.type == record.type && other.characterId == record.characterId && other.subjectId == record.subjectId;
+    };
+
+    // merged ends at or before record.timestamp, the rest of tail after it
+    for (auto it = merged.crbegin(); it != merged.crend() && it->timestamp > record.timestamp - DUPLICATE_WINDOW_MS; ++it) {
+        if (sameActivity(*it)) {
+            return true;
+        }
+    }
+    for (size_t i = tailIndex; i < tail.size() && tail[i].timestamp < record.timestamp + DUPLICATE_WINDOW_MS; ++i) {
+        if (sameActivity(tail[i])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+quint16 ActivityStore::internName(const QString& fullName)
+{
+    const QString name = storedName(fullName);
+    auto it = m_nameIds.constFind(name);
+    if (it != m_nameIds.constEnd()) {
+        return it.value();
+    }
+
+    if (m_header->nameCount >= NAME_CAPACITY) {
+        if (!m_nameTableFullLogged) {
+            qCWarning(lcLog) << "ActivityStore: Name table is full, new names are stored as unknown";
+            m_nameTableFullLogged = true;
+        }
+        return NO_NAME;
+    }
+
+    const quint16 id = quint16(m_header->nameCount);
+    NameSlot& slot = m_names[id];
+    const int length = int(name.size());
+    std::memcpy(slot.chars, name.utf16(), size_t(length) * sizeof(char16_t));
+    slot.length = quint16(length);
+    m_header->nameCount = id + 1;
+
+    m_nameIds.insert(name, id);
+    return id;
+}
+
+QString ActivityStore::nameAt(quint16 id) const
+{
+    if (id == NO_NAME || id >= m_header->nameCount) {
+        return QString();
+    }
+    const NameSlot& slot = m_names[id];
+    return QString::fromUtf16(slot.chars, qMin<int>(slot.length, MAX_NAME_LENGTH));
+}
+
+const ActivityStore::Record& ActivityStore::recordAt(quint64 sequence) const
+{
+    return m_records[sequence % RECORD_CAPACITY];
+}
+
+quint64 ActivityStore::firstSequenceAtOrAfter(qint64 timestamp) const
+{
+    const quint64 end = m_header->writeSequence;
+    quint64 low = end > RECORD_CAPACITY ? end - RECORD_CAPACITY : 0;
+    quint64 high = end;
+    while (low < high) {
+        const quint64 mid = low + (high - low) / 2;
+        if (recordAt(mid).timestamp < timestamp) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+ActivityEntry ActivityStore::toEntry(const Record& record) const
+{
+    ActivityEntry entry;
+    entry.timestamp = record.timestamp;
+    entry.type = ActivityType(record.type);
+    entry.characterName = nameAt(record.characterId);
+    entry.subject = nameAt(record.subjectId);
+    entry.value = record.value;
+    return entry;
+}
+
+QVector<ActivityEntry> ActivityStore::query(const QString& characterName, qint64 fromMs, qint64 toMs) const
+{
+    QVector<ActivityEntry> result;
+
+    QMutexLocker locker(&m_mutex);
+    if (!m_header) {
+        return result;
+    }
+
+    int characterId = -1;
+    if (!characterName.isEmpty()) {
+        auto it = m_nameIds.constFind(storedName(characterName));
+        if (it == m_nameIds.constEnd()) {
+            return result;
+        }
+        characterId = it.value();
+    }
+
+    const quint64 end = m_header->writeSequence;
+    for (quint64 sequence = firstSequenceAtOrAfter(fromMs); sequence < end; ++sequence) {
+        const Record& record = recordAt(sequence);
+        if (record.timestamp > toMs) {
+            break;
+        }
+        if (characterId >= 0 && record.characterId != characterId) {
+            continue;
+        }
+        result.append(toEntry(record));
+    }
+    return result;
+}
+
+QHash<QString, ActivityLocation> ActivityStore::lastKnownSystems(qint64 sinceMs) const
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_header) {
+        return QHash<QString, ActivityLocation>();
+    }
+
+    QHash<quint16, quint64> visitByCharacter;
+    const quint64 end = m_header->writeSequence;
+    for (quint64 sequence = firstSequenceAtOrAfter(sinceMs); sequence < end; ++sequence) {
+        const Record& record = recordAt(sequence);
+        if (record.type == quint16(ActivityType::SystemVisit) && record.characterId != NO_NAME && record.subjectId != NO_NAME) {
+            visitByCharacter.insert(record.characterId, sequence);
+        }
+    }
+
+    QHash<QString, ActivityLocation> result;
+    result.reserve(visitByCharacter.size());
+    for (auto it = visitByCharacter.constBegin(); it != visitByCharacter.constEnd(); ++it) {
+        const Record& record = recordAt(it.value());
+        result.insert(nameAt(it.key()), ActivityLocation{nameAt(record.subjectId), record.timestamp});
+    }
+    return result;
+}
+
+QString ActivityStore::storePathForProfile(const QString& profileName)
+{
+    return QCoreApplication::applicationDirPath() + "/activity/" + profileName + ".act";
+}
@@ -0,0 +1,71 @@
+#include "boundedcache.h"
+#include <QMutex>
+#include <QMutexLocker>
+#include <QVector>
+#include <algorithm>
+
+namespace {
+
+std::atomic<int> s_defaultCapacity{0};
+
+QMutex& registryMutex()
+{
+    static QMutex mutex;
+    return mutex;
+}
+
+QVector<const BoundedCacheBase*>& registry()
+{
+    static QVector<const BoundedCacheBase*> caches;
+    return caches;
+}
+
+}
+
+BoundedCacheBase::BoundedCacheBase(const char* name, int capacity, qsizetype entryBytes)
+    : m_name(name)
+    , m_entryBytes(entryBytes)
+    , m_capacity(capacity)
+{
+    QMutexLocker locker(&registryMutex());
+    registry().append(this);
+}
+
+BoundedCacheBase::~BoundedCacheBase()
+{
+    QMutexLocker locker(&registryMutex());
+    registry().removeOne(this);
+}
+
+int BoundedCacheBase::defaultCapacity()
+{
+    int capacity = s_defaultCapacity.load(std::memory_order_relaxed);
+    return capacity > 0 ? capacity : DEFAULT_CAPACITY;
+}
+
+void BoundedCacheBase::setDefaultCapacity(int capacity)
+{
+    s_defaultCapacity.store(std::max(capacity, 0), std::memory_order_relaxed);
+}
+
+QStringList BoundedCacheBase::memoryReport()
+{
+    QStringList lines;
+    qsizetype totalBytes = 0;
+
+    QMutexLocker locker(&registryMutex());
+    for (const BoundedCacheBase* cache : registry()) {
+        qsizetype entries = cache->m_entryCount.load(std::memory_order_relaxed);
+        qsizetype bytes = entries * cache->m_entryBytes + cache->m_payloadBytes.load(std::memory_order_relaxed);
+        totalBytes += bytes;
+        lines.append(QString("%1: %2/%3 entries, ~%4 KB, %5 evicted")
+                         .arg(cache->m_name)
+                         .arg(entries)
+                         .arg(cache->effectiveCapacity())
+                         .arg(bytes / 1024.0, 0, 'f', 1)
+                         .arg(cache->m_evictions.load(std::memory_order_relaxed)));
+    }
+
+    lines.append(QString("Total: ~%1 KB in %2 caches").arg(totalBytes / 1024.0, 0, 'f', 1).arg(registry().size()));
+    return lines;
+}
@@ -0,0 +1,61 @@
+#include "characterregistry.h"
+
+CharacterRegistry& CharacterRegistry::instance()
+{
+    static CharacterRegistry instance;
+    return instance;
+}
+
+CharacterId CharacterRegistry::intern(const QString& characterName)
+{
+    if (characterName.isEmpty()) {
+        return INVALID_ID;
+    }
+
+    {
+        QReadLocker locker(&m_lock);
+        auto it = m_exactIds.constFind(characterName);
+        if (it != m_exactIds.constEnd()) {
+            return it.value();
+        }
+    }
+
+    QWriteLocker locker(&m_lock);
+    auto exact = m_exactIds.constFind(characterName);
+    if (exact != m_exactIds.constEnd()) {
+        return exact.value();
+    }
+
+    QString folded = characterName.toCaseFolded();
+    CharacterId id = m_foldedIds.value(folded, INVALID_ID);
+    if (id == INVALID_ID) {
+        m_names.append(characterName);
+        id = static_cast<CharacterId>(m_names.size());
+        m_foldedIds.insert(folded, id);
+    }
+    m_exactIds.insert(characterName, id);
+    return id;
+}
+
+CharacterId CharacterRegistry::find(const QString& characterName) const
+{
+    if (characterName.isEmpty()) {
+        return INVALID_ID;
+    }
+
+    QReadLocker locker(&m_lock);
+    auto it = m_exactIds.constFind(characterName);
+    if (it != m_exactIds.constEnd()) {
+        return it.value();
+    }
+    return m_foldedIds.value(characterName.toCaseFolded(), INVALID_ID);
+}
+
+QString CharacterRegistry::name(CharacterId id) const
+{
+    QReadLocker locker(&m_lock);
+    if (id == INVALID_ID || id > static_cast<CharacterId>(m_names.size())) {
+        return QString();
+    }
+    return m_names.at(static_cast<int>(id - 1));
+}
@@ -1,10 +1,13 @@
 #include "chatlogreader.h"
 #include "config.h"
+#include "starmap.h"
+#include "logging.h"
 #include <QFile>
 #include <QTextStream>
 #include <QDir>
 #include <QRegularExpression>
 #include <QDateTime>
+#include <QTimeZone>
 #include <QElapsedTimer>
 #include <QDebug>
 #include <QStandardPaths>
@@ -26,6 +29,30 @@ ChatLogWorker::ChatLogWorker(QObject *parent)
     
     connect(m_scanTimer, &QTimer::timeout, this, &ChatLogWorker::checkForNewFiles);
     m_scanTimer->setInterval(300000);
+    
+    // Every detected event is also kept in the activity history, stamped with
+    // the time of the log line that raised it
+    connect(this, &ChatLogWorker::combatEventDetected, this,
+        [this](const QString& characterName, const QString& eventType, const QString&) {
+            if (m_activityStore) {
+                qint64 timestamp = m_lineTimestamp > 0 ? m_lineTimestamp : QDateTime::currentMSecsSinceEpoch();
+                m_activityStore->append(ActivityType::Event, characterName, eventType, 0, timestamp);
+            }
+        });
+}
+
+// "[ 2024.01.31 12:34:56 ] ..." in UTC as ms since epoch, or 0 without a timestamp
+static qint64 logLineTime(const QString &line)
+{
+    static const QRegularExpression timestampPattern(R"(^\[\s*(\d{4}\.\d{2}\.\d{2} \d{2}:\d{2}:\d{2})\s*\])");
+
+    QRegularExpressionMatch match = timestampPattern.match(line);
+    if (!match.hasMatch()) {
+        return 0;
+    }
+    QDateTime dt = QDateTime::fromString(match.captured(1), "yyyy.MM.dd HH:mm:ss");
+    dt.setTimeZone(QTimeZone::UTC);
+    return dt.isValid() ? dt.toMSecsSinceEpoch() : 0;
 }
 
 static QString normalizeLogLine(const QString &line)
@@ -84,6 +111,24 @@ void ChatLogWorker::setEnableGameLogMonitoring(bool enabled)
     m_enableGameLogMonitoring = enabled;
 }
 
+void ChatLogWorker::setActivityStore(ActivityStore* store)
+{
+    QMutexLocker locker(&m_mutex);
+    m_activityStore = store;
+}
+
+void ChatLogWorker::setIntelChannels(const QStringList& channels)
+{
+    QMutexLocker locker(&m_mutex);
+    m_intelChannels.clear();
+    for (const QString& channel : channels) {
+        QString trimmed = channel.trimmed();
+        if (!trimmed.isEmpty() && !m_intelChannels.contains(trimmed.toLower())) {
+            m_intelChannels.insert(trimmed.toLower(), trimmed);
+        }
+    }
+}
+
 void ChatLogWorker::refreshMonitoring()
 {
     QMutexLocker locker(&m_mutex);
@@ -92,19 +137,19 @@ void ChatLogWorker::refreshMonitoring()
         return;  // Not monitoring, nothing to refresh
     }
     
-    qDebug() << "ChatLogWorker: Refreshing monitoring with updated settings (ChatLog:" << m_enableChatLogMonitoring << ", GameLog:" << m_enableGameLogMonitoring << ")";
+    qCDebug(lcLog) << "ChatLogWorker: Refreshing monitoring with updated settings (ChatLog:" << m_enableChatLogMonitoring << ", GameLog:" << m_enableGameLogMonitoring << ")";
     
     // Add or remove directory watchers based on current settings
     if (m_enableChatLogMonitoring) {
         QDir logDir(m_logDirectory);
         if (logDir.exists() && !m_fileWatcher->directories().contains(m_logDirectory)) {
             m_fileWatcher->addPath(m_logDirectory);
-            qDebug() << "ChatLogWorker: Now watching Chatlogs directory:" << m_logDirectory;
+            qCDebug(lcLog) << "ChatLogWorker: Now watching Chatlogs directory:" << m_logDirectory;
         }
     } else {
         if (m_fileWatcher->directories().contains(m_logDirectory)) {
             m_fileWatcher->removePath(m_logDirectory);
-            qDebug() << "ChatLogWorker: Stopped watching Chatlogs directory:" << m_logDirectory;
+            qCDebug(lcLog) << "ChatLogWorker: Stopped watching Chatlogs directory:" << m_logDirectory;
         }
     }
     
@@ -112,19 +157,19 @@ void ChatLogWorker::refreshMonitoring()
         QDir gameLogDir(m_gameLogDirectory);
         if (gameLogDir.exists() && !m_fileWatcher->directories().contains(m_gameLogDirectory)) {
             m_fileWatcher->addPath(m_gameLogDirectory);
-            qDebug() << "ChatLogWorker: Now watching Gamelogs directory:" << m_gameLogDirectory;
+            qCDebug(lcLog) << "ChatLogWorker: Now watching Gamelogs directory:" << m_gameLogDirectory;
         }
     } else {
         if (m_fileWatcher->directories().contains(m_gameLogDirectory)) {
             m_fileWatcher->removePath(m_gameLogDirectory);
-            qDebug() << "ChatLogWorker: Stopped watching Gamelogs directory:" << m_gameLogDirectory;
+            qCDebug(lcLog) << "ChatLogWorker: Stopped watching Gamelogs directory:" << m_gameLogDirectory;
         }
     }
     
     // Rescan logs with updated settings
     scanExistingLogs();
     
-    qDebug() << "ChatLogWorker: Monitoring refresh completed";
+    qCDebug(lcLog) << "ChatLogWorker: Monitoring refresh completed";
 }
 
 void ChatLogWorker::startMonitoring()
@@ -137,17 +182,28 @@ void ChatLogWorker::startMonitoring()
     
     m_running = true;
     
-    qDebug() << "ChatLogWorker: Starting monitoring (ChatLog:" << m_enableChatLogMonitoring << ", GameLog:" << m_enableGameLogMonitoring << ")";
+    // Seed from the activity history so unchanged systems are not re-recorded
+    if (m_activityStore) {
+        qint64 since = QDateTime::currentMSecsSinceEpoch() - 24 * 60 * 60 * 1000;
+        QHash<QString, ActivityLocation> systems = m_activityStore->lastKnownSystems(since);
+        for (auto it = systems.constBegin(); it != systems.constEnd(); ++it) {
+            if (!m_characterLocations.contains(it.key())) {
+                m_characterLocations.insert(it.key(), CharacterLocation(it.key(), it->systemName, it->timestamp));
+            }
+        }
+    }
+    
+    qCDebug(lcLog) << "ChatLogWorker: Starting monitoring (ChatLog:" << m_enableChatLogMonitoring << ", GameLog:" << m_enableGameLogMonitoring << ")";
     
     if (m_enableChatLogMonitoring) {
         QDir logDir(m_logDirectory);
         if (logDir.exists()) {
             if (!m_fileWatcher->directories().contains(m_logDirectory)) {
                 m_fileWatcher->addPath(m_logDirectory);
-                qDebug() << "ChatLogWorker: Watching Chatlogs directory:" << m_logDirectory;
+                qCDebug(lcLog) << "ChatLogWorker: Watching Chatlogs directory:" << m_logDirectory;
             }
         } else {
-            qWarning() << "ChatLogWorker: Chatlogs directory does not exist:" << m_logDirectory;
+            qCWarning(lcLog) << "ChatLogWorker: Chatlogs directory does not exist:" << m_logDirectory;
         }
     }
     
@@ -156,10 +212,10 @@ void ChatLogWorker::startMonitoring()
         if (gameLogDir.exists()) {
             if (!m_fileWatcher->directories().contains(m_gameLogDirectory)) {
                 m_fileWatcher->addPath(m_gameLogDirectory);
-                qDebug() << "ChatLogWorker: Watching Gamelogs directory:" << m_gameLogDirectory;
+                qCDebug(lcLog) << "ChatLogWorker: Watching Gamelogs directory:" << m_gameLogDirectory;
             }
         } else {
-            qWarning() << "ChatLogWorker: Gamelogs directory does not exist:" << m_gameLogDirectory;
+            qCWarning(lcLog) << "ChatLogWorker: Gamelogs directory does not exist:" << m_gameLogDirectory;
         }
     }
     
@@ -172,7 +228,7 @@ void ChatLogWorker::startMonitoring()
     m_aggregateTimer->setInterval(200);
     connect(m_aggregateTimer, &QTimer::timeout, this, &ChatLogWorker::processPendingFiles);
     
-    qDebug() << "ChatLogWorker: Monitoring started for" << m_characterNames.size() << "characters";
+    qCDebug(lcLog) << "ChatLogWorker: Monitoring started for" << m_characterNames.size() << "characters";
 }
 
 void ChatLogWorker::stopMonitoring()
@@ -208,7 +264,7 @@ void ChatLogWorker::stopMonitoring()
     }
     m_fileTimers.clear();
     
-    qDebug() << "ChatLogWorker: Monitoring stopped";
+    qCDebug(lcLog) << "ChatLogWorker: Monitoring stopped";
 }
 
 void ChatLogWorker::scanExistingLogs()
@@ -216,6 +272,9 @@ void ChatLogWorker::scanExistingLogs()
     QElapsedTimer totalTimer;
     totalTimer.start();
     
+    // The characters' last system lines arrive in no particular time order
+    ActivityStore::Batch activityBatch(m_activityStore);
+    
     QHash<QString, QString> chatListenerMap = m_cachedChatListenerMap;
     QHash<QString, QString> gameListenerMap = m_cachedGameListenerMap;
     
@@ -234,9 +293,9 @@ void ChatLogWorker::scanExistingLogs()
                 chatListenerMap = buildListenerToFileMap(d, filters, 24);
                 m_cachedChatListenerMap = chatListenerMap; 
                 m_lastChatDirScanTime = dirLastMod;
-                qDebug() << "ChatLogWorker: chatListenerMap build took" << chatMapTimer.elapsed() << "ms (files:" << chatListenerMap.count() << ")";
+                qCDebug(lcLog) << "ChatLogWorker: chatListenerMap build took" << chatMapTimer.elapsed() << "ms (files:" << chatListenerMap.count() << ")";
             } else {
-                qDebug() << "ChatLogWorker: chat directory unchanged since last scan (using cached map with" << chatListenerMap.count() << "entries)";
+                qCDebug(lcLog) << "ChatLogWorker: chat directory unchanged since last scan (using cached map with" << chatListenerMap.count() << "entries)";
             }
         }
     }
@@ -255,9 +314,9 @@ void ChatLogWorker::scanExistingLogs()
                 gameListenerMap = buildListenerToFileMap(gd, filters, 24);
                 m_cachedGameListenerMap = gameListenerMap; 
                 m_lastGameDirScanTime = dirLastMod;
-                qDebug() << "ChatLogWorker: gameListenerMap build took" << gameMapTimer.elapsed() << "ms (files:" << gameListenerMap.count() << ")";
+                qCDebug(lcLog) << "ChatLogWorker: gameListenerMap build took" << gameMapTimer.elapsed() << "ms (files:" << gameListenerMap.count() << ")";
             } else {
-                qDebug() << "ChatLogWorker: gamelog directory unchanged since last scan (using cached map with" << gameListenerMap.count() << "entries)";
+                qCDebug(lcLog) << "ChatLogWorker: gamelog directory unchanged since last scan (using cached map with" << gameListenerMap.count() << "entries)";
             }
         }
     }
@@ -285,7 +344,7 @@ void ChatLogWorker::scanExistingLogs()
                     m_fileToKeyMap[chatLogFile] = key;
                     m_fileWatcher->addPath(chatLogFile);
                     
-                    qDebug() << "ChatLogWorker: Monitoring CHATLOG for" << characterName << ":" << chatLogFile;
+                    qCDebug(lcLog) << "ChatLogWorker: Monitoring CHATLOG for" << characterName << ":" << chatLogFile;
                     
                     QFile file(chatLogFile);
                     if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
@@ -302,7 +361,7 @@ void ChatLogWorker::scanExistingLogs()
                         QFileInfo fi(chatLogFile);
                         const qint64 fallbackSize = 5 * 1024 * 1024; 
                         if (lastSystemLine.isEmpty() && fi.size() <= fallbackSize) {
-                            qDebug() << "ChatLogWorker: tail scan found nothing, falling back to full scan for" << chatLogFile;
+                            qCDebug(lcLog) << "ChatLogWorker: tail scan found nothing, falling back to full scan for" << chatLogFile;
                             file.seek(0);
                             QTextStream inFull(&file);
                             inFull.setAutoDetectUnicode(true);
@@ -319,7 +378,7 @@ void ChatLogWorker::scanExistingLogs()
                                 }
                             }
                             if (lastSystemLine.isEmpty() && !firstNonEmptyLine.isEmpty()) {
-                                qDebug() << "ChatLogWorker: fallback full scan found nothing either. First non-empty line:" << firstNonEmptyLine;
+                                qCDebug(lcLog) << "ChatLogWorker: fallback full scan found nothing either. First non-empty line:" << firstNonEmptyLine;
                             }
                         }
 
@@ -360,7 +419,7 @@ void ChatLogWorker::scanExistingLogs()
                     m_fileToKeyMap[gameLogFile] = key;
                     m_fileWatcher->addPath(gameLogFile);
                     
-                    qDebug() << "ChatLogWorker: Monitoring GAMELOG for" << characterName << ":" << gameLogFile;
+                    qCDebug(lcLog) << "ChatLogWorker: Monitoring GAMELOG for" << characterName << ":" << gameLogFile;
                     
                     QFile file(gameLogFile);
                     if (file.open(QIODevice::ReadOnly)) {
@@ -379,7 +438,9 @@ void ChatLogWorker::scanExistingLogs()
         }
     }
     
-    qDebug() << "ChatLogWorker: File watcher now watching" << m_fileWatcher->files().count() << "files";
+    scanIntelChannels();
+    
+    qCDebug(lcLog) << "ChatLogWorker: File watcher now watching" << m_fileWatcher->files().count() << "files";
     
     QSet<QString> newFiles;
     for (auto it = m_characterToLogFile.constBegin(); it != m_characterToLogFile.constEnd(); ++it) {
@@ -390,7 +451,7 @@ void ChatLogWorker::scanExistingLogs()
     for (const QString& w : watchedFiles) {
         if (!newFiles.contains(w)) {
             if (!watchedDirs.contains(w)) {
-                qDebug() << "ChatLogWorker: Removing stale file watcher:" << w;
+                qCDebug(lcLog) << "ChatLogWorker: Removing stale file watcher:" << w;
                 m_fileWatcher->removePath(w);
                 m_fileToKeyMap.remove(w);
                 m_filePositions.remove(w);
@@ -405,7 +466,92 @@ void ChatLogWorker::scanExistingLogs()
             }
         }
     }
-    qDebug() << "ChatLogWorker: scanExistingLogs total took" << totalTimer.elapsed() << "ms";
+    qCDebug(lcLog) << "ChatLogWorker: scanExistingLogs total took" << totalTimer.elapsed() << "ms";
+}
+
+void ChatLogWorker::scanIntelChannels()
+{
+    // Drop channels that were removed from the settings or are no longer monitored
+    for (auto it = m_characterToLogFile.begin(); it != m_characterToLogFile.end();) {
+        QString key = it.key();
+        if (key.endsWith("_intel")) {
+            QString channel = key.left(key.length() - 6);
+            if (!m_enableChatLogMonitoring || !m_intelChannels.contains(channel)) {
+                m_fileToKeyMap.remove(it.value());
+                it = m_characterToLogFile.erase(it);
+                continue;
+            }
+        }
+        ++it;
+    }
+    
+    if (!m_enableChatLogMonitoring || m_intelChannels.isEmpty()) {
+        return;
+    }
+    
+    QDir chatLogDir(m_logDirectory);
+    if (!chatLogDir.exists()) {
+        return;
+    }
+    
+    // Every listener writes its own copy of a channel log, only the newest one is tailed
+    for (auto it = m_intelChannels.constBegin(); it != m_intelChannels.constEnd(); ++it) {
+        const QString& channel = it.value();
+        QString intelFile = findIntelLogFile(chatLogDir, channel);
+        if (intelFile.isEmpty()) {
+            continue;
+        }
+        
+        QString key = it.key() + "_intel";
+        QString currentFile = m_characterToLogFile.value(key);
+        if (currentFile == intelFile) {
+            continue;
+        }
+        
+        if (!currentFile.isEmpty() && m_fileWatcher->files().contains(currentFile)) {
+            m_fileWatcher->removePath(currentFile);
+            m_fileToKeyMap.remove(currentFile);
+        }
+        
+        m_characterToLogFile[key] = intelFile;
+        m_fileToKeyMap[intelFile] = key;
+        m_fileWatcher->addPath(intelFile);
+        
+        // Only new reports matter, start tailing from the current end of the file
+        QFileInfo fi(intelFile);
+        m_filePositions[intelFile] = fi.size();
+        m_fileLastSize[intelFile] = fi.size();
+        m_fileLastModified[intelFile] = fi.lastModified().toMSecsSinceEpoch();
+        
+        qCDebug(lcLog) << "ChatLogWorker: Monitoring INTEL channel" << channel << ":" << intelFile;
+    }
+}
+
+QString ChatLogWorker::findIntelLogFile(const QDir& dir, const QString& channel)
+{
+    QStringList filters;
+    filters << channel + "_*.txt";
+    
+    // The glob also catches longer channel names sharing the prefix, the date
+    // suffix pins it to this channel: <channel>_YYYYMMDD_HHMMSS[_listenerId].txt
+    QRegularExpression fileNamePattern(
+        "^" + QRegularExpression::escape(channel) + R"(_\d{8}_\d{6}(_\d+)?\.txt$)",
+        QRegularExpression::CaseInsensitiveOption
+    );
+    
+    QFileInfoList channelFiles = dir.entryInfoList(filters, QDir::Files, QDir::Time);
+    for (const QFileInfo& fileInfo : channelFiles) {
+        if (!fileNamePattern.match(fileInfo.fileName()).hasMatch()) {
+            continue;
+        }
+        
+        qint64 hoursSinceModified = fileInfo.lastModified().secsTo(QDateTime::currentDateTime()) / 3600;
+        if (hoursSinceModified <= 24) {
+            return fileInfo.absoluteFilePath();
+        }
+    }
+    
+    return QString();
 }
 
 void ChatLogWorker::checkForNewFiles()
@@ -560,18 +706,22 @@ QString ChatLogWorker::extractCharacterFromLogFile(const QString& filePath)
 
 void ChatLogWorker::processLogFile(const QString& filePath)
 {
-    qDebug() << "ChatLogWorker: processLogFile called for:" << filePath;
+    qCDebug(lcLog) << "ChatLogWorker: processLogFile called for:" << filePath;
     
     QMutexLocker locker(&m_mutex);
     
     if (!m_running) {
-        qDebug() << "ChatLogWorker: Not running, ignoring file change";
+        qCDebug(lcLog) << "ChatLogWorker: Not running, ignoring file change";
         return;
     }
     
     QString characterName;
     QString key = m_fileToKeyMap.value(filePath);
-    if (!key.isEmpty()) {
+    bool isIntel = key.endsWith("_intel");
+    if (isIntel) {
+        QString channelKey = key.left(key.length() - 6);
+        characterName = m_intelChannels.value(channelKey, channelKey);
+    } else if (!key.isEmpty()) {
         if (key.endsWith("_chatlog")) {
             characterName = key.left(key.length() - 8);
         } else if (key.endsWith("_gamelog")) {
@@ -596,16 +746,16 @@ void ChatLogWorker::processLogFile(const QString& filePath)
     }
     
     if (characterName.isEmpty()) {
-        qDebug() << "ChatLogWorker: Could not find character for log file:" << filePath;
+        qCDebug(lcLog) << "ChatLogWorker: Could not find character for log file:" << filePath;
         return;
     }
     
-    qDebug() << "ChatLogWorker: Processing log for character:" << characterName;
-    qDebug() << "ChatLogWorker: File path:" << filePath;
+    qCDebug(lcLog) << "ChatLogWorker: Processing log for character:" << characterName;
+    qCDebug(lcLog) << "ChatLogWorker: File path:" << filePath;
     
     QFile file(filePath);
     if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        qWarning() << "ChatLogWorker: Failed to open log file:" << filePath;
+        qCWarning(lcLog) << "ChatLogWorker: Failed to open log file:" << filePath;
         
         m_fileWatcher->removePath(filePath);
         m_characterToLogFile.remove(characterName);
@@ -615,7 +765,7 @@ void ChatLogWorker::processLogFile(const QString& filePath)
     
     qint64 lastPos = m_filePositions.value(filePath, 0);
     qint64 fileSize = file.size();
-    qDebug() << "ChatLogWorker: File size:" << fileSize << ", Last position:" << lastPos;
+    qCDebug(lcLog) << "ChatLogWorker: File size:" << fileSize << ", Last position:" << lastPos;
     
     if (lastPos > 0 && fileSize >= lastPos) {
         file.seek(lastPos);
@@ -626,14 +776,20 @@ void ChatLogWorker::processLogFile(const QString& filePath)
     QTextStream in(&file);
     in.setAutoDetectUnicode(true);
     
+    // Reading from the start replays old lines into the activity history
+    ActivityStore::Batch activityBatch(m_activityStore);
     int linesRead = 0;
     while (!in.atEnd()) {
         QString line = in.readLine();
         linesRead++;
-        parseLogLine(line, characterName);
+        if (isIntel) {
+            parseIntelLine(line, characterName);
+        } else {
+            parseLogLine(line, characterName);
+        }
     }
     
-    qDebug() << "ChatLogWorker: Read" << linesRead << "new lines from log";
+    qCDebug(lcLog) << "ChatLogWorker: Read" << linesRead << "new lines from log";
     
     m_filePositions[filePath] = file.pos();
     file.close();
@@ -645,7 +801,7 @@ void ChatLogWorker::markFileDirty(const QString& filePath)
     
     QFileInfo fi(filePath);
     if (!fi.exists()) {
-        qDebug() << "ChatLogWorker: markFileDirty called for non-existent file:" << filePath;
+        qCDebug(lcLog) << "ChatLogWorker: markFileDirty called for non-existent file:" << filePath;
         return;
     }
     
@@ -662,7 +818,7 @@ void ChatLogWorker::markFileDirty(const QString& filePath)
     m_fileLastModified[filePath] = currentModified;
     
     m_fileDirty.insert(filePath);
-    qDebug() << "ChatLogWorker: markFileDirty for" << filePath << "(dirtyCount=" << m_fileDirty.size() 
+    qCDebug(lcLog) << "ChatLogWorker: markFileDirty for" << filePath << "(dirtyCount=" << m_fileDirty.size() 
              << "size:" << lastSize << "->" << currentSize << ")";
     if (m_aggregateTimer) {
         m_aggregateTimer->start();
@@ -753,11 +909,14 @@ void ChatLogWorker::processPendingFiles()
 void ChatLogWorker::parseLogLine(const QString& line, const QString& characterName)
 {
     QString normalizedLine = normalizeLogLine(line);
+    m_lineTimestamp = logLineTime(normalizedLine);
     
-    if (normalizedLine.contains("mining", Qt::CaseInsensitive) || 
-        normalizedLine.contains("fleet", Qt::CaseInsensitive) ||
-        normalizedLine.contains("question", Qt::CaseInsensitive)) {
-        qDebug() << "ChatLogWorker: Parsing line for" << characterName << ":" << normalizedLine;
+    // Checked first so the keyword scans are skipped when tracing is off
+    if (lcLog().isDebugEnabled() &&
+        (normalizedLine.contains("mining", Qt::CaseInsensitive) ||
+         normalizedLine.contains("fleet", Qt::CaseInsensitive) ||
+         normalizedLine.contains("question", Qt::CaseInsensitive))) {
+        qCDebug(lcLog) << "ChatLogWorker: Parsing line for" << characterName << ":" << normalizedLine;
     }
     
     static QRegularExpression systemChangePattern(
@@ -772,11 +931,7 @@ void ChatLogWorker::parseLogLine(const QString& line, const QString& characterNa
 
         QString newSystem = sanitizeSystemName(rawSystem);
 
-        QDateTime dt = QDateTime::fromString(timestampStr, "yyyy.MM.dd HH:mm:ss");
-        qint64 updateTime = QDateTime::currentMSecsSinceEpoch();
-        if (dt.isValid()) {
-            updateTime = dt.toMSecsSinceEpoch();
-        }
+        qint64 updateTime = m_lineTimestamp > 0 ? m_lineTimestamp : QDateTime::currentMSecsSinceEpoch();
 
         CharacterLocation& location = m_characterLocations[characterName];
         if (location.systemName != newSystem) {
@@ -784,8 +939,12 @@ void ChatLogWorker::parseLogLine(const QString& line, const QString& characterNa
             location.systemName = newSystem;
             location.lastUpdate = updateTime;
 
-            qDebug() << "ChatLogWorker: System change detected:" << characterName << "->" << newSystem << "(from" << timestampStr << ")";
+            qCDebug(lcLog) << "ChatLogWorker: System change detected:" << characterName << "->" << newSystem << "(from" << timestampStr << ")";
             emit systemChanged(characterName, newSystem);
+            
+            if (m_activityStore) {
+                m_activityStore->append(ActivityType::SystemVisit, characterName, newSystem, 0, updateTime);
+            }
         }
     }
     
@@ -797,7 +956,7 @@ void ChatLogWorker::parseLogLine(const QString& line, const QString& characterNa
     if (fleetMatch.hasMatch()) {
         QString inviter = fleetMatch.captured(1).trimmed();
         QString eventText = QString("Fleet invite from %1").arg(inviter);
-        qDebug() << "ChatLogWorker: Fleet invite detected for" << characterName << "from" << inviter;
+        qCDebug(lcLog) << "ChatLogWorker: Fleet invite detected for" << characterName << "from" << inviter;
         emit combatEventDetected(characterName, "fleet_invite", eventText);
     }
     
@@ -810,7 +969,7 @@ void ChatLogWorker::parseLogLine(const QString& line, const QString& characterNa
     if (followMatch.hasMatch()) {
         QString leader = followMatch.captured(1).trimmed();
         QString eventText = QString("Following %1").arg(leader);
-        qDebug() << "ChatLogWorker: Follow warp detected for" << characterName << "->" << leader;
+        qCDebug(lcLog) << "ChatLogWorker: Follow warp detected for" << characterName << "->" << leader;
         emit combatEventDetected(characterName, "follow_warp", eventText);
     }
     
@@ -823,7 +982,7 @@ void ChatLogWorker::parseLogLine(const QString& line, const QString& characterNa
     if (regroupMatch.hasMatch()) {
         QString leader = regroupMatch.captured(1).trimmed();
         QString eventText = QString("Regrouping to %1").arg(leader);
-        qDebug() << "ChatLogWorker: Regroup detected for" << characterName << "->" << leader;
+        qCDebug(lcLog) << "ChatLogWorker: Regroup detected for" << characterName << "->" << leader;
         emit combatEventDetected(characterName, "regroup", eventText);
     }
     
@@ -841,7 +1000,7 @@ void ChatLogWorker::parseLogLine(const QString& line, const QString& characterNa
             compressedItem.chop(1);
         }
         QString eventText = QString("Compressed: %1x %2").arg(count, compressedItem);
-        qDebug() << "ChatLogWorker: Compression detected for" << characterName << ":" << eventText;
+        qCDebug(lcLog) << "ChatLogWorker: Compression detected for" << characterName << ":" << eventText;
         emit combatEventDetected(characterName, "compression", eventText);
     }
     
@@ -851,16 +1010,79 @@ void ChatLogWorker::parseLogLine(const QString& line, const QString& characterNa
     
     QRegularExpressionMatch miningMatch = miningPattern.match(normalizedLine);
     if (miningMatch.hasMatch()) {
-        qDebug() << "ChatLogWorker: Mining event detected";
-        handleMiningEvent(characterName, "ore");
+        qCDebug(lcLog) << "ChatLogWorker: Mining event detected";
+        handleMiningEvent(characterName, "ore", m_lineTimestamp > 0 ? m_lineTimestamp : QDateTime::currentMSecsSinceEpoch());
+    }
+
+    m_lineTimestamp = 0;
+}
+
+void ChatLogWorker::parseIntelLine(const QString& line, const QString& channel)
+{
+    static QRegularExpression messagePattern(
+        R"(^\[\s*([\d.\s:]+)\]\s*(.+?)\s*>\s*(.*)$)",
+        QRegularExpression::UseUnicodePropertiesOption
+    );
+    
+    QString normalizedLine = normalizeLogLine(line);
+    QRegularExpressionMatch match = messagePattern.match(normalizedLine);
+    if (!match.hasMatch()) {
+        return;
+    }
+    
+    QString reporter = match.captured(2).trimmed();
+    if (reporter.compare("EVE System", Qt::CaseInsensitive) == 0) {
+        return;
+    }
+    
+    const StarMap& starMap = StarMap::instance();
+    if (!starMap.isLoaded()) {
+        static bool warned = false;
+        if (!warned) {
+            warned = true;
+            qCWarning(lcLog) << "ChatLogWorker: No star map bundled, intel reports can't be matched to systems";
+        }
+        return;
+    }
+    if (m_systemMatcher.isEmpty()) {
+        m_systemMatcher.build(starMap.systemNames());
+    }
+    
+    QString message = match.captured(3);
+    QVector<int> systems = m_systemMatcher.findAll(message);
+    if (systems.isEmpty()) {
+        return;
+    }
+    
+    QHash<QString, QString> characterSystems;
+    for (const auto& entry : m_characterLocations) {
+        if (!entry.second.systemName.isEmpty()) {
+            characterSystems.insert(entry.first, entry.second.systemName);
+        }
+    }
+    
+    QDateTime dt = QDateTime::fromString(match.captured(1).trimmed(), "yyyy.MM.dd HH:mm:ss");
+    qint64 timestamp = dt.isValid() ? dt.toMSecsSinceEpoch() : QDateTime::currentMSecsSinceEpoch();
+    
+    for (int systemIndex : systems) {
+        IntelReport report;
+        report.channel = channel;
+        report.reporter = reporter;
+        report.systemName = starMap.systemName(systemIndex);
+        report.message = message;
+        report.timestamp = timestamp;
+        report.jumpsByCharacter = starMap.distancesFrom(report.systemName, characterSystems);
+        
+        qCDebug(lcLog) << "ChatLogWorker: Intel in" << channel << "-" << report.systemName << "reported by" << reporter;
+        emit intelReported(report);
     }
 }
 
-void ChatLogWorker::handleMiningEvent(const QString& characterName, const QString& ore)
+void ChatLogWorker::handleMiningEvent(const QString& characterName, const QString& ore, qint64 timestamp)
 {
     int timeoutMs = Config::instance().miningTimeoutSeconds() * 1000;
     
-    qDebug() << "ChatLogWorker: Mining event detected for" << characterName << "- ore:" << ore << "- timeout:" << timeoutMs << "ms";
+    qCDebug(lcLog) << "ChatLogWorker: Mining event detected for" << characterName << "- ore:" << ore << "- timeout:" << timeoutMs << "ms";
     
     QTimer* timer = m_miningTimers.value(characterName, nullptr);
     if (!timer) {
@@ -871,30 +1093,44 @@ void ChatLogWorker::handleMiningEvent(const QString& characterName, const QStrin
             onMiningTimeout(characterName);
         });
         m_miningTimers[characterName] = timer;
-        qDebug() << "ChatLogWorker: Created new mining timer for" << characterName;
+        qCDebug(lcLog) << "ChatLogWorker: Created new mining timer for" << characterName;
     } else {
         timer->setInterval(timeoutMs);
-        qDebug() << "ChatLogWorker: Restarting existing mining timer for" << characterName;
+        qCDebug(lcLog) << "ChatLogWorker: Restarting existing mining timer for" << characterName;
     }
     
     if (!m_miningActiveState.value(characterName, false)) {
         m_miningActiveState[characterName] = true;
+        m_miningStartTimes[characterName] = timestamp;
+        m_miningLastTimes[characterName] = timestamp;
         emit combatEventDetected(characterName, "mining_started", "Mining started");
-        qDebug() << "ChatLogWorker: Mining started for" << characterName;
+        qCDebug(lcLog) << "ChatLogWorker: Mining started for" << characterName;
     } else {
-        qDebug() << "ChatLogWorker: Mining already active for" << characterName << ", resetting timer";
+        m_miningLastTimes[characterName] = timestamp;
+        qCDebug(lcLog) << "ChatLogWorker: Mining already active for" << characterName << ", resetting timer";
     }
     
     timer->start();
-    qDebug() << "ChatLogWorker: Mining timer started/restarted for" << characterName << "- will timeout in" << timeoutMs << "ms";
+    qCDebug(lcLog) << "ChatLogWorker: Mining timer started/restarted for" << characterName << "- will timeout in" << timeoutMs << "ms";
 }
 
 void ChatLogWorker::onMiningTimeout(const QString& characterName)
 {
     if (m_miningActiveState.value(characterName, false)) {
         m_miningActiveState[characterName] = false;
+
+        // The session ends at its last mining line, not when the idle timeout fires
+        qint64 lastTime = m_miningLastTimes.take(characterName);
+        m_lineTimestamp = lastTime;
         emit combatEventDetected(characterName, "mining_stopped", "Mining stopped");
-        qDebug() << "ChatLogWorker: Mining stopped for" << characterName << "(timeout)";
+        m_lineTimestamp = 0;
+        
+        // One aggregate record per session
+        if (m_activityStore && m_miningStartTimes.contains(characterName)) {
+            qint64 sessionMs = qMax<qint64>(0, lastTime - m_miningStartTimes.take(characterName));
+            m_activityStore->append(ActivityType::MiningSession, characterName, QString(), qint32(sessionMs / 1000), lastTime);
+        }
+        qCDebug(lcLog) << "ChatLogWorker: Mining stopped for" << characterName << "(timeout)";
     }
 }
 
@@ -1013,12 +1249,15 @@ ChatLogReader::ChatLogReader(QObject *parent)
     , m_monitoring(false)
 {
     m_worker->moveToThread(m_workerThread);
+    m_worker->setActivityStore(&m_activityStore);
     
     // Connect signals from worker to main thread
     connect(m_worker, &ChatLogWorker::systemChanged, 
             this, &ChatLogReader::handleSystemChanged, Qt::QueuedConnection);
     connect(m_worker, &ChatLogWorker::combatEventDetected,
             this, &ChatLogReader::combatEventDetected, Qt::QueuedConnection);
+    connect(m_worker, &ChatLogWorker::intelReported,
+            this, &ChatLogReader::intelReported, Qt::QueuedConnection);
     connect(m_worker, &ChatLogWorker::characterLoggedIn, 
             this, &ChatLogReader::characterLoggedIn, Qt::QueuedConnection);
     connect(m_worker, &ChatLogWorker::characterLoggedOut, 
@@ -1028,14 +1267,16 @@ ChatLogReader::ChatLogReader(QObject *parent)
     connect(m_workerThread, &QThread::started, 
         m_worker, &ChatLogWorker::startMonitoring);
     
-    qDebug() << "ChatLogReader: Created";
+    connect(&Config::instance(), &Config::settingsChanged, this, &ChatLogReader::onConfigChanged);
+    
+    qCDebug(lcLog) << "ChatLogReader: Created";
 }
 
 ChatLogReader::~ChatLogReader()
 {
     stop();
     if (!m_workerThread->wait(3000)) {
-        qWarning() << "ChatLogReader: Worker thread did not stop in time, terminating";
+        qCWarning(lcLog) << "ChatLogReader: Worker thread did not stop in time, terminating";
         m_workerThread->terminate();
         m_workerThread->wait();
     }
@@ -1044,7 +1285,7 @@ ChatLogReader::~ChatLogReader()
     delete m_worker;
     m_worker = nullptr;
     
-    qDebug() << "ChatLogReader: Destroyed";
+    qCDebug(lcLog) << "ChatLogReader: Destroyed";
 }
 
 void ChatLogReader::setCharacterNames(const QStringList& characters)
@@ -1076,46 +1317,78 @@ void ChatLogReader::setCharacterNames(const QStringList& characters)
 void ChatLogReader::setLogDirectory(const QString& directory)
 {
     m_worker->setLogDirectory(directory);
-    qDebug() << "ChatLogReader: Chatlog directory set to:" << directory;
+    qCDebug(lcLog) << "ChatLogReader: Chatlog directory set to:" << directory;
 }
 
 void ChatLogReader::setGameLogDirectory(const QString& directory)
 {
     m_worker->setGameLogDirectory(directory);
-    qDebug() << "ChatLogReader: Gamelog directory set to:" << directory;
+    qCDebug(lcLog) << "ChatLogReader: Gamelog directory set to:" << directory;
 }
 
 void ChatLogReader::setEnableChatLogMonitoring(bool enabled)
 {
     m_worker->setEnableChatLogMonitoring(enabled);
-    qDebug() << "ChatLogReader: Chat log monitoring enabled:" << enabled;
+    qCDebug(lcLog) << "ChatLogReader: Chat log monitoring enabled:" << enabled;
 }
 
 void ChatLogReader::setEnableGameLogMonitoring(bool enabled)
 {
     m_worker->setEnableGameLogMonitoring(enabled);
-    qDebug() << "ChatLogReader: Game log monitoring enabled:" << enabled;
+    qCDebug(lcLog) << "ChatLogReader: Game log monitoring enabled:" << enabled;
+}
+
+void ChatLogReader::setIntelChannels(const QStringList& channels)
+{
+    m_worker->setIntelChannels(channels);
+    qCDebug(lcLog) << "ChatLogReader: Intel channels set to:" << channels;
+}
+
+void ChatLogReader::setActivityProfile(const QString& profileName)
+{
+    QString path = ActivityStore::storePathForProfile(profileName);
+    if (m_activityStore.filePath() == path) {
+        return;
+    }
+    
+    if (!m_activityStore.open(path)) {
+        return;
+    }
+    
+    // Restore recent locations so thumbnails show a system before the logs are rescanned
+    qint64 since = QDateTime::currentMSecsSinceEpoch() - ACTIVITY_RESTORE_WINDOW_MS;
+    QHash<QString, ActivityLocation> systems = m_activityStore.lastKnownSystems(since);
+    for (auto it = systems.constBegin(); it != systems.constEnd(); ++it) {
+        if (getSystemForCharacter(it.key()).isEmpty()) {
+            handleSystemChanged(it.key(), it->systemName);
+        }
+    }
+}
+
+QVector<ActivityEntry> ChatLogReader::activityHistory(const QString& characterName, qint64 fromMs, qint64 toMs) const
+{
+    return m_activityStore.query(characterName, fromMs, toMs);
 }
 
 void ChatLogReader::refreshMonitoring()
 {
     if (!m_monitoring || !m_workerThread->isRunning()) {
-        qDebug() << "ChatLogReader: Cannot refresh - monitoring not active";
+        qCDebug(lcLog) << "ChatLogReader: Cannot refresh - monitoring not active";
         return;
     }
     
-    qDebug() << "ChatLogReader: Requesting monitoring refresh";
+    qCDebug(lcLog) << "ChatLogReader: Requesting monitoring refresh";
     QMetaObject::invokeMethod(m_worker, "refreshMonitoring", Qt::QueuedConnection);
 }
 
 void ChatLogReader::start()
 {
     if (m_monitoring) {
-        qDebug() << "ChatLogReader: Already monitoring";
+        qCDebug(lcLog) << "ChatLogReader: Already monitoring";
         return;
     }
     
-    qDebug() << "ChatLogReader: Starting monitoring";
+    qCDebug(lcLog) << "ChatLogReader: Starting monitoring";
     m_monitoring = true;
     
     if (!m_workerThread->isRunning()) {
@@ -1134,7 +1407,7 @@ void ChatLogReader::stop()
         return;
     }
     
-    qDebug() << "ChatLogReader: Stopping monitoring";
+    qCDebug(lcLog) << "ChatLogReader: Stopping monitoring";
     m_monitoring = false;
     
     if (m_workerThread->isRunning()) {
@@ -1144,6 +1417,42 @@ void ChatLogReader::stop()
     emit monitoringStopped();
 }
 
+void ChatLogReader::onConfigChanged(Config::ChangeGroups groups, const Config::SettingSet& changed)
+{
+    Q_UNUSED(changed);
+    if (!(groups & (Config::LogMonitoringChanges | Config::ProfileChanges))) {
+        return;
+    }
+    
+    const Config& cfg = Config::instance();
+    setActivityProfile(cfg.getCurrentProfileName());
+    if (!(groups & Config::LogMonitoringChanges)) {
+        return;
+    }
+    
+    setLogDirectory(cfg.chatLogDirectory());
+    setGameLogDirectory(cfg.gameLogDirectory());
+    
+    bool enableChatLog = cfg.enableChatLogMonitoring();
+    bool enableGameLog = cfg.enableGameLogMonitoring();
+    setEnableChatLogMonitoring(enableChatLog);
+    setEnableGameLogMonitoring(enableGameLog);
+    setIntelChannels(cfg.intelChannels());
+    
+    bool shouldMonitor = enableChatLog || enableGameLog;
+    if (shouldMonitor && !m_monitoring) {
+        start();
+        qCDebug(lcLog) << "ChatLog: Monitoring started via settings (ChatLog:" << enableChatLog << ", GameLog:" << enableGameLog << ")";
+    } else if (!shouldMonitor && m_monitoring) {
+        stop();
+        qCDebug(lcLog) << "ChatLog: Monitoring stopped via settings";
+    } else if (shouldMonitor) {
+        // Monitoring is active and should remain active, but settings may have changed
+        refreshMonitoring();
+        qCDebug(lcLog) << "ChatLog: Monitoring refreshed via settings (ChatLog:" << enableChatLog << ", GameLog:" << enableGameLog << ")";
+    }
+}
+
 QString ChatLogReader::getSystemForCharacter(const QString& characterName) const
 {
     QMutexLocker locker(&m_locationMutex);
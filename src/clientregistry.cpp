@@ -0,0 +1,183 @@
+#include "clientregistry.h"
+#include "overlayinfo.h"
+#include <algorithm>
+
+ClientSlot ClientRegistry::add(WindowId hwnd, const QString& processName, qint64 creationTime, ClientThumbnail* thumbnail)
+{
+    ClientSlot slot;
+    if (!m_freeSlots.isEmpty()) {
+        slot = m_freeSlots.takeLast();
+    } else {
+        slot = m_windows.size();
+        m_windows.append(0);
+        m_thumbnails.append(nullptr);
+        m_titles.append(QString());
+        m_processNames.append(QString());
+        m_creationTimes.append(0);
+        m_kinds.append(Kind::NonEVE);
+        m_characters.append(CharacterRegistry::INVALID_ID);
+        m_characterNames.append(QString());
+        m_systemNames.append(QString());
+        m_locationMoveAttempted.append(false);
+        m_dragOrigins.append(QPoint());
+        m_isEVE.append(false);
+    }
+
+    bool isEVE = processName.compare("exefile.exe", Qt::CaseInsensitive) == 0;
+    m_windows[slot] = hwnd;
+    m_thumbnails[slot] = thumbnail;
+    m_titles[slot].clear();
+    m_processNames[slot] = processName;
+    m_creationTimes[slot] = creationTime;
+    m_kinds[slot] = isEVE ? Kind::NotLoggedIn : Kind::NonEVE;
+    m_characters[slot] = CharacterRegistry::INVALID_ID;
+    m_characterNames[slot].clear();
+    m_systemNames[slot].clear();
+    m_locationMoveAttempted[slot] = false;
+    m_dragOrigins[slot] = QPoint();
+    m_isEVE[slot] = isEVE;
+
+    m_slotByWindow.insert(hwnd, slot);
+    insertOrdered(m_creationOrder, slot);
+    indexKind(slot);
+    return slot;
+}
+
+void ClientRegistry::remove(ClientSlot slot)
+{
+    if (slot == INVALID_SLOT || m_slotByWindow.value(m_windows[slot], INVALID_SLOT) != slot) {
+        return;
+    }
+
+    unindexKind(slot);
+    m_creationOrder.removeOne(slot);
+    m_slotByWindow.remove(m_windows[slot]);
+
+    m_windows[slot] = 0;
+    m_thumbnails[slot] = nullptr;
+    m_titles[slot].clear();
+    m_processNames[slot].clear();
+    m_characterNames[slot].clear();
+    m_systemNames[slot].clear();
+    m_characters[slot] = CharacterRegistry::INVALID_ID;
+    m_freeSlots.append(slot);
+}
+
+bool ClientRegistry::setTitle(ClientSlot slot, const QString& title)
+{
+    if (m_titles[slot] == title) {
+        return false;
+    }
+
+    Kind kind = Kind::NonEVE;
+    QString characterName;
+    if (m_isEVE[slot]) {
+        characterName = OverlayInfo::extractCharacterName(title);
+        kind = characterName.isEmpty() ? Kind::NotLoggedIn : Kind::LoggedIn;
+    }
+
+    // Non-EVE positions are saved under their title, so any rename moves them
+    bool changed = kind != m_kinds[slot] || characterName != m_characterNames[slot] || kind == Kind::NonEVE;
+    m_titles[slot] = title;
+    if (!changed) {
+        return false;
+    }
+
+    unindexKind(slot);
+    m_kinds[slot] = kind;
+    m_characterNames[slot] = characterName;
+    m_characters[slot] = CharacterRegistry::instance().intern(characterName);
+    indexKind(slot);
+    return true;
+}
+
+ClientThumbnail* ClientRegistry::thumbnailFor(WindowId hwnd) const
+{
+    ClientSlot slot = slotFor(hwnd);
+    return slot == INVALID_SLOT ? nullptr : m_thumbnails[slot];
+}
+
+QString ClientRegistry::positionKey(ClientSlot slot) const
+{
+    switch (m_kinds[slot]) {
+    case Kind::LoggedIn:
+        return m_characterNames[slot];
+    case Kind::NonEVE:
+        if (m_titles[slot].isEmpty() || m_processNames[slot].isEmpty()) {
+            return QString();
+        }
+        return QString("%1::%2").arg(m_processNames[slot], m_titles[slot]);
+    case Kind::NotLoggedIn:
+        break;
+    }
+    return QString();
+}
+
+void ClientRegistry::clearLocationMoveAttempted()
+{
+    std::fill(m_locationMoveAttempted.begin(), m_locationMoveAttempted.end(), false);
+}
+
+QHash<CharacterId, WindowId> ClientRegistry::characterWindows() const
+{
+    QHash<CharacterId, WindowId> windows;
+    windows.reserve(m_slotByCharacter.size());
+    for (auto it = m_slotByCharacter.constBegin(); it != m_slotByCharacter.constEnd(); ++it) {
+        windows.insert(it.key(), m_windows[it.value()]);
+    }
+    return windows;
+}
+
+QStringList ClientRegistry::characterNames() const
+{
+    QStringList names;
+    names.reserve(m_slotByCharacter.size());
+    for (ClientSlot slot : m_slotByCharacter) {
+        names.append(m_characterNames[slot]);
+    }
+    return names;
+}
+
+void ClientRegistry::insertOrdered(QVector<ClientSlot>& index, ClientSlot slot)
+{
+    // Ties keep insertion order, so clients without a creation time stay in arrival order
+    auto position = std::upper_bound(index.begin(), index.end(), slot, [this](ClientSlot a, ClientSlot b) {
+        return m_creationTimes[a] < m_creationTimes[b];
+    });
+    index.insert(position, slot);
+}
+
+void ClientRegistry::indexKind(ClientSlot slot)
+{
+    switch (m_kinds[slot]) {
+    case Kind::LoggedIn:
+        // A second client on the same character takes over its hotkeys
+        m_slotByCharacter.insert(m_characters[slot], slot);
+        break;
+    case Kind::NotLoggedIn:
+        insertOrdered(m_notLoggedIn, slot);
+        break;
+    case Kind::NonEVE:
+        insertOrdered(m_nonEVE, slot);
+        break;
+    }
+}
+
+void ClientRegistry::unindexKind(ClientSlot slot)
+{
+    switch (m_kinds[slot]) {
+    case Kind::LoggedIn: {
+        auto it = m_slotByCharacter.find(m_characters[slot]);
+        if (it != m_slotByCharacter.end() && it.value() == slot) {
+            m_slotByCharacter.erase(it);
+        }
+        break;
+    }
+    case Kind::NotLoggedIn:
+        m_notLoggedIn.removeOne(slot);
+        break;
+    case Kind::NonEVE:
+        m_nonEVE.removeOne(slot);
+        break;
+    }
+}
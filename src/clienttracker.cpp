@@ -0,0 +1,693 @@
+#include "clienttracker.h"
+#include "windowcapture.h"
+#include "hotkeymanager.h"
+#include "overlayinfo.h"
+#include "config.h"
+#include "logging.h"
+#include "starmap.h"
+#include "layoutengine.h"
+#include <QMap>
+#include <QGuiApplication>
+#include <QScreen>
+#include <algorithm>
+#include <initializer_list>
+#include <limits>
+#include <utility>
+
+static const QString NOT_LOGGED_IN_TEXT = QStringLiteral("Not Logged In");
+
+// Primary screen first, the layout engine starts there
+static QVector<QRect> screenGeometries()
+{
+    QVector<QRect> geometries;
+    QScreen* primaryScreen = QGuiApplication::primaryScreen();
+    if (primaryScreen) {
+        geometries.append(primaryScreen->geometry());
+    }
+    for (QScreen* screen : QGuiApplication::screens()) {
+        if (screen != primaryScreen) {
+            geometries.append(screen->geometry());
+        }
+    }
+    return geometries;
+}
+
+static bool isWindowRectValid(const QRect& rect)
+{
+    if (rect.isNull() || rect.isEmpty()) {
+        return false;
+    }
+
+    // Check if any part of the window is on a valid monitor
+    for (QScreen* screen : QGuiApplication::screens()) {
+        if (screen->geometry().intersects(rect)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+ClientTracker::ClientTracker(WindowCapture& windowCapture, HotkeyManager& hotkeyManager,
+                             ThumbnailFactory createThumbnail, QObject *parent)
+    : QObject(parent)
+    , m_windowCapture(windowCapture)
+    , m_hotkeyManager(hotkeyManager)
+    , m_createThumbnail(std::move(createThumbnail))
+{
+    connect(&m_hotkeyManager, &HotkeyManager::cycleGroupsChanged, this, &ClientTracker::rebuildCycleTables);
+    connect(&WindowSystem::instance(), &WindowSystem::windowEvent, this, &ClientTracker::onWindowEvent);
+}
+
+ClientTracker::~ClientTracker()
+{
+    disconnect(&WindowSystem::instance(), nullptr, this, nullptr);
+
+    for (ClientSlot slot : m_clients.clients()) {
+        delete m_clients.thumbnail(slot);
+    }
+}
+
+void ClientTracker::onWindowEvent(WindowSystem::Event event, quintptr windowId)
+{
+    WindowId hwnd = windowId;
+
+    switch (event) {
+    case WindowSystem::Event::Destroyed:
+        removeWindow(hwnd);
+        break;
+    case WindowSystem::Event::Created:
+    case WindowSystem::Event::Shown:
+    case WindowSystem::Event::NameChanged:
+        trackWindow(hwnd);
+        break;
+    case WindowSystem::Event::Foreground:
+        break;
+    }
+}
+
+void ClientTracker::refresh()
+{
+    applyWindows(m_windowCapture.getEVEWindows(), true);
+}
+
+void ClientTracker::trackWindow(WindowId hwnd)
+{
+    WindowInfo window;
+    if (!m_windowCapture.captureWindow(hwnd, window)) {
+        // Tracked windows are dropped when destroyed or on the next reconcile,
+        // a client briefly clearing its title while loading keeps its thumbnail
+        return;
+    }
+
+    ClientSlot slot = m_clients.slotFor(hwnd);
+    if (slot != ClientRegistry::INVALID_SLOT && m_clients.title(slot) == window.title) {
+        return;
+    }
+
+    applyWindows({ window }, false);
+}
+
+void ClientTracker::removeWindow(WindowId hwnd)
+{
+    ClientSlot slot = m_clients.slotFor(hwnd);
+    if (slot == ClientRegistry::INVALID_SLOT) {
+        return;
+    }
+
+    emit clientRemoved(slot);
+    m_clients.thumbnail(slot)->dispose();
+    m_clients.remove(slot);
+    m_needsMappingUpdate = true;
+
+    emit clientsChanged(true);
+    updateCharacterMappings();
+}
+
+void ClientTracker::applyWindows(QVector<WindowInfo> windows, bool removeMissing)
+{
+    const Config& cfg = Config::instance();
+    const int thumbWidth = cfg.thumbnailWidth();
+    const int thumbHeight = cfg.thumbnailHeight();
+    const bool rememberPos = cfg.rememberPositions();
+    const bool showNotLoggedIn = cfg.showNotLoggedInClients();
+    const bool showNotLoggedInOverlay = cfg.showNotLoggedInOverlay();
+    const bool showNonEVEOverlay = cfg.showNonEVEOverlay();
+
+    QSet<WindowId> currentWindows;
+    bool hasNewWindows = false;
+    for (const auto& window : windows) {
+        currentWindows.insert(window.handle);
+        if (m_clients.slotFor(window.handle) == ClientRegistry::INVALID_SLOT) {
+            hasNewWindows = true;
+        }
+    }
+
+    if (hasNewWindows) {
+        std::sort(windows.begin(), windows.end(), [](const WindowInfo& a, const WindowInfo& b) {
+            return a.creationTime < b.creationTime;
+        });
+    }
+
+    bool membershipChanged = false;
+    if (removeMissing) {
+        // Copied, removing a client edits the index being walked
+        const QVector<ClientSlot> clients = m_clients.clients();
+        for (ClientSlot slot : clients) {
+            if (!currentWindows.contains(m_clients.window(slot))) {
+                emit clientRemoved(slot);
+                m_clients.thumbnail(slot)->dispose();
+                m_clients.remove(slot);
+                m_needsMappingUpdate = true;
+                membershipChanged = true;
+            }
+        }
+    }
+
+    // Placed together once every client is registered, so the layout sees
+    // the clients already sitting on it
+    QVector<ClientSlot> needsPlacement;
+
+    for (const auto& window : windows) {
+        bool isEVEClient = window.processName.compare("exefile.exe", Qt::CaseInsensitive) == 0;
+
+        QString characterName;
+        QString displayName;
+
+        if (isEVEClient) {
+            characterName = OverlayInfo::extractCharacterName(window.title);
+
+            if (characterName.isEmpty() && showNotLoggedInOverlay) {
+                displayName = NOT_LOGGED_IN_TEXT;
+            } else {
+                displayName = characterName;
+            }
+        } else {
+            displayName = showNonEVEOverlay ? window.title : "";
+        }
+
+        ClientSlot slot = m_clients.slotFor(window.handle);
+        ClientThumbnail *thumbnail = nullptr;
+
+        if (slot == ClientRegistry::INVALID_SLOT) {
+            if (isEVEClient && characterName.isEmpty() && !showNotLoggedIn) {
+                continue;
+            }
+
+            thumbnail = m_createThumbnail(window, displayName);
+            slot = m_clients.add(window.handle, window.processName, window.creationTime, thumbnail);
+            m_clients.setTitle(slot, window.title);
+
+            m_needsMappingUpdate = true;
+            membershipChanged = true;
+
+            if (m_clients.kind(slot) == ClientRegistry::Kind::LoggedIn) {
+                QString cachedSystem = m_characterSystems.value(characterName);
+                if (!cachedSystem.isEmpty()) {
+                    m_clients.setSystemName(slot, cachedSystem);
+                    thumbnail->setSystemName(cachedSystem);
+                }
+
+                tryRestoreClientLocation(slot);
+            }
+
+            emit clientAdded(slot);
+            needsPlacement.append(slot);
+        } else {
+            thumbnail = m_clients.thumbnail(slot);
+            if (m_clients.title(slot) != window.title) {
+                thumbnail->setTitle(window.title);
+
+                ClientRegistry::Kind previousKind = m_clients.kind(slot);
+                bool identityChanged = m_clients.setTitle(slot, window.title);
+                if (identityChanged) {
+                    m_needsMappingUpdate = true;
+                }
+
+                if (identityChanged && m_clients.kind(slot) == ClientRegistry::Kind::LoggedIn) {
+                    thumbnail->setCharacterName(characterName);
+
+                    QString cachedSystem = m_characterSystems.value(characterName);
+                    m_clients.setSystemName(slot, cachedSystem);
+                    thumbnail->setSystemName(cachedSystem);
+
+                    // Try to restore client window location
+                    tryRestoreClientLocation(slot);
+
+                    if (rememberPos) {
+                        QPoint savedPos = cfg.getThumbnailPosition(characterName);
+                        if (savedPos != QPoint(-1, -1) &&
+                            LayoutEngine::isOnScreen(QRect(savedPos, QSize(thumbWidth, thumbHeight)), screenGeometries())) {
+                            thumbnail->placeAt(savedPos);
+                        }
+                    }
+                } else if (identityChanged && previousKind == ClientRegistry::Kind::LoggedIn) {
+                    QString newDisplayName = showNotLoggedInOverlay ? NOT_LOGGED_IN_TEXT : "";
+                    thumbnail->setCharacterName(newDisplayName);
+                    m_clients.setSystemName(slot, QString());
+                    thumbnail->setSystemName(QString());
+
+                    if (!cfg.preserveLogoutPositions()) {
+                        needsPlacement.append(slot);
+                    }
+                }
+            }
+
+            if (isEVEClient && characterName.isEmpty()) {
+                QString newDisplayName = showNotLoggedInOverlay ? NOT_LOGGED_IN_TEXT : "";
+                thumbnail->setCharacterName(newDisplayName);
+                thumbnail->setSystemName(QString());
+            } else if (!isEVEClient) {
+                thumbnail->setCharacterName(showNonEVEOverlay ? window.title : "");
+            }
+        }
+    }
+
+    if (!needsPlacement.isEmpty()) {
+        const QHash<ClientSlot, QPoint> targets = layoutTargets();
+        for (ClientSlot slot : needsPlacement) {
+            m_clients.thumbnail(slot)->placeAt(targets.value(slot));
+        }
+    }
+
+    emit clientsChanged(membershipChanged);
+    updateCharacterMappings();
+}
+
+void ClientTracker::updateCharacterMappings()
+{
+    // The registry indexes are always current, this only pushes them out
+    if (!m_needsMappingUpdate) {
+        return;
+    }
+    m_needsMappingUpdate = false;
+
+    Config& cfg = Config::instance();
+    for (ClientSlot slot : m_clients.clients()) {
+        QString positionKey = m_clients.positionKey(slot);
+        if (!positionKey.isEmpty()) {
+            cfg.markCharacterSeen(positionKey);
+        }
+    }
+
+    m_hotkeyManager.updateCharacterWindows(m_clients.characterWindows());
+    rebuildCycleTables();
+    emit characterNamesChanged(m_clients.characterNames());
+}
+
+ClientSlot ClientTracker::setCharacterSystem(const QString& characterName, const QString& systemName)
+{
+    m_characterSystems[characterName] = systemName;
+
+    ClientSlot slot = m_clients.slotFor(CharacterRegistry::instance().find(characterName));
+    if (slot != ClientRegistry::INVALID_SLOT) {
+        m_clients.setSystemName(slot, systemName);
+        m_clients.thumbnail(slot)->setSystemName(systemName);
+    }
+    return slot;
+}
+
+QHash<QString, QString> ClientTracker::liveCharacterSystems() const
+{
+    // Only clients with a thumbnail need a distance, the cache holds many more
+    QHash<QString, QString> systems;
+    for (ClientSlot slot : m_clients.clients()) {
+        if (!m_clients.characterName(slot).isEmpty() && !m_clients.systemName(slot).isEmpty()) {
+            systems.insert(m_clients.characterName(slot), m_clients.systemName(slot));
+        }
+    }
+    return systems;
+}
+
+QVector<int> ClientTracker::layoutGroups() const
+{
+    const Config& cfg = Config::instance();
+    const QVector<ClientSlot>& clients = m_clients.clients();
+    QVector<int> groups(clients.size(), 0);
+
+    auto grouping = static_cast<LayoutEngine::Grouping>(cfg.layoutGrouping());
+    if (grouping == LayoutEngine::Grouping::None && cfg.groupThumbnailsByJumpDistance()) {
+        grouping = LayoutEngine::Grouping::System;
+    }
+
+    if (grouping == LayoutEngine::Grouping::CycleGroup) {
+        // Cycle groups in name order, a character in several goes with the first
+        QHash<QString, CycleGroup> allGroups = m_hotkeyManager.getAllCycleGroups();
+        QStringList groupNames = allGroups.keys();
+        groupNames.sort(Qt::CaseInsensitive);
+
+        const CharacterRegistry& characters = CharacterRegistry::instance();
+        QHash<CharacterId, int> groupByCharacter;
+        for (int group = 0; group < groupNames.size(); ++group) {
+            for (const QString& characterName : allGroups.value(groupNames[group]).characterNames) {
+                CharacterId characterId = characters.find(characterName);
+                if (characterId != CharacterRegistry::INVALID_ID && !groupByCharacter.contains(characterId)) {
+                    groupByCharacter.insert(characterId, group);
+                }
+            }
+        }
+
+        for (int i = 0; i < clients.size(); ++i) {
+            groups[i] = groupByCharacter.value(m_clients.character(clients[i]), groupNames.size());
+        }
+    } else if (grouping == LayoutEngine::Grouping::System) {
+        // Nearest systems to the active client first, clients with no known system last
+        QHash<QString, int> distances = StarMap::instance().distancesFrom(m_referenceSystem, liveCharacterSystems());
+        auto systemKey = [&](ClientSlot slot) {
+            return std::make_pair(distances.value(m_clients.characterName(slot), std::numeric_limits<int>::max()),
+                                  m_clients.systemName(slot));
+        };
+
+        QMap<std::pair<int, QString>, int> ranks;
+        for (ClientSlot slot : clients) {
+            if (!m_clients.systemName(slot).isEmpty()) {
+                ranks.insert(systemKey(slot), 0);
+            }
+        }
+        int rank = 0;
+        for (auto it = ranks.begin(); it != ranks.end(); ++it) {
+            it.value() = rank++;
+        }
+
+        for (int i = 0; i < clients.size(); ++i) {
+            ClientSlot slot = clients[i];
+            groups[i] = m_clients.systemName(slot).isEmpty() ? ranks.size() : ranks.value(systemKey(slot));
+        }
+    }
+
+    return groups;
+}
+
+QHash<ClientSlot, QPoint> ClientTracker::layoutTargets() const
+{
+    const Config& cfg = Config::instance();
+    const bool rememberPos = cfg.rememberPositions();
+    const QVector<ClientSlot>& clients = m_clients.clients();
+    const QVector<int> groups = layoutGroups();
+
+    QVector<LayoutEngine::Item> items;
+    items.reserve(clients.size());
+    for (int i = 0; i < clients.size(); ++i) {
+        ClientSlot slot = clients[i];
+        LayoutEngine::Item item;
+        item.notLoggedIn = m_clients.kind(slot) == ClientRegistry::Kind::NotLoggedIn;
+        item.group = groups[i];
+
+        QString positionKey = m_clients.positionKey(slot);
+        if (rememberPos && !positionKey.isEmpty()) {
+            item.savedPosition = cfg.getThumbnailPosition(positionKey);
+        }
+        items.append(item);
+    }
+
+    int strategy = cfg.layoutStrategy();
+    if (strategy < 0 || strategy > static_cast<int>(LayoutEngine::Strategy::PackAroundSaved)) {
+        strategy = static_cast<int>(LayoutEngine::Strategy::Grid);
+    }
+
+    LayoutEngine::Parameters parameters;
+    parameters.strategy = static_cast<LayoutEngine::Strategy>(strategy);
+    parameters.thumbnailSize = QSize(cfg.thumbnailWidth(), cfg.thumbnailHeight());
+    parameters.screens = screenGeometries();
+    parameters.notLoggedInOrigin = cfg.notLoggedInReferencePosition();
+    parameters.notLoggedInStackMode = cfg.notLoggedInStackMode();
+
+    const QVector<QRect> rects = LayoutEngine::layout(items, parameters);
+    QHash<ClientSlot, QPoint> targets;
+    targets.reserve(clients.size());
+    for (int i = 0; i < clients.size(); ++i) {
+        targets.insert(clients[i], rects[i].topLeft());
+    }
+    return targets;
+}
+
+void ClientTracker::rebuildCycleTables()
+{
+    m_cycleTables.clear();
+    m_cyclePositions.clear();
+
+    const CharacterRegistry& characters = CharacterRegistry::instance();
+    const QHash<QString, CycleGroup> groups = m_hotkeyManager.getAllCycleGroups();
+    for (auto it = groups.cbegin(); it != groups.cend(); ++it) {
+        const CycleGroup& group = it.value();
+        CycleTable& table = m_cycleTables[it.key()];
+        table.noLoop = group.noLoop;
+
+        for (const QString& characterName : group.characterNames) {
+            ClientSlot slot = m_clients.slotFor(characters.find(characterName));
+            if (slot != ClientRegistry::INVALID_SLOT) {
+                table.clients.append(slot);
+            }
+        }
+
+        if (group.includeNotLoggedIn) {
+            table.clients += m_clients.notLoggedInClients();
+        }
+
+        for (int index = 0; index < table.clients.size(); ++index) {
+            m_cyclePositions[table.clients[index]].append({it.key(), index});
+        }
+    }
+}
+
+QVector<ClientSlot> ClientTracker::cycleClients(const QString& groupName) const
+{
+    return m_cycleTables.value(groupName).clients;
+}
+
+int ClientTracker::cycleIndexOf(ClientSlot slot, const QString& groupName) const
+{
+    auto positions = m_cyclePositions.constFind(slot);
+    if (positions == m_cyclePositions.cend()) {
+        return -1;
+    }
+
+    for (const CyclePosition& position : *positions) {
+        if (position.groupName == groupName) {
+            return position.index;
+        }
+    }
+    return -1;
+}
+
+void ClientTracker::setActivated(WindowId hwnd)
+{
+    ClientSlot slot = m_clients.slotFor(hwnd);
+    auto positions = m_cyclePositions.constFind(slot);
+    if (positions != m_cyclePositions.cend()) {
+        for (const CyclePosition& position : *positions) {
+            m_cycleIndexByGroup[position.groupName] = position.index;
+            m_lastActivatedWindowByGroup[position.groupName] = hwnd;
+        }
+    }
+
+    int notLoggedInIndex = m_clients.notLoggedInClients().indexOf(slot);
+    if (notLoggedInIndex != -1) {
+        m_notLoggedInCycleIndex = notLoggedInIndex;
+    }
+}
+
+QSet<WindowId> ClientTracker::preRestoreTargets(WindowId target) const
+{
+    QSet<WindowId> targets;
+    int limit = Config::instance().preRestoreCount();
+    auto table = m_cycleTables.constFind(m_lastCycleGroup);
+    if (limit <= 0 || table == m_cycleTables.cend()) {
+        return targets;
+    }
+
+    const QVector<ClientSlot>& clients = table->clients;
+    int index = cycleIndexOf(m_clients.slotFor(target), m_lastCycleGroup);
+    if (index == -1) {
+        return targets;
+    }
+
+    // Next and previous first, widening until the set is full
+    const int count = clients.size();
+    for (int step = 1; step < count && targets.size() < limit; ++step) {
+        for (int candidate : {index + step, index - step}) {
+            if (table->noLoop && (candidate < 0 || candidate >= count)) {
+                continue;
+            }
+
+            WindowId hwnd = m_clients.window(clients[(candidate % count + count) % count]);
+            if (hwnd != target && targets.size() < limit) {
+                targets.insert(hwnd);
+            }
+        }
+    }
+    return targets;
+}
+
+WindowId ClientTracker::cycleForward(const QString& groupName)
+{
+    auto table = m_cycleTables.constFind(groupName);
+    if (table == m_cycleTables.cend() || table->clients.isEmpty()) {
+        return 0;
+    }
+    const QVector<ClientSlot>& clients = table->clients;
+
+    WindowId lastActivatedWindow = m_lastActivatedWindowByGroup.value(groupName, 0);
+    int currentIndex = cycleIndexOf(m_clients.slotFor(lastActivatedWindow), groupName);
+
+    if (currentIndex == -1) {
+        currentIndex = m_cycleIndexByGroup.value(groupName, -1);
+    }
+
+    currentIndex++;
+
+    if (table->noLoop && currentIndex >= clients.size()) {
+        return 0;
+    }
+
+    if (currentIndex >= clients.size()) {
+        currentIndex = 0;
+    }
+
+    WindowId hwnd = m_clients.window(clients[currentIndex]);
+    m_cycleIndexByGroup[groupName] = currentIndex;
+    m_lastActivatedWindowByGroup[groupName] = hwnd;
+    m_lastCycleGroup = groupName;
+    return hwnd;
+}
+
+WindowId ClientTracker::cycleBackward(const QString& groupName)
+{
+    auto table = m_cycleTables.constFind(groupName);
+    if (table == m_cycleTables.cend() || table->clients.isEmpty()) {
+        return 0;
+    }
+    const QVector<ClientSlot>& clients = table->clients;
+
+    WindowId lastActivatedWindow = m_lastActivatedWindowByGroup.value(groupName, 0);
+    int currentIndex = cycleIndexOf(m_clients.slotFor(lastActivatedWindow), groupName);
+
+    if (currentIndex == -1) {
+        currentIndex = m_cycleIndexByGroup.value(groupName, 0);
+    }
+
+    currentIndex--;
+
+    if (table->noLoop && currentIndex < 0) {
+        return 0;
+    }
+
+    // A stored index can outlive clients that have since left the group
+    if (currentIndex < 0 || currentIndex >= clients.size()) {
+        currentIndex = clients.size() - 1;
+    }
+
+    WindowId hwnd = m_clients.window(clients[currentIndex]);
+    m_cycleIndexByGroup[groupName] = currentIndex;
+    m_lastActivatedWindowByGroup[groupName] = hwnd;
+    m_lastCycleGroup = groupName;
+    return hwnd;
+}
+
+WindowId ClientTracker::cycleNotLoggedInForward()
+{
+    // Destroyed windows leave the registry as they close, every entry is live
+    const QVector<ClientSlot>& clients = m_clients.notLoggedInClients();
+    if (clients.isEmpty()) {
+        return 0;
+    }
+
+    m_notLoggedInCycleIndex++;
+    if (m_notLoggedInCycleIndex >= clients.size()) {
+        m_notLoggedInCycleIndex = 0;
+    }
+
+    return m_clients.window(clients[m_notLoggedInCycleIndex]);
+}
+
+WindowId ClientTracker::cycleNotLoggedInBackward()
+{
+    const QVector<ClientSlot>& clients = m_clients.notLoggedInClients();
+    if (clients.isEmpty()) {
+        return 0;
+    }
+
+    m_notLoggedInCycleIndex--;
+    if (m_notLoggedInCycleIndex < 0 || m_notLoggedInCycleIndex >= clients.size()) {
+        m_notLoggedInCycleIndex = clients.size() - 1;
+    }
+
+    return m_clients.window(clients[m_notLoggedInCycleIndex]);
+}
+
+WindowId ClientTracker::cycleNonEVEForward()
+{
+    const QVector<ClientSlot>& clients = m_clients.nonEVEClients();
+    if (clients.isEmpty()) {
+        return 0;
+    }
+
+    m_nonEVECycleIndex++;
+    if (m_nonEVECycleIndex >= clients.size()) {
+        m_nonEVECycleIndex = 0;
+    }
+
+    return m_clients.window(clients[m_nonEVECycleIndex]);
+}
+
+WindowId ClientTracker::cycleNonEVEBackward()
+{
+    const QVector<ClientSlot>& clients = m_clients.nonEVEClients();
+    if (clients.isEmpty()) {
+        return 0;
+    }
+
+    m_nonEVECycleIndex--;
+    if (m_nonEVECycleIndex < 0 || m_nonEVECycleIndex >= clients.size()) {
+        m_nonEVECycleIndex = clients.size() - 1;
+    }
+
+    return m_clients.window(clients[m_nonEVECycleIndex]);
+}
+
+void ClientTracker::resetCycleState()
+{
+    m_cycleIndexByGroup.clear();
+    m_lastActivatedWindowByGroup.clear();
+    m_lastCycleGroup.clear();
+    m_notLoggedInCycleIndex = -1;
+    m_nonEVECycleIndex = -1;
+}
+
+bool ClientTracker::tryRestoreClientLocation(ClientSlot slot)
+{
+    const Config& cfg = Config::instance();
+
+    if (!cfg.saveClientLocation()) {
+        return false;
+    }
+
+    // Check if we've already attempted to move this window
+    if (m_clients.locationMoveAttempted(slot)) {
+        return false;
+    }
+
+    WindowId hwnd = m_clients.window(slot);
+    const QString& characterName = m_clients.characterName(slot);
+
+    // Get saved window rect
+    QRect savedRect = cfg.getClientWindowRect(characterName);
+
+    if (!isWindowRectValid(savedRect)) {
+        qCDebug(lcWindow) << "Saved window location for" << characterName << "is invalid or off-screen";
+        m_clients.setLocationMoveAttempted(slot, true);
+        return false;
+    }
+
+    // Attempt to move the window
+    bool result = WindowSystem::instance().setWindowRect(hwnd, savedRect);
+
+    m_clients.setLocationMoveAttempted(slot, true);
+
+    if (result) {
+        qCDebug(lcWindow) << "Restored window location for" << characterName << "to" << savedRect;
+        return true;
+    } else {
+        qCDebug(lcWindow) << "Failed to restore window location for" << characterName;
+        return false;
+    }
+}
@@ -1,4 +1,7 @@
 #include "config.h"
+#include "configsyncer.h"
+#include "profilestore.h"
+#include "profilewatcher.h"
 #include <QCoreApplication>
 #include <QDir>
 #include <QStandardPaths>
@@ -7,12 +10,57 @@
 #include <QFileInfo>
 #include <QDebug>
 #include <QKeySequence>
+#include <QElapsedTimer>
+#include <QDate>
+#include <algorithm>
+
+namespace {
+
+QString s_baseDirectory;
+
+QString baseDirectory()
+{
+    return s_baseDirectory.isEmpty() ? QCoreApplication::applicationDirPath() : s_baseDirectory;
+}
+
+bool isHotkeyBindingKey(const QString& key)
+{
+    const QString group = key.section('/', 0, 0);
+    return group == "hotkeys" || group == "characterHotkeys" || group == "cycleGroups" ||
+           group == "notLoggedInHotkeys" || group == "nonEVEHotkeys" || group == "closeAllHotkeys";
+}
+
+bool isLayoutKey(const QString& key)
+{
+    return key.startsWith("thumbnailPositions/") || key.startsWith("clientWindowRects/");
+}
+
+// Whether the keys picked by matches, or their values, differ between two profiles
+bool entriesDiffer(const QSettings& before, const QSettings& after, bool (*matches)(const QString&))
+{
+    QStringList beforeKeys = before.allKeys();
+    QStringList afterKeys = after.allKeys();
+    beforeKeys.removeIf([matches](const QString& key) { return !matches(key); });
+    afterKeys.removeIf([matches](const QString& key) { return !matches(key); });
+    if (beforeKeys.size() != afterKeys.size()) {
+        return true;
+    }
+    for (const QString& key : beforeKeys) {
+        if (!after.contains(key) || before.value(key) != after.value(key)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}
 
 Config::Config()
 {
     loadGlobalSettings();
     
     migrateToProfileSystem();
+    convertProfiles();
     
     QString profileToLoad = m_currentProfileName.isEmpty() ? "default" : m_currentProfileName;
     
@@ -23,18 +71,33 @@ Config::Config()
     }
     
     QString profilePath = getProfileFilePath(profileToLoad);
-    m_settings = std::make_unique<QSettings>(profilePath, QSettings::IniFormat);
+    m_settings = std::make_unique<ProfileSettings>(profilePath, profileFormat());
     m_currentProfileName = profileToLoad;
     
     if (!m_settings->contains(KEY_CONFIG_VERSION)) {
         initializeDefaultProfile();
     }
     
+    migrateProfile(*m_settings);
+    compactStaleCharacters(*m_settings);
+    m_snapshot.store(buildSnapshot(*m_settings));
+    recordHotkeyBindings();
+    scheduleSave();
+    
     saveGlobalSettings();
+    
+    preloadProfiles();
+    
+    ensureProfilesDirectoryExists();
+    m_profileWatcher = std::make_unique<ProfileWatcher>(getProfilesDirectory());
+    connect(m_profileWatcher.get(), &ProfileWatcher::profileChanged, this, &Config::onProfileFileChanged);
+    connect(m_profileWatcher.get(), &ProfileWatcher::profileRemoved, this, &Config::onProfileFileRemoved);
 }
 
 Config::~Config()
 {
+    m_profileWatcher.reset();
+    m_syncer.reset();
     save();
 }
 
@@ -44,83 +107,208 @@ Config& Config::instance()
     return instance;
 }
 
-void Config::refreshCache() const
+void Config::setBaseDirectory(const QString& path)
+{
+    s_baseDirectory = path;
+}
+
+constexpr bool Config::schemaInSettingOrder()
+{
+    for (int i = 0; i < SETTING_COUNT; ++i) {
+        if (SCHEMA[i].id != static_cast<Setting>(i) || SCHEMA[i].path == nullptr) {
+            return false;
+        }
+    }
+    return true;
+}
+
+QVariant Config::defaultValue(const SettingSpec& spec)
+{
+    if (spec.resolveDefault) {
+        return spec.resolveDefault();
+    }
+    
+    switch (spec.type) {
+    case ConfigValueType::Bool:
+        return spec.number != 0;
+    case ConfigValueType::Int:
+        return spec.number;
+    case ConfigValueType::String:
+        return QString(spec.text);
+    case ConfigValueType::StringList:
+        return spec.text ? QString(spec.text).split(',', Qt::SkipEmptyParts) : QStringList();
+    case ConfigValueType::Color:
+        return QColor(spec.text);
+    case ConfigValueType::Font: {
+        QFont font(spec.text, spec.number);
+        font.setBold(spec.extra != 0);
+        return font;
+    }
+    case ConfigValueType::Point:
+        return QPoint(spec.number, spec.extra);
+    }
+    return QVariant();
+}
+
+// Converts whatever QSettings or a setter handed us into exactly the type
+// ConfigValueTraits names, so settingValue() never has to convert on read
+QVariant Config::normalizeValue(const SettingSpec& spec, const QVariant& value)
+{
+    switch (spec.type) {
+    case ConfigValueType::Bool:
+        return value.toBool();
+    case ConfigValueType::Int: {
+        int number = value.toInt();
+        if (spec.minimum < spec.maximum) {
+            number = qBound(spec.minimum, number, spec.maximum);
+        }
+        return number;
+    }
+    case ConfigValueType::String:
+        return value.toString();
+    case ConfigValueType::StringList:
+        return value.toStringList();
+    case ConfigValueType::Color:
+        // Colors are persisted by name, which drops alpha
+        return QColor(value.typeId() == QMetaType::QColor ? value.value<QColor>().name() : value.toString());
+    case ConfigValueType::Font: {
+        if (value.typeId() == QMetaType::QFont) {
+            return value;
+        }
+        QFont font = defaultValue(spec).value<QFont>();
+        font.fromString(value.toString());
+        return font;
+    }
+    case ConfigValueType::Point:
+        return value.toPoint();
+    }
+    return value;
+}
+
+QVariant Config::storedValue(const SettingSpec& spec, const QVariant& value)
+{
+    switch (spec.type) {
+    case ConfigValueType::Color:
+        return value.value<QColor>().name();
+    case ConfigValueType::Font:
+        return value.value<QFont>().toString();
+    default:
+        return value;
+    }
+}
+
+void Config::writeDefaults(QSettings& settings)
+{
+    settings.setValue(KEY_CONFIG_VERSION, CONFIG_VERSION);
+    settings.setValue(KEY_PROFILE_SCHEMA_VERSION, PROFILE_SCHEMA_VERSION);
+    
+    for (const SettingSpec& spec : SCHEMA) {
+        // Machine-dependent defaults such as log directories are resolved on load
+        if (spec.resolveDefault) {
+            continue;
+        }
+        settings.setValue(spec.path, storedValue(spec, defaultValue(spec)));
+    }
+}
+
+template <Config::Setting S>
+Config::SettingValue<S> Config::settingValue() const
 {
-    if (m_cacheValid) {
+    SnapshotPtr snapshot = m_snapshot.load(std::memory_order_acquire);
+    return std::get<static_cast<int>(S)>(snapshot->values);
+}
+
+Config::Values Config::values() const
+{
+    return Values(m_snapshot.load(std::memory_order_acquire));
+}
+
+template <Config::Setting S>
+void Config::setSettingValue(const SettingValue<S>& value)
+{
+    assertOwnerThread();
+    const SettingSpec& spec = SCHEMA[static_cast<int>(S)];
+    SettingValue<S> normalized = normalizeValue(spec, QVariant::fromValue(value)).template value<SettingValue<S>>();
+    SnapshotPtr current = m_snapshot.load(std::memory_order_acquire);
+    if (std::get<static_cast<int>(S)>(current->values) == normalized) {
         return;
     }
     
-    m_cachedHighlightActive = m_settings->value(KEY_UI_HIGHLIGHT_ACTIVE, DEFAULT_UI_HIGHLIGHT_ACTIVE).toBool();
-    m_cachedHideActiveThumbnail = m_settings->value(KEY_UI_HIDE_ACTIVE_THUMBNAIL, DEFAULT_UI_HIDE_ACTIVE_THUMBNAIL).toBool();
-    m_cachedHighlightColor = QColor(m_settings->value(KEY_UI_HIGHLIGHT_COLOR, DEFAULT_UI_HIGHLIGHT_COLOR).toString());
-    m_cachedHighlightBorderWidth = m_settings->value(KEY_UI_HIGHLIGHT_BORDER_WIDTH, DEFAULT_UI_HIGHLIGHT_BORDER_WIDTH).toInt();
-    
-    m_cachedThumbnailWidth = m_settings->value(KEY_THUMBNAIL_WIDTH, DEFAULT_THUMBNAIL_WIDTH).toInt();
-    m_cachedThumbnailHeight = m_settings->value(KEY_THUMBNAIL_HEIGHT, DEFAULT_THUMBNAIL_HEIGHT).toInt();
-    m_cachedRefreshInterval = m_settings->value(KEY_THUMBNAIL_REFRESH_INTERVAL, DEFAULT_THUMBNAIL_REFRESH_INTERVAL).toInt();
-    m_cachedThumbnailOpacity = qBound(OPACITY_MIN, m_settings->value(KEY_THUMBNAIL_OPACITY, DEFAULT_THUMBNAIL_OPACITY).toInt(), OPACITY_MAX);
-    
-    m_cachedShowNotLoggedIn = m_settings->value(KEY_THUMBNAIL_SHOW_NOT_LOGGED_IN, DEFAULT_THUMBNAIL_SHOW_NOT_LOGGED_IN).toBool();
-    m_cachedNotLoggedInStackMode = m_settings->value(KEY_THUMBNAIL_NOT_LOGGED_IN_STACK_MODE, DEFAULT_THUMBNAIL_NOT_LOGGED_IN_STACK_MODE).toInt();
-    m_cachedNotLoggedInReferencePosition = m_settings->value(KEY_THUMBNAIL_NOT_LOGGED_IN_REF_POSITION, 
-        QPoint(DEFAULT_THUMBNAIL_NOT_LOGGED_IN_REF_X, DEFAULT_THUMBNAIL_NOT_LOGGED_IN_REF_Y)).toPoint();
-    m_cachedShowNotLoggedInOverlay = m_settings->value(KEY_THUMBNAIL_SHOW_NOT_LOGGED_IN_OVERLAY, DEFAULT_THUMBNAIL_SHOW_NOT_LOGGED_IN_OVERLAY).toBool();
-    m_cachedShowNonEVEOverlay = m_settings->value(KEY_THUMBNAIL_SHOW_NON_EVE_OVERLAY, DEFAULT_THUMBNAIL_SHOW_NON_EVE_OVERLAY).toBool();
-    
-    QStringList defaultProcessNames;
-    defaultProcessNames << DEFAULT_THUMBNAIL_PROCESS_NAME;
-    m_cachedProcessNames = m_settings->value(KEY_THUMBNAIL_PROCESS_NAMES, defaultProcessNames).toStringList();
-    
-    m_cachedAlwaysOnTop = m_settings->value(KEY_WINDOW_ALWAYS_ON_TOP, DEFAULT_WINDOW_ALWAYS_ON_TOP).toBool();
-    m_cachedMinimizeInactive = m_settings->value(KEY_WINDOW_MINIMIZE_INACTIVE, DEFAULT_WINDOW_MINIMIZE_INACTIVE).toBool();
-    m_cachedMinimizeDelay = m_settings->value(KEY_WINDOW_MINIMIZE_DELAY, DEFAULT_WINDOW_MINIMIZE_DELAY).toInt();
-    m_cachedNeverMinimizeCharacters = m_settings->value(KEY_WINDOW_NEVER_MINIMIZE_CHARACTERS, QStringList()).toStringList();
-    m_cachedSaveClientLocation = m_settings->value(KEY_WINDOW_SAVE_CLIENT_LOCATION, DEFAULT_WINDOW_SAVE_CLIENT_LOCATION).toBool();
-    
-    m_cachedRememberPositions = m_settings->value(KEY_POSITION_REMEMBER, DEFAULT_POSITION_REMEMBER).toBool();
-    m_cachedPreserveLogoutPositions = m_settings->value(KEY_POSITION_PRESERVE_LOGOUT, DEFAULT_POSITION_PRESERVE_LOGOUT).toBool();
-    m_cachedEnableSnapping = m_settings->value(KEY_POSITION_ENABLE_SNAPPING, DEFAULT_POSITION_ENABLE_SNAPPING).toBool();
-    m_cachedSnapDistance = m_settings->value(KEY_POSITION_SNAP_DISTANCE, DEFAULT_POSITION_SNAP_DISTANCE).toInt();
-    m_cachedLockPositions = m_settings->value(KEY_POSITION_LOCK, DEFAULT_POSITION_LOCK).toBool();
-    
-    m_cachedWildcardHotkeys = m_settings->value(KEY_HOTKEY_WILDCARD, DEFAULT_HOTKEY_WILDCARD).toBool();
-    m_cachedHotkeysOnlyWhenEVEFocused = m_settings->value(KEY_HOTKEY_ONLY_WHEN_EVE_FOCUSED, DEFAULT_HOTKEY_ONLY_WHEN_EVE_FOCUSED).toBool();
-    
-    m_cachedShowCharacterName = m_settings->value(KEY_OVERLAY_SHOW_CHARACTER, DEFAULT_OVERLAY_SHOW_CHARACTER).toBool();
-    m_cachedCharacterNameColor = QColor(m_settings->value(KEY_OVERLAY_CHARACTER_COLOR, DEFAULT_OVERLAY_CHARACTER_COLOR).toString());
-    m_cachedCharacterNamePosition = m_settings->value(KEY_OVERLAY_CHARACTER_POSITION, DEFAULT_OVERLAY_CHARACTER_POSITION).toInt();
-    QFont defaultCharFont(DEFAULT_OVERLAY_FONT_FAMILY, DEFAULT_OVERLAY_FONT_SIZE);
-    m_cachedCharacterNameFont.fromString(m_settings->value(KEY_OVERLAY_CHARACTER_FONT, defaultCharFont.toString()).toString());
-    
-    m_cachedShowSystemName = m_settings->value(KEY_OVERLAY_SHOW_SYSTEM, DEFAULT_OVERLAY_SHOW_SYSTEM).toBool();
-    m_cachedSystemNameColor = QColor(m_settings->value(KEY_OVERLAY_SYSTEM_COLOR, DEFAULT_OVERLAY_SYSTEM_COLOR).toString());
-    m_cachedSystemNamePosition = m_settings->value(KEY_OVERLAY_SYSTEM_POSITION, DEFAULT_OVERLAY_SYSTEM_POSITION).toInt();
-    QFont defaultSysFont(DEFAULT_OVERLAY_FONT_FAMILY, DEFAULT_OVERLAY_FONT_SIZE);
-    m_cachedSystemNameFont.fromString(m_settings->value(KEY_OVERLAY_SYSTEM_FONT, defaultSysFont.toString()).toString());
-    
-    m_cachedShowOverlayBackground = m_settings->value(KEY_OVERLAY_SHOW_BACKGROUND, DEFAULT_OVERLAY_SHOW_BACKGROUND).toBool();
-    m_cachedOverlayBackgroundColor = QColor(m_settings->value(KEY_OVERLAY_BACKGROUND_COLOR, DEFAULT_OVERLAY_BACKGROUND_COLOR).toString());
-    m_cachedOverlayBackgroundOpacity = qBound(OPACITY_MIN, m_settings->value(KEY_OVERLAY_BACKGROUND_OPACITY, DEFAULT_OVERLAY_BACKGROUND_OPACITY).toInt(), OPACITY_MAX);
-    
-    QFont defaultFont(DEFAULT_OVERLAY_FONT_FAMILY, DEFAULT_OVERLAY_FONT_SIZE);
-    m_cachedOverlayFont.fromString(m_settings->value(KEY_OVERLAY_FONT, defaultFont.toString()).toString());
-    
-    m_cachedEnableChatLogMonitoring = m_settings->value(KEY_CHATLOG_ENABLE_MONITORING, DEFAULT_CHATLOG_ENABLE_MONITORING).toBool();
-    m_cachedChatLogDirectory = m_settings->value(KEY_CHATLOG_DIRECTORY, getDefaultChatLogDirectory()).toString();
-    m_cachedEnableGameLogMonitoring = m_settings->value(KEY_GAMELOG_ENABLE_MONITORING, DEFAULT_GAMELOG_ENABLE_MONITORING).toBool();
-    m_cachedGameLogDirectory = m_settings->value(KEY_GAMELOG_DIRECTORY, getDefaultGameLogDirectory()).toString();
-    m_cachedFileChangeDebounceMs = m_settings->value(KEY_CHATLOG_FILEDEBOUNCE_MS, DEFAULT_CHATLOG_FILEDEBOUNCE_MS).toInt();
-    
-    m_cachedShowCombatMessages = m_settings->value(KEY_COMBAT_ENABLED, DEFAULT_COMBAT_MESSAGES_ENABLED).toBool();
-    m_cachedCombatMessagePosition = m_settings->value(KEY_COMBAT_POSITION, DEFAULT_COMBAT_MESSAGE_POSITION).toInt();
-    QFont defaultCombatFont(DEFAULT_OVERLAY_FONT_FAMILY, DEFAULT_OVERLAY_FONT_SIZE);
-    defaultCombatFont.setBold(true);
-    m_cachedCombatMessageFont = m_settings->value(KEY_COMBAT_FONT, defaultCombatFont).value<QFont>();
+    m_settings->setValue(spec.path, storedValue(spec, QVariant::fromValue(normalized)));
+    scheduleSave();
+    
+    auto next = std::make_shared<ProfileSnapshot>(*current);
+    std::get<static_cast<int>(S)>(next->values) = std::move(normalized);
+    m_snapshot.store(std::move(next), std::memory_order_release);
+    
+    noteChange(S);
+}
+
+namespace {
+
+template <typename Tuple, typename Function, std::size_t... I>
+void forEachSlot(Tuple& values, Function&& function, std::index_sequence<I...>)
+{
+    (function(int(I), std::get<I>(values)), ...);
+}
+
+template <typename Tuple, std::size_t... I>
+Config::SettingSet differingSlots(const Tuple& before, const Tuple& after, std::index_sequence<I...>)
+{
+    Config::SettingSet changed;
+    ((std::get<I>(before) != std::get<I>(after) ? void(changed.set(I)) : void()), ...);
+    return changed;
+}
+
+}
+
+// Stores a normalized value into the slot at index, returns whether it differed
+bool Config::assignSetting(ProfileSnapshot& snapshot, int index, const QVariant& value)
+{
+    bool changed = false;
+    forEachSlot(snapshot.values, [&](int slotIndex, auto& slot) {
+        using Value = std::decay_t<decltype(slot)>;
+        if (slotIndex != index) {
+            return;
+        }
+        Value typed = value.value<Value>();
+        if (!(slot == typed)) {
+            slot = std::move(typed);
+            changed = true;
+        }
+    }, std::make_index_sequence<SETTING_COUNT>());
+    return changed;
+}
+
+Config::SnapshotPtr Config::buildSnapshot(const QSettings& settings)
+{
+    static_assert(schemaInSettingOrder(), "SCHEMA rows must follow the Setting enum");
+    
+    auto snapshot = std::make_shared<ProfileSnapshot>();
+    for (const SettingSpec& spec : SCHEMA) {
+        QVariant stored = settings.value(spec.path, storedValue(spec, defaultValue(spec)));
+        assignSetting(*snapshot, static_cast<int>(spec.id), normalizeValue(spec, stored));
+    }
+    return snapshot;
+}
+
+Config::SettingSet Config::diffSnapshots(const ProfileSnapshot& before, const ProfileSnapshot& after)
+{
+    return differingSlots(before.values, after.values, std::make_index_sequence<SETTING_COUNT>());
+}
+
+void Config::refreshCombatEventCache() const
+{
+    assertOwnerThread();
+    if (m_validCaches & CombatEventCache) {
+        return;
+    }
     
     m_cachedCombatEventColors.clear();
     m_cachedCombatEventDurations.clear();
     m_cachedCombatEventBorderHighlights.clear();
     QStringList eventTypes = DEFAULT_COMBAT_MESSAGE_EVENT_TYPES();
+    eventTypes.append(INTEL_EVENT_TYPE);
     for (const QString& eventType : eventTypes) {
         QString colorKey = combatEventColorKey(eventType);
         QString defaultColor = DEFAULT_EVENT_COLORS().value(eventType, DEFAULT_COMBAT_MESSAGE_COLOR);
@@ -133,10 +321,16 @@ void Config::refreshCache() const
         m_cachedCombatEventBorderHighlights[eventType] = m_settings->value(borderKey, DEFAULT_COMBAT_EVENT_BORDER_HIGHLIGHT).toBool();
     }
     
-    m_cachedEnabledCombatEventTypes = m_settings->value(KEY_COMBAT_ENABLED_EVENT_TYPES, DEFAULT_COMBAT_MESSAGE_EVENT_TYPES()).toStringList();
-    m_cachedMiningTimeoutSeconds = m_settings->value(KEY_MINING_TIMEOUT_SECONDS, DEFAULT_MINING_TIMEOUT_SECONDS).toInt();
+    m_validCaches |= CombatEventCache;
+}
+
+void Config::refreshBorderColorCache() const
+{
+    assertOwnerThread();
+    if (m_validCaches & BorderColorCache) {
+        return;
+    }
     
-    // Cache character border colors
     m_cachedCharacterBorderColors.clear();
     m_settings->beginGroup("characterBorderColors");
     QStringList characterNames = m_settings->childKeys();
@@ -148,214 +342,239 @@ void Config::refreshCache() const
     }
     m_settings->endGroup();
     
-    // Cache thumbnail positions
-    m_cachedThumbnailPositions.clear();
-    m_settings->beginGroup("thumbnailPositions");
-    QStringList thumbnailCharNames = m_settings->childKeys();
-    for (const QString& characterName : thumbnailCharNames) {
-        QPoint pos = m_settings->value(characterName).toPoint();
-        m_cachedThumbnailPositions[characterName] = pos;
-    }
-    m_settings->endGroup();
-    
-    // Cache client window rects
-    m_cachedClientWindowRects.clear();
-    m_settings->beginGroup("clientWindowRects");
-    QStringList clientCharNames = m_settings->childKeys();
-    for (const QString& characterName : clientCharNames) {
-        QRect rect = m_settings->value(characterName).toRect();
-        if (rect.isValid()) {
-            m_cachedClientWindowRects[characterName] = rect;
-        }
-    }
-    m_settings->endGroup();
-    
-    m_cacheValid = true;
+    m_validCaches |= BorderColorCache;
+}
+
+QPoint Config::readThumbnailPosition(const QString& characterName) const
+{
+    return m_settings->value(QString("thumbnailPositions/%1").arg(characterName), QPoint(-1, -1)).toPoint();
 }
 
-void Config::invalidateCache()
+QRect Config::readClientWindowRect(const QString& characterName) const
 {
-    m_cacheValid = false;
+    QRect rect = m_settings->value(QString("clientWindowRects/%1").arg(characterName)).toRect();
+    return rect.isValid() ? rect : QRect();
+}
+
+void Config::invalidateCache(int groups)
+{
+    m_validCaches &= ~groups;
+    if (groups & ThumbnailPositionCache) {
+        m_cachedThumbnailPositions.clear();
+    }
+    if (groups & ClientRectCache) {
+        m_cachedClientWindowRects.clear();
+    }
 }
 
 int Config::fileChangeDebounceMs() const
 {
-    refreshCache();
-    return m_cachedFileChangeDebounceMs;
+    return settingValue<Setting::FileChangeDebounceMs>();
 }
 
 void Config::setFileChangeDebounceMs(int milliseconds)
 {
-    m_settings->setValue(KEY_CHATLOG_FILEDEBOUNCE_MS, milliseconds);
-    invalidateCache();
+    setSettingValue<Setting::FileChangeDebounceMs>(milliseconds);
+}
+
+QStringList Config::intelChannels() const
+{
+    return settingValue<Setting::IntelChannels>();
+}
+
+void Config::setIntelChannels(const QStringList& channels)
+{
+    setSettingValue<Setting::IntelChannels>(channels);
+}
+
+int Config::intelAlertJumps() const
+{
+    return settingValue<Setting::IntelAlertJumps>();
+}
+
+void Config::setIntelAlertJumps(int jumps)
+{
+    setSettingValue<Setting::IntelAlertJumps>(jumps);
+}
+
+bool Config::showIntelAlerts() const
+{
+    return settingValue<Setting::ShowIntelAlerts>();
+}
+
+void Config::setShowIntelAlerts(bool enabled)
+{
+    setSettingValue<Setting::ShowIntelAlerts>(enabled);
+}
+
+bool Config::enableLogIndexing() const
+{
+    return settingValue<Setting::EnableLogIndexing>();
+}
+
+void Config::setEnableLogIndexing(bool enabled)
+{
+    setSettingValue<Setting::EnableLogIndexing>(enabled);
+}
+
+bool Config::enableDebugLogging() const
+{
+    return settingValue<Setting::EnableDebugLogging>();
+}
+
+void Config::setEnableDebugLogging(bool enabled)
+{
+    setSettingValue<Setting::EnableDebugLogging>(enabled);
+}
+
+bool Config::writeLogToFile() const
+{
+    return settingValue<Setting::WriteLogToFile>();
+}
+
+void Config::setWriteLogToFile(bool enabled)
+{
+    setSettingValue<Setting::WriteLogToFile>(enabled);
 }
 
 bool Config::highlightActiveWindow() const
 {
-    refreshCache();
-    return m_cachedHighlightActive;
+    return settingValue<Setting::HighlightActive>();
 }
 
 void Config::setHighlightActiveWindow(bool enabled)
 {
-    m_settings->setValue(KEY_UI_HIGHLIGHT_ACTIVE, enabled);
-    invalidateCache();
+    setSettingValue<Setting::HighlightActive>(enabled);
 }
 
 bool Config::hideActiveClientThumbnail() const
 {
-    refreshCache();
-    return m_cachedHideActiveThumbnail;
+    return settingValue<Setting::HideActiveThumbnail>();
 }
 
 void Config::setHideActiveClientThumbnail(bool enabled)
 {
-    m_settings->setValue(KEY_UI_HIDE_ACTIVE_THUMBNAIL, enabled);
-    invalidateCache();
+    setSettingValue<Setting::HideActiveThumbnail>(enabled);
 }
 
 QColor Config::highlightColor() const
 {
-    refreshCache();
-    return m_cachedHighlightColor;
+    return settingValue<Setting::HighlightColor>();
 }
 
 void Config::setHighlightColor(const QColor& color)
 {
-    m_settings->setValue(KEY_UI_HIGHLIGHT_COLOR, color.name());
-    invalidateCache();
+    setSettingValue<Setting::HighlightColor>(color);
 }
 
 int Config::highlightBorderWidth() const
 {
-    refreshCache();
-    return m_cachedHighlightBorderWidth;
+    return settingValue<Setting::HighlightBorderWidth>();
 }
 
 void Config::setHighlightBorderWidth(int width)
 {
-    m_settings->setValue(KEY_UI_HIGHLIGHT_BORDER_WIDTH, width);
-    invalidateCache();
+    setSettingValue<Setting::HighlightBorderWidth>(width);
 }
 
 int Config::thumbnailWidth() const
 {
-    refreshCache();
-    return m_cachedThumbnailWidth;
+    return settingValue<Setting::ThumbnailWidth>();
 }
 
 void Config::setThumbnailWidth(int width)
 {
-    m_settings->setValue(KEY_THUMBNAIL_WIDTH, width);
-    invalidateCache();
+    setSettingValue<Setting::ThumbnailWidth>(width);
 }
 
 int Config::thumbnailHeight() const
 {
-    refreshCache();
-    return m_cachedThumbnailHeight;
+    return settingValue<Setting::ThumbnailHeight>();
 }
 
 void Config::setThumbnailHeight(int height)
 {
-    m_settings->setValue(KEY_THUMBNAIL_HEIGHT, height);
-    invalidateCache();
+    setSettingValue<Setting::ThumbnailHeight>(height);
 }
 
 int Config::refreshInterval() const
 {
-    refreshCache();
-    return m_cachedRefreshInterval;
+    return settingValue<Setting::RefreshInterval>();
 }
 
 void Config::setRefreshInterval(int milliseconds)
 {
-    m_settings->setValue(KEY_THUMBNAIL_REFRESH_INTERVAL, milliseconds);
-    invalidateCache();
+    setSettingValue<Setting::RefreshInterval>(milliseconds);
 }
 
 int Config::thumbnailOpacity() const
 {
-    refreshCache();
-    return m_cachedThumbnailOpacity;
+    return settingValue<Setting::ThumbnailOpacity>();
 }
 
 void Config::setThumbnailOpacity(int opacity)
 {
-    m_settings->setValue(KEY_THUMBNAIL_OPACITY, qBound(OPACITY_MIN, opacity, OPACITY_MAX));
-    invalidateCache();
+    setSettingValue<Setting::ThumbnailOpacity>(opacity);
 }
 
 bool Config::showNotLoggedInClients() const
 {
-    refreshCache();
-    return m_cachedShowNotLoggedIn;
+    return settingValue<Setting::ShowNotLoggedIn>();
 }
 
 void Config::setShowNotLoggedInClients(bool enabled)
 {
-    m_settings->setValue(KEY_THUMBNAIL_SHOW_NOT_LOGGED_IN, enabled);
-    invalidateCache();
+    setSettingValue<Setting::ShowNotLoggedIn>(enabled);
 }
 
 int Config::notLoggedInStackMode() const
 {
-    refreshCache();
-    return m_cachedNotLoggedInStackMode;
+    return settingValue<Setting::NotLoggedInStackMode>();
 }
 
 void Config::setNotLoggedInStackMode(int mode)
 {
-    m_settings->setValue(KEY_THUMBNAIL_NOT_LOGGED_IN_STACK_MODE, mode);
-    invalidateCache();
+    setSettingValue<Setting::NotLoggedInStackMode>(mode);
 }
 
 QPoint Config::notLoggedInReferencePosition() const
 {
-    refreshCache();
-    return m_cachedNotLoggedInReferencePosition;
+    return settingValue<Setting::NotLoggedInReferencePosition>();
 }
 
 void Config::setNotLoggedInReferencePosition(const QPoint& pos)
 {
-    m_settings->setValue(KEY_THUMBNAIL_NOT_LOGGED_IN_REF_POSITION, pos);
-    invalidateCache();
+    setSettingValue<Setting::NotLoggedInReferencePosition>(pos);
 }
 
 bool Config::showNotLoggedInOverlay() const
 {
-    refreshCache();
-    return m_cachedShowNotLoggedInOverlay;
+    return settingValue<Setting::ShowNotLoggedInOverlay>();
 }
 
 void Config::setShowNotLoggedInOverlay(bool show)
 {
-    m_settings->setValue(KEY_THUMBNAIL_SHOW_NOT_LOGGED_IN_OVERLAY, show);
-    invalidateCache();
+    setSettingValue<Setting::ShowNotLoggedInOverlay>(show);
 }
 
 bool Config::showNonEVEOverlay() const
 {
-    refreshCache();
-    return m_cachedShowNonEVEOverlay;
+    return settingValue<Setting::ShowNonEVEOverlay>();
 }
 
 void Config::setShowNonEVEOverlay(bool show)
 {
-    m_settings->setValue(KEY_THUMBNAIL_SHOW_NON_EVE_OVERLAY, show);
-    invalidateCache();
+    setSettingValue<Setting::ShowNonEVEOverlay>(show);
 }
 
 QStringList Config::processNames() const
 {
-    refreshCache();
-    return m_cachedProcessNames;
+    return settingValue<Setting::ProcessNames>();
 }
 
 void Config::setProcessNames(const QStringList& names)
 {
-    m_settings->setValue(KEY_THUMBNAIL_PROCESS_NAMES, names);
-    invalidateCache();
+    setSettingValue<Setting::ProcessNames>(names);
 }
 
 void Config::addProcessName(const QString& name)
@@ -376,50 +595,52 @@ void Config::removeProcessName(const QString& name)
 
 bool Config::alwaysOnTop() const
 {
-    refreshCache();
-    return m_cachedAlwaysOnTop;
+    return settingValue<Setting::AlwaysOnTop>();
 }
 
 void Config::setAlwaysOnTop(bool enabled)
 {
-    m_settings->setValue(KEY_WINDOW_ALWAYS_ON_TOP, enabled);
-    invalidateCache();
+    setSettingValue<Setting::AlwaysOnTop>(enabled);
 }
 
 bool Config::minimizeInactiveClients() const
 {
-    refreshCache();
-    return m_cachedMinimizeInactive;
+    return settingValue<Setting::MinimizeInactive>();
 }
 
 void Config::setMinimizeInactiveClients(bool enabled)
 {
-    m_settings->setValue(KEY_WINDOW_MINIMIZE_INACTIVE, enabled);
-    invalidateCache();
+    setSettingValue<Setting::MinimizeInactive>(enabled);
 }
 
 int Config::minimizeDelay() const
 {
-    refreshCache();
-    return m_cachedMinimizeDelay;
+    return settingValue<Setting::MinimizeDelay>();
 }
 
 void Config::setMinimizeDelay(int delayMs)
 {
-    m_settings->setValue(KEY_WINDOW_MINIMIZE_DELAY, delayMs);
-    invalidateCache();
+    setSettingValue<Setting::MinimizeDelay>(delayMs);
+}
+
+int Config::preRestoreCount() const
+{
+    return settingValue<Setting::PreRestoreCount>();
+}
+
+void Config::setPreRestoreCount(int count)
+{
+    setSettingValue<Setting::PreRestoreCount>(count);
 }
 
 QStringList Config::neverMinimizeCharacters() const
 {
-    refreshCache();
-    return m_cachedNeverMinimizeCharacters;
+    return settingValue<Setting::NeverMinimizeCharacters>();
 }
 
 void Config::setNeverMinimizeCharacters(const QStringList& characters)
 {
-    m_settings->setValue(KEY_WINDOW_NEVER_MINIMIZE_CHARACTERS, characters);
-    invalidateCache();
+    setSettingValue<Setting::NeverMinimizeCharacters>(characters);
 }
 
 void Config::addNeverMinimizeCharacter(const QString& characterName)
@@ -446,150 +667,184 @@ bool Config::isCharacterNeverMinimize(const QString& characterName) const
 
 bool Config::saveClientLocation() const
 {
-    refreshCache();
-    return m_cachedSaveClientLocation;
+    return settingValue<Setting::SaveClientLocation>();
 }
 
 void Config::setSaveClientLocation(bool enabled)
 {
-    m_settings->setValue(KEY_WINDOW_SAVE_CLIENT_LOCATION, enabled);
-    invalidateCache();
+    setSettingValue<Setting::SaveClientLocation>(enabled);
 }
 
 QRect Config::getClientWindowRect(const QString& characterName) const
 {
-    refreshCache();
-    return m_cachedClientWindowRects.value(characterName, QRect());
+    assertOwnerThread();
+    if (const QRect* cached = m_cachedClientWindowRects.find(characterName)) {
+        return *cached;
+    }
+    QRect rect = readClientWindowRect(characterName);
+    m_cachedClientWindowRects.insert(characterName, rect);
+    return rect;
 }
 
 void Config::setClientWindowRect(const QString& characterName, const QRect& rect)
 {
+    assertOwnerThread();
     QString key = QString("clientWindowRects/%1").arg(characterName);
     m_settings->setValue(key, rect);
-    invalidateCache();
+    scheduleSave();
+    m_cachedClientWindowRects.insert(characterName, rect.isValid() ? rect : QRect());
 }
 
 bool Config::rememberPositions() const
 {
-    refreshCache();
-    return m_cachedRememberPositions;
+    return settingValue<Setting::RememberPositions>();
 }
 
 void Config::setRememberPositions(bool enabled)
 {
-    m_settings->setValue(KEY_POSITION_REMEMBER, enabled);
-    invalidateCache();
+    setSettingValue<Setting::RememberPositions>(enabled);
 }
 
 bool Config::preserveLogoutPositions() const
 {
-    refreshCache();
-    return m_cachedPreserveLogoutPositions;
+    return settingValue<Setting::PreserveLogoutPositions>();
 }
 
 void Config::setPreserveLogoutPositions(bool enabled)
 {
-    m_settings->setValue(KEY_POSITION_PRESERVE_LOGOUT, enabled);
-    invalidateCache();
+    setSettingValue<Setting::PreserveLogoutPositions>(enabled);
+}
+
+int Config::layoutStrategy() const
+{
+    return settingValue<Setting::LayoutStrategy>();
+}
+
+void Config::setLayoutStrategy(int strategy)
+{
+    setSettingValue<Setting::LayoutStrategy>(strategy);
+}
+
+int Config::layoutGrouping() const
+{
+    return settingValue<Setting::LayoutGrouping>();
+}
+
+void Config::setLayoutGrouping(int grouping)
+{
+    setSettingValue<Setting::LayoutGrouping>(grouping);
 }
 
 QPoint Config::getThumbnailPosition(const QString& characterName) const
 {
-    refreshCache();
-    return m_cachedThumbnailPositions.value(characterName, QPoint(-1, -1));
+    assertOwnerThread();
+    if (const QPoint* cached = m_cachedThumbnailPositions.find(characterName)) {
+        return *cached;
+    }
+    QPoint pos = readThumbnailPosition(characterName);
+    m_cachedThumbnailPositions.insert(characterName, pos);
+    return pos;
 }
 
 void Config::setThumbnailPosition(const QString& characterName, const QPoint& pos)
 {
+    assertOwnerThread();
     QString key = QString("thumbnailPositions/%1").arg(characterName);
     m_settings->setValue(key, pos);
-    invalidateCache();
+    scheduleSave();
+    m_cachedThumbnailPositions.insert(characterName, pos);
 }
 
 QColor Config::getCharacterBorderColor(const QString& characterName) const
 {
-    refreshCache();
+    refreshBorderColorCache();
     return m_cachedCharacterBorderColors.value(characterName, QColor());
 }
 
 void Config::setCharacterBorderColor(const QString& characterName, const QColor& color)
 {
+    refreshBorderColorCache();
+    QColor normalized(color.name());
+    auto it = m_cachedCharacterBorderColors.constFind(characterName);
+    if (it != m_cachedCharacterBorderColors.constEnd() && it.value() == normalized) {
+        return;
+    }
+    
     QString key = QString("characterBorderColors/%1").arg(characterName);
     m_settings->setValue(key, color.name());
-    invalidateCache();
+    scheduleSave();
+    m_cachedCharacterBorderColors.insert(characterName, normalized);
+    noteChange(BorderChanges);
 }
 
 void Config::removeCharacterBorderColor(const QString& characterName)
 {
+    refreshBorderColorCache();
+    if (!m_cachedCharacterBorderColors.contains(characterName)) {
+        return;
+    }
+    
     QString key = QString("characterBorderColors/%1").arg(characterName);
     m_settings->remove(key);
-    invalidateCache();
+    scheduleSave();
+    m_cachedCharacterBorderColors.remove(characterName);
+    noteChange(BorderChanges);
 }
 
 QHash<QString, QColor> Config::getAllCharacterBorderColors() const
 {
-    refreshCache();
+    refreshBorderColorCache();
     return m_cachedCharacterBorderColors;
 }
 
 bool Config::enableSnapping() const
 {
-    refreshCache();
-    return m_cachedEnableSnapping;
+    return settingValue<Setting::EnableSnapping>();
 }
 
 void Config::setEnableSnapping(bool enabled)
 {
-    m_settings->setValue(KEY_POSITION_ENABLE_SNAPPING, enabled);
-    invalidateCache();
+    setSettingValue<Setting::EnableSnapping>(enabled);
 }
 
 int Config::snapDistance() const
 {
-    refreshCache();
-    return m_cachedSnapDistance;
+    return settingValue<Setting::SnapDistance>();
 }
 
 void Config::setSnapDistance(int distance)
 {
-    m_settings->setValue(KEY_POSITION_SNAP_DISTANCE, distance);
-    invalidateCache();
+    setSettingValue<Setting::SnapDistance>(distance);
 }
 
 bool Config::lockThumbnailPositions() const
 {
-    refreshCache();
-    return m_cachedLockPositions;
+    return settingValue<Setting::LockPositions>();
 }
 
 void Config::setLockThumbnailPositions(bool locked)
 {
-    m_settings->setValue(KEY_POSITION_LOCK, locked);
-    invalidateCache();
+    setSettingValue<Setting::LockPositions>(locked);
 }
 
 bool Config::wildcardHotkeys() const
 {
-    refreshCache();
-    return m_cachedWildcardHotkeys;
+    return settingValue<Setting::WildcardHotkeys>();
 }
 
 void Config::setWildcardHotkeys(bool enabled)
 {
-    m_settings->setValue(KEY_HOTKEY_WILDCARD, enabled);
-    invalidateCache();
+    setSettingValue<Setting::WildcardHotkeys>(enabled);
 }
 
 bool Config::hotkeysOnlyWhenEVEFocused() const
 {
-    refreshCache();
-    return m_cachedHotkeysOnlyWhenEVEFocused;
+    return settingValue<Setting::HotkeysOnlyWhenEVEFocused>();
 }
 
 void Config::setHotkeysOnlyWhenEVEFocused(bool enabled)
 {
-    m_settings->setValue(KEY_HOTKEY_ONLY_WHEN_EVE_FOCUSED, enabled);
-    invalidateCache();
+    setSettingValue<Setting::HotkeysOnlyWhenEVEFocused>(enabled);
 }
 
 bool Config::isConfigDialogOpen() const
@@ -604,146 +859,142 @@ void Config::setConfigDialogOpen(bool open)
 
 bool Config::showCharacterName() const
 {
-    refreshCache();
-    return m_cachedShowCharacterName;
+    return settingValue<Setting::ShowCharacterName>();
 }
 
 void Config::setShowCharacterName(bool enabled)
 {
-    m_settings->setValue(KEY_OVERLAY_SHOW_CHARACTER, enabled);
-    invalidateCache();
+    setSettingValue<Setting::ShowCharacterName>(enabled);
 }
 
 QColor Config::characterNameColor() const
 {
-    refreshCache();
-    return m_cachedCharacterNameColor;
+    return settingValue<Setting::CharacterNameColor>();
 }
 
 void Config::setCharacterNameColor(const QColor& color)
 {
-    m_settings->setValue(KEY_OVERLAY_CHARACTER_COLOR, color.name());
-    invalidateCache();
+    setSettingValue<Setting::CharacterNameColor>(color);
 }
 
 int Config::characterNamePosition() const
 {
-    refreshCache();
-    return m_cachedCharacterNamePosition;
+    return settingValue<Setting::CharacterNamePosition>();
 }
 
 void Config::setCharacterNamePosition(int position)
 {
-    m_settings->setValue(KEY_OVERLAY_CHARACTER_POSITION, position);
-    invalidateCache();
+    setSettingValue<Setting::CharacterNamePosition>(position);
 }
 
 bool Config::showSystemName() const
 {
-    refreshCache();
-    return m_cachedShowSystemName;
+    return settingValue<Setting::ShowSystemName>();
 }
 
 void Config::setShowSystemName(bool enabled)
 {
-    m_settings->setValue(KEY_OVERLAY_SHOW_SYSTEM, enabled);
-    invalidateCache();
+    setSettingValue<Setting::ShowSystemName>(enabled);
 }
 
 QColor Config::systemNameColor() const
 {
-    refreshCache();
-    return m_cachedSystemNameColor;
+    return settingValue<Setting::SystemNameColor>();
 }
 
 void Config::setSystemNameColor(const QColor& color)
 {
-    m_settings->setValue(KEY_OVERLAY_SYSTEM_COLOR, color.name());
-    invalidateCache();
+    setSettingValue<Setting::SystemNameColor>(color);
 }
 
 int Config::systemNamePosition() const
 {
-    refreshCache();
-    return m_cachedSystemNamePosition;
+    return settingValue<Setting::SystemNamePosition>();
 }
 
 void Config::setSystemNamePosition(int position)
 {
-    m_settings->setValue(KEY_OVERLAY_SYSTEM_POSITION, position);
-    invalidateCache();
+    setSettingValue<Setting::SystemNamePosition>(position);
+}
+
+bool Config::showJumpDistance() const
+{
+    return settingValue<Setting::ShowJumpDistance>();
+}
+
+void Config::setShowJumpDistance(bool enabled)
+{
+    setSettingValue<Setting::ShowJumpDistance>(enabled);
+}
+
+bool Config::groupThumbnailsByJumpDistance() const
+{
+    return settingValue<Setting::GroupByJumpDistance>();
+}
+
+void Config::setGroupThumbnailsByJumpDistance(bool enabled)
+{
+    setSettingValue<Setting::GroupByJumpDistance>(enabled);
 }
 
 bool Config::showOverlayBackground() const
 {
-    refreshCache();
-    return m_cachedShowOverlayBackground;
+    return settingValue<Setting::ShowOverlayBackground>();
 }
 
 void Config::setShowOverlayBackground(bool enabled)
 {
-    m_settings->setValue(KEY_OVERLAY_SHOW_BACKGROUND, enabled);
-    invalidateCache();
+    setSettingValue<Setting::ShowOverlayBackground>(enabled);
 }
 
 QColor Config::overlayBackgroundColor() const
 {
-    refreshCache();
-    return m_cachedOverlayBackgroundColor;
+    return settingValue<Setting::OverlayBackgroundColor>();
 }
 
 void Config::setOverlayBackgroundColor(const QColor& color)
 {
-    m_settings->setValue(KEY_OVERLAY_BACKGROUND_COLOR, color.name());
-    invalidateCache();
+    setSettingValue<Setting::OverlayBackgroundColor>(color);
 }
 
 int Config::overlayBackgroundOpacity() const
 {
-    refreshCache();
-    return m_cachedOverlayBackgroundOpacity;
+    return settingValue<Setting::OverlayBackgroundOpacity>();
 }
 
 void Config::setOverlayBackgroundOpacity(int opacity)
 {
-    m_settings->setValue(KEY_OVERLAY_BACKGROUND_OPACITY, opacity);
-    invalidateCache();
+    setSettingValue<Setting::OverlayBackgroundOpacity>(opacity);
 }
 
 QFont Config::characterNameFont() const
 {
-    refreshCache();
-    return m_cachedCharacterNameFont;
+    return settingValue<Setting::CharacterNameFont>();
 }
 
 void Config::setCharacterNameFont(const QFont& font)
 {
-    m_settings->setValue(KEY_OVERLAY_CHARACTER_FONT, font.toString());
-    invalidateCache();
+    setSettingValue<Setting::CharacterNameFont>(font);
 }
 
 QFont Config::systemNameFont() const
 {
-    refreshCache();
-    return m_cachedSystemNameFont;
+    return settingValue<Setting::SystemNameFont>();
 }
 
 void Config::setSystemNameFont(const QFont& font)
 {
-    m_settings->setValue(KEY_OVERLAY_SYSTEM_FONT, font.toString());
-    invalidateCache();
+    setSettingValue<Setting::SystemNameFont>(font);
 }
 
 QFont Config::overlayFont() const
 {
-    refreshCache();
-    return m_cachedOverlayFont;
+    return settingValue<Setting::OverlayFont>();
 }
 
 void Config::setOverlayFont(const QFont& font)
 {
-    m_settings->setValue(KEY_OVERLAY_FONT, font.toString());
-    invalidateCache();
+    setSettingValue<Setting::OverlayFont>(font);
 }
 
 QString Config::configFilePath() const
@@ -754,23 +1005,200 @@ QString Config::configFilePath() const
 void Config::save()
 {
     m_settings->sync();
+    noteOwnWrite(m_settings->fileName());
+}
+
+void Config::scheduleSave()
+{
+    if (m_transactionDepth > 0) {
+        m_saveRequested = true;
+        return;
+    }
+    
+    if (!m_syncer) {
+        m_syncer = std::make_unique<ConfigSyncer>();
+        connect(m_syncer.get(), &ConfigSyncer::synced, this,
+                [this](const QString& filePath, const QDateTime& modified, qint64 size) {
+            if (m_profileWatcher) {
+                m_profileWatcher->noteOwnWrite(filePath, modified, size);
+            }
+        });
+    }
+    m_syncer->scheduleSync(m_settings->fileName());
+}
+
+void Config::noteHotkeyBindingsSaved()
+{
+    recordHotkeyBindings();
+    noteOwnWrite(m_settings->fileName());
+}
+
+void Config::recordHotkeyBindings()
+{
+    m_hotkeyBindings.clear();
+    for (const QString& key : m_settings->allKeys()) {
+        if (isHotkeyBindingKey(key)) {
+            m_hotkeyBindings.insert(key, m_settings->value(key));
+        }
+    }
+}
+
+void Config::noteOwnWrite(const QString& filePath)
+{
+    if (m_profileWatcher) {
+        const QFileInfo fileInfo(filePath);
+        m_profileWatcher->noteOwnWrite(filePath, fileInfo.lastModified(), fileInfo.size());
+    }
+}
+
+Config::Transaction::Transaction(Config& config)
+    : m_config(config)
+{
+    ++m_config.m_transactionDepth;
+}
+
+Config::Transaction::~Transaction()
+{
+    if (--m_config.m_transactionDepth > 0) {
+        return;
+    }
+    
+    if (m_config.m_saveRequested) {
+        m_config.m_saveRequested = false;
+        m_config.scheduleSave();
+    }
+    m_config.notifyChanges();
+}
+
+Config::ChangeGroup Config::changeGroup(Setting setting)
+{
+    switch (setting) {
+    case Setting::ThumbnailWidth:
+    case Setting::ThumbnailHeight:
+    case Setting::NotLoggedInStackMode:
+    case Setting::NotLoggedInReferencePosition:
+    case Setting::RememberPositions:
+    case Setting::PreserveLogoutPositions:
+    case Setting::LayoutStrategy:
+    case Setting::LayoutGrouping:
+    case Setting::GroupByJumpDistance:
+        return LayoutChanges;
+    case Setting::HideActiveThumbnail:
+    case Setting::RefreshInterval:
+    case Setting::ThumbnailOpacity:
+    case Setting::AlwaysOnTop:
+        return ThumbnailChanges;
+    case Setting::HighlightActive:
+    case Setting::HighlightColor:
+    case Setting::HighlightBorderWidth:
+        return BorderChanges;
+    case Setting::ShowNotLoggedInOverlay:
+    case Setting::ShowNonEVEOverlay:
+    case Setting::ShowCharacterName:
+    case Setting::CharacterNameColor:
+    case Setting::CharacterNamePosition:
+    case Setting::CharacterNameFont:
+    case Setting::ShowSystemName:
+    case Setting::SystemNameColor:
+    case Setting::SystemNamePosition:
+    case Setting::SystemNameFont:
+    case Setting::ShowJumpDistance:
+    case Setting::ShowOverlayBackground:
+    case Setting::OverlayBackgroundColor:
+    case Setting::OverlayBackgroundOpacity:
+    case Setting::OverlayFont:
+        return OverlayChanges;
+    case Setting::ShowCombatMessages:
+    case Setting::CombatMessagePosition:
+    case Setting::CombatMessageFont:
+    case Setting::EnabledCombatEventTypes:
+    case Setting::MiningTimeoutSeconds:
+    case Setting::ShowIntelAlerts:
+        return CombatMessageChanges;
+    case Setting::ShowNotLoggedIn:
+    case Setting::ProcessNames:
+    case Setting::MinimizeInactive:
+    case Setting::MinimizeDelay:
+    case Setting::PreRestoreCount:
+    case Setting::NeverMinimizeCharacters:
+    case Setting::SaveClientLocation:
+    case Setting::EnableSnapping:
+    case Setting::SnapDistance:
+    case Setting::LockPositions:
+        return WindowBehaviorChanges;
+    case Setting::WildcardHotkeys:
+    case Setting::HotkeysOnlyWhenEVEFocused:
+        return HotkeyChanges;
+    case Setting::EnableChatLogMonitoring:
+    case Setting::ChatLogDirectory:
+    case Setting::EnableGameLogMonitoring:
+    case Setting::GameLogDirectory:
+    case Setting::FileChangeDebounceMs:
+    case Setting::IntelChannels:
+    case Setting::IntelAlertJumps:
+        return LogMonitoringChanges;
+    case Setting::EnableLogIndexing:
+        return LogIndexChanges;
+    case Setting::EnableDebugLogging:
+    case Setting::WriteLogToFile:
+        return DiagnosticsChanges;
+    case Setting::Count:
+        break;
+    }
+    return ProfileChanges;
+}
+
+void Config::noteChange(Setting setting)
+{
+    m_pendingSettings.set(static_cast<size_t>(setting));
+    noteChange(changeGroup(setting));
+}
+
+void Config::noteChange(ChangeGroups groups)
+{
+    assertOwnerThread();
+    m_pendingGroups |= groups;
+    if (m_transactionDepth == 0) {
+        notifyChanges();
+    }
+}
+
+void Config::notifyChanges()
+{
+    if (!m_pendingGroups) {
+        return;
+    }
+    
+    // Clear first so subscribers that write settings start a fresh batch
+    ChangeGroups groups = m_pendingGroups;
+    SettingSet changed = m_pendingSettings;
+    m_pendingGroups = ChangeGroups();
+    m_pendingSettings.reset();
+    
+    emit settingsChanged(groups, changed);
 }
 
 
 QString Config::getProfilesDirectory() const
 {
-    QString exePath = QCoreApplication::applicationDirPath();
+    QString exePath = baseDirectory();
     return exePath + "/profiles";
 }
 
 QString Config::getProfileFilePath(const QString& profileName) const
 {
-    return getProfilesDirectory() + "/" + profileName + ".ini";
+    QString extension = m_binaryProfiles ? ProfileStore::BINARY_EXTENSION : ProfileStore::INI_EXTENSION;
+    return getProfilesDirectory() + "/" + profileName + "." + extension;
+}
+
+QSettings::Format Config::profileFormat() const
+{
+    return m_binaryProfiles ? ProfileStore::binaryFormat() : QSettings::IniFormat;
 }
 
 QString Config::getGlobalSettingsPath() const
 {
-    QString exePath = QCoreApplication::applicationDirPath();
+    QString exePath = baseDirectory();
     return exePath + "/settings.global.ini";
 }
 
@@ -793,6 +1221,11 @@ void Config::loadGlobalSettings()
     m_globalSettings = std::make_unique<QSettings>(globalPath, QSettings::IniFormat);
     
     m_currentProfileName = m_globalSettings->value(KEY_GLOBAL_LAST_USED_PROFILE, DEFAULT_GLOBAL_LAST_USED_PROFILE).toString();
+    m_binaryProfiles = m_globalSettings->value(KEY_GLOBAL_BINARY_PROFILES, DEFAULT_GLOBAL_BINARY_PROFILES).toBool();
+    int cacheLimit = m_globalSettings->value(KEY_GLOBAL_CHARACTER_CACHE_LIMIT, DEFAULT_GLOBAL_CHARACTER_CACHE_LIMIT).toInt();
+    BoundedCacheBase::setDefaultCapacity(qBound(MIN_CHARACTER_CACHE_LIMIT, cacheLimit, MAX_CHARACTER_CACHE_LIMIT));
+    int reconcileSeconds = m_globalSettings->value(KEY_GLOBAL_WINDOW_RECONCILE_SECONDS, DEFAULT_GLOBAL_WINDOW_RECONCILE_SECONDS).toInt();
+    m_windowReconcileSeconds = qBound(MIN_WINDOW_RECONCILE_SECONDS, reconcileSeconds, MAX_WINDOW_RECONCILE_SECONDS);
 }
 
 void Config::saveGlobalSettings()
@@ -805,10 +1238,10 @@ void Config::saveGlobalSettings()
 
 void Config::migrateToProfileSystem()
 {
-    QString exePath = QCoreApplication::applicationDirPath();
+    QString exePath = baseDirectory();
     QString oldSettingsPath = exePath + "/settings.ini";
     QString profilesDir = getProfilesDirectory();
-    QString defaultProfilePath = getProfileFilePath("default");
+    QString defaultProfilePath = profilesDir + "/default." + ProfileStore::INI_EXTENSION;
     
     QFile oldSettingsFile(oldSettingsPath);
     QDir dir;
@@ -841,60 +1274,11 @@ void Config::initializeDefaultProfile()
     ensureProfilesDirectoryExists();
     
     QString defaultProfilePath = getProfileFilePath("default");
-    m_settings = std::make_unique<QSettings>(defaultProfilePath, QSettings::IniFormat);
-    
-    m_settings->setValue(KEY_CONFIG_VERSION, CONFIG_VERSION);
-    
-    m_settings->setValue(KEY_UI_HIGHLIGHT_ACTIVE, DEFAULT_UI_HIGHLIGHT_ACTIVE);
-    m_settings->setValue(KEY_UI_HIDE_ACTIVE_THUMBNAIL, DEFAULT_UI_HIDE_ACTIVE_THUMBNAIL);
-    m_settings->setValue(KEY_UI_HIGHLIGHT_COLOR, DEFAULT_UI_HIGHLIGHT_COLOR);
-    m_settings->setValue(KEY_UI_HIGHLIGHT_BORDER_WIDTH, DEFAULT_UI_HIGHLIGHT_BORDER_WIDTH);
-    
-    m_settings->setValue(KEY_THUMBNAIL_WIDTH, DEFAULT_THUMBNAIL_WIDTH);
-    m_settings->setValue(KEY_THUMBNAIL_HEIGHT, DEFAULT_THUMBNAIL_HEIGHT);
-    m_settings->setValue(KEY_THUMBNAIL_REFRESH_INTERVAL, DEFAULT_THUMBNAIL_REFRESH_INTERVAL);
-    m_settings->setValue(KEY_THUMBNAIL_OPACITY, DEFAULT_THUMBNAIL_OPACITY);
-    
-    QStringList defaultProcessNames;
-    defaultProcessNames << DEFAULT_THUMBNAIL_PROCESS_NAME;
-    m_settings->setValue(KEY_THUMBNAIL_PROCESS_NAMES, defaultProcessNames);
-    m_settings->setValue(KEY_THUMBNAIL_SHOW_NOT_LOGGED_IN, DEFAULT_THUMBNAIL_SHOW_NOT_LOGGED_IN);
-    m_settings->setValue(KEY_THUMBNAIL_NOT_LOGGED_IN_STACK_MODE, DEFAULT_THUMBNAIL_NOT_LOGGED_IN_STACK_MODE);
-    m_settings->setValue(KEY_THUMBNAIL_NOT_LOGGED_IN_REF_POSITION, QPoint(DEFAULT_THUMBNAIL_NOT_LOGGED_IN_REF_X, DEFAULT_THUMBNAIL_NOT_LOGGED_IN_REF_Y));
-    m_settings->setValue(KEY_THUMBNAIL_SHOW_NOT_LOGGED_IN_OVERLAY, DEFAULT_THUMBNAIL_SHOW_NOT_LOGGED_IN_OVERLAY);
-    m_settings->setValue(KEY_THUMBNAIL_SHOW_NON_EVE_OVERLAY, DEFAULT_THUMBNAIL_SHOW_NON_EVE_OVERLAY);
-    
-    m_settings->setValue(KEY_WINDOW_ALWAYS_ON_TOP, DEFAULT_WINDOW_ALWAYS_ON_TOP);
-    m_settings->setValue(KEY_WINDOW_MINIMIZE_INACTIVE, DEFAULT_WINDOW_MINIMIZE_INACTIVE);
-    m_settings->setValue(KEY_WINDOW_MINIMIZE_DELAY, DEFAULT_WINDOW_MINIMIZE_DELAY);
-    
-    m_settings->setValue(KEY_POSITION_REMEMBER, DEFAULT_POSITION_REMEMBER);
-    m_settings->setValue(KEY_POSITION_PRESERVE_LOGOUT, DEFAULT_POSITION_PRESERVE_LOGOUT);
-    m_settings->setValue(KEY_POSITION_ENABLE_SNAPPING, DEFAULT_POSITION_ENABLE_SNAPPING);
-    m_settings->setValue(KEY_POSITION_SNAP_DISTANCE, DEFAULT_POSITION_SNAP_DISTANCE);
-    
-    m_settings->setValue(KEY_OVERLAY_SHOW_CHARACTER, DEFAULT_OVERLAY_SHOW_CHARACTER);
-    m_settings->setValue(KEY_OVERLAY_CHARACTER_COLOR, DEFAULT_OVERLAY_CHARACTER_COLOR);
-    m_settings->setValue(KEY_OVERLAY_CHARACTER_POSITION, DEFAULT_OVERLAY_CHARACTER_POSITION);
-    m_settings->setValue(KEY_OVERLAY_CHARACTER_FONT, QFont(DEFAULT_OVERLAY_FONT_FAMILY, DEFAULT_OVERLAY_FONT_SIZE).toString());
-    m_settings->setValue(KEY_OVERLAY_SHOW_SYSTEM, DEFAULT_OVERLAY_SHOW_SYSTEM);
-    m_settings->setValue(KEY_OVERLAY_SYSTEM_COLOR, DEFAULT_OVERLAY_SYSTEM_COLOR);
-    m_settings->setValue(KEY_OVERLAY_SYSTEM_POSITION, DEFAULT_OVERLAY_SYSTEM_POSITION);
-    m_settings->setValue(KEY_OVERLAY_SYSTEM_FONT, QFont(DEFAULT_OVERLAY_FONT_FAMILY, DEFAULT_OVERLAY_FONT_SIZE).toString());
-    m_settings->setValue(KEY_OVERLAY_SHOW_BACKGROUND, DEFAULT_OVERLAY_SHOW_BACKGROUND);
-    m_settings->setValue(KEY_OVERLAY_BACKGROUND_COLOR, DEFAULT_OVERLAY_BACKGROUND_COLOR);
-    m_settings->setValue(KEY_OVERLAY_BACKGROUND_OPACITY, DEFAULT_OVERLAY_BACKGROUND_OPACITY);
-    m_settings->setValue(KEY_OVERLAY_FONT, QFont(DEFAULT_OVERLAY_FONT_FAMILY, DEFAULT_OVERLAY_FONT_SIZE).toString());
-
-    m_settings->setValue(KEY_COMBAT_ENABLED, DEFAULT_COMBAT_MESSAGES_ENABLED);
-    m_settings->setValue(KEY_COMBAT_DURATION, DEFAULT_COMBAT_MESSAGE_DURATION);
-    m_settings->setValue(KEY_COMBAT_POSITION, DEFAULT_COMBAT_MESSAGE_POSITION);
-    m_settings->setValue(KEY_COMBAT_COLOR, DEFAULT_COMBAT_MESSAGE_COLOR);
-    QFont defaultCombatFont(DEFAULT_OVERLAY_FONT_FAMILY, DEFAULT_OVERLAY_FONT_SIZE);
-    defaultCombatFont.setBold(true);
-    m_settings->setValue(KEY_COMBAT_FONT, defaultCombatFont.toString());
-    m_settings->setValue(KEY_COMBAT_ENABLED_EVENT_TYPES, DEFAULT_COMBAT_MESSAGE_EVENT_TYPES());
-    m_settings->setValue(KEY_MINING_TIMEOUT_SECONDS, DEFAULT_MINING_TIMEOUT_SECONDS);
+    m_settings = std::make_unique<ProfileSettings>(defaultProfilePath, profileFormat());
+    invalidateCache();
+    
+    writeDefaults(*m_settings);
+    m_snapshot.store(buildSnapshot(*m_settings));
     
     m_settings->sync();
     
@@ -912,7 +1296,7 @@ QStringList Config::listProfiles() const
     }
     
     QStringList filters;
-    filters << "*.ini";
+    filters << QString("*.%1").arg(m_binaryProfiles ? ProfileStore::BINARY_EXTENSION : ProfileStore::INI_EXTENSION);
     QFileInfoList fileList = profilesDir.entryInfoList(filters, QDir::Files);
     
     for (const QFileInfo& fileInfo : fileList) {
@@ -938,7 +1322,25 @@ bool Config::profileExists(const QString& profileName) const
     return QFile::exists(profilePath);
 }
 
-void Config::migrateLegacyCombatKeys()
+void Config::migrateProfile(QSettings& settings)
+{
+    int version = settings.value(KEY_PROFILE_SCHEMA_VERSION, 0).toInt();
+    if (version >= PROFILE_SCHEMA_VERSION) {
+        return;
+    }
+    
+    if (version < 1) {
+        migrateLegacyCombatKeys(settings);
+    }
+    if (version < 2) {
+        stampCharacterLastSeen(settings);
+    }
+    
+    settings.setValue(KEY_PROFILE_SCHEMA_VERSION, PROFILE_SCHEMA_VERSION);
+    qDebug() << "Migrated" << settings.fileName() << "from schema version" << version << "to" << PROFILE_SCHEMA_VERSION;
+}
+
+void Config::migrateLegacyCombatKeys(QSettings& settings)
 {
     QPair<const char*, const char*> keys[] = {
         { "CombatMessages/Enabled", KEY_COMBAT_ENABLED },
@@ -952,16 +1354,272 @@ void Config::migrateLegacyCombatKeys()
     for (const auto& pair : keys) {
         const char* oldKey = pair.first;
         const char* newKey = pair.second;
-        if (m_settings->contains(oldKey) && !m_settings->contains(newKey)) {
-            QVariant v = m_settings->value(oldKey);
-            m_settings->setValue(newKey, v);
-            m_settings->remove(oldKey);
+        if (settings.contains(oldKey) && !settings.contains(newKey)) {
+            QVariant v = settings.value(oldKey);
+            settings.setValue(newKey, v);
+            settings.remove(oldKey);
+        }
+    }
+}
+
+void Config::stampCharacterLastSeen(QSettings& settings)
+{
+    // Profiles from before last-seen tracking start their clock today
+    qint64 today = QDate::currentDate().toJulianDay();
+    for (const char* group : { "thumbnailPositions", "clientWindowRects" }) {
+        settings.beginGroup(group);
+        const QStringList characters = settings.childKeys();
+        settings.endGroup();
+        
+        for (const QString& character : characters) {
+            QString key = QString("characterLastSeen/%1").arg(character);
+            if (!settings.contains(key)) {
+                settings.setValue(key, today);
+            }
+        }
+    }
+}
+
+void Config::compactStaleCharacters(QSettings& settings)
+{
+    qint64 cutoff = QDate::currentDate().toJulianDay() - STALE_CHARACTER_DAYS;
+    
+    settings.beginGroup("characterLastSeen");
+    const QStringList characters = settings.childKeys();
+    QStringList stale;
+    for (const QString& character : characters) {
+        if (settings.value(character).toLongLong() < cutoff) {
+            stale.append(character);
+        }
+    }
+    settings.endGroup();
+    
+    // Border colours are picked by hand, so only the recorded geometry goes
+    for (const QString& character : stale) {
+        settings.remove(QString("thumbnailPositions/%1").arg(character));
+        settings.remove(QString("clientWindowRects/%1").arg(character));
+        settings.remove(QString("characterLastSeen/%1").arg(character));
+    }
+    
+    if (!stale.isEmpty()) {
+        qDebug() << "Compacted" << stale.size() << "stale characters from" << settings.fileName();
+    }
+}
+
+void Config::typeSchemaValues(QSettings& settings)
+{
+    // INI stores scalars as text, re-write them typed so the binary store
+    // keeps them in their native sections
+    for (const SettingSpec& spec : SCHEMA) {
+        if (settings.contains(spec.path)) {
+            settings.setValue(spec.path, storedValue(spec, normalizeValue(spec, settings.value(spec.path))));
+        }
+    }
+}
+
+bool Config::convertProfiles()
+{
+    QDir profilesDir(getProfilesDirectory());
+    if (!profilesDir.exists()) {
+        return true;
+    }
+    
+    const char* otherExtension = m_binaryProfiles ? ProfileStore::INI_EXTENSION : ProfileStore::BINARY_EXTENSION;
+    const QFileInfoList fileList = profilesDir.entryInfoList({ QString("*.%1").arg(otherExtension) }, QDir::Files);
+    
+    bool converted = true;
+    for (const QFileInfo& fileInfo : fileList) {
+        QString profileName = fileInfo.completeBaseName();
+        QString targetPath = getProfileFilePath(profileName);
+        if (QFile::exists(targetPath)) {
+            qWarning() << "Profile" << profileName << "exists in both formats, keeping" << targetPath;
+            continue;
+        }
+        
+        bool copied = false;
+        {
+            QSettings source(fileInfo.filePath(), ProfileStore::formatForPath(fileInfo.filePath()));
+            QSettings destination(targetPath, profileFormat());
+            copied = ProfileStore::copySettings(source, destination);
+            if (copied) {
+                typeSchemaValues(destination);
+                destination.sync();
+            }
+        }
+        
+        if (!copied) {
+            QFile::remove(targetPath);
+            converted = false;
+            continue;
+        }
+        
+        QFile::remove(fileInfo.filePath());
+        qDebug() << "Converted profile" << profileName << "to" << targetPath;
+    }
+    
+    return converted;
+}
+
+int Config::characterCacheLimit() const
+{
+    return BoundedCacheBase::defaultCapacity();
+}
+
+void Config::setCharacterCacheLimit(int limit)
+{
+    limit = qBound(MIN_CHARACTER_CACHE_LIMIT, limit, MAX_CHARACTER_CACHE_LIMIT);
+    BoundedCacheBase::setDefaultCapacity(limit);
+    m_globalSettings->setValue(KEY_GLOBAL_CHARACTER_CACHE_LIMIT, limit);
+    m_globalSettings->sync();
+}
+
+int Config::windowReconcileSeconds() const
+{
+    return m_windowReconcileSeconds;
+}
+
+void Config::setWindowReconcileSeconds(int seconds)
+{
+    m_windowReconcileSeconds = qBound(MIN_WINDOW_RECONCILE_SECONDS, seconds, MAX_WINDOW_RECONCILE_SECONDS);
+    m_globalSettings->setValue(KEY_GLOBAL_WINDOW_RECONCILE_SECONDS, m_windowReconcileSeconds);
+    m_globalSettings->sync();
+}
+
+bool Config::useBinaryProfiles() const
+{
+    return m_binaryProfiles;
+}
+
+bool Config::setUseBinaryProfiles(bool enabled)
+{
+    if (enabled == m_binaryProfiles) {
+        return true;
+    }
+    
+    // Every open profile has to be written out and closed before its file
+    // is converted, the current one is reopened from the new file afterwards
+    m_syncer.reset();
+    m_preloadedProfiles.clear();
+    if (m_settings) {
+        m_settings->sync();
+        m_settings.reset();
+    }
+    
+    m_binaryProfiles = enabled;
+    bool converted = convertProfiles();
+    if (!converted) {
+        qWarning() << "Failed to convert profiles, staying with the previous format";
+        m_binaryProfiles = !enabled;
+        convertProfiles();
+    }
+    
+    m_globalSettings->setValue(KEY_GLOBAL_BINARY_PROFILES, m_binaryProfiles);
+    m_globalSettings->sync();
+    
+    m_settings = std::make_unique<ProfileSettings>(getProfileFilePath(m_currentProfileName), profileFormat());
+    invalidateCache();
+    recordHotkeyBindings();
+    preloadProfiles();
+    
+    qDebug() << "Profiles now stored as" << (m_binaryProfiles ? "binary" : "INI");
+    return converted;
+}
+
+bool Config::exportProfileToIni(const QString& profileName, const QString& filePath) const
+{
+    if (!profileExists(profileName)) {
+        qWarning() << "Cannot export profile, it does not exist:" << profileName;
+        return false;
+    }
+    
+    // Opening the same path shares the in-memory store, so unsaved edits export too
+    QSettings source(getProfileFilePath(profileName), profileFormat());
+    QSettings destination(filePath, QSettings::IniFormat);
+    if (!ProfileStore::copySettings(source, destination)) {
+        return false;
+    }
+    
+    qDebug() << "Exported profile" << profileName << "to" << filePath;
+    return true;
+}
+
+bool Config::importProfileFromIni(const QString& filePath, const QString& profileName)
+{
+    if (profileName.isEmpty() || profileExists(profileName)) {
+        qWarning() << "Cannot import profile, invalid or existing name:" << profileName;
+        return false;
+    }
+    
+    if (!QFile::exists(filePath)) {
+        qWarning() << "Cannot import profile, file does not exist:" << filePath;
+        return false;
+    }
+    
+    ensureProfilesDirectoryExists();
+    
+    QString profilePath = getProfileFilePath(profileName);
+    bool copied = false;
+    {
+        QSettings source(filePath, QSettings::IniFormat);
+        QSettings destination(profilePath, profileFormat());
+        copied = ProfileStore::copySettings(source, destination);
+        if (copied) {
+            typeSchemaValues(destination);
+            destination.sync();
         }
     }
+    
+    if (!copied) {
+        QFile::remove(profilePath);
+        return false;
+    }
+    
+    // Parsing runs the schema migrations, so older exports import cleanly
+    m_preloadedProfiles[profileName] = parseProfile(profileName);
+    
+    qDebug() << "Imported profile" << profileName << "from" << filePath;
+    return true;
+}
+
+void Config::markCharacterSeen(const QString& characterName)
+{
+    assertOwnerThread();
+    if (characterName.isEmpty() || m_seenCharacters.contains(characterName)) {
+        return;
+    }
+    m_seenCharacters.insert(characterName);
+    
+    QString key = QString("characterLastSeen/%1").arg(characterName);
+    qint64 today = QDate::currentDate().toJulianDay();
+    if (m_settings->value(key).toLongLong() != today) {
+        m_settings->setValue(key, today);
+        scheduleSave();
+    }
+}
+
+Config::PreloadedProfile Config::parseProfile(const QString& profileName) const
+{
+    PreloadedProfile profile;
+    profile.settings = std::make_unique<ProfileSettings>(getProfileFilePath(profileName), profileFormat());
+    migrateProfile(*profile.settings);
+    compactStaleCharacters(*profile.settings);
+    profile.snapshot = buildSnapshot(*profile.settings);
+    return profile;
+}
+
+void Config::preloadProfiles()
+{
+    for (const QString& profileName : listProfiles()) {
+        if (profileName == m_currentProfileName || m_preloadedProfiles.count(profileName)) {
+            continue;
+        }
+        m_preloadedProfiles[profileName] = parseProfile(profileName);
+    }
 }
 
 bool Config::loadProfile(const QString& profileName)
 {
+    assertOwnerThread();
     if (profileName.isEmpty()) {
         qWarning() << "Cannot load profile: empty profile name";
         return false;
@@ -972,24 +1630,243 @@ bool Config::loadProfile(const QString& profileName)
         return false;
     }
     
+    QElapsedTimer timer;
+    timer.start();
+    
+    SnapshotPtr previous = m_snapshot.load();
+    const QString previousProfileName = m_currentProfileName;
+    const QSettings* previousSettings = m_settings.get();
+    QHash<QString, QColor> previousBorderColors;
+    QMap<QString, QColor> previousEventColors;
+    QMap<QString, int> previousEventDurations;
+    QMap<QString, bool> previousEventBorderHighlights;
     if (m_settings) {
-        m_settings->sync();
+        refreshBorderColorCache();
+        refreshCombatEventCache();
+        previousBorderColors = m_cachedCharacterBorderColors;
+        previousEventColors = m_cachedCombatEventColors;
+        previousEventDurations = m_cachedCombatEventDurations;
+        previousEventBorderHighlights = m_cachedCombatEventBorderHighlights;
+        
+        // The outgoing profile stays parsed so switching back is just as cheap,
+        // its pending writes go out through the write-behind syncer
+        scheduleSave();
+        m_preloadedProfiles[m_currentProfileName] = PreloadedProfile{ std::move(m_settings), previous };
     }
     
-    QString profilePath = getProfileFilePath(profileName);
-    m_settings = std::make_unique<QSettings>(profilePath, QSettings::IniFormat);
+    PreloadedProfile next;
+    auto it = m_preloadedProfiles.find(profileName);
+    if (it != m_preloadedProfiles.end()) {
+        next = std::move(it->second);
+        m_preloadedProfiles.erase(it);
+    } else {
+        next = parseProfile(profileName);
+    }
+    
+    m_settings = std::move(next.settings);
+    m_snapshot.store(next.snapshot);
     m_currentProfileName = profileName;
+    m_seenCharacters.clear();
     
-    migrateLegacyCombatKeys();
-
     invalidateCache();
     
+    // Scalars are diffed through the snapshots. Positions, client rects and
+    // key bindings are compared key by key, so switching between profiles
+    // that share a layout or bindings re-applies neither.
+    SettingSet changed = previous ? diffSnapshots(*previous, *next.snapshot) : SettingSet().set();
+    ChangeGroups groups;
+    if (profileName != previousProfileName) {
+        groups |= ProfileChanges;
+    }
+    if (!previousSettings || entriesDiffer(*previousSettings, *m_settings, isLayoutKey)) {
+        groups |= LayoutChanges;
+    }
+    if (!previousSettings || entriesDiffer(*previousSettings, *m_settings, isHotkeyBindingKey)) {
+        groups |= HotkeyBindingChanges;
+    }
+    recordHotkeyBindings();
+    for (int i = 0; i < SETTING_COUNT; ++i) {
+        if (changed.test(i)) {
+            groups |= changeGroup(static_cast<Setting>(i));
+        }
+    }
+    
+    refreshBorderColorCache();
+    refreshCombatEventCache();
+    if (m_cachedCharacterBorderColors != previousBorderColors ||
+        m_cachedCombatEventBorderHighlights != previousEventBorderHighlights) {
+        groups |= BorderChanges;
+    }
+    if (m_cachedCombatEventColors != previousEventColors ||
+        m_cachedCombatEventDurations != previousEventDurations) {
+        groups |= CombatMessageChanges;
+    }
+    
     saveGlobalSettings();
     
-    qDebug() << "Loaded profile:" << profileName;
+    qDebug() << "Loaded profile:" << profileName << "in" << timer.elapsed() << "ms";
+    
+    m_pendingSettings |= changed;
+    noteChange(groups);
     return true;
 }
 
+void Config::onProfileFileChanged(const QString& filePath, const QStringList& changedKeys, qint64 elapsedMs)
+{
+    if (changedKeys.isEmpty() || ProfileStore::formatForPath(filePath) != profileFormat()) {
+        return;
+    }
+    
+    QString profileName = QFileInfo(filePath).completeBaseName();
+    if (!m_settings || filePath != m_settings->fileName()) {
+        // Other profiles only need a fresh snapshot for the next switch
+        auto it = m_preloadedProfiles.find(profileName);
+        if (it != m_preloadedProfiles.end()) {
+            it->second.settings->sync();
+            it->second.snapshot = buildSnapshot(*it->second.settings);
+        } else if (profileName != m_currentProfileName) {
+            m_preloadedProfiles[profileName] = parseProfile(profileName);
+        }
+        return;
+    }
+    
+    QElapsedTimer timer;
+    timer.start();
+    
+    // The worker reads the file on its own, syncing here on the owner thread
+    // merges the edit into the store our QSettings share
+    save();
+    
+    // The worker also reports keys we saved ourselves, so every key is
+    // compared against the live snapshot and caches before it counts
+    SnapshotPtr previous = m_snapshot.load();
+    auto next = std::make_shared<ProfileSnapshot>(*previous);
+    SettingSet changed;
+    QStringList changedSettings;
+    int staleCaches = 0;
+    bool hotkeysChanged = false;
+    
+    for (const QString& key : changedKeys) {
+        auto spec = std::find_if(std::begin(SCHEMA), std::end(SCHEMA), [&key](const SettingSpec& candidate) {
+            return key == QLatin1String(candidate.path);
+        });
+        if (spec != std::end(SCHEMA)) {
+            int index = static_cast<int>(spec->id);
+            QVariant stored = m_settings->value(spec->path, storedValue(*spec, defaultValue(*spec)));
+            if (assignSetting(*next, index, normalizeValue(*spec, stored))) {
+                changed.set(index);
+                changedSettings.append(key);
+            }
+            continue;
+        }
+        
+        QString group = key.section('/', 0, 0);
+        if (group == "characterBorderColors") {
+            staleCaches |= BorderColorCache;
+        } else if (group == "thumbnailPositions") {
+            staleCaches |= ThumbnailPositionCache;
+        } else if (group == "clientWindowRects") {
+            staleCaches |= ClientRectCache;
+        } else if (key.startsWith("combatMessages/eventColors/") ||
+                   key.startsWith("combatMessages/eventDurations/") ||
+                   key.startsWith("combatMessages/borderHighlights/")) {
+            staleCaches |= CombatEventCache;
+        } else if (isHotkeyBindingKey(key)) {
+            // Compared with what HotkeyManager last loaded or saved, like the scalars above
+            QVariant current = m_settings->value(key);
+            auto known = m_hotkeyBindings.constFind(key);
+            if (known == m_hotkeyBindings.constEnd() ? current.isValid() : known.value() != current) {
+                hotkeysChanged = true;
+            }
+        }
+    }
+    
+    ChangeGroups groups;
+    for (int i = 0; i < SETTING_COUNT; ++i) {
+        if (changed.test(i)) {
+            groups |= changeGroup(static_cast<Setting>(i));
+        }
+    }
+    if (hotkeysChanged) {
+        recordHotkeyBindings();
+        groups |= HotkeyBindingChanges;
+    }
+    
+    // A cache that was never loaded has nothing to compare against
+    if (staleCaches & BorderColorCache) {
+        bool wasLoaded = m_validCaches & BorderColorCache;
+        QHash<QString, QColor> previousColors = m_cachedCharacterBorderColors;
+        invalidateCache(BorderColorCache);
+        refreshBorderColorCache();
+        if (!wasLoaded || previousColors != m_cachedCharacterBorderColors) {
+            groups |= BorderChanges;
+        }
+    }
+    
+    // Positions and rects are read through, only the ones looked up so far
+    // can be on screen or stale. A cache that still matches the file is kept.
+    if (staleCaches & ThumbnailPositionCache) {
+        bool moved = std::any_of(m_cachedThumbnailPositions.begin(), m_cachedThumbnailPositions.end(), [this](const auto& entry) {
+            return readThumbnailPosition(entry.first) != entry.second;
+        });
+        if (moved) {
+            groups |= LayoutChanges;
+            invalidateCache(ThumbnailPositionCache);
+        }
+    }
+    if (staleCaches & ClientRectCache) {
+        bool moved = std::any_of(m_cachedClientWindowRects.begin(), m_cachedClientWindowRects.end(), [this](const auto& entry) {
+            return readClientWindowRect(entry.first) != entry.second;
+        });
+        if (moved) {
+            groups |= LayoutChanges;
+            invalidateCache(ClientRectCache);
+        }
+    }
+    if (staleCaches & CombatEventCache) {
+        bool wasLoaded = m_validCaches & CombatEventCache;
+        QMap<QString, QColor> previousColors = m_cachedCombatEventColors;
+        QMap<QString, int> previousDurations = m_cachedCombatEventDurations;
+        QMap<QString, bool> previousHighlights = m_cachedCombatEventBorderHighlights;
+        invalidateCache(CombatEventCache);
+        refreshCombatEventCache();
+        if (!wasLoaded || previousColors != m_cachedCombatEventColors ||
+            previousDurations != m_cachedCombatEventDurations) {
+            groups |= CombatMessageChanges;
+        }
+        if (!wasLoaded || previousHighlights != m_cachedCombatEventBorderHighlights) {
+            groups |= BorderChanges;
+        }
+    }
+    
+    if (!groups) {
+        return;
+    }
+    
+    if (changed.any()) {
+        m_snapshot.store(std::move(next), std::memory_order_release);
+    }
+    
+    qDebug() << "Reloaded profile" << profileName << "after an external change:" << changedKeys.size() << "keys differed,"
+             << changed.count() << "settings applied, groups" << groups << "- read in" << elapsedMs << "ms, applied in" << timer.elapsed() << "ms";
+    if (!changedSettings.isEmpty()) {
+        qDebug() << "Changed settings:" << changedSettings;
+    }
+    
+    m_pendingSettings |= changed;
+    noteChange(groups);
+}
+
+void Config::onProfileFileRemoved(const QString& filePath)
+{
+    QString profileName = QFileInfo(filePath).completeBaseName();
+    if (ProfileStore::formatForPath(filePath) != profileFormat() || profileName == m_currentProfileName) {
+        return;
+    }
+    
+    m_preloadedProfiles.erase(profileName);
+}
+
 bool Config::createProfile(const QString& profileName, bool useDefaults)
 {
     if (profileName.isEmpty()) {
@@ -1005,64 +1882,14 @@ bool Config::createProfile(const QString& profileName, bool useDefaults)
     ensureProfilesDirectoryExists();
     
     QString profilePath = getProfileFilePath(profileName);
-    QSettings newProfile(profilePath, QSettings::IniFormat);
+    QSettings newProfile(profilePath, profileFormat());
     
     if (useDefaults) {
-        newProfile.setValue(KEY_CONFIG_VERSION, CONFIG_VERSION);
-
-        newProfile.setValue(KEY_UI_HIGHLIGHT_ACTIVE, DEFAULT_UI_HIGHLIGHT_ACTIVE);
-        newProfile.setValue(KEY_UI_HIDE_ACTIVE_THUMBNAIL, DEFAULT_UI_HIDE_ACTIVE_THUMBNAIL);
-        newProfile.setValue(KEY_UI_HIGHLIGHT_COLOR, DEFAULT_UI_HIGHLIGHT_COLOR);
-        newProfile.setValue(KEY_UI_HIGHLIGHT_BORDER_WIDTH, DEFAULT_UI_HIGHLIGHT_BORDER_WIDTH);
-
-        newProfile.setValue(KEY_THUMBNAIL_WIDTH, DEFAULT_THUMBNAIL_WIDTH);
-        newProfile.setValue(KEY_THUMBNAIL_HEIGHT, DEFAULT_THUMBNAIL_HEIGHT);
-        newProfile.setValue(KEY_THUMBNAIL_REFRESH_INTERVAL, DEFAULT_THUMBNAIL_REFRESH_INTERVAL);
-        newProfile.setValue(KEY_THUMBNAIL_OPACITY, DEFAULT_THUMBNAIL_OPACITY);
-
-        QStringList defaultProcessNames;
-        defaultProcessNames << DEFAULT_THUMBNAIL_PROCESS_NAME;
-        newProfile.setValue(KEY_THUMBNAIL_PROCESS_NAMES, defaultProcessNames);
-        newProfile.setValue(KEY_THUMBNAIL_SHOW_NOT_LOGGED_IN, DEFAULT_THUMBNAIL_SHOW_NOT_LOGGED_IN);
-        newProfile.setValue(KEY_THUMBNAIL_NOT_LOGGED_IN_STACK_MODE, DEFAULT_THUMBNAIL_NOT_LOGGED_IN_STACK_MODE);
-        newProfile.setValue(KEY_THUMBNAIL_NOT_LOGGED_IN_REF_POSITION, QPoint(DEFAULT_THUMBNAIL_NOT_LOGGED_IN_REF_X, DEFAULT_THUMBNAIL_NOT_LOGGED_IN_REF_Y));
-        newProfile.setValue(KEY_THUMBNAIL_SHOW_NOT_LOGGED_IN_OVERLAY, DEFAULT_THUMBNAIL_SHOW_NOT_LOGGED_IN_OVERLAY);
-        newProfile.setValue(KEY_THUMBNAIL_SHOW_NON_EVE_OVERLAY, DEFAULT_THUMBNAIL_SHOW_NON_EVE_OVERLAY);
-
-        newProfile.setValue(KEY_WINDOW_ALWAYS_ON_TOP, DEFAULT_WINDOW_ALWAYS_ON_TOP);
-        newProfile.setValue(KEY_WINDOW_MINIMIZE_INACTIVE, DEFAULT_WINDOW_MINIMIZE_INACTIVE);
-        newProfile.setValue(KEY_WINDOW_MINIMIZE_DELAY, DEFAULT_WINDOW_MINIMIZE_DELAY);
-
-        newProfile.setValue(KEY_POSITION_REMEMBER, DEFAULT_POSITION_REMEMBER);
-        newProfile.setValue(KEY_POSITION_PRESERVE_LOGOUT, DEFAULT_POSITION_PRESERVE_LOGOUT);
-        newProfile.setValue(KEY_POSITION_ENABLE_SNAPPING, DEFAULT_POSITION_ENABLE_SNAPPING);
-        newProfile.setValue(KEY_POSITION_SNAP_DISTANCE, DEFAULT_POSITION_SNAP_DISTANCE);
-
-        newProfile.setValue(KEY_OVERLAY_SHOW_CHARACTER, DEFAULT_OVERLAY_SHOW_CHARACTER);
-        newProfile.setValue(KEY_OVERLAY_CHARACTER_COLOR, DEFAULT_OVERLAY_CHARACTER_COLOR);
-        newProfile.setValue(KEY_OVERLAY_CHARACTER_POSITION, DEFAULT_OVERLAY_CHARACTER_POSITION);
-        newProfile.setValue(KEY_OVERLAY_CHARACTER_FONT, QFont(DEFAULT_OVERLAY_FONT_FAMILY, DEFAULT_OVERLAY_FONT_SIZE).toString());
-        newProfile.setValue(KEY_OVERLAY_SHOW_SYSTEM, DEFAULT_OVERLAY_SHOW_SYSTEM);
-        newProfile.setValue(KEY_OVERLAY_SYSTEM_COLOR, DEFAULT_OVERLAY_SYSTEM_COLOR);
-        newProfile.setValue(KEY_OVERLAY_SYSTEM_POSITION, DEFAULT_OVERLAY_SYSTEM_POSITION);
-        newProfile.setValue(KEY_OVERLAY_SYSTEM_FONT, QFont(DEFAULT_OVERLAY_FONT_FAMILY, DEFAULT_OVERLAY_FONT_SIZE).toString());
-        newProfile.setValue(KEY_OVERLAY_SHOW_BACKGROUND, DEFAULT_OVERLAY_SHOW_BACKGROUND);
-        newProfile.setValue(KEY_OVERLAY_BACKGROUND_COLOR, DEFAULT_OVERLAY_BACKGROUND_COLOR);
-        newProfile.setValue(KEY_OVERLAY_BACKGROUND_OPACITY, DEFAULT_OVERLAY_BACKGROUND_OPACITY);
-        newProfile.setValue(KEY_OVERLAY_FONT, QFont(DEFAULT_OVERLAY_FONT_FAMILY, DEFAULT_OVERLAY_FONT_SIZE).toString());
-
-        newProfile.setValue(KEY_COMBAT_ENABLED, DEFAULT_COMBAT_MESSAGES_ENABLED);
-        newProfile.setValue(KEY_COMBAT_DURATION, DEFAULT_COMBAT_MESSAGE_DURATION);
-        newProfile.setValue(KEY_COMBAT_POSITION, DEFAULT_COMBAT_MESSAGE_POSITION);
-        newProfile.setValue(KEY_COMBAT_COLOR, DEFAULT_COMBAT_MESSAGE_COLOR);
-        QFont defaultCombatFont(DEFAULT_OVERLAY_FONT_FAMILY, DEFAULT_OVERLAY_FONT_SIZE);
-        defaultCombatFont.setBold(true);
-        newProfile.setValue(KEY_COMBAT_FONT, defaultCombatFont.toString());
-        newProfile.setValue(KEY_COMBAT_ENABLED_EVENT_TYPES, DEFAULT_COMBAT_MESSAGE_EVENT_TYPES());
-        newProfile.setValue(KEY_MINING_TIMEOUT_SECONDS, DEFAULT_MINING_TIMEOUT_SECONDS);
+        writeDefaults(newProfile);
     }
     
     newProfile.sync();
+    m_preloadedProfiles[profileName] = parseProfile(profileName);
     
     qDebug() << "Created profile:" << profileName;
     return true;
@@ -1091,6 +1918,7 @@ bool Config::cloneProfile(const QString& sourceName, const QString& destName)
     QString destPath = getProfileFilePath(destName);
     
     if (QFile::copy(sourcePath, destPath)) {
+        m_preloadedProfiles[destName] = parseProfile(destName);
         qDebug() << "Cloned profile from" << sourceName << "to" << destName;
         return true;
     } else {
@@ -1123,6 +1951,9 @@ bool Config::deleteProfile(const QString& profileName)
         }
     }
     
+    // Drop the parsed copy first, destroying it later could write the file back
+    m_preloadedProfiles.erase(profileName);
+    
     QString profilePath = getProfileFilePath(profileName);
     if (QFile::remove(profilePath)) {
         clearProfileHotkey(profileName);
@@ -1156,6 +1987,8 @@ bool Config::renameProfile(const QString& oldName, const QString& newName)
         return false;
     }
     
+    m_preloadedProfiles.erase(oldName);
+    
     QString oldPath = getProfileFilePath(oldName);
     QString newPath = getProfileFilePath(newName);
     
@@ -1257,26 +2090,22 @@ QMap<QString, QPair<int, int>> Config::getAllProfileHotkeys() const
 
 bool Config::enableChatLogMonitoring() const
 {
-    refreshCache();
-    return m_cachedEnableChatLogMonitoring;
+    return settingValue<Setting::EnableChatLogMonitoring>();
 }
 
 void Config::setEnableChatLogMonitoring(bool enabled)
 {
-    m_settings->setValue(KEY_CHATLOG_ENABLE_MONITORING, enabled);
-    invalidateCache();
+    setSettingValue<Setting::EnableChatLogMonitoring>(enabled);
 }
 
 QString Config::chatLogDirectory() const
 {
-    refreshCache();
-    return m_cachedChatLogDirectory;
+    return settingValue<Setting::ChatLogDirectory>();
 }
 
 void Config::setChatLogDirectory(const QString& directory)
 {
-    m_settings->setValue(KEY_CHATLOG_DIRECTORY, directory);
-    invalidateCache();
+    setSettingValue<Setting::ChatLogDirectory>(directory);
 }
 
 QString Config::getDefaultChatLogDirectory()
@@ -1307,74 +2136,62 @@ QString Config::getDefaultGameLogDirectory()
 
 QString Config::gameLogDirectory() const
 {
-    refreshCache();
-    return m_cachedGameLogDirectory;
+    return settingValue<Setting::GameLogDirectory>();
 }
 
 void Config::setGameLogDirectory(const QString& directory)
 {
-    m_settings->setValue(KEY_GAMELOG_DIRECTORY, directory);
-    invalidateCache();
+    setSettingValue<Setting::GameLogDirectory>(directory);
 }
 
 bool Config::enableGameLogMonitoring() const
 {
-    refreshCache();
-    return m_cachedEnableGameLogMonitoring;
+    return settingValue<Setting::EnableGameLogMonitoring>();
 }
 
 void Config::setEnableGameLogMonitoring(bool enabled)
 {
-    m_settings->setValue(KEY_GAMELOG_ENABLE_MONITORING, enabled);
-    invalidateCache();
+    setSettingValue<Setting::EnableGameLogMonitoring>(enabled);
 }
 
 bool Config::showCombatMessages() const
 {
-    refreshCache();
-    return m_cachedShowCombatMessages;
+    return settingValue<Setting::ShowCombatMessages>();
 }
 
 void Config::setShowCombatMessages(bool enabled)
 {
-    m_settings->setValue(KEY_COMBAT_ENABLED, enabled);
-    invalidateCache();
+    setSettingValue<Setting::ShowCombatMessages>(enabled);
 }
 
 int Config::combatMessagePosition() const
 {
-    refreshCache();
-    return m_cachedCombatMessagePosition;
+    return settingValue<Setting::CombatMessagePosition>();
 }
 
 void Config::setCombatMessagePosition(int position)
 {
-    m_settings->setValue(KEY_COMBAT_POSITION, position);
-    invalidateCache();
+    setSettingValue<Setting::CombatMessagePosition>(position);
 }
 
 QFont Config::combatMessageFont() const
 {
-    refreshCache();
-    return m_cachedCombatMessageFont;
+    return settingValue<Setting::CombatMessageFont>();
 }
 
 void Config::setCombatMessageFont(const QFont& font)
 {
-    m_settings->setValue(KEY_COMBAT_FONT, font);
-    invalidateCache();
+    setSettingValue<Setting::CombatMessageFont>(font);
 }
 
 QStringList Config::enabledCombatEventTypes() const
 {
-    refreshCache();
-    return m_cachedEnabledCombatEventTypes;
+    return settingValue<Setting::EnabledCombatEventTypes>();
 }
 
 void Config::setEnabledCombatEventTypes(const QStringList& types)
 {
-    m_settings->setValue(KEY_COMBAT_ENABLED_EVENT_TYPES, types);
-    invalidateCache();
+    setSettingValue<Setting::EnabledCombatEventTypes>(types);
 }
 
 bool Config::isCombatEventTypeEnabled(const QString& eventType) const
@@ -1385,53 +2202,69 @@ bool Config::isCombatEventTypeEnabled(const QString& eventType) const
 
 int Config::miningTimeoutSeconds() const
 {
-    refreshCache();
-    return m_cachedMiningTimeoutSeconds;
+    return settingValue<Setting::MiningTimeoutSeconds>();
 }
 
 void Config::setMiningTimeoutSeconds(int seconds)
 {
-    m_settings->setValue(KEY_MINING_TIMEOUT_SECONDS, seconds);
-    invalidateCache();
+    setSettingValue<Setting::MiningTimeoutSeconds>(seconds);
 }
 
 QColor Config::combatEventColor(const QString& eventType) const
 {
-    refreshCache();
+    refreshCombatEventCache();
     return m_cachedCombatEventColors.value(eventType, QColor(DEFAULT_EVENT_COLORS().value(eventType, DEFAULT_COMBAT_MESSAGE_COLOR)));
 }
 
 void Config::setCombatEventColor(const QString& eventType, const QColor& color)
 {
+    if (combatEventColor(eventType) == color) {
+        return;
+    }
+    
     QString key = combatEventColorKey(eventType);
     m_settings->setValue(key, color);
-    invalidateCache();
+    scheduleSave();
+    m_cachedCombatEventColors.insert(eventType, color);
+    noteChange(CombatMessageChanges);
 }
 
 int Config::combatEventDuration(const QString& eventType) const
 {
-    refreshCache();
+    refreshCombatEventCache();
     return m_cachedCombatEventDurations.value(eventType, DEFAULT_COMBAT_MESSAGE_DURATION);
 }
 
 void Config::setCombatEventDuration(const QString& eventType, int milliseconds)
 {
+    if (combatEventDuration(eventType) == milliseconds) {
+        return;
+    }
+    
     QString key = combatEventDurationKey(eventType);
     m_settings->setValue(key, milliseconds);
-    invalidateCache();
+    scheduleSave();
+    m_cachedCombatEventDurations.insert(eventType, milliseconds);
+    noteChange(CombatMessageChanges);
 }
 
 bool Config::combatEventBorderHighlight(const QString& eventType) const
 {
-    refreshCache();
+    refreshCombatEventCache();
     return m_cachedCombatEventBorderHighlights.value(eventType, DEFAULT_COMBAT_EVENT_BORDER_HIGHLIGHT);
 }
 
 void Config::setCombatEventBorderHighlight(const QString& eventType, bool enabled)
 {
+    if (combatEventBorderHighlight(eventType) == enabled) {
+        return;
+    }
+    
     QString key = combatEventBorderHighlightKey(eventType);
     m_settings->setValue(key, enabled);
-    invalidateCache();
+    scheduleSave();
+    m_cachedCombatEventBorderHighlights.insert(eventType, enabled);
+    noteChange(BorderChanges | CombatMessageChanges);
 }
 
 
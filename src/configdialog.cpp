@@ -1,5 +1,7 @@
 #include "configdialog.h"
+#include "windowsystem.h"
 #include "config.h"
+#include "boundedcache.h"
 #include "hotkeycapture.h"
 #include "hotkeymanager.h"
 #include "windowcapture.h"
@@ -17,12 +19,12 @@
 #include <QMessageBox>
 #include <QInputDialog>
 #include <QFileDialog>
+#include <QFileInfo>
+#include <QSignalBlocker>
 #include <QFontDialog>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
-#include <Windows.h>
-#include <Psapi.h>
 #include <QTimer>
 #include <QPropertyAnimation>
 #include <QGraphicsOpacityEffect>
@@ -559,6 +561,16 @@ void ConfigDialog::createAppearancePage()
     sysGrid->addWidget(m_systemNameFontLabel, 2, 0, Qt::AlignLeft);
     sysGrid->addWidget(m_systemNameFontButton, 2, 1);
     
+    m_showJumpDistanceCheck = new QCheckBox("Show jumps from active client");
+    m_showJumpDistanceCheck->setStyleSheet(StyleSheet::getCheckBoxStyleSheet());
+    m_showJumpDistanceCheck->setToolTip("Append the stargate jump count from the active client's system (requires star map data)");
+    sysGrid->addWidget(m_showJumpDistanceCheck, 3, 0, 1, 2);
+    
+    m_groupByJumpDistanceCheck = new QCheckBox("Group default layout by jump distance");
+    m_groupByJumpDistanceCheck->setStyleSheet(StyleSheet::getCheckBoxStyleSheet());
+    m_groupByJumpDistanceCheck->setToolTip("Thumbnails without a saved position are placed nearest system first");
+    sysGrid->addWidget(m_groupByJumpDistanceCheck, 4, 0, 1, 2);
+    
     overlaysSectionLayout->addLayout(sysGrid);
     
     connect(m_showSystemNameCheck, &QCheckBox::toggled, this, [this](bool checked) {
@@ -568,6 +580,7 @@ void ConfigDialog::createAppearancePage()
         m_systemNamePositionCombo->setEnabled(checked);
         m_systemNameFontLabel->setEnabled(checked);
         m_systemNameFontButton->setEnabled(checked);
+        m_showJumpDistanceCheck->setEnabled(checked);
     });
     
     m_showBackgroundCheck = new QCheckBox("Show background");
@@ -1043,7 +1056,7 @@ void ConfigDialog::createBehaviorPage()
     windowSectionLayout->setContentsMargins(16, 12, 16, 12);
     windowSectionLayout->setSpacing(10);
     
-    tagWidget(windowSection, {"window", "desktop", "minimize", "inactive", "delay", "never", "management", "client", "eve", "location", "position", "save", "restore", "move"});
+    tagWidget(windowSection, {"window", "desktop", "minimize", "inactive", "delay", "never", "prerestore", "warm", "cycle", "management", "client", "eve", "location", "position", "save", "restore", "move"});
     
     QLabel *windowHeader = new QLabel("EVE Client Management");
     windowHeader->setStyleSheet(StyleSheet::getSectionHeaderStyleSheet());
@@ -1107,6 +1120,19 @@ void ConfigDialog::createBehaviorPage()
     minimizeGrid->addWidget(m_minimizeDelayLabel, 0, 0, Qt::AlignLeft);
     minimizeGrid->addWidget(m_minimizeDelaySpin, 0, 1);
     
+    m_preRestoreCountLabel = new QLabel("Keep restored:");
+    m_preRestoreCountLabel->setStyleSheet(StyleSheet::getLabelStyleSheet());
+    m_preRestoreCountLabel->setToolTip("Next and previous clients in the cycle group stay restored behind the active one, so cycling to them is faster");
+    m_preRestoreCountSpin = new QSpinBox();
+    m_preRestoreCountSpin->setRange(0, 8);
+    m_preRestoreCountSpin->setSuffix(" clients");
+    m_preRestoreCountSpin->setSpecialValueText("Off");
+    m_preRestoreCountSpin->setFixedWidth(150);
+    m_preRestoreCountSpin->setStyleSheet(StyleSheet::getSpinBoxWithDisabledStyleSheet());
+    
+    minimizeGrid->addWidget(m_preRestoreCountLabel, 1, 0, Qt::AlignLeft);
+    minimizeGrid->addWidget(m_preRestoreCountSpin, 1, 1);
+    
     windowSectionLayout->addLayout(minimizeGrid);
     
     QLabel *neverMinimizeLabel = new QLabel("Never Minimize Characters:");
@@ -1149,6 +1175,8 @@ void ConfigDialog::createBehaviorPage()
     connect(m_minimizeInactiveCheck, &QCheckBox::toggled, this, [this](bool checked) {
         m_minimizeDelayLabel->setEnabled(checked);
         m_minimizeDelaySpin->setEnabled(checked);
+        m_preRestoreCountLabel->setEnabled(checked);
+        m_preRestoreCountSpin->setEnabled(checked);
         m_neverMinimizeTable->setEnabled(checked);
         m_addNeverMinimizeButton->setEnabled(checked);
         m_populateNeverMinimizeButton->setEnabled(checked);
@@ -1160,7 +1188,7 @@ void ConfigDialog::createBehaviorPage()
     positionSectionLayout->setContentsMargins(16, 12, 16, 12);
     positionSectionLayout->setSpacing(10);
     
-    tagWidget(positionSection, {"position", "remember", "snap", "snapping", "distance", "lock", "locked", "placement", "arrange"});
+    tagWidget(positionSection, {"position", "remember", "snap", "snapping", "distance", "lock", "locked", "placement", "arrange", "layout", "grid", "columns", "group"});
     
     QLabel *positionHeader = new QLabel("Thumbnail Positioning");
     positionHeader->setStyleSheet(StyleSheet::getSectionHeaderStyleSheet());
@@ -1180,6 +1208,37 @@ void ConfigDialog::createBehaviorPage()
     positionSectionLayout->addWidget(m_rememberPositionsCheck);
     positionSectionLayout->addWidget(m_preserveLogoutPositionsCheck);
     
+    QGridLayout *layoutGrid = new QGridLayout();
+    layoutGrid->setSpacing(10);
+    layoutGrid->setColumnMinimumWidth(0, 120);
+    layoutGrid->setColumnStretch(2, 1);
+    
+    QLabel *layoutStrategyLabel = new QLabel("Default layout:");
+    layoutStrategyLabel->setStyleSheet(StyleSheet::getLabelStyleSheet());
+    m_layoutStrategyCombo = new QComboBox();
+    m_layoutStrategyCombo->addItem("Grid");
+    m_layoutStrategyCombo->addItem("Columns per monitor");
+    m_layoutStrategyCombo->addItem("Fill around saved positions");
+    m_layoutStrategyCombo->setFixedWidth(200);
+    m_layoutStrategyCombo->setStyleSheet(StyleSheet::getComboBoxWithDisabledStyleSheet());
+    m_layoutStrategyCombo->setToolTip("How thumbnails without a saved position are arranged");
+    
+    QLabel *layoutGroupingLabel = new QLabel("Group by:");
+    layoutGroupingLabel->setStyleSheet(StyleSheet::getLabelStyleSheet());
+    m_layoutGroupingCombo = new QComboBox();
+    m_layoutGroupingCombo->addItem("None");
+    m_layoutGroupingCombo->addItem("Cycle group");
+    m_layoutGroupingCombo->addItem("Solar system");
+    m_layoutGroupingCombo->setFixedWidth(200);
+    m_layoutGroupingCombo->setStyleSheet(StyleSheet::getComboBoxWithDisabledStyleSheet());
+    m_layoutGroupingCombo->setToolTip("Each group starts on a new row or column");
+    
+    layoutGrid->addWidget(layoutStrategyLabel, 0, 0, Qt::AlignLeft);
+    layoutGrid->addWidget(m_layoutStrategyCombo, 0, 1);
+    layoutGrid->addWidget(layoutGroupingLabel, 1, 0, Qt::AlignLeft);
+    layoutGrid->addWidget(m_layoutGroupingCombo, 1, 1);
+    positionSectionLayout->addLayout(layoutGrid);
+    
     m_enableSnappingCheck = new QCheckBox("Enable snapping");
     m_enableSnappingCheck->setStyleSheet(StyleSheet::getCheckBoxStyleSheet());
     positionSectionLayout->addWidget(m_enableSnappingCheck);
@@ -1385,8 +1444,8 @@ void ConfigDialog::createPerformancePage()
     intervalSectionLayout->addWidget(intervalHeader);
     
     QLabel *intervalInfo = new QLabel(
-        "Controls how often the application checks for new/closed windows and updates overlay text. "
-        "Lower values detect changes faster but use slightly more CPU. Best to leave this alone."
+        "Controls how often thumbnails follow a resize of their client window. New and closed windows "
+        "are picked up as they happen. Lower values use slightly more CPU. Best to leave this alone."
     );
     intervalInfo->setStyleSheet(StyleSheet::getInfoLabelStyleSheet());
     intervalInfo->setWordWrap(true);
@@ -1412,6 +1471,130 @@ void ConfigDialog::createPerformancePage()
     
     layout->addWidget(intervalSection);
     
+    QWidget *memorySection = new QWidget();
+    memorySection->setStyleSheet(StyleSheet::getSectionStyleSheet());
+    QVBoxLayout *memorySectionLayout = new QVBoxLayout(memorySection);
+    memorySectionLayout->setContentsMargins(16, 12, 16, 12);
+    memorySectionLayout->setSpacing(10);
+    
+    tagWidget(memorySection, {"memory", "cache", "limit", "characters", "ram", "report", "performance"});
+    
+    QLabel *memoryHeader = new QLabel("Memory");
+    memoryHeader->setStyleSheet(StyleSheet::getSectionHeaderStyleSheet());
+    memorySectionLayout->addWidget(memoryHeader);
+    
+    QLabel *memoryInfo = new QLabel(
+        "Positions, systems and names are cached for the characters seen most recently. "
+        "Raise the limit if you rotate through many more characters than this, the oldest are dropped past it."
+    );
+    memoryInfo->setStyleSheet(StyleSheet::getInfoLabelStyleSheet());
+    memoryInfo->setWordWrap(true);
+    memorySectionLayout->addWidget(memoryInfo);
+    
+    QGridLayout *memoryGrid = new QGridLayout();
+    memoryGrid->setSpacing(10);
+    memoryGrid->setColumnMinimumWidth(0, 120);
+    memoryGrid->setColumnStretch(2, 1);
+    
+    QLabel *cacheLimitLabel = new QLabel("Character cache:");
+    cacheLimitLabel->setStyleSheet(StyleSheet::getLabelStyleSheet());
+    m_characterCacheLimitSpin = new QSpinBox();
+    m_characterCacheLimitSpin->setRange(Config::MIN_CHARACTER_CACHE_LIMIT, Config::MAX_CHARACTER_CACHE_LIMIT);
+    m_characterCacheLimitSpin->setSingleStep(50);
+    m_characterCacheLimitSpin->setSuffix(" entries");
+    m_characterCacheLimitSpin->setFixedWidth(150);
+    m_characterCacheLimitSpin->setStyleSheet(StyleSheet::getSpinBoxStyleSheet());
+    
+    QPushButton *memoryReportButton = new QPushButton("Show Memory Report...");
+    memoryReportButton->setStyleSheet(StyleSheet::getSecondaryButtonStyleSheet());
+    memoryReportButton->setToolTip("Show how full each cache is and roughly how much memory it holds");
+    connect(memoryReportButton, &QPushButton::clicked, this, &ConfigDialog::onShowMemoryReport);
+    
+    memoryGrid->addWidget(cacheLimitLabel, 0, 0, Qt::AlignLeft);
+    memoryGrid->addWidget(m_characterCacheLimitSpin, 0, 1);
+    memoryGrid->addWidget(memoryReportButton, 1, 1, Qt::AlignLeft);
+    
+    memorySectionLayout->addLayout(memoryGrid);
+    
+    layout->addWidget(memorySection);
+    
+    QWidget *diagnosticsSection = new QWidget();
+    diagnosticsSection->setStyleSheet(StyleSheet::getSectionStyleSheet());
+    QVBoxLayout *diagnosticsSectionLayout = new QVBoxLayout(diagnosticsSection);
+    diagnosticsSectionLayout->setContentsMargins(16, 12, 16, 12);
+    diagnosticsSectionLayout->setSpacing(10);
+    
+    tagWidget(diagnosticsSection, {"debug", "log", "logging", "trace", "diagnostics", "file", "troubleshooting"});
+    
+    QLabel *diagnosticsHeader = new QLabel("Diagnostics");
+    diagnosticsHeader->setStyleSheet(StyleSheet::getSectionHeaderStyleSheet());
+    diagnosticsSectionLayout->addWidget(diagnosticsHeader);
+    
+    QLabel *diagnosticsInfo = new QLabel(
+        "Detailed tracing of log parsing, overlays, hotkeys and window tracking. "
+        "Log files are written by a background thread to the logs folder next to the executable."
+    );
+    diagnosticsInfo->setStyleSheet(StyleSheet::getInfoLabelStyleSheet());
+    diagnosticsInfo->setWordWrap(true);
+    diagnosticsSectionLayout->addWidget(diagnosticsInfo);
+    
+    m_enableDebugLoggingCheck = new QCheckBox("Enable debug tracing");
+    m_enableDebugLoggingCheck->setStyleSheet(StyleSheet::getCheckBoxStyleSheet());
+    diagnosticsSectionLayout->addWidget(m_enableDebugLoggingCheck);
+    
+    m_writeLogToFileCheck = new QCheckBox("Write log output to file");
+    m_writeLogToFileCheck->setStyleSheet(StyleSheet::getCheckBoxStyleSheet());
+    diagnosticsSectionLayout->addWidget(m_writeLogToFileCheck);
+    
+    layout->addWidget(diagnosticsSection);
+    
+    QWidget *profileStorageSection = new QWidget();
+    profileStorageSection->setStyleSheet(StyleSheet::getSectionStyleSheet());
+    QVBoxLayout *profileStorageSectionLayout = new QVBoxLayout(profileStorageSection);
+    profileStorageSectionLayout->setContentsMargins(16, 12, 16, 12);
+    profileStorageSectionLayout->setSpacing(10);
+    
+    tagWidget(profileStorageSection, {"profile", "binary", "ini", "format", "storage", "import", "export", "backup", "share", "file"});
+    
+    QLabel *profileStorageHeader = new QLabel("Profile Storage");
+    profileStorageHeader->setStyleSheet(StyleSheet::getSectionHeaderStyleSheet());
+    profileStorageSectionLayout->addWidget(profileStorageHeader);
+    
+    QLabel *profileStorageInfo = new QLabel(
+        "Binary profiles load and save faster than INI files but can't be edited by hand. "
+        "Switching converts every profile right away. Export and import use INI in either mode, "
+        "so profiles can be shared or edited outside the app."
+    );
+    profileStorageInfo->setStyleSheet(StyleSheet::getInfoLabelStyleSheet());
+    profileStorageInfo->setWordWrap(true);
+    profileStorageSectionLayout->addWidget(profileStorageInfo);
+    
+    m_binaryProfilesCheck = new QCheckBox("Store profiles in binary format");
+    m_binaryProfilesCheck->setStyleSheet(StyleSheet::getCheckBoxStyleSheet());
+    m_binaryProfilesCheck->setChecked(Config::instance().useBinaryProfiles());
+    connect(m_binaryProfilesCheck, &QCheckBox::toggled, this, &ConfigDialog::onBinaryProfilesToggled);
+    profileStorageSectionLayout->addWidget(m_binaryProfilesCheck);
+    
+    QHBoxLayout *profileTransferLayout = new QHBoxLayout();
+    profileTransferLayout->setSpacing(10);
+    
+    QPushButton *exportProfileButton = new QPushButton("Export Profile...");
+    exportProfileButton->setStyleSheet(StyleSheet::getSecondaryButtonStyleSheet());
+    exportProfileButton->setToolTip("Save the current profile as an INI file");
+    connect(exportProfileButton, &QPushButton::clicked, this, &ConfigDialog::onExportProfile);
+    profileTransferLayout->addWidget(exportProfileButton);
+    
+    QPushButton *importProfileButton = new QPushButton("Import Profile...");
+    importProfileButton->setStyleSheet(StyleSheet::getSecondaryButtonStyleSheet());
+    importProfileButton->setToolTip("Add a profile from an INI file");
+    connect(importProfileButton, &QPushButton::clicked, this, &ConfigDialog::onImportProfile);
+    profileTransferLayout->addWidget(importProfileButton);
+    
+    profileTransferLayout->addStretch();
+    profileStorageSectionLayout->addLayout(profileTransferLayout);
+    
+    layout->addWidget(profileStorageSection);
+    
     QHBoxLayout *resetLayout = new QHBoxLayout();
     resetLayout->addStretch();
     QPushButton *resetButton = new QPushButton("Reset to Defaults");
@@ -1452,7 +1635,7 @@ void ConfigDialog::createDataSourcesPage()
     logSectionLayout->setContentsMargins(16, 12, 16, 12);
     logSectionLayout->setSpacing(10);
     
-    tagWidget(logMonitoringSection, {"chat", "game", "log", "monitoring", "system", "character", "location", "directory", "path", "combat", "event"});
+    tagWidget(logMonitoringSection, {"chat", "game", "log", "monitoring", "system", "character", "location", "directory", "path", "combat", "event", "intel", "channel", "jumps", "index", "search", "history"});
     
     QLabel *logHeader = new QLabel("Log Monitoring");
     logHeader->setStyleSheet(StyleSheet::getSectionHeaderStyleSheet());
@@ -1490,10 +1673,106 @@ void ConfigDialog::createDataSourcesPage()
     chatDirLayout->addWidget(m_chatLogBrowseButton);
     logSectionLayout->addLayout(chatDirLayout);
     
+    QHBoxLayout *intelChannelsLayout = new QHBoxLayout();
+    intelChannelsLayout->setContentsMargins(24, 0, 0, 0);
+    m_intelChannelsLabel = new QLabel("Intel channels:");
+    m_intelChannelsLabel->setStyleSheet(StyleSheet::getLabelStyleSheet());
+    m_intelChannelsLabel->setFixedWidth(150);
+    
+    m_intelChannelsEdit = new QLineEdit();
+    m_intelChannelsEdit->setStyleSheet(StyleSheet::getDialogLineEditStyleSheet());
+    m_intelChannelsEdit->setPlaceholderText("Comma separated channel names");
+    m_intelChannelsEdit->setToolTip("Chat channels scanned for system names. Each channel is read once, whichever character is listening.");
+    
+    intelChannelsLayout->addWidget(m_intelChannelsLabel);
+    intelChannelsLayout->addWidget(m_intelChannelsEdit, 1);
+    logSectionLayout->addLayout(intelChannelsLayout);
+    
+    QHBoxLayout *intelRangeLayout = new QHBoxLayout();
+    intelRangeLayout->setContentsMargins(24, 0, 0, 0);
+    m_intelAlertJumpsLabel = new QLabel("Intel alert range:");
+    m_intelAlertJumpsLabel->setStyleSheet(StyleSheet::getLabelStyleSheet());
+    m_intelAlertJumpsLabel->setFixedWidth(150);
+    
+    m_intelAlertJumpsSpin = new QSpinBox();
+    m_intelAlertJumpsSpin->setRange(0, 50);
+    m_intelAlertJumpsSpin->setSuffix(" jumps");
+    m_intelAlertJumpsSpin->setStyleSheet(StyleSheet::getSpinBoxStyleSheet());
+    m_intelAlertJumpsSpin->setFixedWidth(120);
+    m_intelAlertJumpsSpin->setToolTip("Show intel reports on thumbnails of characters within this many jumps (requires star map data)");
+    
+    intelRangeLayout->addWidget(m_intelAlertJumpsLabel);
+    intelRangeLayout->addWidget(m_intelAlertJumpsSpin);
+    intelRangeLayout->addStretch();
+    logSectionLayout->addLayout(intelRangeLayout);
+    
+    // Styled like a combat event row, but independent of combat messages
+    QHBoxLayout *intelAlertLayout = new QHBoxLayout();
+    intelAlertLayout->setContentsMargins(24, 0, 0, 0);
+    m_showIntelAlertsCheck = new QCheckBox("Intel alerts");
+    m_showIntelAlertsCheck->setStyleSheet(StyleSheet::getCheckBoxStyleSheet());
+    m_showIntelAlertsCheck->setFixedWidth(150);
+    m_showIntelAlertsCheck->setToolTip("Show intel reports within the alert range on thumbnails");
+    intelAlertLayout->addWidget(m_showIntelAlertsCheck);
+    
+    m_intelAlertColorButton = new QPushButton();
+    m_intelAlertColorButton->setFixedSize(80, 30);
+    m_intelAlertColorButton->setCursor(Qt::PointingHandCursor);
+    updateColorButton(m_intelAlertColorButton, QColor(Config::DEFAULT_EVENT_COLORS().value(Config::INTEL_EVENT_TYPE)));
+    connect(m_intelAlertColorButton, &QPushButton::clicked, this, [this]() {
+        QColor currentColor = Config::instance().combatEventColor(Config::INTEL_EVENT_TYPE);
+        QColor color = QColorDialog::getColor(currentColor, this, "Select Intel Alert Color");
+        if (color.isValid()) {
+            updateColorButton(m_intelAlertColorButton, color);
+            Config::instance().setCombatEventColor(Config::INTEL_EVENT_TYPE, color);
+        }
+    });
+    intelAlertLayout->addWidget(m_intelAlertColorButton);
+    
+    intelAlertLayout->addSpacing(20);
+    
+    m_intelAlertDurationLabel = new QLabel("Duration:");
+    m_intelAlertDurationLabel->setStyleSheet(StyleSheet::getLabelStyleSheet());
+    intelAlertLayout->addWidget(m_intelAlertDurationLabel);
+    
+    m_intelAlertDurationSpin = new QSpinBox();
+    m_intelAlertDurationSpin->setStyleSheet(StyleSheet::getSpinBoxStyleSheet());
+    m_intelAlertDurationSpin->setRange(1, 30);
+    m_intelAlertDurationSpin->setSingleStep(1);
+    m_intelAlertDurationSpin->setSuffix(" sec");
+    m_intelAlertDurationSpin->setFixedWidth(120);
+    connect(m_intelAlertDurationSpin, QOverload<int>::of(&QSpinBox::valueChanged), this, [](int value) {
+        Config::instance().setCombatEventDuration(Config::INTEL_EVENT_TYPE, value * 1000);
+    });
+    intelAlertLayout->addWidget(m_intelAlertDurationSpin);
+    
+    intelAlertLayout->addSpacing(20);
+    
+    m_intelAlertBorderCheck = new QCheckBox("Border");
+    m_intelAlertBorderCheck->setStyleSheet(StyleSheet::getCheckBoxStyleSheet());
+    m_intelAlertBorderCheck->setToolTip("Show colored dashed border when intel is reported nearby");
+    connect(m_intelAlertBorderCheck, &QCheckBox::toggled, this, [](bool checked) {
+        Config::instance().setCombatEventBorderHighlight(Config::INTEL_EVENT_TYPE, checked);
+    });
+    intelAlertLayout->addWidget(m_intelAlertBorderCheck);
+    
+    intelAlertLayout->addStretch();
+    logSectionLayout->addLayout(intelAlertLayout);
+    
     connect(m_enableChatLogMonitoringCheck, &QCheckBox::toggled, this, [this](bool checked) {
         m_chatLogDirectoryLabel->setEnabled(checked);
         m_chatLogDirectoryEdit->setEnabled(checked);
         m_chatLogBrowseButton->setEnabled(checked);
+        m_intelChannelsLabel->setEnabled(checked);
+        m_intelChannelsEdit->setEnabled(checked);
+        m_intelAlertJumpsLabel->setEnabled(checked);
+        m_intelAlertJumpsSpin->setEnabled(checked);
+        m_showIntelAlertsCheck->setEnabled(checked);
+        updateIntelAlertControls();
+    });
+    
+    connect(m_showIntelAlertsCheck, &QCheckBox::toggled, this, [this]() {
+        updateIntelAlertControls();
     });
     
     m_enableGameLogMonitoringCheck = new QCheckBox("Enable game log monitoring");
@@ -1545,6 +1824,11 @@ void ConfigDialog::createDataSourcesPage()
         m_fileChangeDebounceSpin->setEnabled(checked);
     });
     
+    m_enableLogIndexingCheck = new QCheckBox("Index chat and game logs for searching");
+    m_enableLogIndexingCheck->setStyleSheet(StyleSheet::getCheckBoxStyleSheet());
+    m_enableLogIndexingCheck->setToolTip("Builds a search index of old log files in the background. Use \"Search Logs...\" in the tray menu to query it.");
+    logSectionLayout->addWidget(m_enableLogIndexingCheck);
+    
     layout->addWidget(logMonitoringSection);
     
     QWidget *combatSection = new QWidget();
@@ -2020,6 +2304,20 @@ void ConfigDialog::setupBindings()
         false
     ));
     
+    m_bindingManager.addBinding(BindingHelpers::bindComboBox(
+        m_layoutStrategyCombo,
+        [&config]() { return config.layoutStrategy(); },
+        [&config](int value) { config.setLayoutStrategy(value); },
+        Config::DEFAULT_POSITION_LAYOUT_STRATEGY
+    ));
+    
+    m_bindingManager.addBinding(BindingHelpers::bindComboBox(
+        m_layoutGroupingCombo,
+        [&config]() { return config.layoutGrouping(); },
+        [&config](int value) { config.setLayoutGrouping(value); },
+        Config::DEFAULT_POSITION_LAYOUT_GROUPING
+    ));
+    
     m_bindingManager.addBinding(BindingHelpers::bindCheckBox(
         m_enableSnappingCheck,
         [&config]() { return config.enableSnapping(); },
@@ -2063,6 +2361,27 @@ void ConfigDialog::setupBindings()
         100
     ));
     
+    m_bindingManager.addBinding(BindingHelpers::bindSpinBox(
+        m_characterCacheLimitSpin,
+        [&config]() { return config.characterCacheLimit(); },
+        [&config](int value) { config.setCharacterCacheLimit(value); },
+        Config::DEFAULT_GLOBAL_CHARACTER_CACHE_LIMIT
+    ));
+    
+    m_bindingManager.addBinding(BindingHelpers::bindCheckBox(
+        m_enableDebugLoggingCheck,
+        [&config]() { return config.enableDebugLogging(); },
+        [&config](bool value) { config.setEnableDebugLogging(value); },
+        Config::DEFAULT_LOGGING_DEBUG_ENABLED
+    ));
+    
+    m_bindingManager.addBinding(BindingHelpers::bindCheckBox(
+        m_writeLogToFileCheck,
+        [&config]() { return config.writeLogToFile(); },
+        [&config](bool value) { config.setWriteLogToFile(value); },
+        Config::DEFAULT_LOGGING_WRITE_TO_FILE
+    ));
+    
     m_bindingManager.addBinding(BindingHelpers::bindSpinBox(
         m_opacitySpin,
         [&config]() { return config.thumbnailOpacity(); },
@@ -2113,6 +2432,13 @@ void ConfigDialog::setupBindings()
         500
     ));
     
+    m_bindingManager.addBinding(BindingHelpers::bindSpinBox(
+        m_preRestoreCountSpin,
+        [&config]() { return config.preRestoreCount(); },
+        [&config](int value) { config.setPreRestoreCount(value); },
+        Config::DEFAULT_WINDOW_PRE_RESTORE_COUNT
+    ));
+    
     m_bindingManager.addBinding(BindingHelpers::bindCheckBox(
         m_saveClientLocationCheck,
         [&config]() { return config.saveClientLocation(); },
@@ -2207,6 +2533,20 @@ void ConfigDialog::setupBindings()
         0
     ));
     
+    m_bindingManager.addBinding(BindingHelpers::bindCheckBox(
+        m_showJumpDistanceCheck,
+        [&config]() { return config.showJumpDistance(); },
+        [&config](bool value) { config.setShowJumpDistance(value); },
+        Config::DEFAULT_OVERLAY_SHOW_JUMP_DISTANCE
+    ));
+    
+    m_bindingManager.addBinding(BindingHelpers::bindCheckBox(
+        m_groupByJumpDistanceCheck,
+        [&config]() { return config.groupThumbnailsByJumpDistance(); },
+        [&config](bool value) { config.setGroupThumbnailsByJumpDistance(value); },
+        Config::DEFAULT_THUMBNAIL_GROUP_BY_JUMP_DISTANCE
+    ));
+    
     
     m_bindingManager.addBinding(BindingHelpers::bindCheckBox(
         m_showBackgroundCheck,
@@ -2390,6 +2730,13 @@ void ConfigDialog::setupBindings()
         false  
     ));
     
+    m_bindingManager.addBinding(BindingHelpers::bindCheckBox(
+        m_enableLogIndexingCheck,
+        [&config]() { return config.enableLogIndexing(); },
+        [&config](bool value) { config.setEnableLogIndexing(value); },
+        Config::DEFAULT_LOGINDEX_ENABLED
+    ));
+    
     m_bindingManager.addBinding(BindingHelpers::bindCheckBox(
         m_showCombatMessagesCheck,
         [&config]() { return config.showCombatMessages(); },
@@ -2404,6 +2751,20 @@ void ConfigDialog::setupBindings()
         200
     ));
     
+    m_bindingManager.addBinding(BindingHelpers::bindSpinBox(
+        m_intelAlertJumpsSpin,
+        [&config]() { return config.intelAlertJumps(); },
+        [&config](int value) { config.setIntelAlertJumps(value); },
+        Config::DEFAULT_CHATLOG_INTEL_ALERT_JUMPS
+    ));
+    
+    m_bindingManager.addBinding(BindingHelpers::bindCheckBox(
+        m_showIntelAlertsCheck,
+        [&config]() { return config.showIntelAlerts(); },
+        [&config](bool value) { config.setShowIntelAlerts(value); },
+        Config::DEFAULT_CHATLOG_SHOW_INTEL_ALERTS
+    ));
+    
     m_bindingManager.addBinding(BindingHelpers::bindComboBox(
         m_combatMessagePositionCombo,
         [&config]() { return config.combatMessagePosition(); },
@@ -2530,6 +2891,8 @@ void ConfigDialog::loadSettings()
     
     m_chatLogDirectoryEdit->setText(config.chatLogDirectory());
     
+    m_intelChannelsEdit->setText(config.intelChannels().join(", "));
+    
     m_gameLogDirectoryEdit->setText(config.gameLogDirectory());
     
     for (auto it = m_eventColorButtons.constBegin(); it != m_eventColorButtons.constEnd(); ++it) {
@@ -2550,10 +2913,16 @@ void ConfigDialog::loadSettings()
         borderCheck->setChecked(config.combatEventBorderHighlight(eventType));
     }
     
+    updateColorButton(m_intelAlertColorButton, config.combatEventColor(Config::INTEL_EVENT_TYPE));
+    m_intelAlertDurationSpin->setValue(config.combatEventDuration(Config::INTEL_EVENT_TYPE) / 1000);
+    m_intelAlertBorderCheck->setChecked(config.combatEventBorderHighlight(Config::INTEL_EVENT_TYPE));
+    
     m_snapDistanceLabel->setEnabled(config.enableSnapping());
     m_snapDistanceSpin->setEnabled(config.enableSnapping());
     m_minimizeDelayLabel->setEnabled(config.minimizeInactiveClients());
     m_minimizeDelaySpin->setEnabled(config.minimizeInactiveClients());
+    m_preRestoreCountLabel->setEnabled(config.minimizeInactiveClients());
+    m_preRestoreCountSpin->setEnabled(config.minimizeInactiveClients());
     m_highlightColorLabel->setEnabled(config.highlightActiveWindow());
     m_highlightColorButton->setEnabled(config.highlightActiveWindow());
     m_highlightBorderWidthLabel->setEnabled(config.highlightActiveWindow());
@@ -2570,6 +2939,7 @@ void ConfigDialog::loadSettings()
     m_systemNamePositionCombo->setEnabled(config.showSystemName());
     m_systemNameFontLabel->setEnabled(config.showSystemName());
     m_systemNameFontButton->setEnabled(config.showSystemName());
+    m_showJumpDistanceCheck->setEnabled(config.showSystemName());
     m_backgroundColorLabel->setEnabled(config.showOverlayBackground());
     m_backgroundOpacityLabel->setEnabled(config.showOverlayBackground());
     
@@ -2591,6 +2961,12 @@ void ConfigDialog::loadSettings()
     m_chatLogDirectoryLabel->setEnabled(chatLogEnabled);
     m_chatLogDirectoryEdit->setEnabled(chatLogEnabled);
     m_chatLogBrowseButton->setEnabled(chatLogEnabled);
+    m_intelChannelsLabel->setEnabled(chatLogEnabled);
+    m_intelChannelsEdit->setEnabled(chatLogEnabled);
+    m_intelAlertJumpsLabel->setEnabled(chatLogEnabled);
+    m_intelAlertJumpsSpin->setEnabled(chatLogEnabled);
+    m_showIntelAlertsCheck->setEnabled(chatLogEnabled);
+    updateIntelAlertControls();
     
     bool gameLogEnabled = config.enableGameLogMonitoring();
     m_gameLogDirectoryLabel->setEnabled(gameLogEnabled);
@@ -2647,15 +3023,26 @@ void ConfigDialog::loadSettings()
 
 void ConfigDialog::saveSettings()
 {
+    Config::Transaction transaction;
+    
     m_bindingManager.saveAll();
     
     HotkeyManager::instance()->saveToConfig();
     
     Config::instance().setChatLogDirectory(m_chatLogDirectoryEdit->text().trimmed());
     
+    QStringList intelChannels;
+    for (const QString& channel : m_intelChannelsEdit->text().split(',', Qt::SkipEmptyParts)) {
+        QString trimmed = channel.trimmed();
+        if (!trimmed.isEmpty()) {
+            intelChannels.append(trimmed);
+        }
+    }
+    Config::instance().setIntelChannels(intelChannels);
+    
     Config::instance().setGameLogDirectory(m_gameLogDirectoryEdit->text().trimmed());
     
-    Config::instance().save();
+    Config::instance().scheduleSave();
 }
 
 void ConfigDialog::onApplyClicked()
@@ -2749,7 +3136,7 @@ void ConfigDialog::onSetNotLoggedInPosition()
         connect(m_notLoggedInReferenceThumbnail, &ThumbnailWidget::positionChanged, 
                 this, [](quintptr, QPoint position) {
             Config::instance().setNotLoggedInReferencePosition(position);
-            Config::instance().save();
+            Config::instance().scheduleSave();
         });
         
         m_notLoggedInReferenceThumbnail->updateOverlays();
@@ -2826,6 +3213,15 @@ void ConfigDialog::updateColorButton(QPushButton* button, const QColor& color)
     button->setText(color.name().toUpper());
 }
 
+void ConfigDialog::updateIntelAlertControls()
+{
+    bool enable = m_enableChatLogMonitoringCheck->isChecked() && m_showIntelAlertsCheck->isChecked();
+    m_intelAlertColorButton->setEnabled(enable);
+    m_intelAlertDurationLabel->setEnabled(enable);
+    m_intelAlertDurationSpin->setEnabled(enable);
+    m_intelAlertBorderCheck->setEnabled(enable);
+}
+
 void ConfigDialog::onAddCharacterHotkey()
 {
     int row = m_characterHotkeysTable->rowCount();
@@ -3941,42 +4337,23 @@ void ConfigDialog::onPopulateProcessNames()
 {
     QMap<QString, QString> processToTitle;  
     
-    EnumWindows([](HWND hwnd, LPARAM lParam) -> BOOL {
-        auto* processMap = reinterpret_cast<QMap<QString, QString>*>(lParam);
-        
-        if (!IsWindowVisible(hwnd)) {
-            return TRUE;
+    WindowSystem& windowSystem = WindowSystem::instance();
+    for (WindowId window : windowSystem.topLevelWindows()) {
+        if (!windowSystem.isVisible(window)) {
+            continue;
         }
         
-        wchar_t title[256];
-        int length = GetWindowTextW(hwnd, title, sizeof(title) / sizeof(wchar_t));
-        if (length == 0) {
-            return TRUE;
-        }
-        QString titleStr = QString::fromWCharArray(title, length);
+        QString titleStr = windowSystem.windowTitle(window);
         if (titleStr.isEmpty() || titleStr.contains("EVEAPMPreview")) {
-            return TRUE;
+            continue;
         }
         
-        DWORD processId = 0;
-        GetWindowThreadProcessId(hwnd, &processId);
+        QString processName = windowSystem.processName(windowSystem.processId(window));
         
-        QString processName;
-        HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, FALSE, processId);
-        if (hProcess) {
-            wchar_t processNameBuffer[MAX_PATH];
-            if (GetModuleBaseNameW(hProcess, NULL, processNameBuffer, MAX_PATH)) {
-                processName = QString::fromWCharArray(processNameBuffer);
-            }
-            CloseHandle(hProcess);
+        if (!processName.isEmpty() && !processToTitle.contains(processName)) {
+            processToTitle.insert(processName, titleStr);
         }
-        
-        if (!processName.isEmpty() && !processMap->contains(processName)) {
-            processMap->insert(processName, titleStr);
-        }
-        
-        return TRUE;
-    }, reinterpret_cast<LPARAM>(&processToTitle));
+    }
     
     if (processToTitle.isEmpty()) {
         QMessageBox::information(this, "No Processes Found", 
@@ -4232,6 +4609,8 @@ void ConfigDialog::onResetAppearanceDefaults()
         m_systemNameColor = QColor(Config::DEFAULT_OVERLAY_SYSTEM_COLOR);
         updateColorButton(m_systemNameColorButton, m_systemNameColor);
         m_systemNamePositionCombo->setCurrentIndex(Config::DEFAULT_OVERLAY_SYSTEM_POSITION); 
+        m_showJumpDistanceCheck->setChecked(Config::DEFAULT_OVERLAY_SHOW_JUMP_DISTANCE);
+        m_groupByJumpDistanceCheck->setChecked(Config::DEFAULT_THUMBNAIL_GROUP_BY_JUMP_DISTANCE);
     Config::instance().setSystemNameFont(QFont(Config::DEFAULT_OVERLAY_FONT_FAMILY, Config::DEFAULT_OVERLAY_FONT_SIZE));
         
         m_showBackgroundCheck->setChecked(Config::DEFAULT_OVERLAY_SHOW_BACKGROUND);
@@ -4283,11 +4662,14 @@ void ConfigDialog::onResetBehaviorDefaults()
         m_alwaysOnTopCheck->setChecked(Config::DEFAULT_WINDOW_ALWAYS_ON_TOP);
         m_minimizeInactiveCheck->setChecked(Config::DEFAULT_WINDOW_MINIMIZE_INACTIVE);
         m_minimizeDelaySpin->setValue(Config::DEFAULT_WINDOW_MINIMIZE_DELAY);
+        m_preRestoreCountSpin->setValue(Config::DEFAULT_WINDOW_PRE_RESTORE_COUNT);
         m_saveClientLocationCheck->setChecked(Config::DEFAULT_WINDOW_SAVE_CLIENT_LOCATION);
         
         m_neverMinimizeTable->setRowCount(0);
         
         m_rememberPositionsCheck->setChecked(Config::DEFAULT_POSITION_REMEMBER);
+        m_layoutStrategyCombo->setCurrentIndex(Config::DEFAULT_POSITION_LAYOUT_STRATEGY);
+        m_layoutGroupingCombo->setCurrentIndex(Config::DEFAULT_POSITION_LAYOUT_GROUPING);
         m_enableSnappingCheck->setChecked(Config::DEFAULT_POSITION_ENABLE_SNAPPING);
         m_snapDistanceSpin->setValue(Config::DEFAULT_POSITION_SNAP_DISTANCE);
         m_lockPositionsCheck->setChecked(Config::DEFAULT_POSITION_LOCK);
@@ -4303,13 +4685,16 @@ void ConfigDialog::onResetPerformanceDefaults()
     QMessageBox msgBox(this);
     msgBox.setWindowTitle("Reset Performance Settings");
     msgBox.setText("Are you sure you want to reset all performance settings to their default values?");
-    msgBox.setInformativeText("This will reset the refresh interval settings.");
+    msgBox.setInformativeText("This will reset the refresh interval, cache limit and diagnostics settings.");
     msgBox.setStandardButtons(QMessageBox::Yes | QMessageBox::No);
     msgBox.setDefaultButton(QMessageBox::No);
     msgBox.setStyleSheet(StyleSheet::getMessageBoxStyleSheet());
     
     if (msgBox.exec() == QMessageBox::Yes) {
         m_refreshIntervalSpin->setValue(Config::DEFAULT_THUMBNAIL_REFRESH_INTERVAL);
+        m_characterCacheLimitSpin->setValue(Config::DEFAULT_GLOBAL_CHARACTER_CACHE_LIMIT);
+        m_enableDebugLoggingCheck->setChecked(Config::DEFAULT_LOGGING_DEBUG_ENABLED);
+        m_writeLogToFileCheck->setChecked(Config::DEFAULT_LOGGING_WRITE_TO_FILE);
         
         QMessageBox::information(this, "Reset Complete", 
             "Performance settings have been reset to defaults.\n\n"
@@ -6027,7 +6412,7 @@ void ConfigDialog::onProfileChanged(int index)
 bool ConfigDialog::confirmProfileSwitch()
 {
     Config& config = Config::instance();
-    QSettings globalSettings(config.configFilePath().replace(QRegularExpression("/profiles/.*\\.ini$"), "/settings.global.ini"), QSettings::IniFormat);
+    QSettings globalSettings(config.configFilePath().replace(QRegularExpression("/profiles/.*\\.(ini|profile)$"), "/settings.global.ini"), QSettings::IniFormat);
     
     bool skipConfirmation = globalSettings.value(Config::KEY_UI_SKIP_PROFILE_SWITCH_CONFIRMATION, Config::DEFAULT_UI_SKIP_PROFILE_SWITCH_CONFIRMATION).toBool();
     
@@ -6067,8 +6452,6 @@ void ConfigDialog::switchProfile(const QString& profileName)
     HotkeyManager::instance()->saveToConfig();  
     
     if (Config::instance().loadProfile(profileName)) {
-        HotkeyManager::instance()->loadFromConfig();
-        
         loadSettings();
         
         updateProfileDropdown();
@@ -6361,6 +6744,118 @@ void ConfigDialog::onDeleteProfile()
     });
 }
 
+void ConfigDialog::onShowMemoryReport()
+{
+    QMessageBox msgBox(this);
+    msgBox.setWindowTitle("Memory Report");
+    msgBox.setText("Cache usage right now:");
+    msgBox.setInformativeText(BoundedCacheBase::memoryReport().join('\n'));
+    msgBox.setStandardButtons(QMessageBox::Ok);
+    msgBox.setStyleSheet(StyleSheet::getMessageBoxStyleSheet());
+    msgBox.exec();
+}
+
+void ConfigDialog::onBinaryProfilesToggled(bool enabled)
+{
+    Config& config = Config::instance();
+    if (enabled == config.useBinaryProfiles()) {
+        return;
+    }
+    
+    QMessageBox::StandardButton reply = QMessageBox::question(this,
+        "Convert Profiles?",
+        QString("Every profile will be converted to the %1 format now.\n\nContinue?")
+            .arg(enabled ? "binary" : "INI"),
+        QMessageBox::Yes | QMessageBox::No,
+        QMessageBox::No);
+    
+    if (reply != QMessageBox::Yes || !config.setUseBinaryProfiles(enabled)) {
+        if (reply == QMessageBox::Yes) {
+            QMessageBox::warning(this, "Conversion Failed",
+                "The profiles could not be converted and were left in their previous format.");
+        }
+        QSignalBlocker blocker(m_binaryProfilesCheck);
+        m_binaryProfilesCheck->setChecked(config.useBinaryProfiles());
+    }
+}
+
+void ConfigDialog::onExportProfile()
+{
+    QString currentProfile = Config::instance().getCurrentProfileName();
+    QString filePath = QFileDialog::getSaveFileName(
+        this,
+        "Export Profile",
+        currentProfile + ".ini",
+        "INI Files (*.ini);;All Files (*.*)"
+    );
+    
+    if (filePath.isEmpty()) {
+        return;
+    }
+    
+    if (!Config::instance().exportProfileToIni(currentProfile, filePath)) {
+        QMessageBox::critical(this, "Export Failed",
+                            QString("Failed to export profile \"%1\" to:\n%2").arg(currentProfile, filePath));
+        return;
+    }
+    
+    showFeedback(m_binaryProfilesCheck, QString("Exported \"%1\"").arg(currentProfile));
+}
+
+void ConfigDialog::onImportProfile()
+{
+    QString filePath = QFileDialog::getOpenFileName(
+        this,
+        "Import Profile",
+        QString(),
+        "INI Files (*.ini);;All Files (*.*)"
+    );
+    
+    if (filePath.isEmpty()) {
+        return;
+    }
+    
+    QString defaultName = QFileInfo(filePath).completeBaseName();
+    int counter = 2;
+    while (Config::instance().profileExists(defaultName)) {
+        defaultName = QString("%1 (%2)").arg(QFileInfo(filePath).completeBaseName()).arg(counter++);
+    }
+    
+    bool ok;
+    QString profileName = QInputDialog::getText(this,
+                                                "Import Profile",
+                                                "Import as profile:",
+                                                QLineEdit::Normal,
+                                                defaultName,
+                                                &ok);
+    
+    if (!ok || profileName.isEmpty()) {
+        return;
+    }
+    
+    if (profileName.contains('/') || profileName.contains('\\') || profileName.contains('.')) {
+        QMessageBox::warning(this, "Invalid Name",
+                           "Profile name cannot contain slashes or dots.");
+        return;
+    }
+    
+    if (Config::instance().profileExists(profileName)) {
+        QMessageBox::warning(this, "Profile Exists",
+                           QString("Profile \"%1\" already exists.").arg(profileName));
+        return;
+    }
+    
+    if (!Config::instance().importProfileFromIni(filePath, profileName)) {
+        QMessageBox::critical(this, "Import Failed",
+                            QString("Failed to import a profile from:\n%1").arg(filePath));
+        return;
+    }
+    
+    updateProfileDropdown();
+    QMessageBox::information(this, "Profile Imported",
+                           QString("Imported profile \"%1\". Select it in the profile list to use it.").arg(profileName));
+}
+
 void ConfigDialog::onCopyLegacyCategory(const QString& category)
 {
 }
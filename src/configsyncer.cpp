@@ -0,0 +1,97 @@
+#include "configsyncer.h"
+#include "logging.h"
+#include "profilestore.h"
+#include <QElapsedTimer>
+#include <QEvent>
+#include <QFileInfo>
+
+ProfileSettings::ProfileSettings(const QString& fileName, Format format, QObject *parent)
+    : QSettings(fileName, format, parent)
+{
+}
+
+bool ProfileSettings::event(QEvent *event)
+{
+    if (event->type() == QEvent::UpdateRequest) {
+        return true;
+    }
+    return QSettings::event(event);
+}
+
+ConfigSyncWorker::ConfigSyncWorker(QObject *parent)
+    : QObject(parent)
+    , m_debounceTimer(new QTimer(this))
+{
+    m_debounceTimer->setSingleShot(true);
+    m_debounceTimer->setInterval(SYNC_DEBOUNCE_MS);
+    connect(m_debounceTimer, &QTimer::timeout, this, &ConfigSyncWorker::syncNow);
+}
+
+void ConfigSyncWorker::scheduleSync(const QString& filePath)
+{
+    if (!m_settings || m_settings->fileName() != filePath) {
+        // Profile changed, write out the old file before switching over
+        syncNow();
+        m_settings = std::make_unique<QSettings>(filePath, ProfileStore::formatForPath(filePath));
+    }
+
+    m_debounceTimer->start();
+}
+
+void ConfigSyncWorker::syncNow()
+{
+    m_debounceTimer->stop();
+    if (!m_settings) {
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    m_settings->sync();
+
+    if (m_settings->status() != QSettings::NoError) {
+        qCWarning(lcLog) << "ConfigSyncer: Failed to write" << m_settings->fileName();
+        return;
+    }
+    qCDebug(lcLog) << "ConfigSyncer: Synced" << m_settings->fileName() << "in" << timer.elapsed() << "ms";
+
+    const QFileInfo fileInfo(m_settings->fileName());
+    emit synced(m_settings->fileName(), fileInfo.lastModified(), fileInfo.size());
+}
+
+ConfigSyncer::ConfigSyncer(QObject *parent)
+    : QObject(parent)
+    , m_workerThread(new QThread(this))
+    , m_worker(new ConfigSyncWorker())
+{
+    m_worker->moveToThread(m_workerThread);
+    connect(m_worker, &ConfigSyncWorker::synced, this, &ConfigSyncer::synced);
+    m_workerThread->start(QThread::LowPriority);
+}
+
+ConfigSyncer::~ConfigSyncer()
+{
+    flush();
+    m_workerThread->quit();
+    if (!m_workerThread->wait(3000)) {
+        qCWarning(lcLog) << "ConfigSyncer: Worker thread did not stop in time, terminating";
+        m_workerThread->terminate();
+        m_workerThread->wait();
+    }
+
+    // Manual deletion required - worker has no parent (moved to separate thread)
+    delete m_worker;
+    m_worker = nullptr;
+}
+
+void ConfigSyncer::scheduleSync(const QString& filePath)
+{
+    QMetaObject::invokeMethod(m_worker, "scheduleSync", Qt::QueuedConnection, Q_ARG(QString, filePath));
+}
+
+void ConfigSyncer::flush()
+{
+    if (m_workerThread->isRunning()) {
+        QMetaObject::invokeMethod(m_worker, "syncNow", Qt::BlockingQueuedConnection);
+    }
+}
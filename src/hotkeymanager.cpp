@@ -1,12 +1,16 @@
 #include "hotkeymanager.h"
+#include "logging.h"
 #include "config.h"
+#include "profilestore.h"
 #include "windowcapture.h"
+#include "windowsystem.h"
 #include <QStringList>
 #include <QSettings>
-#include <Psapi.h>
 
 HotkeyManager* HotkeyManager::s_instance = nullptr;
 
+static constexpr int DEFAULT_SUSPEND_KEY = 0x7B;  // VK_F12
+
 HotkeyManager::HotkeyManager(QObject *parent)
     : QObject(parent)
     , m_nextHotkeyId(1000)
@@ -19,7 +23,10 @@ HotkeyManager::HotkeyManager(QObject *parent)
     , m_closeAllClientsHotkeyId(-1)
 {
     s_instance = this;
+    connect(&WindowSystem::instance(), &WindowSystem::hotkeyPressed, this, &HotkeyManager::onHotkeyPressed);
     loadFromConfig();
+    
+    connect(&Config::instance(), &Config::settingsChanged, this, &HotkeyManager::onConfigChanged);
 }
 
 HotkeyManager::~HotkeyManager()
@@ -33,59 +40,57 @@ bool HotkeyManager::registerHotkey(const HotkeyBinding& binding, int& outHotkeyI
     if (!binding.enabled)
         return false;
 
-    UINT modifiers = 0;
-    if (binding.ctrl) modifiers |= MOD_CONTROL;
-    if (binding.alt) modifiers |= MOD_ALT;
-    if (binding.shift) modifiers |= MOD_SHIFT;
+    WindowSystem& windowSystem = WindowSystem::instance();
+    quint32 modifiers = binding.getModifiers();
 
     int hotkeyId = m_nextHotkeyId++;
     
     bool wildcardMode = Config::instance().wildcardHotkeys();
     
-    if (RegisterHotKey(nullptr, hotkeyId, modifiers, binding.keyCode))
+    if (windowSystem.registerHotkey(hotkeyId, modifiers, binding.keyCode))
     {
         outHotkeyId = hotkeyId;
         
         if (wildcardMode)
         {
-            QVector<UINT> additionalMods;
+            QVector<quint32> additionalMods;
             
             if (!binding.ctrl)
             {
-                additionalMods.append(modifiers | MOD_CONTROL);
+                additionalMods.append(modifiers | WindowSystem::HotkeyControl);
             }
             
             if (!binding.alt)
             {
-                additionalMods.append(modifiers | MOD_ALT);
+                additionalMods.append(modifiers | WindowSystem::HotkeyAlt);
             }
             
             if (!binding.shift)
             {
-                additionalMods.append(modifiers | MOD_SHIFT);
+                additionalMods.append(modifiers | WindowSystem::HotkeyShift);
             }
             
             if (!binding.ctrl && !binding.alt)
             {
-                additionalMods.append(modifiers | MOD_CONTROL | MOD_ALT);
+                additionalMods.append(modifiers | WindowSystem::HotkeyControl | WindowSystem::HotkeyAlt);
             }
             if (!binding.ctrl && !binding.shift)
             {
-                additionalMods.append(modifiers | MOD_CONTROL | MOD_SHIFT);
+                additionalMods.append(modifiers | WindowSystem::HotkeyControl | WindowSystem::HotkeyShift);
             }
             if (!binding.alt && !binding.shift)
             {
-                additionalMods.append(modifiers | MOD_ALT | MOD_SHIFT);
+                additionalMods.append(modifiers | WindowSystem::HotkeyAlt | WindowSystem::HotkeyShift);
             }
             if (!binding.ctrl && !binding.alt && !binding.shift)
             {
-                additionalMods.append(modifiers | MOD_CONTROL | MOD_ALT | MOD_SHIFT);
+                additionalMods.append(modifiers | WindowSystem::HotkeyControl | WindowSystem::HotkeyAlt | WindowSystem::HotkeyShift);
             }
             
-            for (UINT extraMod : additionalMods)
+            for (quint32 extraMod : additionalMods)
             {
                 int extraHotkeyId = m_nextHotkeyId++;
-                if (RegisterHotKey(nullptr, extraHotkeyId, extraMod, binding.keyCode))
+                if (windowSystem.registerHotkey(extraHotkeyId, extraMod, binding.keyCode))
                 {
                     m_wildcardAliases.insert(extraHotkeyId, hotkeyId);
                 }
@@ -102,7 +107,7 @@ bool HotkeyManager::registerHotkey(const HotkeyBinding& binding, int& outHotkeyI
 
 void HotkeyManager::unregisterHotkey(int hotkeyId)
 {
-    UnregisterHotKey(nullptr, hotkeyId);
+    WindowSystem::instance().unregisterHotkey(hotkeyId);
 }
 
 bool HotkeyManager::registerHotkeys()
@@ -145,7 +150,7 @@ bool HotkeyManager::registerHotkeys()
             int hotkeyId;
             if (registerHotkey(binding, hotkeyId))
             {
-                m_hotkeyIdToCharacter.insert(hotkeyId, characterName);
+                m_hotkeyIdToCharacter.insert(hotkeyId, CharacterRegistry::instance().intern(characterName));
             }
         }
     }
@@ -165,7 +170,7 @@ bool HotkeyManager::registerHotkeys()
         int hotkeyId;
         if (registerHotkey(binding, hotkeyId))
         {
-            m_hotkeyIdToCharacter.insert(hotkeyId, characterName);
+            m_hotkeyIdToCharacter.insert(hotkeyId, CharacterRegistry::instance().intern(characterName));
         }
     }
 
@@ -370,24 +375,12 @@ void HotkeyManager::unregisterHotkeys()
 
 static bool isForegroundWindowEVEClient()
 {
-    HWND foregroundWindow = GetForegroundWindow();
+    WindowSystem& windowSystem = WindowSystem::instance();
+    WindowId foregroundWindow = windowSystem.foregroundWindow();
     if (!foregroundWindow)
         return false;
     
-    DWORD processId = 0;
-    GetWindowThreadProcessId(foregroundWindow, &processId);
-    
-    HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, FALSE, processId);
-    if (!hProcess)
-        return false;
-    
-    wchar_t processNameBuffer[MAX_PATH];
-    QString processName;
-    if (GetModuleBaseNameW(hProcess, NULL, processNameBuffer, MAX_PATH)) {
-        processName = QString::fromWCharArray(processNameBuffer);
-    }
-    CloseHandle(hProcess);
-    
+    QString processName = windowSystem.processName(windowSystem.processId(foregroundWindow));
     if (processName.isEmpty())
         return false;
     
@@ -401,98 +394,86 @@ static bool isForegroundWindowEVEClient()
     return false;
 }
 
-bool HotkeyManager::nativeEventFilter(void* message, long* result)
+void HotkeyManager::onHotkeyPressed(int hotkeyId)
 {
-    if (!s_instance)
-        return false;
-        
-    MSG* msg = static_cast<MSG*>(message);
+    if (m_wildcardAliases.contains(hotkeyId))
+    {
+        hotkeyId = m_wildcardAliases.value(hotkeyId);
+    }
     
-    if (msg->message == WM_HOTKEY)
+    if (hotkeyId == m_suspendHotkeyId)
     {
-        int hotkeyId = static_cast<int>(msg->wParam);
-        
-        if (s_instance->m_wildcardAliases.contains(hotkeyId))
-        {
-            hotkeyId = s_instance->m_wildcardAliases.value(hotkeyId);
-        }
-        
-        if (hotkeyId == s_instance->m_suspendHotkeyId)
-        {
-            s_instance->toggleSuspended();
-            return true;
-        }
-        
-        if (s_instance->m_suspended)
-        {
-            return true;
-        }
-        
-        bool onlyWhenEVEFocused = Config::instance().hotkeysOnlyWhenEVEFocused();
-        if (onlyWhenEVEFocused && !isForegroundWindowEVEClient())
-        {
-            return false;
-        }
-        
-        if (s_instance->m_hotkeyIdToCharacter.contains(hotkeyId))
-        {
-            QString characterName = s_instance->m_hotkeyIdToCharacter.value(hotkeyId);
-            emit s_instance->characterHotkeyPressed(characterName);
-            return false;  // Allow message to continue, preserving keyboard state
-        }
-        
-        if (s_instance->m_hotkeyIdToCycleGroup.contains(hotkeyId))
-        {
-            QString groupName = s_instance->m_hotkeyIdToCycleGroup.value(hotkeyId);
-            bool isForward = s_instance->m_hotkeyIdIsForward.value(hotkeyId, true);
-            
-            if (isForward)
-                emit s_instance->namedCycleForwardPressed(groupName);
-            else
-                emit s_instance->namedCycleBackwardPressed(groupName);
-            
-            return false;
-        }
-        
-        if (hotkeyId == s_instance->m_notLoggedInForwardHotkeyId)
-        {
-            emit s_instance->notLoggedInCycleForwardPressed();
-            return false;
-        }
-        
-        if (hotkeyId == s_instance->m_notLoggedInBackwardHotkeyId)
-        {
-            emit s_instance->notLoggedInCycleBackwardPressed();
-            return false;
-        }
-        
-        if (hotkeyId == s_instance->m_nonEVEForwardHotkeyId)
-        {
-            emit s_instance->nonEVECycleForwardPressed();
-            return false;
-        }
-        
-        if (hotkeyId == s_instance->m_nonEVEBackwardHotkeyId)
-        {
-            emit s_instance->nonEVECycleBackwardPressed();
-            return false;
-        }
+        toggleSuspended();
+        return;
+    }
+    
+    if (m_suspended)
+    {
+        return;
+    }
+    
+    bool onlyWhenEVEFocused = Config::instance().hotkeysOnlyWhenEVEFocused();
+    if (onlyWhenEVEFocused && !isForegroundWindowEVEClient())
+    {
+        return;
+    }
+    
+    auto character = m_hotkeyIdToCharacter.constFind(hotkeyId);
+    if (character != m_hotkeyIdToCharacter.constEnd())
+    {
+        emit characterHotkeyPressed(character.value());
+        return;  // Allow message to continue, preserving keyboard state
+    }
+    
+    if (m_hotkeyIdToCycleGroup.contains(hotkeyId))
+    {
+        QString groupName = m_hotkeyIdToCycleGroup.value(hotkeyId);
+        bool isForward = m_hotkeyIdIsForward.value(hotkeyId, true);
         
-        if (hotkeyId == s_instance->m_closeAllClientsHotkeyId)
-        {
-            emit s_instance->closeAllClientsRequested();
-            return false;
-        }
+        if (isForward)
+            emit namedCycleForwardPressed(groupName);
+        else
+            emit namedCycleBackwardPressed(groupName);
         
-        if (s_instance->m_hotkeyIdToProfile.contains(hotkeyId))
-        {
-            QString profileName = s_instance->m_hotkeyIdToProfile.value(hotkeyId);
-            emit s_instance->profileSwitchRequested(profileName);
-            return false;
-        }
+        return;
     }
     
-    return false;
+    if (hotkeyId == m_notLoggedInForwardHotkeyId)
+    {
+        emit notLoggedInCycleForwardPressed();
+        return;
+    }
+    
+    if (hotkeyId == m_notLoggedInBackwardHotkeyId)
+    {
+        emit notLoggedInCycleBackwardPressed();
+        return;
+    }
+    
+    if (hotkeyId == m_nonEVEForwardHotkeyId)
+    {
+        emit nonEVECycleForwardPressed();
+        return;
+    }
+    
+    if (hotkeyId == m_nonEVEBackwardHotkeyId)
+    {
+        emit nonEVECycleBackwardPressed();
+        return;
+    }
+    
+    if (hotkeyId == m_closeAllClientsHotkeyId)
+    {
+        emit closeAllClientsRequested();
+        return;
+    }
+    
+    if (m_hotkeyIdToProfile.contains(hotkeyId))
+    {
+        QString profileName = m_hotkeyIdToProfile.value(hotkeyId);
+        emit profileSwitchRequested(profileName);
+        return;
+    }
 }
 
 void HotkeyManager::setSuspended(bool suspended)
@@ -609,18 +590,21 @@ void HotkeyManager::createCycleGroup(const QString& groupName, const QVector<QSt
     m_cycleGroups.insert(groupName, group);
     registerHotkeys();
     saveToConfig();
+    emit cycleGroupsChanged();
 }
 
 void HotkeyManager::createCycleGroup(const CycleGroup& group)
 {
     m_cycleGroups.insert(group.groupName, group);
     registerHotkeys();
+    emit cycleGroupsChanged();
 }
 
 void HotkeyManager::removeCycleGroup(const QString& groupName)
 {
     m_cycleGroups.remove(groupName);
     registerHotkeys();
+    emit cycleGroupsChanged();
 }
 
 CycleGroup HotkeyManager::getCycleGroup(const QString& groupName) const
@@ -648,24 +632,40 @@ void HotkeyManager::setCloseAllClientsHotkey(const HotkeyBinding& binding)
     registerHotkeys();
 }
 
-void HotkeyManager::updateCharacterWindows(const QHash<QString, HWND>& characterWindows)
+void HotkeyManager::onConfigChanged(Config::ChangeGroups groups, const Config::SettingSet& changed)
+{
+    // Bindings are stored per profile, the hotkey settings only affect how they are registered
+    bool wildcardChanged = changed.test(static_cast<size_t>(Config::Setting::WildcardHotkeys));
+    if (groups & Config::HotkeyBindingChanges) {
+        loadFromConfig();
+    } else if (wildcardChanged) {
+        registerHotkeys();
+    }
+}
+
+void HotkeyManager::updateCharacterWindows(const QHash<CharacterId, WindowId>& characterWindows)
 {
     m_characterWindows = characterWindows;
 }
 
-HWND HotkeyManager::getWindowForCharacter(const QString& characterName) const
+WindowId HotkeyManager::getWindowForCharacter(CharacterId characterId) const
+{
+    return m_characterWindows.value(characterId, 0);
+}
+
+WindowId HotkeyManager::getWindowForCharacter(const QString& characterName) const
 {
-    return m_characterWindows.value(characterName, nullptr);
+    return getWindowForCharacter(CharacterRegistry::instance().find(characterName));
 }
 
-QString HotkeyManager::getCharacterForWindow(HWND hwnd) const
+CharacterId HotkeyManager::getCharacterForWindow(WindowId hwnd) const
 {
     for (auto it = m_characterWindows.constBegin(); it != m_characterWindows.constEnd(); ++it) {
         if (it.value() == hwnd) {
             return it.key();
         }
     }
-    return QString(); 
+    return CharacterRegistry::INVALID_ID;
 }
 
 int HotkeyManager::generateHotkeyId()
@@ -675,7 +675,8 @@ int HotkeyManager::generateHotkeyId()
 
 void HotkeyManager::loadFromConfig()
 {
-    QSettings settings(Config::instance().configFilePath(), QSettings::IniFormat);
+    QString profilePath = Config::instance().configFilePath();
+    QSettings settings(profilePath, ProfileStore::formatForPath(profilePath));
     
     // Clear previous hotkey data to prevent accumulation
     m_suspendHotkeys.clear();
@@ -703,11 +704,11 @@ void HotkeyManager::loadFromConfig()
                 }
             }
         }
-        m_suspendHotkey = !m_suspendHotkeys.isEmpty() ? m_suspendHotkeys.first() : HotkeyBinding(VK_F12, true, true, true, true);
+        m_suspendHotkey = !m_suspendHotkeys.isEmpty() ? m_suspendHotkeys.first() : HotkeyBinding(DEFAULT_SUSPEND_KEY, true, true, true, true);
     }
     else
     {
-        m_suspendHotkey = HotkeyBinding(VK_F12, true, true, true, true);
+        m_suspendHotkey = HotkeyBinding(DEFAULT_SUSPEND_KEY, true, true, true, true);
     }
     settings.endGroup();
     
@@ -910,11 +911,13 @@ void HotkeyManager::loadFromConfig()
     settings.endGroup();
     
     registerHotkeys();
+    emit cycleGroupsChanged();
 }
 
 void HotkeyManager::saveToConfig()
 {
-    QSettings settings(Config::instance().configFilePath(), QSettings::IniFormat);
+    QString profilePath = Config::instance().configFilePath();
+    QSettings settings(profilePath, ProfileStore::formatForPath(profilePath));
     
     settings.beginGroup("hotkeys");
     // Save suspend hotkeys (multi-hotkey support)
@@ -1067,6 +1070,7 @@ void HotkeyManager::saveToConfig()
     settings.endGroup();
     
     settings.sync();
+    Config::instance().noteHotkeyBindingsSaved();
 }
 
 bool HotkeyBinding::operator<(const HotkeyBinding& other) const
@@ -1133,18 +1137,18 @@ void HotkeyManager::registerProfileHotkeys()
         QString conflict = findHotkeyConflict(binding, profileName);
         if (!conflict.isEmpty())
         {
-            qWarning() << "Profile hotkey for" << profileName << "conflicts with" << conflict;
+            qCWarning(lcHotkey) << "Profile hotkey for" << profileName << "conflicts with" << conflict;
         }
         
         int hotkeyId;
         if (registerHotkey(binding, hotkeyId))
         {
             m_hotkeyIdToProfile.insert(hotkeyId, profileName);
-            qDebug() << "Registered profile hotkey for" << profileName << "with ID" << hotkeyId;
+            qCDebug(lcHotkey) << "Registered profile hotkey for" << profileName << "with ID" << hotkeyId;
         }
         else
         {
-            qWarning() << "Failed to register profile hotkey for" << profileName << "- hotkey may already be in use";
+            qCWarning(lcHotkey) << "Failed to register profile hotkey for" << profileName << "- hotkey may already be in use";
         }
     }
 }
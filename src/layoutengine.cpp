@@ -0,0 +1,220 @@
+#include "layoutengine.h"
+#include <algorithm>
+#include <numeric>
+
+namespace {
+
+// Walks grid cells row by row across each screen in turn
+class CellCursor
+{
+public:
+    CellCursor(const QVector<QRect>& screens, const QSize& size, int margin)
+        : m_screens(screens)
+        , m_size(size)
+        , m_margin(margin)
+    {
+    }
+
+    QRect cell() const
+    {
+        const QRect& area = m_screens[m_screen];
+        return QRect(area.left() + m_margin + m_column * (m_size.width() + m_margin),
+                     area.top() + m_margin + m_row * (m_size.height() + m_margin),
+                     m_size.width(), m_size.height());
+    }
+
+    bool atRowStart() const { return m_column == 0; }
+    // Set once every cell on every screen has been handed out
+    bool exhausted() const { return m_exhausted; }
+
+    void next()
+    {
+        if (++m_column >= columns()) {
+            nextRow();
+        }
+    }
+
+    void nextRow()
+    {
+        m_column = 0;
+        if (++m_row >= rows()) {
+            m_row = 0;
+            if (++m_screen >= m_screens.size()) {
+                m_screen = 0;
+                m_exhausted = true;
+            }
+        }
+    }
+
+private:
+    int columns() const
+    {
+        return std::max(1, (m_screens[m_screen].width() - m_margin) / (m_size.width() + m_margin));
+    }
+
+    int rows() const
+    {
+        return std::max(1, (m_screens[m_screen].height() - m_margin) / (m_size.height() + m_margin));
+    }
+
+    const QVector<QRect>& m_screens;
+    const QSize m_size;
+    const int m_margin;
+    int m_screen = 0;
+    int m_row = 0;
+    int m_column = 0;
+    bool m_exhausted = false;
+};
+
+}
+
+QVector<QRect> LayoutEngine::layout(const QVector<Item>& items, const Parameters& parameters)
+{
+    const QSize size = parameters.thumbnailSize;
+    const int margin = parameters.margin;
+    QVector<QRect> result(items.size());
+    if (items.isEmpty()) {
+        return result;
+    }
+
+    QVector<QRect> screens = parameters.screens;
+    if (screens.isEmpty()) {
+        screens.append(QRect(QPoint(0, 0), size.grownBy(QMargins(margin, margin, margin, margin))));
+    }
+
+    // Groups are placed in order, callers' order holds within each
+    QVector<int> order(items.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&items](int a, int b) {
+        return items[a].group < items[b].group;
+    });
+
+    QVector<QRect> occupied;
+    QVector<int> pending;
+    int notLoggedInIndex = 0;
+    for (int index : order) {
+        const Item& item = items[index];
+        QRect saved(item.savedPosition, size);
+        if (item.savedPosition != QPoint(-1, -1) && isOnScreen(saved, screens)) {
+            result[index] = saved;
+            occupied.append(saved);
+        } else if (item.notLoggedIn) {
+            result[index] = QRect(notLoggedInPosition(notLoggedInIndex++, parameters), size);
+            occupied.append(result[index]);
+        } else {
+            pending.append(index);
+        }
+    }
+
+    if (pending.isEmpty()) {
+        return result;
+    }
+
+    const int step = size.width() + margin;
+    const int rowStep = size.height() + margin;
+
+    switch (parameters.strategy) {
+    case Strategy::Grid: {
+        const QRect& area = screens.first();
+        int x = area.left() + margin;
+        int y = area.top() + margin;
+        int group = items[pending.first()].group;
+        for (int index : pending) {
+            if (items[index].group != group && x != area.left() + margin) {
+                x = area.left() + margin;
+                y += rowStep;
+            }
+            group = items[index].group;
+
+            if (x + size.width() > area.left() + area.width() - margin) {
+                x = area.left() + margin;
+                y += rowStep;
+            }
+            // Past the bottom the grid starts over on top of itself
+            if (y + size.height() > area.top() + area.height() - margin) {
+                y = area.top() + margin;
+            }
+
+            result[index] = QRect(QPoint(x, y), size);
+            x += step;
+        }
+        break;
+    }
+    case Strategy::MonitorColumns: {
+        int screen = 0;
+        int x = screens[screen].left() + margin;
+        int y = screens[screen].top() + margin;
+        int group = items[pending.first()].group;
+        for (int index : pending) {
+            const QRect* area = &screens[screen];
+            if (items[index].group != group && y != area->top() + margin) {
+                y = area->top() + margin;
+                x += step;
+            }
+            group = items[index].group;
+
+            if (y + size.height() > area->top() + area->height() - margin) {
+                y = area->top() + margin;
+                x += step;
+            }
+            if (x + size.width() > area->left() + area->width() - margin) {
+                screen = (screen + 1) % screens.size();
+                area = &screens[screen];
+                x = area->left() + margin;
+                y = area->top() + margin;
+            }
+
+            result[index] = QRect(QPoint(x, y), size);
+            y += rowStep;
+        }
+        break;
+    }
+    case Strategy::PackAroundSaved: {
+        CellCursor cursor(screens, size, margin);
+        auto isFree = [&occupied](const QRect& cell) {
+            return std::none_of(occupied.cbegin(), occupied.cend(), [&cell](const QRect& rect) {
+                return rect.intersects(cell);
+            });
+        };
+
+        int group = items[pending.first()].group;
+        for (int index : pending) {
+            if (items[index].group != group && !cursor.atRowStart()) {
+                cursor.nextRow();
+            }
+            group = items[index].group;
+
+            // Once every screen is full the remaining thumbnails overlap from the first cell
+            while (!cursor.exhausted() && !isFree(cursor.cell())) {
+                cursor.next();
+            }
+
+            result[index] = cursor.cell();
+            cursor.next();
+        }
+        break;
+    }
+    }
+
+    return result;
+}
+
+bool LayoutEngine::isOnScreen(const QRect& rect, const QVector<QRect>& screens)
+{
+    return std::any_of(screens.cbegin(), screens.cend(), [&rect](const QRect& screen) {
+        return screen.intersects(rect);
+    });
+}
+
+QPoint LayoutEngine::notLoggedInPosition(int index, const Parameters& parameters)
+{
+    const QSize size = parameters.thumbnailSize;
+    switch (parameters.notLoggedInStackMode) {
+    case 0:
+        return parameters.notLoggedInOrigin + QPoint(index * (size.width() + parameters.margin), 0);
+    case 1:
+        return parameters.notLoggedInOrigin + QPoint(0, index * (size.height() + parameters.margin));
+    default:
+        return parameters.notLoggedInOrigin;
+    }
+}
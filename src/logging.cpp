@@ -0,0 +1,224 @@
+#include "logging.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QThread>
+#include <QDebug>
+#include <cstring>
+
+Q_LOGGING_CATEGORY(lcLog, "eveapm.log", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcOverlay, "eveapm.overlay", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcHotkey, "eveapm.hotkey", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcWindow, "eveapm.window", QtInfoMsg)
+
+// Bounded multi-producer ring: a slot is free for the producer at position p
+// when its sequence equals p, and ready for the flush thread when it equals
+// p + 1.
+struct LogSink::Slot {
+    std::atomic<quint64> sequence{0};
+    qint64 timestamp = 0;
+    QtMsgType type = QtDebugMsg;
+    const char* category = nullptr;
+    int length = 0;
+    char16_t text[MAX_MESSAGE_CHARS];
+};
+
+LogSink& LogSink::instance()
+{
+    static LogSink instance;
+    return instance;
+}
+
+LogSink::LogSink() = default;
+
+LogSink::~LogSink()
+{
+    shutdown();
+}
+
+QString LogSink::logDirectory()
+{
+    return QCoreApplication::applicationDirPath() + "/logs";
+}
+
+void LogSink::setDebugEnabled(bool enabled)
+{
+    QLoggingCategory::setFilterRules(enabled ? QStringLiteral("eveapm.*.debug=true")
+                                             : QStringLiteral("eveapm.*.debug=false"));
+}
+
+void LogSink::setFileEnabled(bool enabled)
+{
+    if (enabled == m_fileEnabled) {
+        return;
+    }
+
+    if (!enabled) {
+        shutdown();
+        return;
+    }
+
+    if (!m_slots) {
+        m_slots.reset(new Slot[RING_CAPACITY]);
+        for (quint64 i = 0; i < RING_CAPACITY; ++i) {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        m_enqueuePosition.store(0, std::memory_order_relaxed);
+        m_dequeuePosition = 0;
+    }
+
+    QDir().mkpath(logDirectory());
+    m_file.setFileName(logDirectory() + "/eveapm.log");
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+        qWarning() << "LogSink: Cannot open log file" << m_file.fileName();
+        return;
+    }
+
+    m_stopping.store(false);
+    m_flushThread = QThread::create([this]() { flushLoop(); });
+    m_flushThread->setObjectName("LogSinkFlush");
+    m_flushThread->start(QThread::LowPriority);
+
+    m_fileEnabled = true;
+    m_previousHandler = qInstallMessageHandler(&LogSink::messageHandler);
+}
+
+void LogSink::shutdown()
+{
+    if (!m_fileEnabled) {
+        return;
+    }
+
+    qInstallMessageHandler(m_previousHandler);
+    m_previousHandler = nullptr;
+    m_fileEnabled = false;
+
+    m_stopping.store(true);
+    {
+        QMutexLocker locker(&m_wakeMutex);
+        m_wakeCondition.wakeAll();
+    }
+    m_flushThread->wait();
+    delete m_flushThread;
+    m_flushThread = nullptr;
+
+    m_file.close();
+}
+
+void LogSink::messageHandler(QtMsgType type, const QMessageLogContext& context, const QString& message)
+{
+    LogSink& sink = instance();
+    bool queued = sink.push(type, context.category ? context.category : "default", message);
+
+    // Warnings and worse still reach the debugger immediately
+    bool forward = !queued || (type != QtDebugMsg && type != QtInfoMsg);
+    if (forward && sink.m_previousHandler) {
+        sink.m_previousHandler(type, context, message);
+    }
+}
+
+bool LogSink::push(QtMsgType type, const char* category, const QString& message)
+{
+    quint64 position = m_enqueuePosition.load(std::memory_order_relaxed);
+    Slot* slot = nullptr;
+    for (;;) {
+        slot = &m_slots[position & (RING_CAPACITY - 1)];
+        quint64 sequence = slot->sequence.load(std::memory_order_acquire);
+        qint64 diff = qint64(sequence) - qint64(position);
+        if (diff == 0) {
+            if (m_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            position = m_enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    const int length = qMin(int(message.size()), MAX_MESSAGE_CHARS);
+    slot->timestamp = QDateTime::currentMSecsSinceEpoch();
+    slot->type = type;
+    slot->category = category;
+    slot->length = length;
+    std::memcpy(slot->text, message.utf16(), size_t(length) * sizeof(char16_t));
+
+    slot->sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+void LogSink::flushLoop()
+{
+    while (!m_stopping.load()) {
+        drain();
+
+        QMutexLocker locker(&m_wakeMutex);
+        if (!m_stopping.load()) {
+            m_wakeCondition.wait(&m_wakeMutex, FLUSH_INTERVAL_MS);
+        }
+    }
+    drain();
+}
+
+int LogSink::drain()
+{
+    int count = 0;
+    for (;;) {
+        Slot& slot = m_slots[m_dequeuePosition & (RING_CAPACITY - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != m_dequeuePosition + 1) {
+            break;
+        }
+
+        writeSlot(slot);
+        slot.sequence.store(m_dequeuePosition + RING_CAPACITY, std::memory_order_release);
+        ++m_dequeuePosition;
+        ++count;
+    }
+
+    quint64 dropped = m_dropped.exchange(0, std::memory_order_relaxed);
+    if (dropped > 0) {
+        m_file.write(QString("%1 [W] eveapm.log: %2 messages dropped, log writer fell behind\n")
+                         .arg(QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss.zzz"))
+                         .arg(dropped)
+                         .toUtf8());
+    }
+
+    if (count > 0 || dropped > 0) {
+        m_file.flush();
+        rotateIfNeeded();
+    }
+    return count;
+}
+
+void LogSink::writeSlot(const Slot& slot)
+{
+    static const char levels[] = {'D', 'W', 'C', 'F', 'I'};
+    const char level = (slot.type >= 0 && slot.type < int(sizeof(levels))) ? levels[slot.type] : '?';
+
+    QString line = QString("%1 [%2] %3: %4\n")
+        .arg(QDateTime::fromMSecsSinceEpoch(slot.timestamp).toString("yyyy-MM-dd HH:mm:ss.zzz"))
+        .arg(QChar(level))
+        .arg(QString::fromLatin1(slot.category))
+        .arg(QString::fromUtf16(slot.text, slot.length));
+    m_file.write(line.toUtf8());
+}
+
+void LogSink::rotateIfNeeded()
+{
+    if (m_file.size() < MAX_FILE_BYTES) {
+        return;
+    }
+
+    const QString base = logDirectory() + "/eveapm";
+    m_file.close();
+
+    QFile::remove(QString("%1.%2.log").arg(base).arg(MAX_ROTATED_FILES));
+    for (int i = MAX_ROTATED_FILES - 1; i >= 1; --i) {
+        QFile::rename(QString("%1.%2.log").arg(base).arg(i), QString("%1.%2.log").arg(base).arg(i + 1));
+    }
+    QFile::rename(base + ".log", base + ".1.log");
+
+    m_file.setFileName(base + ".log");
+    m_file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text);
+}
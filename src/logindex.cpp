@@ -0,0 +1,1020 @@
+#include "logindex.h"
+#include "logging.h"
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QSaveFile>
+#include <QSet>
+#include <QElapsedTimer>
+#include <QMutexLocker>
+#include <QRegularExpression>
+#include <QTimeZone>
+#include <QDebug>
+#include <Windows.h>
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <numeric>
+
+namespace {
+
+// Segment layout, little endian and naturally aligned so it can be read in
+// place from a memory mapping:
+//   SegmentHeader
+//   BlockRecord[blockCount]
+//   TrigramRecord[trigramCount]   sorted by trigram
+//   quint32 postings[postingCount] block ids, ascending per trigram
+constexpr quint32 SEGMENT_MAGIC = 0x49544C45;  // "ELTI"
+constexpr quint32 SEGMENT_VERSION = 1;
+constexpr quint32 CATALOG_MAGIC = 0x43544C45;  // "ELTC"
+constexpr quint32 CATALOG_VERSION = 1;
+constexpr int BLOCK_MAX_LINES = 32;
+constexpr qint64 BLOCK_MAX_BYTES = 4096;
+constexpr int STARTUP_DELAY_MS = 30000;
+constexpr const char* CATALOG_FILE = "catalog.dat";
+constexpr const char* SEGMENT_FILTER = "*.seg";
+
+struct SegmentHeader {
+    quint32 magic;
+    quint32 version;
+    quint32 blockCount;
+    quint32 trigramCount;
+    quint32 postingCount;
+    quint32 reserved;
+};
+
+struct BlockRecord {
+    quint32 fileId;
+    quint32 length;
+    qint64 offset;
+    qint64 firstTimestamp;
+    qint64 lastTimestamp;
+};
+
+struct TrigramRecord {
+    quint32 trigram;
+    quint32 postingsOffset;
+    quint32 postingsCount;
+};
+
+static_assert(sizeof(SegmentHeader) == 24, "SegmentHeader layout changed");
+static_assert(sizeof(BlockRecord) == 32, "BlockRecord layout changed");
+static_assert(sizeof(TrigramRecord) == 12, "TrigramRecord layout changed");
+
+struct RawLine {
+    qint64 offset;
+    qint64 length;
+};
+
+quint32 trigramKey(const QChar* chars)
+{
+    quint32 hash = 2166136261u;
+    for (int i = 0; i < 3; ++i) {
+        hash = (hash ^ chars[i].unicode()) * 16777619u;
+    }
+    return hash;
+}
+
+void collectTrigrams(const QString& lowered, QSet<quint32>& trigrams)
+{
+    const QChar* chars = lowered.constData();
+    for (int i = 0; i + 3 <= lowered.size(); ++i) {
+        trigrams.insert(trigramKey(chars + i));
+    }
+}
+
+qint64 parseTimestamp(const QString& line)
+{
+    static const QRegularExpression pattern(R"(^\[\s*(\d{4}\.\d{2}\.\d{2} \d{2}:\d{2}:\d{2})\s*\])");
+
+    QRegularExpressionMatch match = pattern.match(line);
+    if (!match.hasMatch()) {
+        return 0;
+    }
+
+    // EVE writes log timestamps in UTC
+    QDateTime timestamp = QDateTime::fromString(match.captured(1), "yyyy.MM.dd HH:mm:ss");
+    timestamp.setTimeZone(QTimeZone::UTC);
+    return timestamp.isValid() ? timestamp.toMSecsSinceEpoch() : 0;
+}
+
+QString decodeLine(const char* data, qint64 length, bool utf16)
+{
+    QString line = utf16
+        ? QString::fromUtf16(reinterpret_cast<const char16_t*>(data), length / 2)
+        : QString::fromUtf8(data, length);
+    if (line.endsWith('\r')) {
+        line.chop(1);
+    }
+    return line;
+}
+
+// Splits raw bytes into complete lines. consumed is set to the byte count up
+// to and including the last newline, a trailing partial line is left for the
+// next pass.
+QVector<RawLine> splitLines(const QByteArray& bytes, bool utf16, qint64& consumed)
+{
+    QVector<RawLine> lines;
+    const char* data = bytes.constData();
+    const qint64 size = bytes.size();
+    const int unit = utf16 ? 2 : 1;
+
+    qint64 start = 0;
+    for (qint64 i = 0; i + unit <= size; i += unit) {
+        bool newline = utf16 ? (data[i] == '\n' && data[i + 1] == '\0') : data[i] == '\n';
+        if (newline) {
+            lines.append({start, i - start});
+            start = i + unit;
+        }
+    }
+
+    consumed = start;
+    return lines;
+}
+
+bool readCatalog(const QString& path, QVector<LogIndexedFile>& files, QStringList& segmentNames, quint32& nextSegmentId)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    in >> magic >> version;
+    if (magic != CATALOG_MAGIC || version != CATALOG_VERSION) {
+        qCWarning(lcLog) << "LogIndex: Ignoring catalog with unknown format" << path;
+        return false;
+    }
+
+    qint32 fileCount = 0;
+    in >> nextSegmentId >> segmentNames >> fileCount;
+
+    files.clear();
+    files.reserve(qMax(0, fileCount));
+    for (qint32 i = 0; i < fileCount && in.status() == QDataStream::Ok; ++i) {
+        LogIndexedFile entry;
+        in >> entry.path >> entry.channel >> entry.listener >> entry.indexedBytes >> entry.utf16;
+        files.append(entry);
+    }
+
+    if (in.status() != QDataStream::Ok) {
+        qCWarning(lcLog) << "LogIndex: Catalog is truncated" << path;
+        files.clear();
+        segmentNames.clear();
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+struct MappedLogSegment {
+    QFile file;
+    const SegmentHeader* header = nullptr;
+    const BlockRecord* blocks = nullptr;
+    const TrigramRecord* trigrams = nullptr;
+    const quint32* postings = nullptr;
+    // Block id ranges [first, last) per file. A pass writes each file's blocks
+    // back to back, so a channel or character filter selects whole ranges.
+    QHash<quint32, QVector<QPair<quint32, quint32>>> fileBlocks;
+
+    bool open(const QString& path)
+    {
+        file.setFileName(path);
+        if (!file.open(QIODevice::ReadOnly)) {
+            return false;
+        }
+
+        const qint64 size = file.size();
+        if (size < qint64(sizeof(SegmentHeader))) {
+            return false;
+        }
+
+        const uchar* data = file.map(0, size);
+        if (!data) {
+            return false;
+        }
+
+        header = reinterpret_cast<const SegmentHeader*>(data);
+        if (header->magic != SEGMENT_MAGIC || header->version != SEGMENT_VERSION) {
+            return false;
+        }
+
+        const qint64 expected = qint64(sizeof(SegmentHeader))
+            + qint64(header->blockCount) * sizeof(BlockRecord)
+            + qint64(header->trigramCount) * sizeof(TrigramRecord)
+            + qint64(header->postingCount) * sizeof(quint32);
+        if (expected != size) {
+            return false;
+        }
+
+        blocks = reinterpret_cast<const BlockRecord*>(data + sizeof(SegmentHeader));
+        trigrams = reinterpret_cast<const TrigramRecord*>(blocks + header->blockCount);
+        postings = reinterpret_cast<const quint32*>(trigrams + header->trigramCount);
+
+        for (quint32 b = 0; b < header->blockCount; ++b) {
+            QVector<QPair<quint32, quint32>>& ranges = fileBlocks[blocks[b].fileId];
+            if (!ranges.isEmpty() && ranges.last().second == b) {
+                ranges.last().second = b + 1;
+            } else {
+                ranges.append(qMakePair(b, b + 1));
+            }
+        }
+        return true;
+    }
+
+    // Ascending ids of the blocks belonging to any of the files
+    QVector<quint32> blocksOfFiles(const QSet<quint32>& fileIds) const
+    {
+        QVector<quint32> result;
+        for (quint32 fileId : fileIds) {
+            const auto ranges = fileBlocks.constFind(fileId);
+            if (ranges == fileBlocks.cend()) {
+                continue;
+            }
+            for (const auto& range : *ranges) {
+                for (quint32 b = range.first; b < range.second; ++b) {
+                    result.append(b);
+                }
+            }
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    const TrigramRecord* find(quint32 trigram) const
+    {
+        const TrigramRecord* end = trigrams + header->trigramCount;
+        const TrigramRecord* it = std::lower_bound(trigrams, end, trigram,
+            [](const TrigramRecord& record, quint32 value) { return record.trigram < value; });
+        return (it != end && it->trigram == trigram) ? it : nullptr;
+    }
+
+    // Blocks containing every trigram, intersecting the shortest lists first.
+    // fileFilter, when given, limits them to the blocks of those files.
+    QVector<quint32> candidateBlocks(const QSet<quint32>& queryTrigrams, const QSet<quint32>* fileFilter) const
+    {
+        QVector<quint32> result;
+        if (queryTrigrams.isEmpty()) {
+            if (fileFilter) {
+                return blocksOfFiles(*fileFilter);
+            }
+            result.resize(header->blockCount);
+            std::iota(result.begin(), result.end(), 0u);
+            return result;
+        }
+
+        QVector<const TrigramRecord*> records;
+        records.reserve(queryTrigrams.size());
+        for (quint32 trigram : queryTrigrams) {
+            const TrigramRecord* record = find(trigram);
+            if (!record) {
+                return result;
+            }
+            records.append(record);
+        }
+
+        std::sort(records.begin(), records.end(), [](const TrigramRecord* a, const TrigramRecord* b) {
+            return a->postingsCount < b->postingsCount;
+        });
+
+        const quint32* first = postings + records[0]->postingsOffset;
+        result = QVector<quint32>(first, first + records[0]->postingsCount);
+        for (int i = 1; i < records.size() && !result.isEmpty(); ++i) {
+            const quint32* list = postings + records[i]->postingsOffset;
+            QVector<quint32> narrowed;
+            std::set_intersection(result.cbegin(), result.cend(), list, list + records[i]->postingsCount,
+                                  std::back_inserter(narrowed));
+            result.swap(narrowed);
+        }
+
+        if (fileFilter && !result.isEmpty()) {
+            const QVector<quint32> allowed = blocksOfFiles(*fileFilter);
+            QVector<quint32> narrowed;
+            std::set_intersection(result.cbegin(), result.cend(), allowed.cbegin(), allowed.cend(),
+                                  std::back_inserter(narrowed));
+            result.swap(narrowed);
+        }
+        return result;
+    }
+};
+
+LogIndexReader::LogIndexReader(const QString& indexDirectory)
+{
+    QStringList segmentNames;
+    quint32 nextSegmentId = 0;
+    if (!readCatalog(indexDirectory + "/" + CATALOG_FILE, m_files, segmentNames, nextSegmentId)) {
+        return;
+    }
+
+    for (const QString& name : segmentNames) {
+        auto segment = std::make_unique<MappedLogSegment>();
+        if (segment->open(indexDirectory + "/" + name)) {
+            m_segments.push_back(std::move(segment));
+        } else {
+            qCWarning(lcLog) << "LogIndexReader: Failed to map segment" << name;
+        }
+    }
+}
+
+LogIndexReader::~LogIndexReader() = default;
+
+QVector<LogSearchHit> LogIndexReader::search(const LogSearchQuery& query) const
+{
+    QVector<LogSearchHit> hits;
+    const QString phrase = query.phrase.trimmed().toLower();
+    if (phrase.isEmpty() && query.channel.isEmpty() && query.character.isEmpty()) {
+        return hits;
+    }
+
+    QSet<quint32> queryTrigrams;
+    collectTrigrams(phrase, queryTrigrams);
+
+    // Channel and character are per-file, resolved once against the catalog
+    const bool fileFiltered = !query.channel.isEmpty() || !query.character.isEmpty();
+    QSet<quint32> matchingFiles;
+    if (fileFiltered) {
+        for (int i = 0; i < m_files.size(); ++i) {
+            const LogIndexedFile& file = m_files[i];
+            if (file.isRemoved()) {
+                continue;
+            }
+            if (!query.channel.isEmpty() && file.channel.compare(query.channel, Qt::CaseInsensitive) != 0) {
+                continue;
+            }
+            if (!query.character.isEmpty() && file.listener.compare(query.character, Qt::CaseInsensitive) != 0) {
+                continue;
+            }
+            matchingFiles.insert(quint32(i));
+        }
+        if (matchingFiles.isEmpty()) {
+            return hits;
+        }
+    }
+
+    const bool timeFiltered = query.from.isValid() || query.to.isValid();
+    const qint64 fromMs = query.from.isValid() ? query.from.toMSecsSinceEpoch() : std::numeric_limits<qint64>::min();
+    const qint64 toMs = query.to.isValid() ? query.to.toMSecsSinceEpoch() : std::numeric_limits<qint64>::max();
+
+    QHash<quint32, QFile*> openFiles;
+    bool full = false;
+
+    // Newest segments and blocks first so the result cap drops the oldest hits
+    for (auto segmentIt = m_segments.crbegin(); segmentIt != m_segments.crend() && !full; ++segmentIt) {
+        const MappedLogSegment& segment = **segmentIt;
+        const QVector<quint32> candidates = segment.candidateBlocks(queryTrigrams, fileFiltered ? &matchingFiles : nullptr);
+
+        for (auto blockIt = candidates.crbegin(); blockIt != candidates.crend() && !full; ++blockIt) {
+            const BlockRecord& block = segment.blocks[*blockIt];
+            if (block.fileId >= quint32(m_files.size())) {
+                continue;
+            }
+
+            // Deleted or truncated since the block was written
+            const LogIndexedFile& file = m_files[block.fileId];
+            if (file.isRemoved()) {
+                continue;
+            }
+            if (block.lastTimestamp != 0 && block.lastTimestamp < fromMs) {
+                continue;
+            }
+            if (block.firstTimestamp != 0 && block.firstTimestamp > toMs) {
+                continue;
+            }
+
+            QFile* source = openFiles.value(block.fileId, nullptr);
+            if (!source) {
+                source = new QFile(file.path);
+                openFiles.insert(block.fileId, source);
+                if (!source->open(QIODevice::ReadOnly)) {
+                    qCWarning(lcLog) << "LogIndexReader: Cannot open" << file.path;
+                }
+            }
+            if (!source->isOpen() || !source->seek(block.offset)) {
+                continue;
+            }
+
+            // Trigrams only narrow the candidates, every line is verified
+            const QByteArray bytes = source->read(block.length);
+            qint64 consumed = 0;
+            const QVector<RawLine> lines = splitLines(bytes, file.utf16, consumed);
+            for (const RawLine& raw : lines) {
+                QString line = decodeLine(bytes.constData() + raw.offset, raw.length, file.utf16);
+                if (!phrase.isEmpty() && !line.contains(phrase, Qt::CaseInsensitive)) {
+                    continue;
+                }
+
+                qint64 timestamp = parseTimestamp(line);
+                if (timeFiltered && (timestamp == 0 || timestamp < fromMs || timestamp > toMs)) {
+                    continue;
+                }
+
+                LogSearchHit hit;
+                hit.filePath = file.path;
+                hit.channel = file.channel;
+                hit.character = file.listener;
+                if (timestamp != 0) {
+                    hit.timestamp = QDateTime::fromMSecsSinceEpoch(timestamp, QTimeZone::UTC);
+                }
+                hit.line = line.trimmed();
+                hits.append(hit);
+
+                if (hits.size() >= query.maxResults) {
+                    full = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    qDeleteAll(openFiles);
+
+    std::stable_sort(hits.begin(), hits.end(), [](const LogSearchHit& a, const LogSearchHit& b) {
+        return a.timestamp > b.timestamp;
+    });
+    return hits;
+}
+
+struct LogIndexWorker::SegmentBuilder {
+    QVector<BlockRecord> blocks;
+    QHash<quint32, QVector<quint32>> postings;
+};
+
+LogIndexWorker::LogIndexWorker(QObject *parent)
+    : QObject(parent)
+    , m_indexDirectory(LogIndexer::indexDirectory())
+    , m_passTimer(new QTimer(this))
+{
+    m_passTimer->setSingleShot(true);
+    connect(m_passTimer, &QTimer::timeout, this, &LogIndexWorker::runPass);
+}
+
+void LogIndexWorker::setDirectories(const QString& chatLogDirectory, const QString& gameLogDirectory)
+{
+    QMutexLocker locker(&m_mutex);
+    m_chatLogDirectory = chatLogDirectory;
+    m_gameLogDirectory = gameLogDirectory;
+}
+
+void LogIndexWorker::startIndexing()
+{
+    if (m_running) {
+        return;
+    }
+
+    if (!QDir().mkpath(m_indexDirectory)) {
+        qCWarning(lcLog) << "LogIndexWorker: Cannot create index directory" << m_indexDirectory;
+        return;
+    }
+
+    // Background mode also lowers I/O and memory priority, not just CPU. Only
+    // entered once started, stopIndexing() is what ends it.
+    SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+
+    loadCatalog();
+    removeOrphanedSegments();
+
+    m_running = true;
+    m_passTimer->start(STARTUP_DELAY_MS);
+    qCDebug(lcLog) << "LogIndexWorker: Started," << m_files.size() << "files and" << m_segmentNames.size() << "segments in index";
+}
+
+void LogIndexWorker::stopIndexing()
+{
+    if (!m_running) {
+        return;
+    }
+
+    m_running = false;
+    m_passTimer->stop();
+    SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_END);
+    qCDebug(lcLog) << "LogIndexWorker: Stopped";
+}
+
+void LogIndexWorker::runPass()
+{
+    if (!m_running) {
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QString chatLogDirectory;
+    QString gameLogDirectory;
+    {
+        QMutexLocker locker(&m_mutex);
+        chatLogDirectory = m_chatLogDirectory;
+        gameLogDirectory = m_gameLogDirectory;
+    }
+
+    // Oldest files first so a large backlog is indexed chronologically
+    QVector<int> pending;
+    QSet<int> seen;
+    int removedFiles = 0;
+    const QPair<QString, bool> sources[] = {
+        qMakePair(chatLogDirectory, false),
+        qMakePair(gameLogDirectory, true),
+    };
+    for (const auto& source : sources) {
+        if (source.first.isEmpty()) {
+            continue;
+        }
+
+        QDir dir(source.first);
+        if (!dir.exists()) {
+            continue;
+        }
+
+        const QFileInfoList entries = dir.entryInfoList(QStringList() << "*.txt", QDir::Files, QDir::Time | QDir::Reversed);
+        for (const QFileInfo& info : entries) {
+            const QString path = info.absoluteFilePath();
+            int fileId = m_fileIds.value(path, -1);
+            if (fileId >= 0 && info.size() < m_files[fileId].indexedBytes) {
+                // Truncated or replaced, the indexed offsets no longer hold.
+                // Indexed again from the start under a new id.
+                removeFile(fileId);
+                ++removedFiles;
+                fileId = -1;
+            }
+            if (fileId < 0) {
+                LogIndexedFile file;
+                file.path = path;
+                readFileHeader(file, source.second);
+                fileId = m_files.size();
+                m_files.append(file);
+                m_fileIds.insert(path, fileId);
+            }
+
+            seen.insert(fileId);
+            if (info.size() > m_files[fileId].indexedBytes) {
+                pending.append(fileId);
+            }
+        }
+    }
+
+    // Files outside the scanned directories are kept while they still exist,
+    // the log directory may just have been changed
+    for (int fileId = 0; fileId < m_files.size(); ++fileId) {
+        const LogIndexedFile& file = m_files[fileId];
+        if (!file.isRemoved() && !seen.contains(fileId) && !QFileInfo::exists(file.path)) {
+            removeFile(fileId);
+            ++removedFiles;
+        }
+    }
+
+    SegmentBuilder builder;
+    qint64 byteBudget = PASS_BYTE_BUDGET;
+    bool backlog = false;
+    for (int fileId : pending) {
+        if (byteBudget <= 0) {
+            backlog = true;
+            break;
+        }
+        indexFile(fileId, builder, byteBudget);
+    }
+
+    const int newBlocks = builder.blocks.size();
+    if (newBlocks > 0) {
+        const QString name = nextSegmentName();
+        if (writeSegment(builder, name)) {
+            m_segmentNames.append(name);
+        } else {
+            // Roll the checkpoints back so the same bytes are retried
+            loadCatalog();
+            m_passTimer->start(PASS_INTERVAL_MS);
+            return;
+        }
+    }
+
+    if (removedFiles > 0) {
+        qCDebug(lcLog) << "LogIndexWorker: Removed" << removedFiles << "deleted or truncated files from the index";
+        compactSegments();
+    }
+
+    if (m_segmentNames.size() > MAX_SEGMENTS) {
+        mergeSmallSegments();
+    }
+
+    saveCatalog();
+    removeOrphanedSegments();
+
+    const qint64 elapsed = timer.elapsed();
+    if (newBlocks > 0) {
+        qCDebug(lcLog) << "LogIndexWorker: Indexed" << newBlocks << "blocks in" << elapsed << "ms"
+                 << (backlog ? "(backlog remaining)" : "");
+    }
+    emit passFinished(newBlocks, elapsed);
+
+    m_passTimer->start(backlog ? BACKLOG_PASS_INTERVAL_MS : PASS_INTERVAL_MS);
+}
+
+bool LogIndexWorker::loadCatalog()
+{
+    m_files.clear();
+    m_fileIds.clear();
+    m_segmentNames.clear();
+    m_nextSegmentId = 0;
+
+    if (!readCatalog(m_indexDirectory + "/" + CATALOG_FILE, m_files, m_segmentNames, m_nextSegmentId)) {
+        return false;
+    }
+
+    for (int i = 0; i < m_files.size(); ++i) {
+        if (!m_files[i].isRemoved()) {
+            m_fileIds.insert(m_files[i].path, i);
+        }
+    }
+    return true;
+}
+
+bool LogIndexWorker::saveCatalog()
+{
+    QSaveFile file(m_indexDirectory + "/" + CATALOG_FILE);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(lcLog) << "LogIndexWorker: Cannot write catalog" << file.fileName();
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << CATALOG_MAGIC << CATALOG_VERSION << m_nextSegmentId << m_segmentNames << qint32(m_files.size());
+    for (const LogIndexedFile& entry : m_files) {
+        out << entry.path << entry.channel << entry.listener << entry.indexedBytes << entry.utf16;
+    }
+
+    return file.commit();
+}
+
+void LogIndexWorker::readFileHeader(LogIndexedFile& file, bool isGameLog)
+{
+    static const QRegularExpression listenerPattern(R"(Listener:\s+([^\r\n]+))");
+    static const QRegularExpression channelPattern(R"(Channel Name:\s+([^\r\n]+))");
+    static const QRegularExpression fileNamePattern(R"(^(.+?)_\d{8}_\d{6}(?:_\d+)?$)");
+
+    QFile source(file.path);
+    if (!source.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    const QByteArray head = source.read(4096);
+    int bomLength = 0;
+    if (head.startsWith("\xFF\xFE")) {
+        file.utf16 = true;
+        bomLength = 2;
+    } else if (head.startsWith("\xEF\xBB\xBF")) {
+        bomLength = 3;
+    }
+    file.indexedBytes = bomLength;
+
+    const QString text = decodeLine(head.constData() + bomLength, head.size() - bomLength, file.utf16);
+
+    QRegularExpressionMatch listener = listenerPattern.match(text);
+    if (listener.hasMatch()) {
+        file.listener = listener.captured(1).trimmed();
+    }
+
+    if (isGameLog) {
+        file.channel = "Gamelog";
+        return;
+    }
+
+    QRegularExpressionMatch channel = channelPattern.match(text);
+    if (channel.hasMatch()) {
+        file.channel = channel.captured(1).trimmed();
+        return;
+    }
+
+    QRegularExpressionMatch fileName = fileNamePattern.match(QFileInfo(file.path).completeBaseName());
+    file.channel = fileName.hasMatch() ? fileName.captured(1) : QFileInfo(file.path).completeBaseName();
+}
+
+bool LogIndexWorker::indexFile(int fileId, SegmentBuilder& builder, qint64& byteBudget)
+{
+    LogIndexedFile& file = m_files[fileId];
+
+    QFile source(file.path);
+    if (!source.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    const qint64 start = file.indexedBytes;
+    const qint64 available = source.size() - start;
+    if (available <= 0 || !source.seek(start)) {
+        return true;
+    }
+
+    const qint64 toRead = qMin(available, byteBudget);
+    const QByteArray bytes = source.read(toRead);
+    byteBudget -= toRead;
+
+    qint64 consumed = 0;
+    const QVector<RawLine> lines = splitLines(bytes, file.utf16, consumed);
+    const int newlineLength = file.utf16 ? 2 : 1;
+
+    QSet<quint32> blockTrigrams;
+    int lineIndex = 0;
+    while (lineIndex < lines.size()) {
+        BlockRecord block = {};
+        block.fileId = quint32(fileId);
+        block.offset = start + lines[lineIndex].offset;
+        blockTrigrams.clear();
+
+        qint64 blockEnd = block.offset;
+        int lineCount = 0;
+        while (lineIndex < lines.size() && lineCount < BLOCK_MAX_LINES && blockEnd - block.offset < BLOCK_MAX_BYTES) {
+            const RawLine& raw = lines[lineIndex];
+            const QString line = decodeLine(bytes.constData() + raw.offset, raw.length, file.utf16);
+            collectTrigrams(line.toLower(), blockTrigrams);
+
+            qint64 timestamp = parseTimestamp(line);
+            if (timestamp != 0) {
+                if (block.firstTimestamp == 0) {
+                    block.firstTimestamp = timestamp;
+                }
+                block.lastTimestamp = timestamp;
+            }
+
+            blockEnd = start + raw.offset + raw.length + newlineLength;
+            ++lineIndex;
+            ++lineCount;
+        }
+
+        block.length = quint32(blockEnd - block.offset);
+        const quint32 blockId = quint32(builder.blocks.size());
+        builder.blocks.append(block);
+        for (quint32 trigram : blockTrigrams) {
+            builder.postings[trigram].append(blockId);
+        }
+    }
+
+    file.indexedBytes = start + consumed;
+    return true;
+}
+
+bool LogIndexWorker::writeSegment(const SegmentBuilder& builder, const QString& fileName)
+{
+    QVector<quint32> keys = builder.postings.keys().toVector();
+    std::sort(keys.begin(), keys.end());
+
+    QVector<TrigramRecord> table;
+    table.reserve(keys.size());
+    quint32 postingCount = 0;
+    for (quint32 key : keys) {
+        const quint32 count = quint32(builder.postings[key].size());
+        table.append({key, postingCount, count});
+        postingCount += count;
+    }
+
+    SegmentHeader header = {};
+    header.magic = SEGMENT_MAGIC;
+    header.version = SEGMENT_VERSION;
+    header.blockCount = quint32(builder.blocks.size());
+    header.trigramCount = quint32(table.size());
+    header.postingCount = postingCount;
+
+    QSaveFile out(m_indexDirectory + "/" + fileName);
+    if (!out.open(QIODevice::WriteOnly)) {
+        qCWarning(lcLog) << "LogIndexWorker: Cannot write segment" << fileName;
+        return false;
+    }
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(builder.blocks.constData()), builder.blocks.size() * qint64(sizeof(BlockRecord)));
+    out.write(reinterpret_cast<const char*>(table.constData()), table.size() * qint64(sizeof(TrigramRecord)));
+    for (quint32 key : keys) {
+        const QVector<quint32>& list = builder.postings[key];
+        out.write(reinterpret_cast<const char*>(list.constData()), list.size() * qint64(sizeof(quint32)));
+    }
+
+    if (!out.commit()) {
+        qCWarning(lcLog) << "LogIndexWorker: Failed to commit segment" << fileName;
+        return false;
+    }
+    return true;
+}
+
+void LogIndexWorker::mergeSmallSegments()
+{
+    // Only a run of neighbouring segments is merged, so the catalog keeps its
+    // oldest-to-newest order that search() walks backwards for its result cap.
+    // The run picked is the one with the fewest bytes to rewrite.
+    QVector<qint64> sizes;
+    sizes.reserve(m_segmentNames.size());
+    for (const QString& name : m_segmentNames) {
+        sizes.append(QFileInfo(m_indexDirectory + "/" + name).size());
+    }
+
+    const int runLength = qMin(SEGMENTS_PER_MERGE, int(m_segmentNames.size()));
+    if (runLength < 2) {
+        return;
+    }
+
+    int runStart = 0;
+    qint64 runBytes = std::accumulate(sizes.cbegin(), sizes.cbegin() + runLength, qint64(0));
+    qint64 bestBytes = runBytes;
+    for (int i = 1; i + runLength <= sizes.size(); ++i) {
+        runBytes += sizes[i + runLength - 1] - sizes[i - 1];
+        if (runBytes < bestBytes) {
+            bestBytes = runBytes;
+            runStart = i;
+        }
+    }
+
+    // Concatenated in catalog order so block ids and postings stay ascending.
+    // Blocks of removed files are dropped on the way.
+    SegmentBuilder merged;
+    for (int i = runStart; i < runStart + runLength; ++i) {
+        const QString& name = m_segmentNames[i];
+        MappedLogSegment segment;
+        if (!segment.open(m_indexDirectory + "/" + name)) {
+            qCWarning(lcLog) << "LogIndexWorker: Cannot merge unreadable segment" << name;
+            return;
+        }
+
+        appendLiveBlocks(segment, merged);
+    }
+
+    const QString name = nextSegmentName();
+    if (!writeSegment(merged, name)) {
+        return;
+    }
+
+    m_segmentNames.erase(m_segmentNames.begin() + runStart, m_segmentNames.begin() + runStart + runLength);
+    m_segmentNames.insert(runStart, name);
+
+    qCDebug(lcLog) << "LogIndexWorker: Merged" << runLength << "segments into" << name;
+}
+
+void LogIndexWorker::removeFile(int fileId)
+{
+    m_fileIds.remove(m_files[fileId].path);
+    m_files[fileId] = LogIndexedFile();
+}
+
+bool LogIndexWorker::isFileRemoved(quint32 fileId) const
+{
+    return fileId >= quint32(m_files.size()) || m_files[fileId].isRemoved();
+}
+
+int LogIndexWorker::appendLiveBlocks(const MappedLogSegment& segment, SegmentBuilder& builder) const
+{
+    constexpr quint32 DROPPED = std::numeric_limits<quint32>::max();
+
+    // Live blocks keep their order, so remapped postings stay ascending
+    QVector<quint32> remap(segment.header->blockCount, DROPPED);
+    int dropped = 0;
+    for (quint32 b = 0; b < segment.header->blockCount; ++b) {
+        if (isFileRemoved(segment.blocks[b].fileId)) {
+            ++dropped;
+            continue;
+        }
+        remap[b] = quint32(builder.blocks.size());
+        builder.blocks.append(segment.blocks[b]);
+    }
+
+    for (quint32 t = 0; t < segment.header->trigramCount; ++t) {
+        const TrigramRecord& record = segment.trigrams[t];
+        const quint32* postings = segment.postings + record.postingsOffset;
+        QVector<quint32> live;
+        for (quint32 p = 0; p < record.postingsCount; ++p) {
+            if (remap[postings[p]] != DROPPED) {
+                live.append(remap[postings[p]]);
+            }
+        }
+        if (!live.isEmpty()) {
+            builder.postings[record.trigram].append(live);
+        }
+    }
+    return dropped;
+}
+
+void LogIndexWorker::compactSegments()
+{
+    // Segments where removed files are a small share wait for the next merge,
+    // search() already skips their blocks
+    for (int i = 0; i < m_segmentNames.size();) {
+        const QString name = m_segmentNames[i];
+        MappedLogSegment segment;
+        if (!segment.open(m_indexDirectory + "/" + name)) {
+            ++i;
+            continue;
+        }
+
+        const quint32 blockCount = segment.header->blockCount;
+        quint32 removedBlocks = 0;
+        for (quint32 b = 0; b < blockCount; ++b) {
+            if (isFileRemoved(segment.blocks[b].fileId)) {
+                ++removedBlocks;
+            }
+        }
+        if (removedBlocks == 0 || qint64(removedBlocks) * 100 < qint64(blockCount) * COMPACT_REMOVED_PERCENT) {
+            ++i;
+            continue;
+        }
+
+        if (removedBlocks == blockCount) {
+            m_segmentNames.removeAt(i);
+            qCDebug(lcLog) << "LogIndexWorker: Dropped segment" << name << "of removed files";
+            continue;
+        }
+
+        SegmentBuilder compacted;
+        appendLiveBlocks(segment, compacted);
+        const QString compactedName = nextSegmentName();
+        if (writeSegment(compacted, compactedName)) {
+            m_segmentNames[i] = compactedName;
+            qCDebug(lcLog) << "LogIndexWorker: Compacted" << name << "into" << compactedName
+                     << "dropping" << removedBlocks << "of" << blockCount << "blocks";
+        }
+        ++i;
+    }
+}
+
+void LogIndexWorker::removeOrphanedSegments()
+{
+    QDir dir(m_indexDirectory);
+    const QStringList existing = dir.entryList(QStringList() << SEGMENT_FILTER, QDir::Files);
+    for (const QString& name : existing) {
+        // A reader may still have the segment mapped, retried on the next pass
+        if (!m_segmentNames.contains(name)) {
+            dir.remove(name);
+        }
+    }
+}
+
+QString LogIndexWorker::nextSegmentName()
+{
+    return QString("segment_%1.seg").arg(m_nextSegmentId++, 6, 10, QChar('0'));
+}
+
+LogIndexer::LogIndexer(QObject *parent)
+    : QObject(parent)
+    , m_workerThread(new QThread(this))
+    , m_worker(new LogIndexWorker())
+{
+    m_worker->moveToThread(m_workerThread);
+
+    connect(m_workerThread, &QThread::started,
+        m_worker, &LogIndexWorker::startIndexing);
+}
+
+LogIndexer::~LogIndexer()
+{
+    stop();
+    m_workerThread->quit();
+    if (!m_workerThread->wait(3000)) {
+        qCWarning(lcLog) << "LogIndexer: Worker thread did not stop in time, terminating";
+        m_workerThread->terminate();
+        m_workerThread->wait();
+    }
+
+    // Manual deletion required - worker has no parent (moved to separate thread)
+    delete m_worker;
+    m_worker = nullptr;
+}
+
+void LogIndexer::setDirectories(const QString& chatLogDirectory, const QString& gameLogDirectory)
+{
+    m_worker->setDirectories(chatLogDirectory, gameLogDirectory);
+}
+
+void LogIndexer::start()
+{
+    if (m_running) {
+        return;
+    }
+
+    m_running = true;
+
+    if (!m_workerThread->isRunning()) {
+        m_workerThread->start(QThread::IdlePriority);
+    } else {
+        QMetaObject::invokeMethod(m_worker, "startIndexing", Qt::QueuedConnection);
+    }
+}
+
+void LogIndexer::stop()
+{
+    if (!m_running) {
+        return;
+    }
+
+    m_running = false;
+
+    if (m_workerThread->isRunning()) {
+        QMetaObject::invokeMethod(m_worker, "stopIndexing", Qt::QueuedConnection);
+    }
+}
+
+QString LogIndexer::indexDirectory()
+{
+    return QCoreApplication::applicationDirPath() + "/logindex";
+}
@@ -0,0 +1,192 @@
+#include "logsearchdialog.h"
+#include "logindex.h"
+#include "stylesheet.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QGridLayout>
+#include <QHeaderView>
+#include <QElapsedTimer>
+#include <QtConcurrent>
+
+LogSearchDialog::LogSearchDialog(QWidget *parent)
+    : QDialog(parent)
+    , m_searchWatcher(new QFutureWatcher<SearchResult>(this))
+{
+    setWindowTitle("Search Logs");
+    resize(900, 600);
+    setupUi();
+    setStyleSheet(StyleSheet::getDialogStyleSheet());
+}
+
+void LogSearchDialog::setupUi()
+{
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+    mainLayout->setContentsMargins(12, 12, 12, 12);
+    mainLayout->setSpacing(10);
+
+    QGridLayout *filterGrid = new QGridLayout();
+    filterGrid->setHorizontalSpacing(10);
+    filterGrid->setVerticalSpacing(8);
+
+    QLabel *phraseLabel = new QLabel("Text:");
+    phraseLabel->setStyleSheet(StyleSheet::getLabelStyleSheet());
+    m_phraseEdit = new QLineEdit();
+    m_phraseEdit->setPlaceholderText("Text to find in chat and game logs");
+    m_phraseEdit->setStyleSheet(StyleSheet::getDialogLineEditStyleSheet());
+    filterGrid->addWidget(phraseLabel, 0, 0);
+    filterGrid->addWidget(m_phraseEdit, 0, 1, 1, 3);
+
+    QLabel *channelLabel = new QLabel("Channel:");
+    channelLabel->setStyleSheet(StyleSheet::getLabelStyleSheet());
+    m_channelEdit = new QLineEdit();
+    m_channelEdit->setPlaceholderText("Any (use Gamelog for game logs)");
+    m_channelEdit->setStyleSheet(StyleSheet::getDialogLineEditStyleSheet());
+    filterGrid->addWidget(channelLabel, 1, 0);
+    filterGrid->addWidget(m_channelEdit, 1, 1);
+
+    QLabel *characterLabel = new QLabel("Character:");
+    characterLabel->setStyleSheet(StyleSheet::getLabelStyleSheet());
+    m_characterEdit = new QLineEdit();
+    m_characterEdit->setPlaceholderText("Any");
+    m_characterEdit->setStyleSheet(StyleSheet::getDialogLineEditStyleSheet());
+    filterGrid->addWidget(characterLabel, 1, 2);
+    filterGrid->addWidget(m_characterEdit, 1, 3);
+
+    // Log timestamps are UTC, so the range is entered in UTC as well
+    const QDateTime now = QDateTime::currentDateTimeUtc();
+
+    m_fromCheck = new QCheckBox("From (UTC):");
+    m_fromCheck->setStyleSheet(StyleSheet::getCheckBoxStyleSheet());
+    m_fromEdit = new QDateTimeEdit(now.addDays(-7));
+    m_fromEdit->setDisplayFormat("yyyy.MM.dd HH:mm");
+    m_fromEdit->setCalendarPopup(true);
+    m_fromEdit->setEnabled(false);
+    m_fromEdit->setStyleSheet(StyleSheet::getSpinBoxStyleSheet());
+    filterGrid->addWidget(m_fromCheck, 2, 0);
+    filterGrid->addWidget(m_fromEdit, 2, 1);
+
+    m_toCheck = new QCheckBox("To (UTC):");
+    m_toCheck->setStyleSheet(StyleSheet::getCheckBoxStyleSheet());
+    m_toEdit = new QDateTimeEdit(now);
+    m_toEdit->setDisplayFormat("yyyy.MM.dd HH:mm");
+    m_toEdit->setCalendarPopup(true);
+    m_toEdit->setEnabled(false);
+    m_toEdit->setStyleSheet(StyleSheet::getSpinBoxStyleSheet());
+    filterGrid->addWidget(m_toCheck, 2, 2);
+    filterGrid->addWidget(m_toEdit, 2, 3);
+
+    connect(m_fromCheck, &QCheckBox::toggled, m_fromEdit, &QWidget::setEnabled);
+    connect(m_toCheck, &QCheckBox::toggled, m_toEdit, &QWidget::setEnabled);
+
+    mainLayout->addLayout(filterGrid);
+
+    QHBoxLayout *actionLayout = new QHBoxLayout();
+    m_statusLabel = new QLabel();
+    m_statusLabel->setStyleSheet(StyleSheet::getInfoLabelStyleSheet());
+    m_searchButton = new QPushButton("Search");
+    m_searchButton->setStyleSheet(StyleSheet::getButtonStyleSheet());
+    m_searchButton->setDefault(true);
+    actionLayout->addWidget(m_statusLabel, 1);
+    actionLayout->addWidget(m_searchButton);
+    mainLayout->addLayout(actionLayout);
+
+    m_resultsTable = new QTableWidget(0, 4);
+    m_resultsTable->setHorizontalHeaderLabels({"Time (UTC)", "Channel", "Character", "Line"});
+    m_resultsTable->setStyleSheet(StyleSheet::getTableStyleSheet());
+    m_resultsTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_resultsTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_resultsTable->verticalHeader()->setVisible(false);
+    m_resultsTable->horizontalHeader()->setSectionResizeMode(0, QHeaderView::ResizeToContents);
+    m_resultsTable->horizontalHeader()->setSectionResizeMode(1, QHeaderView::ResizeToContents);
+    m_resultsTable->horizontalHeader()->setSectionResizeMode(2, QHeaderView::ResizeToContents);
+    m_resultsTable->horizontalHeader()->setSectionResizeMode(3, QHeaderView::Stretch);
+    mainLayout->addWidget(m_resultsTable, 1);
+
+    connect(m_searchButton, &QPushButton::clicked, this, &LogSearchDialog::onSearchClicked);
+    connect(m_phraseEdit, &QLineEdit::returnPressed, this, &LogSearchDialog::onSearchClicked);
+    connect(m_searchWatcher, &QFutureWatcher<SearchResult>::finished, this, &LogSearchDialog::onSearchFinished);
+
+    LogIndexReader reader(LogIndexer::indexDirectory());
+    m_statusLabel->setText(reader.isValid()
+        ? QString("%1 log files indexed").arg(reader.fileCount())
+        : QString("No log index yet. Enable log indexing under Data Sources."));
+}
+
+void LogSearchDialog::onSearchClicked()
+{
+    if (m_searchWatcher->isRunning()) {
+        return;
+    }
+
+    LogSearchQuery query;
+    query.phrase = m_phraseEdit->text();
+    query.channel = m_channelEdit->text().trimmed();
+    query.character = m_characterEdit->text().trimmed();
+    if (m_fromCheck->isChecked()) {
+        query.from = m_fromEdit->dateTime();
+    }
+    if (m_toCheck->isChecked()) {
+        query.to = m_toEdit->dateTime();
+    }
+
+    // A search reads every candidate block from disk, so it runs on the
+    // global thread pool. Closing the dialog just drops the result.
+    m_searchButton->setEnabled(false);
+    m_statusLabel->setText("Searching...");
+    m_searchWatcher->setFuture(QtConcurrent::run(&LogSearchDialog::runSearch, query));
+}
+
+LogSearchDialog::SearchResult LogSearchDialog::runSearch(const LogSearchQuery& query)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    SearchResult result;
+    result.maxResults = query.maxResults;
+
+    // Reopened per search so newly written segments are picked up
+    LogIndexReader reader(LogIndexer::indexDirectory());
+    if (!reader.isValid()) {
+        return result;
+    }
+
+    result.indexValid = true;
+    result.hits = reader.search(query);
+    result.elapsedMs = timer.elapsed();
+    return result;
+}
+
+void LogSearchDialog::onSearchFinished()
+{
+    m_searchButton->setEnabled(true);
+
+    const SearchResult result = m_searchWatcher->result();
+    if (!result.indexValid) {
+        m_resultsTable->setRowCount(0);
+        m_statusLabel->setText("No log index yet. Enable log indexing under Data Sources.");
+        return;
+    }
+
+    const QVector<LogSearchHit>& hits = result.hits;
+    m_resultsTable->setUpdatesEnabled(false);
+    m_resultsTable->setRowCount(hits.size());
+    for (int row = 0; row < hits.size(); ++row) {
+        const LogSearchHit& hit = hits[row];
+        QTableWidgetItem *timeItem = new QTableWidgetItem(
+            hit.timestamp.isValid() ? hit.timestamp.toString("yyyy.MM.dd HH:mm:ss") : QString());
+        QTableWidgetItem *lineItem = new QTableWidgetItem(hit.line);
+        lineItem->setToolTip(hit.filePath);
+
+        m_resultsTable->setItem(row, 0, timeItem);
+        m_resultsTable->setItem(row, 1, new QTableWidgetItem(hit.channel));
+        m_resultsTable->setItem(row, 2, new QTableWidgetItem(hit.character));
+        m_resultsTable->setItem(row, 3, lineItem);
+    }
+    m_resultsTable->setUpdatesEnabled(true);
+
+    QString status = QString("%1 results in %2 ms").arg(hits.size()).arg(result.elapsedMs);
+    if (hits.size() >= result.maxResults) {
+        status += " (limited to the newest matches)";
+    }
+    m_statusLabel->setText(status);
+}
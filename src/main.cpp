@@ -1,24 +1,14 @@
 #include "mainwindow.h"
-#include "hotkeymanager.h"
+#include "config.h"
+#include "logging.h"
 #include "version.h"
 #include <QApplication>
-#include <QAbstractNativeEventFilter>
 #include <QMessageBox>
 #include <Windows.h>
 #include <dwmapi.h>
 
 #pragma comment(lib, "dwmapi.lib")
 
-class HotkeyEventFilter : public QAbstractNativeEventFilter
-{
-public:
-    bool nativeEventFilter(const QByteArray &eventType, void *message, qintptr *result) override
-    {
-        Q_UNUSED(eventType);
-        return HotkeyManager::nativeEventFilter(message, reinterpret_cast<long*>(result));
-    }
-};
-
 int main(int argc, char *argv[])
 {
     HANDLE hMutex = CreateMutexW(nullptr, TRUE, L"Global\\EVE-APM-Preview-SingleInstance");
@@ -56,13 +46,15 @@ int main(int argc, char *argv[])
     
     app.setQuitOnLastWindowClosed(false);
     
-    HotkeyEventFilter hotkeyFilter;
-    app.installNativeEventFilter(&hotkeyFilter);
+    LogSink::instance().setDebugEnabled(Config::instance().enableDebugLogging());
+    LogSink::instance().setFileEnabled(Config::instance().writeLogToFile());
     
     MainWindow manager;
     
     int exitCode = app.exec();
     
+    LogSink::instance().shutdown();
+    
     if (hMutex)
     {
         CloseHandle(hMutex);
@@ -1,11 +1,18 @@
 #include "mainwindow.h"
+#include "clienttracker.h"
 #include "windowcapture.h"
+#include "windowsystem.h"
 #include "thumbnailwidget.h"
 #include "hotkeymanager.h"
 #include "overlayinfo.h"
 #include "config.h"
 #include "configdialog.h"
 #include "chatlogreader.h"
+#include "logindex.h"
+#include "logsearchdialog.h"
+#include "logging.h"
+#include "boundedcache.h"
+#include "starmap.h"
 #include <QSet>
 #include <QCoreApplication>
 #include <QGuiApplication>
@@ -16,24 +23,26 @@
 #include <QPainter>
 #include <QFont>
 #include <QDir>
-#include <algorithm>
+#include <initializer_list>
+#include <utility>
 
-static const QString NOT_LOGGED_IN_TEXT = QStringLiteral("Not Logged In");
 static const QString SETTINGS_TEXT = QStringLiteral("Settings");
+static const QString SEARCH_LOGS_TEXT = QStringLiteral("Search Logs...");
 static const QString EXIT_TEXT = QStringLiteral("Exit");
 static const QString EVEO_PREVIEW_TEXT = QStringLiteral("EVE-APM Preview");
 static const QString EVE_TEXT = QStringLiteral("EVE");
-
-MainWindow* MainWindow::s_instance = nullptr;
+static constexpr int CACHE_REPORT_INTERVAL_MS = 10 * 60 * 1000;
 
 MainWindow::MainWindow(QObject *parent)
     : QObject(parent)
     , windowCapture(std::make_unique<WindowCapture>())
     , hotkeyManager(std::make_unique<HotkeyManager>())
-    , m_notLoggedInCycleIndex(-1)
-    , m_nonEVECycleIndex(-1)
 {
-    s_instance = this;
+    m_tracker = std::make_unique<ClientTracker>(*windowCapture, *hotkeyManager,
+        [this](const WindowInfo& window, const QString& displayName) { return createThumbnail(window, displayName); });
+    connect(m_tracker.get(), &ClientTracker::clientAdded, this, &MainWindow::onClientAdded);
+    connect(m_tracker.get(), &ClientTracker::clientRemoved, this, &MainWindow::onClientRemoved);
+    connect(m_tracker.get(), &ClientTracker::clientsChanged, this, &MainWindow::onClientsChanged);
     
     connect(hotkeyManager.get(), &HotkeyManager::characterHotkeyPressed, this, &MainWindow::activateCharacter);
     connect(hotkeyManager.get(), &HotkeyManager::namedCycleForwardPressed, this, &MainWindow::handleNamedCycleForward);
@@ -46,20 +55,36 @@ MainWindow::MainWindow(QObject *parent)
     connect(hotkeyManager.get(), &HotkeyManager::suspendedChanged, this, &MainWindow::onHotkeysSuspendedChanged);
     connect(hotkeyManager.get(), &HotkeyManager::closeAllClientsRequested, this, &MainWindow::closeAllEVEClients);
     
-    refreshTimer = new QTimer(this);
-    connect(refreshTimer, &QTimer::timeout, this, &MainWindow::refreshWindows);
-    refreshTimer->start(Config::instance().refreshInterval());
+    // Window events keep the thumbnails current, this only catches anything they missed
+    m_reconcileTimer = new QTimer(this);
+    m_reconcileTimer->setTimerType(Qt::VeryCoarseTimer);
+    connect(m_reconcileTimer, &QTimer::timeout, this, &MainWindow::refreshWindows);
+    m_reconcileTimer->start(Config::instance().windowReconcileSeconds() * 1000);
     
     minimizeTimer = new QTimer(this);
     minimizeTimer->setSingleShot(true);
     connect(minimizeTimer, &QTimer::timeout, this, &MainWindow::minimizeInactiveWindows);
     
+    // Group drags land at most once per display frame, however often the mouse reports
+    m_groupDragTimer = new QTimer(this);
+    m_groupDragTimer->setSingleShot(true);
+    m_groupDragTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_groupDragTimer, &QTimer::timeout, this, &MainWindow::applyGroupDrag);
+    
+    m_cacheReportTimer = new QTimer(this);
+    connect(m_cacheReportTimer, &QTimer::timeout, this, &MainWindow::logCacheReport);
+    m_cacheReportTimer->start(CACHE_REPORT_INTERVAL_MS);
+    
     m_trayMenu = new QMenu();
     
     QAction *settingsAction = new QAction(SETTINGS_TEXT, this);
     connect(settingsAction, &QAction::triggered, this, &MainWindow::showSettings);
     m_trayMenu->addAction(settingsAction);
     
+    QAction *searchLogsAction = new QAction(SEARCH_LOGS_TEXT, this);
+    connect(searchLogsAction, &QAction::triggered, this, &MainWindow::showLogSearch);
+    m_trayMenu->addAction(searchLogsAction);
+    
     m_profilesMenu = new QMenu("Profiles", m_trayMenu);
     m_trayMenu->addMenu(m_profilesMenu);
     updateProfilesMenu();
@@ -111,37 +136,9 @@ MainWindow::MainWindow(QObject *parent)
         }
     });
     
-    m_eventHook = SetWinEventHook(
-        EVENT_SYSTEM_FOREGROUND, EVENT_SYSTEM_FOREGROUND,
-        nullptr,
-        WinEventProc,
-        0, 0,
-        WINEVENT_OUTOFCONTEXT | WINEVENT_SKIPOWNPROCESS
-    );
-    
-    m_createHook = SetWinEventHook(
-        EVENT_OBJECT_CREATE, EVENT_OBJECT_CREATE,
-        nullptr,
-        WindowEventProc,
-        0, 0,
-        WINEVENT_OUTOFCONTEXT
-    );
-    
-    m_destroyHook = SetWinEventHook(
-        EVENT_OBJECT_DESTROY, EVENT_OBJECT_DESTROY,
-        nullptr,
-        WindowEventProc,
-        0, 0,
-        WINEVENT_OUTOFCONTEXT
-    );
-    
-    m_showHook = SetWinEventHook(
-        EVENT_OBJECT_SHOW, EVENT_OBJECT_SHOW,
-        nullptr,
-        WindowEventProc,
-        0, 0,
-        WINEVENT_OUTOFCONTEXT
-    );
+    WindowSystem& windowSystem = WindowSystem::instance();
+    connect(&windowSystem, &WindowSystem::windowEvent, this, &MainWindow::onWindowEvent);
+    windowSystem.setWindowEventsEnabled(true);
     
     m_chatLogReader = std::make_unique<ChatLogReader>();
     
@@ -154,31 +151,47 @@ MainWindow::MainWindow(QObject *parent)
     bool enableGameLog = Config::instance().enableGameLogMonitoring();
     m_chatLogReader->setEnableChatLogMonitoring(enableChatLog);
     m_chatLogReader->setEnableGameLogMonitoring(enableGameLog);
+    m_chatLogReader->setIntelChannels(Config::instance().intelChannels());
     
     QDir chatLogDir(chatLogDirectory);
     if (chatLogDir.exists()) {
-        qDebug() << "ChatLog: Chatlog directory found:" << chatLogDirectory;
+        qCDebug(lcLog) << "ChatLog: Chatlog directory found:" << chatLogDirectory;
     } else {
-        qDebug() << "ChatLog: Chatlog directory not found:" << chatLogDirectory;
+        qCDebug(lcLog) << "ChatLog: Chatlog directory not found:" << chatLogDirectory;
     }
     
     QDir gameLogDir(gameLogDirectory);
     if (gameLogDir.exists()) {
-        qDebug() << "ChatLog: Gamelog directory found:" << gameLogDirectory;
+        qCDebug(lcLog) << "ChatLog: Gamelog directory found:" << gameLogDirectory;
     } else {
-        qDebug() << "ChatLog: Gamelog directory not found:" << gameLogDirectory;
+        qCDebug(lcLog) << "ChatLog: Gamelog directory not found:" << gameLogDirectory;
     }
     
     connect(m_chatLogReader.get(), &ChatLogReader::systemChanged,
             this, &MainWindow::onCharacterSystemChanged);
     connect(m_chatLogReader.get(), &ChatLogReader::combatEventDetected,
             this, &MainWindow::onCombatEventDetected);
+    connect(m_chatLogReader.get(), &ChatLogReader::intelReported,
+            this, &MainWindow::onIntelReported);
+    // Kept current even while monitoring is off so the reader can start on its own
+    connect(m_tracker.get(), &ClientTracker::characterNamesChanged,
+            m_chatLogReader.get(), &ChatLogReader::setCharacterNames);
+    
+    m_chatLogReader->setActivityProfile(Config::instance().getCurrentProfileName());
     
     if (enableChatLog || enableGameLog) {
         m_chatLogReader->start();
-        qDebug() << "ChatLog: Monitoring started (ChatLog:" << enableChatLog << ", GameLog:" << enableGameLog << ")";
+        qCDebug(lcLog) << "ChatLog: Monitoring started (ChatLog:" << enableChatLog << ", GameLog:" << enableGameLog << ")";
     } else {
-        qDebug() << "ChatLog: Monitoring disabled in config";
+        qCDebug(lcLog) << "ChatLog: Monitoring disabled in config";
+    }
+    
+    connect(&Config::instance(), &Config::settingsChanged, this, &MainWindow::onConfigChanged);
+    
+    m_logIndexer = std::make_unique<LogIndexer>();
+    m_logIndexer->setDirectories(chatLogDirectory, gameLogDirectory);
+    if (Config::instance().enableLogIndexing()) {
+        m_logIndexer->start();
     }
     
     hotkeyManager->registerHotkeys();
@@ -187,778 +200,288 @@ MainWindow::MainWindow(QObject *parent)
 
 MainWindow::~MainWindow()
 {
-    s_instance = nullptr;
+    WindowSystem::instance().setWindowEventsEnabled(false);
+    disconnect(&WindowSystem::instance(), nullptr, this, nullptr);
     
     if (m_chatLogReader) {
         m_chatLogReader->stop();
     }
     
+    if (m_logIndexer) {
+        m_logIndexer->stop();
+    }
+    
     if (windowCapture) {
         windowCapture->clearCache();
     }
     OverlayInfo::clearCache();
-    
-    if (m_eventHook) {
-        UnhookWinEvent(m_eventHook);
-    }
-    if (m_createHook) {
-        UnhookWinEvent(m_createHook);
-    }
-    if (m_destroyHook) {
-        UnhookWinEvent(m_destroyHook);
-    }
-    if (m_showHook) {
-        UnhookWinEvent(m_showHook);
-    }
-    
-    qDeleteAll(thumbnails);
-    thumbnails.clear();
-}
-
-void CALLBACK MainWindow::WinEventProc(HWINEVENTHOOK hWinEventHook, DWORD event, HWND hwnd,
-                                       LONG idObject, LONG idChild, DWORD dwEventThread, DWORD dwmsEventTime)
-{
-    Q_UNUSED(hWinEventHook);
-    Q_UNUSED(event);
-    Q_UNUSED(hwnd);
-    Q_UNUSED(idObject);
-    Q_UNUSED(idChild);
-    Q_UNUSED(dwEventThread);
-    Q_UNUSED(dwmsEventTime);
-    
-    if (s_instance) {
-        QMetaObject::invokeMethod(s_instance, "updateActiveWindow", Qt::QueuedConnection);
-    }
 }
 
-void CALLBACK MainWindow::WindowEventProc(HWINEVENTHOOK hWinEventHook, DWORD event, HWND hwnd,
-                                          LONG idObject, LONG idChild, DWORD dwEventThread, DWORD dwmsEventTime)
+void MainWindow::onWindowEvent(WindowSystem::Event event, quintptr windowId)
 {
-    Q_UNUSED(hWinEventHook);
-    Q_UNUSED(dwEventThread);
-    Q_UNUSED(dwmsEventTime);
-    
-    if (idObject != OBJID_WINDOW) {
-        return;
-    }
+    WindowId hwnd = windowId;
     
-    if (s_instance) {
-        if (event == EVENT_OBJECT_CREATE || event == EVENT_OBJECT_DESTROY) {
-            s_instance->m_needsEnumeration = true;
+    switch (event) {
+    case WindowSystem::Event::Foreground:
+        if (hwnd == m_activationTarget) {
+            qCDebug(lcWindow) << "MainWindow: Activation reached foreground in"
+                              << m_activationTimer.nsecsElapsed() / 1000000.0 << "ms"
+                              << (m_activationTargetMinimized ? "(restored from minimized)" : "(already restored)");
+            m_activationTarget = 0;
         }
-        else if (event == EVENT_OBJECT_SHOW) {
-            if (hwnd == s_instance->m_hwndPendingRefresh) {
-                QMetaObject::invokeMethod(s_instance, [hwnd]() {
-                    if (s_instance) {
-                        s_instance->refreshSingleThumbnail(hwnd);
-                        s_instance->m_hwndPendingRefresh = nullptr;
-                    }
-                }, Qt::QueuedConnection);
-            }
+        QMetaObject::invokeMethod(this, "updateActiveWindow", Qt::QueuedConnection);
+        break;
+    case WindowSystem::Event::Shown:
+        if (hwnd == m_hwndPendingRefresh) {
+            QMetaObject::invokeMethod(this, [this, hwnd]() {
+                refreshSingleThumbnail(hwnd);
+                m_hwndPendingRefresh = 0;
+            }, Qt::QueuedConnection);
         }
+        break;
+    case WindowSystem::Event::Created:
+    case WindowSystem::Event::NameChanged:
+    case WindowSystem::Event::Destroyed:
+        // ClientTracker keeps the clients current
+        break;
     }
 }
 
 void MainWindow::refreshWindows()
+{
+    m_tracker->refresh();
+    m_reconcileTimer->setInterval(Config::instance().windowReconcileSeconds() * 1000);
+}
+
+ClientThumbnail* MainWindow::createThumbnail(const WindowInfo& window, const QString& displayName)
 {
     const Config& cfg = Config::instance();
-    const int thumbWidth = cfg.thumbnailWidth();
-    const int thumbHeight = cfg.thumbnailHeight();
-    const bool rememberPos = cfg.rememberPositions();
-    const bool showNotLoggedIn = cfg.showNotLoggedInClients();
-    const bool showNotLoggedInOverlay = cfg.showNotLoggedInOverlay();
-    const bool showNonEVEOverlay = cfg.showNonEVEOverlay();
-    const double thumbnailOpacity = cfg.thumbnailOpacity() / 100.0;  
-    
-    m_enumerationCounter++;
-    if (m_enumerationCounter >= 10) {
-        m_needsEnumeration = true;
-        m_enumerationCounter = 0;
-    }
-    
-    QVector<WindowInfo> windows;
-    
-    if (m_needsEnumeration) {
-        windows = windowCapture->getEVEWindows();
-        m_needsEnumeration = false;
-    } else {
-        windows.reserve(thumbnails.size());
-        for (auto it = thumbnails.begin(); it != thumbnails.end(); ++it) {
-            HWND hwnd = it.key();
-            
-            if (!IsWindow(hwnd)) {
-                m_needsEnumeration = true;
-                windows = windowCapture->getEVEWindows();
-                break;
-            }
-            
-            QString title = windowCapture->getWindowTitle(hwnd);
-            QString processName = m_windowProcessNames.value(hwnd, "exefile.exe");  
-            qint64 creationTime = m_windowCreationTimes.value(hwnd, 0);
-            
-            windows.append(WindowInfo(hwnd, title, processName, creationTime));
-        }
-    }
-    
-    QSet<HWND> currentWindows;
-    QSet<HWND> newWindows;
-    for (const auto& window : windows) {
-        currentWindows.insert(window.handle);
-        if (!thumbnails.contains(window.handle)) {
-            newWindows.insert(window.handle);
-        }
-    }
-    
-    if (!newWindows.isEmpty()) {
-        std::sort(windows.begin(), windows.end(), [](const WindowInfo& a, const WindowInfo& b) {
-            return a.creationTime < b.creationTime;
-        });
-    }
+    ThumbnailWidget *thumbWidget = new ThumbnailWidget(window.id, window.title, nullptr);
+    thumbWidget->setFixedSize(cfg.thumbnailWidth(), cfg.thumbnailHeight());
     
-    auto it = thumbnails.begin();
-    while (it != thumbnails.end()) {
-        if (!currentWindows.contains(it.key())) {
-            m_lastKnownTitles.remove(it.key());
-            it.value()->deleteLater();
-            it = thumbnails.erase(it);
-        } else {
-            ++it;
-        }
-    }
+    thumbWidget->setCharacterName(displayName);
+    thumbWidget->setWindowOpacity(cfg.thumbnailOpacity() / 100.0);
     
-    int loggedInClientsWithoutSavedPos = 0;
-    for (const auto& window : windows) {
-        QString charName = OverlayInfo::extractCharacterName(window.title);
-        if (!charName.isEmpty()) {
-            QPoint savedPos = rememberPos 
-                ? cfg.getThumbnailPosition(charName) 
-                : QPoint(-1, -1);
-            
-            if (thumbnails.contains(window.handle) && (savedPos.x() < 0 || savedPos.y() < 0)) {
-                loggedInClientsWithoutSavedPos++;
-            }
-        }
-    }
-    
-    QScreen *primaryScreen = QGuiApplication::primaryScreen();
-    QRect screenGeometry = primaryScreen->geometry();
-    int screenWidth = screenGeometry.width();
-    int screenHeight = screenGeometry.height();
-    int margin = 10;
-    
-    int xOffset = margin;
-    int yOffset = margin;
-    int currentRow = 0;
-    
-    int thumbnailsPerRow = (screenWidth - margin) / (thumbWidth + margin);
-    if (thumbnailsPerRow < 1) thumbnailsPerRow = 1;
-    
-    if (loggedInClientsWithoutSavedPos > 0) {
-        currentRow = loggedInClientsWithoutSavedPos / thumbnailsPerRow;
-        int colInRow = loggedInClientsWithoutSavedPos % thumbnailsPerRow;
-        xOffset = margin + (colInRow * (thumbWidth + margin));
-        yOffset = margin + (currentRow * (thumbHeight + margin));
-    }
-    
-    int notLoggedInCount = 0;
-    
-    for (const auto& window : windows) {
-        m_windowCreationTimes[window.handle] = window.creationTime;
-        m_windowProcessNames[window.handle] = window.processName;
-        
-        bool isEVEClient = window.processName.compare("exefile.exe", Qt::CaseInsensitive) == 0;
-        
-        QString characterName;
-        QString displayName;
-        
-        if (isEVEClient) {
-            characterName = OverlayInfo::extractCharacterName(window.title);
-            
-            if (characterName.isEmpty() && !showNotLoggedIn) {
-                continue;
-            }
-            
-            if (characterName.isEmpty() && showNotLoggedInOverlay) {
-                displayName = NOT_LOGGED_IN_TEXT;
-            } else {
-                displayName = characterName;
-            }
-        } else {
-            characterName = window.title;
-            displayName = showNonEVEOverlay ? window.title : "";
-        }
-        
-        ThumbnailWidget *thumbWidget = thumbnails.value(window.handle, nullptr);
-        
-        if (!thumbWidget) {
-            thumbWidget = new ThumbnailWidget(window.id, window.title, nullptr);
-            thumbWidget->setFixedSize(thumbWidth, thumbHeight);
-            
-            thumbWidget->setCharacterName(displayName);
-            thumbWidget->setWindowOpacity(thumbnailOpacity);
-            
-            if (isEVEClient && !characterName.isEmpty()) {
-                QString cachedSystem = m_characterSystems.value(characterName);
-                if (!cachedSystem.isEmpty()) {
-                    thumbWidget->setSystemName(cachedSystem);
-                }
-            }
-            
-            connect(thumbWidget, &ThumbnailWidget::clicked, this, &MainWindow::onThumbnailClicked);
-            connect(thumbWidget, &ThumbnailWidget::positionChanged, this, &MainWindow::onThumbnailPositionChanged);
-            connect(thumbWidget, &ThumbnailWidget::groupDragStarted, this, &MainWindow::onGroupDragStarted);
-            connect(thumbWidget, &ThumbnailWidget::groupDragMoved, this, &MainWindow::onGroupDragMoved);
-            connect(thumbWidget, &ThumbnailWidget::groupDragEnded, this, &MainWindow::onGroupDragEnded);
-            
-            thumbnails.insert(window.handle, thumbWidget);
-            
-            m_needsMappingUpdate = true;
-            
-            QPoint savedPos(-1, -1);
-            bool hasSavedPosition = false;
-            if (rememberPos) {
-                if (isEVEClient && !characterName.isEmpty()) {
-                    savedPos = cfg.getThumbnailPosition(characterName);
-                    hasSavedPosition = (savedPos != QPoint(-1, -1));
-                } else if (!isEVEClient) {
-                    QString uniqueId = QString("%1::%2").arg(window.processName, window.title);
-                    savedPos = cfg.getThumbnailPosition(uniqueId);
-                    hasSavedPosition = (savedPos != QPoint(-1, -1));
-                }
-            }
-            
-            thumbWidget->show();
-            
-            if (hasSavedPosition) {
-                QRect thumbRect(savedPos, QSize(thumbWidth, thumbHeight));
-                QScreen* targetScreen = nullptr;
-                for (QScreen* screen : QGuiApplication::screens()) {
-                    if (screen->geometry().intersects(thumbRect)) {
-                        targetScreen = screen;
-                        break;
-                    }
-                }
-                
-                if (targetScreen) {
-                    thumbWidget->move(savedPos);
-                } else {
-                    if (isEVEClient && characterName.isEmpty()) {
-                        QPoint pos = calculateNotLoggedInPosition(notLoggedInCount);
-                        thumbWidget->move(pos);
-                        notLoggedInCount++;
-                    } else {
-                        if (xOffset + thumbWidth > screenWidth - margin) {
-                            xOffset = margin;
-                            yOffset += thumbHeight + margin;
-                        }
-                        
-                        if (yOffset + thumbHeight > screenHeight - margin) {
-                            yOffset = margin;
-                        }
-                        
-                        thumbWidget->move(xOffset, yOffset);
-                        xOffset += thumbWidth + margin;
-                    }
-                }
-            } else if (isEVEClient && characterName.isEmpty()) {
-                QPoint pos = calculateNotLoggedInPosition(notLoggedInCount);
-                thumbWidget->move(pos);
-                notLoggedInCount++;
-            } else {
-                if (xOffset + thumbWidth > screenWidth - margin) {
-                    xOffset = margin;
-                    yOffset += thumbHeight + margin;
-                }
-                
-                if (yOffset + thumbHeight > screenHeight - margin) {
-                    yOffset = margin;
-                }
-                
-                thumbWidget->move(xOffset, yOffset);
-                xOffset += thumbWidth + margin;
-            }
-        } else {
-            QString lastTitle = m_lastKnownTitles.value(window.handle, "");
-            if (lastTitle != window.title) {
-                thumbWidget->setTitle(window.title);
-                m_lastKnownTitles.insert(window.handle, window.title);
-                
-                if (isEVEClient) {
-                    QString lastCharacterName = OverlayInfo::extractCharacterName(lastTitle);
-                    bool wasNotLoggedIn = lastCharacterName.isEmpty();
-                    bool isNowLoggedIn = !characterName.isEmpty();
-                    bool wasLoggedIn = !lastCharacterName.isEmpty();
-                    bool isNowNotLoggedIn = characterName.isEmpty();
-                    
-                    if (wasNotLoggedIn && isNowLoggedIn) {
-                        thumbWidget->setCharacterName(characterName);
-                        
-                        QString cachedSystem = m_characterSystems.value(characterName);
-                        if (!cachedSystem.isEmpty()) {
-                            thumbWidget->setSystemName(cachedSystem);
-                        } else {
-                            thumbWidget->setSystemName(QString());
-                        }
-                        
-                        // Try to restore client window location
-                        tryRestoreClientLocation(window.handle, characterName);
-                        
-                        if (rememberPos) {
-                            QPoint savedPos = cfg.getThumbnailPosition(characterName);
-                            if (savedPos != QPoint(-1, -1)) {
-                                QRect thumbRect(savedPos, QSize(thumbWidth, thumbHeight));
-                                for (QScreen* screen : QGuiApplication::screens()) {
-                                    if (screen->geometry().intersects(thumbRect)) {
-                                        thumbWidget->move(savedPos);
-                                        break;
-                                    }
-                                }
-                            }
-                        }
-                        m_needsMappingUpdate = true;
-                    } else if (wasLoggedIn && isNowNotLoggedIn) {
-                        QString newDisplayName = showNotLoggedInOverlay ? NOT_LOGGED_IN_TEXT : "";
-                        thumbWidget->setCharacterName(newDisplayName);
-                        thumbWidget->setSystemName(QString());
-                        
-                        if (!cfg.preserveLogoutPositions()) {
-                            QPoint pos = calculateNotLoggedInPosition(notLoggedInCount);
-                            thumbWidget->move(pos);
-                            notLoggedInCount++;
-                        }
-                        m_needsMappingUpdate = true;
-                    }
-                } else {
-                    thumbWidget->setCharacterName(showNonEVEOverlay ? window.title : "");
-                }
-            }
-            
-            if (isEVEClient && characterName.isEmpty()) {
-                QString newDisplayName = showNotLoggedInOverlay ? NOT_LOGGED_IN_TEXT : "";
-                thumbWidget->setCharacterName(newDisplayName);
-                thumbWidget->setSystemName(QString());
-            } else if (!isEVEClient) {
-                thumbWidget->setCharacterName(showNonEVEOverlay ? window.title : "");
-            }
-        }
-    }
-    
-    updateSnappingLists();
-    updateActiveWindow();
-    updateCharacterMappings();
+    connect(thumbWidget, &ThumbnailWidget::clicked, this, &MainWindow::onThumbnailClicked);
+    connect(thumbWidget, &ThumbnailWidget::positionChanged, this, &MainWindow::onThumbnailPositionChanged);
+    connect(thumbWidget, &ThumbnailWidget::groupDragStarted, this, &MainWindow::onGroupDragStarted);
+    connect(thumbWidget, &ThumbnailWidget::groupDragMoved, this, &MainWindow::onGroupDragMoved);
+    connect(thumbWidget, &ThumbnailWidget::groupDragEnded, this, &MainWindow::onGroupDragEnded);
+    return thumbWidget;
 }
 
-void MainWindow::updateSnappingLists()
+ThumbnailWidget* MainWindow::thumbnailWidget(ClientSlot slot) const
 {
-    if (thumbnails.size() != m_lastThumbnailListSize) {
-        m_cachedThumbnailList = thumbnails.values().toVector();
-        m_lastThumbnailListSize = thumbnails.size();
-        
-        for (auto* thumb : m_cachedThumbnailList) {
-            thumb->setOtherThumbnails(m_cachedThumbnailList);
-        }
+    // Every thumbnail the tracker holds came from createThumbnail()
+    return static_cast<ThumbnailWidget*>(m_tracker->clients().thumbnail(slot));
+}
+
+void MainWindow::onClientAdded(ClientSlot slot)
+{
+    // Shown here, unless it is already the foreground client and active ones are hidden
+    applyActiveState(slot, clients().window(slot) == m_activeWindow);
+}
+
+void MainWindow::onClientRemoved(ClientSlot slot)
+{
+    m_groupDragMembers.remove(slot);
+}
+
+void MainWindow::onClientsChanged(bool membershipChanged)
+{
+    if (membershipChanged) {
+        m_snappingListDirty = true;
     }
+    updateSnappingLists();
+    updateActiveWindow();
 }
 
-void MainWindow::updateCharacterMappings()
+void MainWindow::updateSnappingLists()
 {
-    static int lastThumbnailCount = -1;
-    if (thumbnails.size() == lastThumbnailCount && lastThumbnailCount > 0 && !m_needsMappingUpdate) {
+    if (!m_snappingListDirty) {
         return;
     }
-    lastThumbnailCount = thumbnails.size();
-    m_needsMappingUpdate = false;
-    
-    m_characterToWindow.clear();
-    m_windowToCharacter.clear();
-    m_notLoggedInWindows.clear();
-    m_nonEVEWindows.clear();
-    
-    for (auto it = thumbnails.begin(); it != thumbnails.end(); ++it) {
-        HWND hwnd = it.key();
-        ThumbnailWidget* widget = it.value();
-        
-        QString processName = m_windowProcessNames.value(hwnd, "");
-        bool isEVEClient = processName.compare("exefile.exe", Qt::CaseInsensitive) == 0;
-        
-        if (!isEVEClient) {
-            m_nonEVEWindows.append(hwnd);
-            continue;
-        }
-        
-        QString title = m_lastKnownTitles.value(hwnd, "");
-        if (title.isEmpty()) {
-            title = widget->property("windowTitle").toString();
-        }
-        
-        QString characterName = OverlayInfo::extractCharacterName(title);
-        
-        if (!characterName.isEmpty()) {
-            m_characterToWindow[characterName] = hwnd;
-            m_windowToCharacter[hwnd] = characterName;
-        } else {
-            m_notLoggedInWindows.append(hwnd);
-        }
-    }
-    
-    static int lastNotLoggedInCount = 0;
-    if (m_notLoggedInWindows.size() != lastNotLoggedInCount) {
-        std::sort(m_notLoggedInWindows.begin(), m_notLoggedInWindows.end(), 
-            [this](HWND a, HWND b) {
-                return m_windowCreationTimes.value(a, 0) < m_windowCreationTimes.value(b, 0);
-            });
-        lastNotLoggedInCount = m_notLoggedInWindows.size();
-    }
+    m_snappingListDirty = false;
     
-    static int lastNonEVECount = 0;
-    if (m_nonEVEWindows.size() != lastNonEVECount) {
-        std::sort(m_nonEVEWindows.begin(), m_nonEVEWindows.end(), 
-            [this](HWND a, HWND b) {
-                return m_windowCreationTimes.value(a, 0) < m_windowCreationTimes.value(b, 0);
-            });
-        lastNonEVECount = m_nonEVEWindows.size();
+    m_cachedThumbnailList.clear();
+    m_cachedThumbnailList.reserve(clients().size());
+    for (ClientSlot slot : clients().clients()) {
+        m_cachedThumbnailList.append(thumbnailWidget(slot));
     }
     
-    hotkeyManager->updateCharacterWindows(m_characterToWindow);
-    
-    if (m_chatLogReader && (Config::instance().enableChatLogMonitoring() || Config::instance().enableGameLogMonitoring())) {
-        QStringList characterNames = m_characterToWindow.keys();
-        m_chatLogReader->setCharacterNames(characterNames);
+    for (auto* thumb : m_cachedThumbnailList) {
+        thumb->setOtherThumbnails(m_cachedThumbnailList);
     }
 }
 
-void MainWindow::refreshSingleThumbnail(HWND hwnd)
+void MainWindow::refreshSingleThumbnail(WindowId hwnd)
 {
-    auto it = thumbnails.find(hwnd);
-    if (it == thumbnails.end()) {
+    ThumbnailWidget* thumbWidget = static_cast<ThumbnailWidget*>(clients().thumbnailFor(hwnd));
+    if (!thumbWidget) {
         return;  
     }
     
-    ThumbnailWidget* thumbWidget = it.value();
     thumbWidget->forceUpdate();
 }
 
-QPoint MainWindow::calculateNotLoggedInPosition(int index)
-{
-    const Config& cfg = Config::instance();
-    int stackMode = cfg.notLoggedInStackMode();  
-    
-    int thumbWidth = cfg.thumbnailWidth();
-    int thumbHeight = cfg.thumbnailHeight();
-    int spacing = 10;
-    
-    // Use the custom reference position
-    QPoint refPos = cfg.notLoggedInReferencePosition();
-    int baseX = refPos.x();
-    int baseY = refPos.y();
-    
-    int offsetX = 0, offsetY = 0;
-    
-    switch (stackMode) {
-        case 0: 
-            offsetX = index * (thumbWidth + spacing);
-            break;
-        case 1: 
-            offsetY = index * (thumbHeight + spacing);
-            break;
-        case 2: 
-            offsetX = 0;
-            offsetY = 0;
-            break;
-    }
-    
-    return QPoint(baseX + offsetX, baseY + offsetY);
-}
-
 void MainWindow::updateActiveWindow()
 {
-    const Config& cfg = Config::instance();
-    HWND activeWindow = GetForegroundWindow();
-    bool hideActive = cfg.hideActiveClientThumbnail();
-    bool highlightActive = cfg.highlightActiveWindow();
+    WindowId activeWindow = WindowSystem::instance().foregroundWindow();
+    if (activeWindow != m_activeWindow) {
+        WindowId previousWindow = m_activeWindow;
+        m_activeWindow = activeWindow;
+        applyActiveState(clients().slotFor(previousWindow), false);
+        applyActiveState(clients().slotFor(activeWindow), true);
+    }
     
-    for (auto it = thumbnails.begin(); it != thumbnails.end(); ++it) {
-        bool isActive = (it.key() == activeWindow);
-        
-        if (highlightActive) {
-            it.value()->setActive(isActive);
-        } else {
-            it.value()->setActive(false);
-        }
-        
-        if (isActive) {
-            it.value()->forceUpdate();
-            
-            if (it.value()->hasCombatEvent()) {
-                it.value()->setCombatMessage("", "");
-                qDebug() << "MainWindow: Cleared combat event for focused window";
-            }
-        }
-        
-        if (hideActive && isActive) {
-            it.value()->hide();
-        } else {
-            it.value()->show();
+    ClientSlot activeSlot = clients().slotFor(activeWindow);
+    if (activeSlot != ClientRegistry::INVALID_SLOT && clients().kind(activeSlot) == ClientRegistry::Kind::LoggedIn) {
+        const QString& activeSystem = clients().systemName(activeSlot);
+        if (activeSystem != m_tracker->referenceSystem()) {
+            m_tracker->setReferenceSystem(activeSystem);
+            updateJumpDistances();
         }
     }
 }
 
-void MainWindow::onThumbnailClicked(quintptr windowId)
+void MainWindow::applyActiveState(ClientSlot slot, bool active)
 {
-    HWND hwnd = reinterpret_cast<HWND>(windowId);
-    activateWindow(hwnd);
+    if (slot == ClientRegistry::INVALID_SLOT) {
+        return;
+    }
     
-    QHash<QString, CycleGroup> allGroups = hotkeyManager->getAllCycleGroups();
-    for (auto it = allGroups.begin(); it != allGroups.end(); ++it) {
-        const QString& groupName = it.key();
-        const CycleGroup& group = it.value();
-        
-        QVector<HWND> windowsToCycle = buildCycleWindowList(group);
+    const Config& cfg = Config::instance();
+    ThumbnailWidget* thumb = thumbnailWidget(slot);
+    thumb->setActive(active && cfg.highlightActiveWindow());
+    
+    if (active) {
+        thumb->forceUpdate();
         
-        int index = windowsToCycle.indexOf(hwnd);
-        if (index != -1) {
-            m_cycleIndexByGroup[groupName] = index;
-            m_lastActivatedWindowByGroup[groupName] = hwnd;  
+        if (thumb->hasCombatEvent()) {
+            thumb->setCombatMessage("", "");
+            qCDebug(lcWindow) << "MainWindow: Cleared combat event for focused window";
         }
     }
     
-    int notLoggedInIndex = m_notLoggedInWindows.indexOf(hwnd);
-    if (notLoggedInIndex != -1) {
-        m_notLoggedInCycleIndex = notLoggedInIndex;
+    bool visible = !(active && cfg.hideActiveClientThumbnail());
+    if (thumb->isVisible() != visible) {
+        thumb->setVisible(visible);
     }
 }
 
-QVector<HWND> MainWindow::buildCycleWindowList(const CycleGroup& group)
+void MainWindow::refreshActiveStates()
 {
-    QVector<HWND> windowsToCycle;
-    
-    for (const QString& characterName : group.characterNames) {
-        HWND hwnd = hotkeyManager->getWindowForCharacter(characterName);
-        if (hwnd && IsWindow(hwnd)) {
-            windowsToCycle.append(hwnd);
-        }
-    }
-    
-    if (group.includeNotLoggedIn) {
-        for (HWND hwnd : m_notLoggedInWindows) {
-            if (!windowsToCycle.contains(hwnd)) {
-                windowsToCycle.append(hwnd);
-            }
-        }
+    // Settings changed what being active looks like, so every thumbnail is redone
+    m_activeWindow = WindowSystem::instance().foregroundWindow();
+    for (ClientSlot slot : clients().clients()) {
+        applyActiveState(slot, clients().window(slot) == m_activeWindow);
     }
-    
-    return windowsToCycle;
+    updateActiveWindow();
 }
 
-void MainWindow::handleNamedCycleForward(const QString& groupName)
+void MainWindow::updateJumpDistances()
 {
-    CycleGroup group = hotkeyManager->getCycleGroup(groupName);
-    QVector<HWND> windowsToCycle = buildCycleWindowList(group);
-    
-    if (windowsToCycle.isEmpty()) {
+    if (!Config::instance().showJumpDistance()) {
         return;
     }
     
-    int currentIndex = -1;
-    HWND lastActivatedWindow = m_lastActivatedWindowByGroup.value(groupName, nullptr);
-    if (lastActivatedWindow) {
-        currentIndex = windowsToCycle.indexOf(lastActivatedWindow);
+    QHash<QString, int> distances = StarMap::instance().distancesFrom(m_tracker->referenceSystem(),
+                                                                      m_tracker->liveCharacterSystems());
+    for (ClientSlot slot : clients().clients()) {
+        thumbnailWidget(slot)->setJumpDistance(distances.value(clients().characterName(slot), StarMap::UNREACHABLE));
     }
-    
-    if (currentIndex == -1) {
-        currentIndex = m_cycleIndexByGroup.value(groupName, -1);
-    }
-    
-    currentIndex++;
-    
-    if (group.noLoop && currentIndex >= windowsToCycle.size()) {
+}
+
+void MainWindow::logCacheReport()
+{
+    if (!lcLog().isDebugEnabled()) {
         return;
     }
     
-    if (currentIndex >= windowsToCycle.size()) {
-        currentIndex = 0;
+    for (const QString& line : BoundedCacheBase::memoryReport()) {
+        qCDebug(lcLog) << "Cache:" << qPrintable(line);
     }
-    
-    HWND hwnd = windowsToCycle[currentIndex];
-    m_cycleIndexByGroup[groupName] = currentIndex;
-    m_lastActivatedWindowByGroup[groupName] = hwnd;  
+}
+
+void MainWindow::onThumbnailClicked(quintptr windowId)
+{
+    WindowId hwnd = windowId;
     activateWindow(hwnd);
+    m_tracker->setActivated(hwnd);
 }
 
-void MainWindow::handleNamedCycleBackward(const QString& groupName)
+void MainWindow::handleNamedCycleForward(const QString& groupName)
 {
-    CycleGroup group = hotkeyManager->getCycleGroup(groupName);
-    QVector<HWND> windowsToCycle = buildCycleWindowList(group);
-    
-    if (windowsToCycle.isEmpty()) {
-        return;
-    }
-    
-    int currentIndex = -1;
-    HWND lastActivatedWindow = m_lastActivatedWindowByGroup.value(groupName, nullptr);
-    if (lastActivatedWindow) {
-        currentIndex = windowsToCycle.indexOf(lastActivatedWindow);
-    }
-    
-    if (currentIndex == -1) {
-        currentIndex = m_cycleIndexByGroup.value(groupName, 0);
-    }
-    
-    currentIndex--;
-    
-    if (group.noLoop && currentIndex < 0) {
-        return;
+    if (WindowId hwnd = m_tracker->cycleForward(groupName)) {
+        activateWindow(hwnd);
     }
-    
-    if (currentIndex < 0) {
-        currentIndex = windowsToCycle.size() - 1;
+}
+
+void MainWindow::handleNamedCycleBackward(const QString& groupName)
+{
+    if (WindowId hwnd = m_tracker->cycleBackward(groupName)) {
+        activateWindow(hwnd);
     }
-    
-    HWND hwnd = windowsToCycle[currentIndex];
-    m_cycleIndexByGroup[groupName] = currentIndex;
-    m_lastActivatedWindowByGroup[groupName] = hwnd;  
-    activateWindow(hwnd);
 }
 
 void MainWindow::handleNotLoggedInCycleForward()
 {
-    if (m_notLoggedInWindows.isEmpty()) {
-        return;
-    }
-    
-    m_notLoggedInWindows.erase(
-        std::remove_if(m_notLoggedInWindows.begin(), m_notLoggedInWindows.end(),
-            [](HWND hwnd) { return !IsWindow(hwnd); }),
-        m_notLoggedInWindows.end()
-    );
-    
-    if (m_notLoggedInWindows.isEmpty()) {
-        return;
-    }
-    
-    m_notLoggedInCycleIndex++;
-    if (m_notLoggedInCycleIndex >= m_notLoggedInWindows.size()) {
-        m_notLoggedInCycleIndex = 0;
+    if (WindowId hwnd = m_tracker->cycleNotLoggedInForward()) {
+        activateWindow(hwnd);
     }
-    
-    HWND hwnd = m_notLoggedInWindows[m_notLoggedInCycleIndex];
-    activateWindow(hwnd);
 }
 
 void MainWindow::handleNotLoggedInCycleBackward()
 {
-    if (m_notLoggedInWindows.isEmpty()) {
-        return;
-    }
-    
-    m_notLoggedInWindows.erase(
-        std::remove_if(m_notLoggedInWindows.begin(), m_notLoggedInWindows.end(),
-            [](HWND hwnd) { return !IsWindow(hwnd); }),
-        m_notLoggedInWindows.end()
-    );
-    
-    if (m_notLoggedInWindows.isEmpty()) {
-        return;
-    }
-    
-    m_notLoggedInCycleIndex--;
-    if (m_notLoggedInCycleIndex < 0) {
-        m_notLoggedInCycleIndex = m_notLoggedInWindows.size() - 1;
+    if (WindowId hwnd = m_tracker->cycleNotLoggedInBackward()) {
+        activateWindow(hwnd);
     }
-    
-    HWND hwnd = m_notLoggedInWindows[m_notLoggedInCycleIndex];
-    activateWindow(hwnd);
 }
 
 void MainWindow::handleNonEVECycleForward()
 {
-    if (m_nonEVEWindows.isEmpty()) {
-        return;
-    }
-    
-    m_nonEVEWindows.erase(
-        std::remove_if(m_nonEVEWindows.begin(), m_nonEVEWindows.end(),
-            [](HWND hwnd) { return !IsWindow(hwnd); }),
-        m_nonEVEWindows.end()
-    );
-    
-    if (m_nonEVEWindows.isEmpty()) {
-        return;
-    }
-    
-    m_nonEVECycleIndex++;
-    if (m_nonEVECycleIndex >= m_nonEVEWindows.size()) {
-        m_nonEVECycleIndex = 0;
+    if (WindowId hwnd = m_tracker->cycleNonEVEForward()) {
+        activateWindow(hwnd);
     }
-    
-    HWND hwnd = m_nonEVEWindows[m_nonEVECycleIndex];
-    activateWindow(hwnd);
 }
 
 void MainWindow::handleNonEVECycleBackward()
 {
-    if (m_nonEVEWindows.isEmpty()) {
-        return;
-    }
-    
-    m_nonEVEWindows.erase(
-        std::remove_if(m_nonEVEWindows.begin(), m_nonEVEWindows.end(),
-            [](HWND hwnd) { return !IsWindow(hwnd); }),
-        m_nonEVEWindows.end()
-    );
-    
-    if (m_nonEVEWindows.isEmpty()) {
-        return;
-    }
-    
-    m_nonEVECycleIndex--;
-    if (m_nonEVECycleIndex < 0) {
-        m_nonEVECycleIndex = m_nonEVEWindows.size() - 1;
+    if (WindowId hwnd = m_tracker->cycleNonEVEBackward()) {
+        activateWindow(hwnd);
     }
-    
-    HWND hwnd = m_nonEVEWindows[m_nonEVECycleIndex];
-    activateWindow(hwnd);
 }
 
-void MainWindow::activateCharacter(const QString& characterName)
+void MainWindow::activateCharacter(CharacterId characterId)
 {
-    HWND hwnd = hotkeyManager->getWindowForCharacter(characterName);
-    if (hwnd) {
+    ClientSlot slot = clients().slotFor(characterId);
+    if (slot != ClientRegistry::INVALID_SLOT) {
+        WindowId hwnd = clients().window(slot);
         activateWindow(hwnd);
-        
-        QHash<QString, CycleGroup> allGroups = hotkeyManager->getAllCycleGroups();
-        for (auto it = allGroups.begin(); it != allGroups.end(); ++it)
-        {
-            const QString& groupName = it.key();
-            const CycleGroup& group = it.value();
-            
-            QVector<HWND> windowsToCycle = buildCycleWindowList(group);
-            
-            int index = windowsToCycle.indexOf(hwnd);
-            if (index != -1)
-            {
-                m_cycleIndexByGroup[groupName] = index;
-                m_lastActivatedWindowByGroup[groupName] = hwnd;  
-            }
-        }
+        m_tracker->setActivated(hwnd);
     }
 }
 
-void MainWindow::activateWindow(HWND hwnd)
+void MainWindow::activateWindow(WindowId hwnd)
 {
+    m_activationTimer.start();
     const Config& cfg = Config::instance();
+    WindowSystem& windowSystem = WindowSystem::instance();
+    bool wasMinimized = windowSystem.isMinimized(hwnd);
+    
+    // Nothing to time when it is already in front, no foreground event follows
+    m_activationTarget = windowSystem.foregroundWindow() == hwnd ? 0 : hwnd;
+    m_activationTargetMinimized = wasMinimized;
+    
     if (cfg.minimizeInactiveClients()) {
-        bool wasMinimized = IsIconic(hwnd);
-        
         if (wasMinimized) {
-            ShowWindowAsync(hwnd, SW_RESTORE);
+            windowSystem.restore(hwnd, false);
             m_hwndJustRestored = hwnd;  
             
             m_hwndPendingRefresh = hwnd;
         }
         
-        SetForegroundWindow(hwnd);
-        SetFocus(hwnd);
+        windowSystem.setForegroundWindow(hwnd);
         
         m_hwndToActivate = hwnd;
         
@@ -971,15 +494,25 @@ void MainWindow::activateWindow(HWND hwnd)
 void MainWindow::minimizeInactiveWindows()
 {
     const Config& cfg = Config::instance();
-    for (auto it = thumbnails.begin(); it != thumbnails.end(); ++it) {
-        HWND otherHwnd = it.key();
-        if (otherHwnd != m_hwndToActivate && IsWindow(otherHwnd)) {
-            QString characterName = m_windowToCharacter.value(otherHwnd);
+    WindowSystem& windowSystem = WindowSystem::instance();
+    const QSet<WindowId> preRestored = m_tracker->preRestoreTargets(m_hwndToActivate);
+    for (ClientSlot slot : clients().clients()) {
+        WindowId otherHwnd = clients().window(slot);
+        if (otherHwnd != m_hwndToActivate && windowSystem.isWindow(otherHwnd)) {
+            const QString& characterName = clients().characterName(slot);
             if (!characterName.isEmpty() && cfg.isCharacterNeverMinimize(characterName)) {
                 continue;
             }
             
-            ShowWindowAsync(otherHwnd, 11);
+            // Likely next targets wait behind the active client, cycling to them skips the restore
+            if (preRestored.contains(otherHwnd)) {
+                if (windowSystem.isMinimized(otherHwnd)) {
+                    windowSystem.restoreBehind(otherHwnd, m_hwndToActivate);
+                }
+                continue;
+            }
+            
+            windowSystem.minimize(otherHwnd);
         }
     }
 }
@@ -991,83 +524,125 @@ void MainWindow::onThumbnailPositionChanged(quintptr windowId, QPoint position)
         return;
     }
     
-    HWND hwnd = reinterpret_cast<HWND>(windowId);
+    ClientSlot slot = clients().slotFor(windowId);
+    if (slot == ClientRegistry::INVALID_SLOT) {
+        return;
+    }
     
-    QString processName = m_windowProcessNames.value(hwnd, "");
-    bool isEVEClient = processName.compare("exefile.exe", Qt::CaseInsensitive) == 0;
+    QString positionKey = clients().positionKey(slot);
+    if (!positionKey.isEmpty()) {
+        cfg.setThumbnailPosition(positionKey, position);
+    }
+}
+
+void MainWindow::onGroupDragStarted(quintptr windowId)
+{
+    WindowId draggedWindow = windowId;
+    WindowSystem& windowSystem = WindowSystem::instance();
+    m_groupDragMembers.clear();
+    m_groupDragDelta = QPoint();
+    m_groupDragPending = false;
     
-    if (isEVEClient) {
-        QString characterName = m_windowToCharacter.value(hwnd);
-        if (!characterName.isEmpty()) {
-            cfg.setThumbnailPosition(characterName, position);
+    for (ClientSlot slot : clients().clients()) {
+        ThumbnailWidget* thumbnail = thumbnailWidget(slot);
+        clients().setDragOrigin(slot, thumbnail->pos());
+        if (clients().window(slot) == draggedWindow) {
+            continue;
         }
-    } else {
-        QString title = m_lastKnownTitles.value(hwnd, "");
-        if (!title.isEmpty() && !processName.isEmpty()) {
-            QString uniqueId = QString("%1::%2").arg(processName, title);
-            cfg.setThumbnailPosition(uniqueId, position);
+        
+        std::optional<QPoint> nativeOrigin;
+        if (thumbnail->isVisible()) {
+            QRect nativeRect = windowSystem.windowRect(WindowId(thumbnail->winId()));
+            if (!nativeRect.isNull()) {
+                nativeOrigin = nativeRect.topLeft();
+            }
         }
+        m_groupDragMembers.insert(slot, nativeOrigin);
     }
+    
+    ThumbnailWidget* dragged = static_cast<ThumbnailWidget*>(clients().thumbnailFor(draggedWindow));
+    QScreen* screen = dragged ? dragged->screen() : QGuiApplication::primaryScreen();
+    qreal refreshRate = screen && screen->refreshRate() > 0 ? screen->refreshRate() : 60.0;
+    m_groupDragTimer->setInterval(qMax(1, qRound(1000.0 / refreshRate)));
 }
 
-void MainWindow::onGroupDragStarted(quintptr windowId)
+void MainWindow::onGroupDragMoved(quintptr windowId, QPoint delta)
 {
-    m_groupDragInitialPositions.clear();
+    Q_UNUSED(windowId);
+    
+    m_groupDragDelta = delta;
+    m_groupDragPending = true;
     
-    for (auto it = thumbnails.begin(); it != thumbnails.end(); ++it) {
-        ThumbnailWidget* thumb = it.value();
-        m_groupDragInitialPositions.insert(thumb->getWindowId(), thumb->pos());
+    // The first move lands at once, later ones wait for the next frame
+    if (!m_groupDragTimer->isActive()) {
+        applyGroupDrag();
     }
 }
 
-void MainWindow::onGroupDragMoved(quintptr windowId, QPoint delta)
+void MainWindow::applyGroupDrag()
 {
-    for (auto it = thumbnails.begin(); it != thumbnails.end(); ++it) {
-        ThumbnailWidget* thumb = it.value();
-        
-        if (thumb->getWindowId() == windowId) {
+    if (!m_groupDragPending) {
+        return;
+    }
+    m_groupDragPending = false;
+    
+    QVector<WindowSystem::WindowMove> moves;
+    QVector<std::pair<ThumbnailWidget*, QPoint>> batched;
+    moves.reserve(m_groupDragMembers.size() * 2);
+    batched.reserve(m_groupDragMembers.size());
+    
+    for (auto it = m_groupDragMembers.cbegin(); it != m_groupDragMembers.cend(); ++it) {
+        ThumbnailWidget* thumbnail = thumbnailWidget(it.key());
+        QPoint target = clients().dragOrigin(it.key()) + m_groupDragDelta;
+        if (!it.value() || !thumbnail->isVisible()) {
+            thumbnail->move(target);
             continue;
         }
         
-        QPoint initialPos = m_groupDragInitialPositions.value(thumb->getWindowId());
-        QPoint newPos = initialPos + delta;
-        
-        thumb->move(newPos);
+        // Widget positions are device independent, the batch is in native pixels
+        QPoint nativeTarget = *it.value() + m_groupDragDelta * thumbnail->devicePixelRatioF();
+        moves.append({WindowId(thumbnail->winId()), nativeTarget});
+        if (WindowId overlay = thumbnail->overlayWindow()) {
+            moves.append({overlay, nativeTarget});
+        }
+        batched.append({thumbnail, target});
+    }
+    
+    if (!WindowSystem::instance().moveWindows(moves)) {
+        for (const auto& [thumbnail, target] : batched) {
+            thumbnail->move(target);
+        }
     }
+    
+    m_groupDragTimer->start();
 }
 
 void MainWindow::onGroupDragEnded(quintptr windowId)
 {
-    Q_UNUSED(windowId);
+    applyGroupDrag();
+    m_groupDragTimer->stop();
     
     Config& cfg = Config::instance();
-    if (!cfg.rememberPositions()) {
-        m_groupDragInitialPositions.clear();
-        return;
-    }
-    
-    for (auto it = thumbnails.begin(); it != thumbnails.end(); ++it) {
-        HWND hwnd = it.key();
-        ThumbnailWidget* thumb = it.value();
-        
-        QString processName = m_windowProcessNames.value(hwnd, "");
-        bool isEVEClient = processName.compare("exefile.exe", Qt::CaseInsensitive) == 0;
-        
-        if (isEVEClient) {
-            QString characterName = m_windowToCharacter.value(hwnd);
-            if (!characterName.isEmpty()) {
-                cfg.setThumbnailPosition(characterName, thumb->pos());
+    if (cfg.rememberPositions()) {
+        // Saved from where the drag put them, native moves may not have reached pos() yet
+        WindowId draggedWindow = windowId;
+        Config::Transaction transaction(cfg);
+        for (ClientSlot slot : clients().clients()) {
+            QString positionKey = clients().positionKey(slot);
+            if (positionKey.isEmpty()) {
+                continue;
             }
-        } else {
-            QString title = m_lastKnownTitles.value(hwnd, "");
-            if (!title.isEmpty() && !processName.isEmpty()) {
-                QString uniqueId = QString("%1::%2").arg(processName, title);
-                cfg.setThumbnailPosition(uniqueId, thumb->pos());
+            
+            if (clients().window(slot) == draggedWindow) {
+                cfg.setThumbnailPosition(positionKey, thumbnailWidget(slot)->pos());
+            } else if (m_groupDragMembers.contains(slot)) {
+                cfg.setThumbnailPosition(positionKey, clients().dragOrigin(slot) + m_groupDragDelta);
             }
         }
+        cfg.scheduleSave();
     }
     
-    m_groupDragInitialPositions.clear();
+    m_groupDragMembers.clear();
 }
 
 void MainWindow::showSettings()
@@ -1080,12 +655,13 @@ void MainWindow::showSettings()
         m_configDialog->raise();
         m_configDialog->activateWindow();
         
-        HWND hwnd = reinterpret_cast<HWND>(m_configDialog->winId());
+        WindowId hwnd = WindowId(m_configDialog->winId());
         if (hwnd) {
-            if (IsIconic(hwnd)) {
-                ShowWindow(hwnd, SW_RESTORE);
+            WindowSystem& windowSystem = WindowSystem::instance();
+            if (windowSystem.isMinimized(hwnd)) {
+                windowSystem.restore(hwnd, true);
             }
-            SetForegroundWindow(hwnd);
+            windowSystem.setForegroundWindow(hwnd);
         }
         
         return;
@@ -1095,19 +671,20 @@ void MainWindow::showSettings()
     m_configDialog->setAttribute(Qt::WA_DeleteOnClose);
     m_configDialog->setWindowModality(Qt::NonModal);
     
-    connect(m_configDialog, &ConfigDialog::settingsApplied, this, &MainWindow::applySettings);
+    // Setting changes arrive through Config::settingsChanged, cycle groups live in HotkeyManager
+    connect(m_configDialog, &ConfigDialog::settingsApplied, m_tracker.get(), &ClientTracker::resetCycleState);
     connect(m_configDialog, &ConfigDialog::saveClientLocationsRequested, this, &MainWindow::saveCurrentClientLocations);
     
     connect(this, &MainWindow::profileSwitchedExternally, m_configDialog, &ConfigDialog::onExternalProfileSwitch);
     
-    for (auto it = thumbnails.begin(); it != thumbnails.end(); ++it) {
-        it.value()->update();
+    for (ClientSlot slot : clients().clients()) {
+        thumbnailWidget(slot)->update();
     }
     
     connect(m_configDialog, &QObject::destroyed, this, [this]() {
         m_configDialog = nullptr;
-        for (auto it = thumbnails.begin(); it != thumbnails.end(); ++it) {
-            it.value()->update();
+        for (ClientSlot slot : clients().clients()) {
+            thumbnailWidget(slot)->update();
         }
         updateProfilesMenu();
     });
@@ -1121,188 +698,121 @@ void MainWindow::handleProfileSwitch(const QString& profileName)
     QString currentProfile = cfg.getCurrentProfileName();
     
     if (profileName == currentProfile) {
-        qDebug() << "Already on profile:" << profileName;
+        qCDebug(lcWindow) << "Already on profile:" << profileName;
         return;
     }
     
-    qDebug() << "Switching from profile" << currentProfile << "to" << profileName;
+    qCDebug(lcWindow) << "Switching from profile" << currentProfile << "to" << profileName;
     
-    cfg.save();
     hotkeyManager->saveToConfig();  
     
+    // loadProfile() schedules the write-behind for the outgoing profile and
+    // notifies settingsChanged() subscribers with what differs between them
     if (cfg.loadProfile(profileName)) {
-        applySettings();
         
         emit profileSwitchedExternally(profileName);
         
         updateProfilesMenu();
         
-        qDebug() << "Successfully switched to profile:" << profileName;
+        qCDebug(lcWindow) << "Successfully switched to profile:" << profileName;
     } else {
-        qWarning() << "Failed to switch to profile:" << profileName;
+        qCWarning(lcWindow) << "Failed to switch to profile:" << profileName;
     }
 }
 
-void MainWindow::applySettings()
+void MainWindow::onConfigChanged(Config::ChangeGroups groups, const Config::SettingSet& changed)
 {
-    qDebug() << "MainWindow::applySettings - updating thumbnails and overlay caches";
+    qCDebug(lcWindow) << "MainWindow::onConfigChanged -" << groups << changed.count() << "settings changed";
     const Config& cfg = Config::instance();
-    m_cycleIndexByGroup.clear();
-    m_lastActivatedWindowByGroup.clear();
-    m_notLoggedInCycleIndex = -1;
-    m_nonEVECycleIndex = -1;
-    m_clientLocationMoveAttempted.clear();
-    
-    hotkeyManager->loadFromConfig();
-    
-    if (!cfg.minimizeInactiveClients()) {
-        for (auto it = thumbnails.begin(); it != thumbnails.end(); ++it) {
-            HWND hwnd = it.key();
-            if (IsWindow(hwnd) && IsIconic(hwnd)) {
-                ShowWindowAsync(hwnd, SW_RESTORE);
+    auto anyChanged = [&changed](std::initializer_list<Config::Setting> settings) {
+        for (Config::Setting setting : settings) {
+            if (changed.test(static_cast<size_t>(setting))) {
+                return true;
             }
         }
-    }
-    
-    // Prepare default layout parameters in case we need to re-layout thumbnails
-    QScreen *primaryScreen = QGuiApplication::primaryScreen();
-    QRect screenGeometry = primaryScreen->geometry();
-    int screenWidth = screenGeometry.width();
-    int screenHeight = screenGeometry.height();
-    int margin = 10;
-    int thumbWidth = cfg.thumbnailWidth();
-    int thumbHeight = cfg.thumbnailHeight();
+        return false;
+    };
     
-    int xOffset = margin;
-    int yOffset = margin;
-    int thumbnailsPerRow = (screenWidth - margin) / (thumbWidth + margin);
-    if (thumbnailsPerRow < 1) thumbnailsPerRow = 1;
+    if (groups & Config::ProfileChanges) {
+        m_tracker->resetCycleState();
+    }
     
-    int notLoggedInCount = 0;
-    bool rememberPos = cfg.rememberPositions();
+    if ((groups & Config::ProfileChanges) || anyChanged({Config::Setting::SaveClientLocation})) {
+        clients().clearLocationMoveAttempted();
+    }
     
-    for (auto it = thumbnails.begin(); it != thumbnails.end(); ++it) {
-        HWND hwnd = it.key();
-        ThumbnailWidget* thumb = it.value();
-        
-        QSize currentSize = thumb->size();
-        QSize newSize(thumbWidth, thumbHeight);
-        if (currentSize != newSize) {
-            thumb->setFixedSize(newSize);
-        }
-        
-        thumb->setWindowOpacity(cfg.thumbnailOpacity() / 100.0);  
-        
-        thumb->updateWindowFlags(cfg.alwaysOnTop());
-        
-        QString processName = m_windowProcessNames.value(hwnd, "");
-        bool isEVEClient = processName.compare("exefile.exe", Qt::CaseInsensitive) == 0;
-        
-        QPoint savedPos(-1, -1);
-        bool hasSavedPosition = false;
-        
-        if (rememberPos) {
-            if (isEVEClient) {
-                QString characterName = m_windowToCharacter.value(hwnd);
-                if (!characterName.isEmpty()) {
-                    savedPos = cfg.getThumbnailPosition(characterName);
-                    hasSavedPosition = (savedPos != QPoint(-1, -1));
-                }
-            } else {
-                QString title = m_lastKnownTitles.value(hwnd, "");
-                if (!title.isEmpty() && !processName.isEmpty()) {
-                    QString uniqueId = QString("%1::%2").arg(processName, title);
-                    savedPos = cfg.getThumbnailPosition(uniqueId);
-                    hasSavedPosition = (savedPos != QPoint(-1, -1));
-                }
-            }
-        }
-        
-        if (hasSavedPosition) {
-            QRect thumbRect(savedPos, QSize(thumbWidth, thumbHeight));
-            QScreen* targetScreen = nullptr;
-            for (QScreen* screen : QGuiApplication::screens()) {
-                if (screen->geometry().intersects(thumbRect)) {
-                    targetScreen = screen;
-                    break;
-                }
-            }
-            
-            if (targetScreen) {
-                thumb->move(savedPos);
-            } else {
-                // Saved position is off-screen, use default layout
-                hasSavedPosition = false;
+    if (anyChanged({Config::Setting::MinimizeInactive}) && !cfg.minimizeInactiveClients()) {
+        WindowSystem& windowSystem = WindowSystem::instance();
+        for (ClientSlot slot : clients().clients()) {
+            WindowId hwnd = clients().window(slot);
+            if (windowSystem.isWindow(hwnd) && windowSystem.isMinimized(hwnd)) {
+                windowSystem.restore(hwnd, false);
             }
         }
-        
-        // If no saved position or rememberPositions is disabled, use default layout
-        if (!hasSavedPosition) {
-            QString characterName = m_windowToCharacter.value(hwnd);
-            bool isNotLoggedIn = isEVEClient && characterName.isEmpty();
-            
-            if (isNotLoggedIn) {
-                QPoint pos = calculateNotLoggedInPosition(notLoggedInCount);
-                thumb->move(pos);
-                notLoggedInCount++;
-            } else {
-                if (xOffset + thumbWidth > screenWidth - margin) {
-                    xOffset = margin;
-                    yOffset += thumbHeight + margin;
-                }
-                
-                if (yOffset + thumbHeight > screenHeight - margin) {
-                    yOffset = margin;
-                }
-                
-                thumb->move(xOffset, yOffset);
-                xOffset += thumbWidth + margin;
+    }
+    
+    // Size, opacity, window flags and overlays are handled by each ThumbnailWidget
+    if (groups & Config::LayoutChanges) {
+        // Only thumbnails whose target moved are touched
+        const QHash<ClientSlot, QPoint> targets = m_tracker->layoutTargets();
+        for (auto it = targets.constBegin(); it != targets.constEnd(); ++it) {
+            ThumbnailWidget* thumb = thumbnailWidget(it.key());
+            if (thumb->pos() != it.value()) {
+                thumb->move(it.value());
             }
         }
-        
-    thumb->updateOverlays();
-    thumb->forceOverlayRender();
-        
-        thumb->QWidget::update();
     }
     
-    refreshTimer->setInterval(cfg.refreshInterval());
+    if (anyChanged({Config::Setting::EnableDebugLogging, Config::Setting::WriteLogToFile})) {
+        LogSink::instance().setDebugEnabled(cfg.enableDebugLogging());
+        LogSink::instance().setFileEnabled(cfg.writeLogToFile());
+    }
     
-    if (m_chatLogReader) {
-        QString chatLogDirectory = cfg.chatLogDirectory();
-        QString gameLogDirectory = cfg.gameLogDirectory();
-        m_chatLogReader->setLogDirectory(chatLogDirectory);
-        m_chatLogReader->setGameLogDirectory(gameLogDirectory);
-        
-        bool enableChatLog = cfg.enableChatLogMonitoring();
-        bool enableGameLog = cfg.enableGameLogMonitoring();
-        m_chatLogReader->setEnableChatLogMonitoring(enableChatLog);
-        m_chatLogReader->setEnableGameLogMonitoring(enableGameLog);
-        
-        bool shouldMonitor = enableChatLog || enableGameLog;
-        
-        // Update character names before starting/refreshing monitoring
-        if (shouldMonitor) {
-            QStringList characterNames = m_characterToWindow.keys();
-            m_chatLogReader->setCharacterNames(characterNames);
+    if (m_logIndexer && anyChanged({Config::Setting::ChatLogDirectory, Config::Setting::GameLogDirectory,
+                                    Config::Setting::EnableLogIndexing})) {
+        m_logIndexer->setDirectories(cfg.chatLogDirectory(), cfg.gameLogDirectory());
+        if (cfg.enableLogIndexing()) {
+            m_logIndexer->start();
+        } else {
+            m_logIndexer->stop();
         }
-        
-        if (shouldMonitor && !m_chatLogReader->isMonitoring()) {
-            m_chatLogReader->start();
-            qDebug() << "ChatLog: Monitoring started via settings (ChatLog:" << enableChatLog << ", GameLog:" << enableGameLog << ")";
-        } else if (!shouldMonitor && m_chatLogReader->isMonitoring()) {
-            m_chatLogReader->stop();
-            qDebug() << "ChatLog: Monitoring stopped via settings";
-        } else if (shouldMonitor && m_chatLogReader->isMonitoring()) {
-            // Monitoring is active and should remain active, but settings may have changed
-            m_chatLogReader->refreshMonitoring();
-            qDebug() << "ChatLog: Monitoring refreshed via settings (ChatLog:" << enableChatLog << ", GameLog:" << enableGameLog << ")";
+    }
+    
+    if (groups & (Config::ThumbnailChanges | Config::BorderChanges | Config::ProfileChanges)) {
+        refreshActiveStates();
+    }
+    
+    if (groups & (Config::OverlayChanges | Config::LayoutChanges)) {
+        updateJumpDistances();
+    }
+    
+    // Display names for not-logged-in and non-EVE thumbnails are chosen while refreshing
+    if ((groups & (Config::WindowBehaviorChanges | Config::LayoutChanges)) ||
+        anyChanged({Config::Setting::ShowNotLoggedInOverlay, Config::Setting::ShowNonEVEOverlay})) {
+        refreshWindows();
+    }
+}
+
+void MainWindow::showLogSearch()
+{
+    if (m_logSearchDialog) {
+        if (m_logSearchDialog->isMinimized()) {
+            m_logSearchDialog->showNormal();
         }
+        m_logSearchDialog->raise();
+        m_logSearchDialog->activateWindow();
+        return;
     }
     
-    updateActiveWindow();
+    m_logSearchDialog = new LogSearchDialog();
+    m_logSearchDialog->setAttribute(Qt::WA_DeleteOnClose);
+    m_logSearchDialog->setWindowModality(Qt::NonModal);
     
-    refreshWindows();
+    connect(m_logSearchDialog, &QObject::destroyed, this, [this]() {
+        m_logSearchDialog = nullptr;
+    });
+    
+    m_logSearchDialog->show();
 }
 
 void MainWindow::exitApplication()
@@ -1312,44 +822,71 @@ void MainWindow::exitApplication()
 
 void MainWindow::onCharacterSystemChanged(const QString& characterName, const QString& systemName)
 {
-    qDebug() << "MainWindow: Character" << characterName << "moved to system" << systemName;
+    qCDebug(lcWindow) << "MainWindow: Character" << characterName << "moved to system" << systemName;
     
-    m_characterSystems[characterName] = systemName;
-    
-    HWND hwnd = m_characterToWindow.value(characterName);
-    if (hwnd && thumbnails.contains(hwnd)) {
-        ThumbnailWidget* widget = thumbnails[hwnd];
-        widget->setSystemName(systemName);
-        qDebug() << "MainWindow: Updated thumbnail for" << characterName << "with system:" << systemName;
+    ClientSlot slot = m_tracker->setCharacterSystem(characterName, systemName);
+    if (slot != ClientRegistry::INVALID_SLOT) {
+        qCDebug(lcWindow) << "MainWindow: Updated thumbnail for" << characterName << "with system:" << systemName;
+        
+        if (clients().window(slot) == WindowSystem::instance().foregroundWindow()) {
+            m_tracker->setReferenceSystem(systemName);
+        }
     }
+    updateJumpDistances();
 }
 
 void MainWindow::onCombatEventDetected(const QString& characterName, const QString& eventType, const QString& eventText)
 {
-    qDebug() << "MainWindow: Combat event for" << characterName << "- Type:" << eventType << "- Text:" << eventText;
+    qCDebug(lcWindow) << "MainWindow: Combat event for" << characterName << "- Type:" << eventType << "- Text:" << eventText;
     
     const Config& cfg = Config::instance();
     if (!cfg.showCombatMessages()) {
-        qDebug() << "MainWindow: Combat messages disabled in settings";
+        qCDebug(lcWindow) << "MainWindow: Combat messages disabled in settings";
         return;
     }
     
     if (!cfg.isCombatEventTypeEnabled(eventType)) {
-        qDebug() << "MainWindow: Event type" << eventType << "is disabled in settings";
+        qCDebug(lcWindow) << "MainWindow: Event type" << eventType << "is disabled in settings";
         return;
     }
     
-    HWND hwnd = m_characterToWindow.value(characterName);
-    if (hwnd && thumbnails.contains(hwnd)) {
-        HWND activeWindow = GetForegroundWindow();
-        if (hwnd == activeWindow) {
-            qDebug() << "MainWindow: Suppressing combat event for focused window:" << characterName;
+    ClientSlot slot = clients().slotFor(CharacterRegistry::instance().find(characterName));
+    if (slot != ClientRegistry::INVALID_SLOT) {
+        WindowId activeWindow = WindowSystem::instance().foregroundWindow();
+        if (clients().window(slot) == activeWindow) {
+            qCDebug(lcWindow) << "MainWindow: Suppressing combat event for focused window:" << characterName;
             return;
         }
         
-        ThumbnailWidget* widget = thumbnails[hwnd];
-        widget->setCombatMessage(eventText, eventType);
-        qDebug() << "MainWindow: Updated thumbnail for" << characterName << "with combat message:" << eventText;
+        thumbnailWidget(slot)->setCombatMessage(eventText, eventType);
+        qCDebug(lcWindow) << "MainWindow: Updated thumbnail for" << characterName << "with combat message:" << eventText;
+    }
+}
+
+void MainWindow::onIntelReported(const IntelReport& report)
+{
+    qCDebug(lcWindow) << "MainWindow: Intel in" << report.channel << "-" << report.systemName << ":" << report.message;
+    
+    const Config& cfg = Config::instance();
+    if (!cfg.showIntelAlerts()) {
+        qCDebug(lcWindow) << "MainWindow: Intel alerts disabled in settings";
+        return;
+    }
+    
+    int alertJumps = cfg.intelAlertJumps();
+    WindowId activeWindow = WindowSystem::instance().foregroundWindow();
+    for (auto it = report.jumpsByCharacter.constBegin(); it != report.jumpsByCharacter.constEnd(); ++it) {
+        if (it.value() > alertJumps) {
+            continue;
+        }
+        
+        ClientSlot slot = clients().slotFor(CharacterRegistry::instance().find(it.key()));
+        if (slot == ClientRegistry::INVALID_SLOT || clients().window(slot) == activeWindow) {
+            continue;
+        }
+        
+        QString text = QString("Intel: %1 (%2j)").arg(report.systemName).arg(it.value());
+        thumbnailWidget(slot)->setCombatMessage(text, Config::INTEL_EVENT_TYPE);
     }
 }
 
@@ -1422,12 +959,13 @@ void MainWindow::onHotkeysSuspendedChanged(bool suspended)
 void MainWindow::closeAllEVEClients()
 {
     QVector<WindowInfo> windows = windowCapture->getEVEWindows();
+    WindowSystem& windowSystem = WindowSystem::instance();
     
     for (const WindowInfo& window : windows)
     {
-        if (window.handle && IsWindow(window.handle))
+        if (windowSystem.isWindow(window.handle))
         {
-            PostMessage(window.handle, WM_CLOSE, 0, 0);
+            windowSystem.close(window.handle);
         }
     }
 }
@@ -1435,85 +973,27 @@ void MainWindow::closeAllEVEClients()
 void MainWindow::saveCurrentClientLocations()
 {
     Config& cfg = Config::instance();
+    Config::Transaction transaction(cfg);
+    WindowSystem& windowSystem = WindowSystem::instance();
     int savedCount = 0;
     
-    // Iterate through all known windows
-    for (auto it = m_windowToCharacter.constBegin(); it != m_windowToCharacter.constEnd(); ++it) {
-        HWND hwnd = it.key();
-        QString characterName = it.value();
+    for (ClientSlot slot : clients().clients()) {
+        WindowId hwnd = clients().window(slot);
+        const QString& characterName = clients().characterName(slot);
         
-        if (!IsWindow(hwnd) || characterName.isEmpty()) {
+        if (!windowSystem.isWindow(hwnd) || characterName.isEmpty()) {
             continue;
         }
         
-        // Get window rectangle
-        RECT rect;
-        if (GetWindowRect(hwnd, &rect)) {
-            QRect qRect(rect.left, rect.top, rect.right - rect.left, rect.bottom - rect.top);
+        QRect qRect = windowSystem.windowRect(hwnd);
+        if (!qRect.isNull()) {
             cfg.setClientWindowRect(characterName, qRect);
             savedCount++;
-            qDebug() << "Saved window location for" << characterName << ":" << qRect;
+            qCDebug(lcWindow) << "Saved window location for" << characterName << ":" << qRect;
         }
     }
     
-    cfg.save();
-    qDebug() << "Saved" << savedCount << "client window locations";
-}
-
-bool MainWindow::isWindowRectValid(const QRect& rect)
-{
-    if (rect.isNull() || rect.isEmpty()) {
-        return false;
-    }
-    
-    // Check if any part of the window is on a valid monitor
-    RECT winRect = { rect.left(), rect.top(), rect.right(), rect.bottom() };
-    HMONITOR hMonitor = MonitorFromRect(&winRect, MONITOR_DEFAULTTONULL);
-    
-    return (hMonitor != nullptr);
-}
-
-bool MainWindow::tryRestoreClientLocation(HWND hwnd, const QString& characterName)
-{
-    const Config& cfg = Config::instance();
-    
-    if (!cfg.saveClientLocation()) {
-        return false;
-    }
-    
-    // Check if we've already attempted to move this window
-    if (m_clientLocationMoveAttempted.value(hwnd, false)) {
-        return false;
-    }
-    
-    // Get saved window rect
-    QRect savedRect = cfg.getClientWindowRect(characterName);
-    
-    if (!isWindowRectValid(savedRect)) {
-        qDebug() << "Saved window location for" << characterName << "is invalid or off-screen";
-        m_clientLocationMoveAttempted[hwnd] = true;
-        return false;
-    }
-    
-    // Attempt to move the window
-    BOOL result = SetWindowPos(
-        hwnd,
-        nullptr,
-        savedRect.x(),
-        savedRect.y(),
-        savedRect.width(),
-        savedRect.height(),
-        SWP_NOZORDER | SWP_NOACTIVATE
-    );
-    
-    m_clientLocationMoveAttempted[hwnd] = true;
-    
-    if (result) {
-        qDebug() << "Restored window location for" << characterName << "to" << savedRect;
-        return true;
-    } else {
-        qDebug() << "Failed to restore window location for" << characterName;
-        return false;
-    }
+    cfg.scheduleSave();
+    qCDebug(lcWindow) << "Saved" << savedCount << "client window locations";
 }
 
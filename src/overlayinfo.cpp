@@ -1,13 +1,12 @@
 #include "overlayinfo.h"
 #include <QFontMetrics>
 
-QHash<QString, QString> OverlayInfo::s_characterNameCache;
+BoundedCache<QString, QString> OverlayInfo::s_characterNameCache("OverlayInfo character names");
 
 QString OverlayInfo::extractCharacterName(const QString& windowTitle)
 {
-    auto it = s_characterNameCache.constFind(windowTitle);
-    if (it != s_characterNameCache.constEnd()) {
-        return it.value();
+    if (const QString* cached = s_characterNameCache.find(windowTitle)) {
+        return *cached;
     }
     
     QString characterName;
@@ -16,10 +15,6 @@ QString OverlayInfo::extractCharacterName(const QString& windowTitle)
         characterName = windowTitle.mid(prefix.length());
     }
     
-    if (s_characterNameCache.size() > 100) {
-        s_characterNameCache.clear();
-    }
-    
     s_characterNameCache.insert(windowTitle, characterName);
     return characterName;
 }
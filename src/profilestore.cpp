@@ -0,0 +1,401 @@
+#include "profilestore.h"
+#include "logging.h"
+#include <QColor>
+#include <QDataStream>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QPoint>
+#include <QRect>
+#include <QStringList>
+#include <QVector>
+#include <array>
+#include <limits>
+
+// File layout: header (magic, format version, section count, string count),
+// the string table as length-prefixed UTF-8, then one section per value kind
+// holding (key string id, value) pairs. Keys and repeated string values such
+// as colour names are stored once in the string table.
+namespace {
+
+constexpr quint32 PROFILE_MAGIC = 0x50505645;  // "EVPP"
+constexpr quint16 PROFILE_FORMAT_VERSION = 1;
+
+enum SectionType : quint8 {
+    BoolSection,
+    IntSection,
+    StringSection,
+    StringListSection,
+    PointSection,
+    RectSection,
+    ColorSection,
+    VariantSection,
+    SectionTypeCount
+};
+
+SectionType sectionFor(const QVariant& value)
+{
+    switch (value.typeId()) {
+    case QMetaType::Bool:
+        return BoolSection;
+    case QMetaType::Int:
+    case QMetaType::UInt:
+    case QMetaType::LongLong:
+        return IntSection;
+    case QMetaType::QString:
+        return StringSection;
+    case QMetaType::QStringList:
+        return StringListSection;
+    case QMetaType::QPoint:
+        return PointSection;
+    case QMetaType::QRect:
+        return RectSection;
+    case QMetaType::QColor:
+        return ColorSection;
+    default:
+        return VariantSection;
+    }
+}
+
+// Undoes the key escaping QSettings applies to INI files: '\\' separates
+// groups, %XX and %UXXXX encode everything outside plain ASCII
+QString unescapedIniKey(QStringView escaped)
+{
+    QString key;
+    key.reserve(escaped.size());
+    for (qsizetype i = 0; i < escaped.size(); ++i) {
+        const QChar ch = escaped[i];
+        if (ch == u'\\') {
+            key += u'/';
+        } else if (ch == u'%' && i + 1 < escaped.size()) {
+            const bool wide = escaped[i + 1] == u'U';
+            const qsizetype start = i + (wide ? 2 : 1);
+            const qsizetype digits = wide ? 4 : 2;
+            bool ok = false;
+            const uint code = start + digits <= escaped.size() ? escaped.mid(start, digits).toUInt(&ok, 16) : 0;
+            if (ok) {
+                key += QChar(char16_t(code));
+                i = start + digits - 1;
+            } else {
+                key += ch;
+            }
+        } else {
+            key += ch;
+        }
+    }
+    return key;
+}
+
+}
+
+QSettings::Format ProfileStore::binaryFormat()
+{
+    static const QSettings::Format format = QSettings::registerFormat(BINARY_EXTENSION, &ProfileStore::read, &ProfileStore::write);
+    return format;
+}
+
+QSettings::Format ProfileStore::formatForPath(const QString& filePath)
+{
+    if (QFileInfo(filePath).suffix().compare(BINARY_EXTENSION, Qt::CaseInsensitive) == 0) {
+        return binaryFormat();
+    }
+    return QSettings::IniFormat;
+}
+
+bool ProfileStore::copySettings(const QSettings& source, QSettings& destination)
+{
+    destination.clear();
+    for (const QString& key : source.allKeys()) {
+        destination.setValue(key, source.value(key));
+    }
+    destination.sync();
+
+    if (destination.status() != QSettings::NoError) {
+        qCWarning(lcLog) << "ProfileStore: Failed to write" << destination.fileName();
+        return false;
+    }
+    return true;
+}
+
+bool ProfileStore::readEntries(const QString& filePath, QSettings::SettingsMap& map)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    if (formatForPath(filePath) == binaryFormat()) {
+        return read(file, map);
+    }
+    return readIniEntries(file, map);
+}
+
+bool ProfileStore::readIniEntries(QIODevice& device, QSettings::SettingsMap& map)
+{
+    QString section;
+    const QList<QByteArray> lines = device.readAll().split('\n');
+    for (const QByteArray& rawLine : lines) {
+        const QString line = QString::fromUtf8(rawLine).trimmed();
+        if (line.isEmpty() || line.startsWith(u';') || line.startsWith(u'#')) {
+            continue;
+        }
+
+        if (line.startsWith(u'[') && line.endsWith(u']')) {
+            const QStringView name = QStringView(line).mid(1, line.size() - 2).trimmed();
+            // [General] holds top-level keys, a group really named General is written as [%General]
+            if (name.compare(u"General", Qt::CaseInsensitive) == 0) {
+                section.clear();
+            } else if (name.compare(u"%General", Qt::CaseInsensitive) == 0) {
+                section = name.mid(1).toString() + u'/';
+            } else {
+                section = unescapedIniKey(name) + u'/';
+            }
+            continue;
+        }
+
+        const qsizetype separator = line.indexOf(u'=');
+        if (separator <= 0) {
+            continue;
+        }
+        const QString key = section + unescapedIniKey(QStringView(line).left(separator).trimmed());
+        map.insert(key, line.mid(separator + 1).trimmed());
+    }
+    return true;
+}
+
+bool ProfileStore::write(QIODevice& device, const QSettings::SettingsMap& map)
+{
+    QHash<QString, quint32> stringIds;
+    QStringList strings;
+    auto intern = [&stringIds, &strings](const QString& text) {
+        auto it = stringIds.constFind(text);
+        if (it != stringIds.constEnd()) {
+            return it.value();
+        }
+        quint32 id = static_cast<quint32>(strings.size());
+        stringIds.insert(text, id);
+        strings.append(text);
+        return id;
+    };
+
+    std::array<QVector<QSettings::SettingsMap::const_iterator>, SectionTypeCount> sections;
+    for (auto it = map.constBegin(); it != map.constEnd(); ++it) {
+        SectionType type = sectionFor(it.value());
+        sections[type].append(it);
+        intern(it.key());
+        if (type == StringSection) {
+            intern(it.value().toString());
+        } else if (type == StringListSection) {
+            for (const QString& item : it.value().toStringList()) {
+                intern(item);
+            }
+        }
+    }
+
+    quint16 sectionCount = 0;
+    for (const auto& entries : sections) {
+        if (!entries.isEmpty()) {
+            ++sectionCount;
+        }
+    }
+
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << PROFILE_MAGIC << PROFILE_FORMAT_VERSION << sectionCount << quint32(strings.size());
+
+    for (const QString& text : strings) {
+        QByteArray utf8 = text.toUtf8();
+        out << quint32(utf8.size());
+        out.writeRawData(utf8.constData(), utf8.size());
+    }
+
+    for (int type = 0; type < SectionTypeCount; ++type) {
+        const auto& entries = sections[type];
+        if (entries.isEmpty()) {
+            continue;
+        }
+
+        out << quint8(type) << quint32(entries.size());
+        for (const auto& entry : entries) {
+            const QVariant& value = entry.value();
+            out << stringIds.value(entry.key());
+            switch (type) {
+            case BoolSection:
+                out << quint8(value.toBool() ? 1 : 0);
+                break;
+            case IntSection:
+                out << qint64(value.toLongLong());
+                break;
+            case StringSection:
+                out << stringIds.value(value.toString());
+                break;
+            case StringListSection: {
+                const QStringList items = value.toStringList();
+                out << quint32(items.size());
+                for (const QString& item : items) {
+                    out << stringIds.value(item);
+                }
+                break;
+            }
+            case PointSection: {
+                QPoint point = value.toPoint();
+                out << qint32(point.x()) << qint32(point.y());
+                break;
+            }
+            case RectSection: {
+                QRect rect = value.toRect();
+                out << qint32(rect.x()) << qint32(rect.y()) << qint32(rect.width()) << qint32(rect.height());
+                break;
+            }
+            case ColorSection:
+                out << quint32(value.value<QColor>().rgba());
+                break;
+            default:
+                out << value;
+                break;
+            }
+        }
+    }
+
+    if (out.status() != QDataStream::Ok) {
+        return false;
+    }
+    return device.write(payload) == payload.size();
+}
+
+bool ProfileStore::read(QIODevice& device, QSettings::SettingsMap& map)
+{
+    const QByteArray data = device.readAll();
+    if (data.isEmpty()) {
+        return true;
+    }
+
+    QDataStream in(data);
+    in.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    quint16 sectionCount = 0;
+    quint32 stringCount = 0;
+    in >> magic >> version >> sectionCount >> stringCount;
+
+    if (magic != PROFILE_MAGIC || version > PROFILE_FORMAT_VERSION) {
+        qCWarning(lcLog) << "ProfileStore: Unrecognised profile header, version" << version;
+        return false;
+    }
+
+    // Every string costs at least its length prefix, anything larger is corrupt
+    if (stringCount > quint32(data.size() / sizeof(quint32))) {
+        qCWarning(lcLog) << "ProfileStore: Corrupt string table";
+        return false;
+    }
+
+    QVector<QString> strings;
+    strings.reserve(stringCount);
+    for (quint32 i = 0; i < stringCount; ++i) {
+        quint32 length = 0;
+        in >> length;
+        qint64 offset = in.device()->pos();
+        if (in.status() != QDataStream::Ok || length > quint64(data.size() - offset)) {
+            qCWarning(lcLog) << "ProfileStore: Corrupt string table";
+            return false;
+        }
+        strings.append(QString::fromUtf8(data.constData() + offset, length));
+        in.skipRawData(length);
+    }
+
+    bool valid = true;
+    auto stringAt = [&strings, &valid](quint32 id) {
+        if (id >= quint32(strings.size())) {
+            valid = false;
+            return QString();
+        }
+        return strings[id];
+    };
+
+    for (quint16 section = 0; section < sectionCount && valid; ++section) {
+        quint8 type = 0;
+        quint32 count = 0;
+        in >> type >> count;
+
+        for (quint32 i = 0; i < count && valid && in.status() == QDataStream::Ok; ++i) {
+            quint32 keyId = 0;
+            in >> keyId;
+            QString key = stringAt(keyId);
+            QVariant value;
+
+            switch (type) {
+            case BoolSection: {
+                quint8 flag = 0;
+                in >> flag;
+                value = flag != 0;
+                break;
+            }
+            case IntSection: {
+                qint64 number = 0;
+                in >> number;
+                if (number >= std::numeric_limits<int>::min() && number <= std::numeric_limits<int>::max()) {
+                    value = int(number);
+                } else {
+                    value = qlonglong(number);
+                }
+                break;
+            }
+            case StringSection: {
+                quint32 id = 0;
+                in >> id;
+                value = stringAt(id);
+                break;
+            }
+            case StringListSection: {
+                quint32 itemCount = 0;
+                in >> itemCount;
+                QStringList items;
+                for (quint32 j = 0; j < itemCount && valid && in.status() == QDataStream::Ok; ++j) {
+                    quint32 id = 0;
+                    in >> id;
+                    items.append(stringAt(id));
+                }
+                value = items;
+                break;
+            }
+            case PointSection: {
+                qint32 x = 0;
+                qint32 y = 0;
+                in >> x >> y;
+                value = QPoint(x, y);
+                break;
+            }
+            case RectSection: {
+                qint32 x = 0;
+                qint32 y = 0;
+                qint32 width = 0;
+                qint32 height = 0;
+                in >> x >> y >> width >> height;
+                value = QRect(x, y, width, height);
+                break;
+            }
+            case ColorSection: {
+                quint32 rgba = 0;
+                in >> rgba;
+                value = QColor::fromRgba(rgba);
+                break;
+            }
+            case VariantSection:
+                in >> value;
+                break;
+            default:
+                valid = false;
+                break;
+            }
+
+            map.insert(key, value);
+        }
+    }
+
+    if (!valid || in.status() != QDataStream::Ok) {
+        qCWarning(lcLog) << "ProfileStore: Corrupt profile section";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,167 @@
+#include "profilewatcher.h"
+#include "profilestore.h"
+#include "logging.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QElapsedTimer>
+#include <QVariant>
+
+ProfileReloadWorker::ProfileReloadWorker(QObject *parent)
+    : QObject(parent)
+{
+}
+
+QSettings::SettingsMap ProfileReloadWorker::readContents(const QString& filePath)
+{
+    // A QSettings here would share the app's store for this path and flush
+    // its pending writes from this thread, ahead of the syncer's debounce
+    QSettings::SettingsMap contents;
+    if (!ProfileStore::readEntries(filePath, contents)) {
+        qCWarning(lcLog) << "ProfileWatcher: Failed to read" << filePath;
+    }
+    return contents;
+}
+
+void ProfileReloadWorker::track(const QStringList& filePaths)
+{
+    for (const QString& filePath : filePaths) {
+        m_lastContents.insert(filePath, readContents(filePath));
+    }
+}
+
+void ProfileReloadWorker::reload(const QString& filePath)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QSettings::SettingsMap before = m_lastContents.take(filePath);
+    QSettings::SettingsMap after = readContents(filePath);
+
+    QStringList changedKeys;
+    for (auto it = after.constBegin(); it != after.constEnd(); ++it) {
+        auto previous = before.find(it.key());
+        if (previous == before.end()) {
+            changedKeys.append(it.key());
+            continue;
+        }
+        if (previous.value() != it.value()) {
+            changedKeys.append(it.key());
+        }
+        before.erase(previous);
+    }
+    // Whatever is left of the old contents was removed from the file
+    changedKeys.append(before.keys());
+
+    m_lastContents.insert(filePath, after);
+    emit reloaded(filePath, changedKeys, timer.elapsed());
+}
+
+void ProfileReloadWorker::forget(const QString& filePath)
+{
+    m_lastContents.remove(filePath);
+}
+
+ProfileWatcher::ProfileWatcher(const QString& profilesDirectory, QObject *parent)
+    : QObject(parent)
+    , m_profilesDirectory(profilesDirectory)
+    , m_fileWatcher(new QFileSystemWatcher(this))
+    , m_debounceTimer(new QTimer(this))
+    , m_workerThread(new QThread(this))
+    , m_worker(new ProfileReloadWorker())
+{
+    m_debounceTimer->setSingleShot(true);
+    m_debounceTimer->setInterval(RELOAD_DEBOUNCE_MS);
+    connect(m_debounceTimer, &QTimer::timeout, this, &ProfileWatcher::scanProfiles);
+
+    connect(m_fileWatcher, &QFileSystemWatcher::fileChanged, this, &ProfileWatcher::onPathChanged);
+    connect(m_fileWatcher, &QFileSystemWatcher::directoryChanged, this, &ProfileWatcher::onPathChanged);
+
+    m_worker->moveToThread(m_workerThread);
+    connect(m_worker, &ProfileReloadWorker::reloaded, this, &ProfileWatcher::profileChanged);
+    m_workerThread->start(QThread::LowPriority);
+
+    m_fileStamps = currentStamps();
+    m_fileWatcher->addPath(m_profilesDirectory);
+    if (!m_fileStamps.isEmpty()) {
+        m_fileWatcher->addPaths(m_fileStamps.keys());
+        QMetaObject::invokeMethod(m_worker, "track", Qt::QueuedConnection, Q_ARG(QStringList, m_fileStamps.keys()));
+    }
+}
+
+ProfileWatcher::~ProfileWatcher()
+{
+    m_workerThread->quit();
+    if (!m_workerThread->wait(3000)) {
+        qCWarning(lcLog) << "ProfileWatcher: Worker thread did not stop in time, terminating";
+        m_workerThread->terminate();
+        m_workerThread->wait();
+    }
+
+    // Manual deletion required - worker has no parent (moved to separate thread)
+    delete m_worker;
+    m_worker = nullptr;
+}
+
+void ProfileWatcher::noteOwnWrite(const QString& filePath, const QDateTime& modified, qint64 size)
+{
+    m_ownWrites.insert(filePath, FileStamp{ modified, size });
+}
+
+void ProfileWatcher::onPathChanged(const QString& path)
+{
+    Q_UNUSED(path);
+    m_debounceTimer->start();
+}
+
+QHash<QString, ProfileWatcher::FileStamp> ProfileWatcher::currentStamps() const
+{
+    QHash<QString, FileStamp> stamps;
+    QDir profilesDir(m_profilesDirectory);
+    QStringList filters;
+    filters << QString("*.%1").arg(ProfileStore::INI_EXTENSION) << QString("*.%1").arg(ProfileStore::BINARY_EXTENSION);
+
+    const QFileInfoList fileList = profilesDir.entryInfoList(filters, QDir::Files);
+    for (const QFileInfo& fileInfo : fileList) {
+        stamps.insert(fileInfo.filePath(), FileStamp{ fileInfo.lastModified(), fileInfo.size() });
+    }
+    return stamps;
+}
+
+void ProfileWatcher::scanProfiles()
+{
+    QHash<QString, FileStamp> stamps = currentStamps();
+
+    for (auto it = stamps.constBegin(); it != stamps.constEnd(); ++it) {
+        auto previous = m_fileStamps.constFind(it.key());
+        bool changed = previous == m_fileStamps.constEnd() ||
+                       previous->modified != it->modified ||
+                       previous->size != it->size;
+        if (!changed) {
+            continue;
+        }
+
+        // Files replaced by an atomic save drop out of the watch list
+        if (!m_fileWatcher->files().contains(it.key())) {
+            m_fileWatcher->addPath(it.key());
+        }
+
+        // Our own save only needs the worker's baseline moved forward
+        auto ownWrite = m_ownWrites.constFind(it.key());
+        if (ownWrite != m_ownWrites.constEnd() && ownWrite->modified == it->modified && ownWrite->size == it->size) {
+            m_ownWrites.erase(ownWrite);
+            QMetaObject::invokeMethod(m_worker, "track", Qt::QueuedConnection, Q_ARG(QStringList, QStringList{ it.key() }));
+            continue;
+        }
+        QMetaObject::invokeMethod(m_worker, "reload", Qt::QueuedConnection, Q_ARG(QString, it.key()));
+    }
+
+    for (auto it = m_fileStamps.constBegin(); it != m_fileStamps.constEnd(); ++it) {
+        if (!stamps.contains(it.key())) {
+            QMetaObject::invokeMethod(m_worker, "forget", Qt::QueuedConnection, Q_ARG(QString, it.key()));
+            m_ownWrites.remove(it.key());
+            emit profileRemoved(it.key());
+        }
+    }
+
+    m_fileStamps = stamps;
+}
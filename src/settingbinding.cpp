@@ -1276,7 +1276,7 @@ void CharacterColorTableBinding::saveToConfig()
         }
     }
     
-    config.save();
+    config.scheduleSave();
 }
 
 void CharacterColorTableBinding::reset()
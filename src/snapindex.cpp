@@ -0,0 +1,78 @@
+#include "snapindex.h"
+#include <algorithm>
+#include <cstdlib>
+
+void SnapIndex::build(const QVector<QRect>& others, const QVector<QRect>& screens, const QSize& size, int distance)
+{
+    clear();
+    m_size = size;
+    m_distance = distance;
+
+    const int width = size.width();
+    const int height = size.height();
+    m_xEdges.reserve(screens.size() * 2 + others.size() * 4);
+    m_yEdges.reserve(screens.size() * 2 + others.size() * 4);
+
+    for (const QRect& screen : screens) {
+        m_xEdges.append({ screen.left(), screen.top(), screen.bottom(), Rule::Overlap });
+        m_xEdges.append({ screen.right() - width + 1, screen.top(), screen.bottom(), Rule::Overlap });
+        m_yEdges.append({ screen.top(), screen.left(), screen.right(), Rule::Overlap });
+        m_yEdges.append({ screen.bottom() - height + 1, screen.left(), screen.right(), Rule::Overlap });
+    }
+
+    for (const QRect& other : others) {
+        // Side by side, touching edges
+        m_xEdges.append({ other.right() + 1, other.top() - distance, other.bottom() + distance, Rule::Overlap });
+        m_xEdges.append({ other.left() - width, other.top() - distance, other.bottom() + distance, Rule::Overlap });
+        m_yEdges.append({ other.bottom() + 1, other.left() - distance, other.right() + distance, Rule::Overlap });
+        m_yEdges.append({ other.top() - height, other.left() - distance, other.right() + distance, Rule::Overlap });
+
+        // Stacked, aligned edges
+        m_xEdges.append({ other.left(), other.top(), other.bottom(), Rule::Adjacent });
+        m_xEdges.append({ other.right() - width + 1, other.top(), other.bottom(), Rule::Adjacent });
+        m_yEdges.append({ other.top(), other.left(), other.right(), Rule::Adjacent });
+        m_yEdges.append({ other.bottom() - height + 1, other.left(), other.right(), Rule::Adjacent });
+    }
+
+    auto byTarget = [](const Edge& a, const Edge& b) { return a.target < b.target; };
+    std::sort(m_xEdges.begin(), m_xEdges.end(), byTarget);
+    std::sort(m_yEdges.begin(), m_yEdges.end(), byTarget);
+}
+
+void SnapIndex::clear()
+{
+    m_xEdges.clear();
+    m_yEdges.clear();
+}
+
+QPoint SnapIndex::snap(const QPoint& pos) const
+{
+    return QPoint(nearest(m_xEdges, pos.x(), pos.y(), m_size.height()),
+                  nearest(m_yEdges, pos.y(), pos.x(), m_size.width()));
+}
+
+int SnapIndex::nearest(const QVector<Edge>& edges, int position, int crossStart, int crossLength) const
+{
+    const int crossEnd = crossStart + crossLength - 1;
+    auto it = std::lower_bound(edges.cbegin(), edges.cend(), position - m_distance, [](const Edge& edge, int value) {
+        return edge.target < value;
+    });
+
+    int best = position;
+    int bestDistance = m_distance + 1;
+    for (; it != edges.cend() && it->target <= position + m_distance; ++it) {
+        bool applies = it->rule == Rule::Overlap
+            ? crossStart <= it->high && crossEnd >= it->low
+            : std::abs(crossStart - (it->high + 1)) <= m_distance || std::abs(crossEnd + 1 - it->low) <= m_distance;
+        if (!applies) {
+            continue;
+        }
+
+        int distance = std::abs(it->target - position);
+        if (distance < bestDistance) {
+            bestDistance = distance;
+            best = it->target;
+        }
+    }
+    return best;
+}
@@ -0,0 +1,214 @@
+#include "starmap.h"
+#include <QCoreApplication>
+#include <QFile>
+#include <QTextStream>
+#include <QElapsedTimer>
+#include <QMutexLocker>
+#include <QDebug>
+#include <algorithm>
+
+StarMap& StarMap::instance()
+{
+    static StarMap instance;
+    return instance;
+}
+
+StarMap::StarMap()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QString localPath = QCoreApplication::applicationDirPath() + "/" + FILE_NAME;
+    if (!loadFromFile(RESOURCE_PATH) && !loadFromFile(localPath)) {
+        qDebug() << "StarMap: No star map data found, jump distances disabled";
+        return;
+    }
+
+    qDebug() << "StarMap: Loaded" << m_names.size() << "systems and" << m_neighbors.size() / 2
+             << "gates in" << timer.elapsed() << "ms";
+}
+
+// File format, one record per line, tab separated:
+//   S <systemId> <name>
+//   G <fromSystemId> <toSystemId>
+// Gates only need to be listed once, the graph is treated as undirected.
+bool StarMap::loadFromFile(const QString& filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return false;
+    }
+
+    QHash<qint64, int> idToIndex;
+    QStringList names;
+    QVector<QPair<qint64, qint64>> rawGates;
+
+    QTextStream in(&file);
+    while (!in.atEnd()) {
+        QString line = in.readLine();
+        if (line.isEmpty() || line.startsWith('#')) {
+            continue;
+        }
+
+        QStringList parts = line.split('\t');
+        if (parts.size() != 3) {
+            continue;
+        }
+
+        if (parts[0] == "S") {
+            qint64 id = parts[1].toLongLong();
+            if (!idToIndex.contains(id)) {
+                idToIndex.insert(id, names.size());
+                names.append(parts[2].trimmed());
+            }
+        } else if (parts[0] == "G") {
+            rawGates.append(qMakePair(parts[1].toLongLong(), parts[2].toLongLong()));
+        }
+    }
+
+    if (names.isEmpty()) {
+        qWarning() << "StarMap: No systems in" << filePath;
+        return false;
+    }
+
+    const int systemCount = names.size();
+    QVector<QVector<int>> adjacency(systemCount);
+    for (const auto& gate : rawGates) {
+        int from = idToIndex.value(gate.first, -1);
+        int to = idToIndex.value(gate.second, -1);
+        if (from < 0 || to < 0 || from == to) {
+            continue;
+        }
+        adjacency[from].append(to);
+        adjacency[to].append(from);
+    }
+
+    m_rowOffsets.clear();
+    m_neighbors.clear();
+    m_rowOffsets.reserve(systemCount + 1);
+    m_rowOffsets.append(0);
+    for (QVector<int>& row : adjacency) {
+        std::sort(row.begin(), row.end());
+        row.erase(std::unique(row.begin(), row.end()), row.end());
+        m_neighbors.append(row);
+        m_rowOffsets.append(m_neighbors.size());
+    }
+
+    m_names = names;
+    m_nameToIndex.clear();
+    m_nameToIndex.reserve(systemCount);
+    for (int i = 0; i < systemCount; ++i) {
+        m_nameToIndex.insert(m_names[i].toLower(), i);
+    }
+
+    return true;
+}
+
+int StarMap::systemIndex(const QString& systemName) const
+{
+    if (systemName.isEmpty()) {
+        return -1;
+    }
+    return m_nameToIndex.value(systemName.toLower(), -1);
+}
+
+QString StarMap::systemName(int index) const
+{
+    if (index < 0 || index >= m_names.size()) {
+        return QString();
+    }
+    return m_names[index];
+}
+
+QVector<quint16> StarMap::distanceRow(int originIndex) const
+{
+    QMutexLocker locker(&m_cacheMutex);
+
+    auto cached = m_distanceCache.constFind(originIndex);
+    if (cached != m_distanceCache.constEnd()) {
+        m_cacheOrder.removeOne(originIndex);
+        m_cacheOrder.append(originIndex);
+        return cached.value();
+    }
+
+    const int systemCount = m_names.size();
+    QVector<quint16> distances(systemCount, NO_ROUTE);
+    QVector<int> queue;
+    queue.reserve(systemCount);
+
+    distances[originIndex] = 0;
+    queue.append(originIndex);
+    for (int head = 0; head < queue.size(); ++head) {
+        int current = queue[head];
+        quint16 next = distances[current] + 1;
+        for (int i = m_rowOffsets[current]; i < m_rowOffsets[current + 1]; ++i) {
+            int neighbor = m_neighbors[i];
+            if (distances[neighbor] == NO_ROUTE) {
+                distances[neighbor] = next;
+                queue.append(neighbor);
+            }
+        }
+    }
+
+    if (m_cacheOrder.size() >= MAX_CACHED_ORIGINS) {
+        m_distanceCache.remove(m_cacheOrder.takeFirst());
+    }
+    m_distanceCache.insert(originIndex, distances);
+    m_cacheOrder.append(originIndex);
+
+    return distances;
+}
+
+int StarMap::jumpDistance(int fromIndex, int toIndex) const
+{
+    if (fromIndex < 0 || toIndex < 0 || fromIndex >= m_names.size() || toIndex >= m_names.size()) {
+        return UNREACHABLE;
+    }
+    if (fromIndex == toIndex) {
+        return 0;
+    }
+
+    quint16 distance = distanceRow(fromIndex)[toIndex];
+    return distance == NO_ROUTE ? UNREACHABLE : distance;
+}
+
+int StarMap::jumpDistance(const QString& fromSystem, const QString& toSystem) const
+{
+    return jumpDistance(systemIndex(fromSystem), systemIndex(toSystem));
+}
+
+QVector<int> StarMap::distancesFrom(int originIndex, const QVector<int>& targetIndices) const
+{
+    QVector<int> result(targetIndices.size(), UNREACHABLE);
+    if (originIndex < 0 || originIndex >= m_names.size()) {
+        return result;
+    }
+
+    QVector<quint16> row = distanceRow(originIndex);
+    for (int i = 0; i < targetIndices.size(); ++i) {
+        int target = targetIndices[i];
+        if (target >= 0 && target < row.size() && row[target] != NO_ROUTE) {
+            result[i] = row[target];
+        }
+    }
+    return result;
+}
+
+QHash<QString, int> StarMap::distancesFrom(const QString& originSystem, const QHash<QString, QString>& systemsByCharacter) const
+{
+    QHash<QString, int> result;
+    int origin = systemIndex(originSystem);
+    if (origin < 0) {
+        return result;
+    }
+
+    QVector<quint16> row = distanceRow(origin);
+    result.reserve(systemsByCharacter.size());
+    for (auto it = systemsByCharacter.constBegin(); it != systemsByCharacter.constEnd(); ++it) {
+        int target = systemIndex(it.value());
+        if (target >= 0 && row[target] != NO_ROUTE) {
+            result.insert(it.key(), row[target]);
+        }
+    }
+    return result;
+}
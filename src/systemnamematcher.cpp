@@ -0,0 +1,169 @@
+#include "systemnamematcher.h"
+#include <QQueue>
+#include <algorithm>
+#include <map>
+
+void SystemNameMatcher::build(const QStringList& names)
+{
+    m_nodes.clear();
+    m_edgeLabels.clear();
+    m_edgeTargets.clear();
+    m_patternLengths.clear();
+
+    std::vector<std::map<char16_t, int>> children(1);
+    QVector<int> outputs(1, -1);
+
+    m_patternLengths.reserve(names.size());
+    for (int i = 0; i < names.size(); ++i) {
+        QString name = names[i].toLower();
+        m_patternLengths.append(name.size());
+        if (name.isEmpty()) {
+            continue;
+        }
+
+        int node = 0;
+        for (QChar c : name) {
+            auto it = children[node].find(c.unicode());
+            if (it == children[node].end()) {
+                int next = static_cast<int>(children.size());
+                children[node].emplace(c.unicode(), next);
+                children.emplace_back();
+                outputs.append(-1);
+                node = next;
+            } else {
+                node = it->second;
+            }
+        }
+        if (outputs[node] < 0) {
+            outputs[node] = i;
+        }
+    }
+
+    const int nodeCount = static_cast<int>(children.size());
+    m_nodes.resize(nodeCount);
+
+    int edgeCount = 0;
+    for (int i = 0; i < nodeCount; ++i) {
+        m_nodes[i].output = outputs[i];
+        m_nodes[i].edgeBegin = edgeCount;
+        edgeCount += static_cast<int>(children[i].size());
+        m_nodes[i].edgeEnd = edgeCount;
+    }
+
+    // std::map keeps the labels sorted, so child() can binary search each range
+    m_edgeLabels.reserve(edgeCount);
+    m_edgeTargets.reserve(edgeCount);
+    for (int i = 0; i < nodeCount; ++i) {
+        for (const auto& edge : children[i]) {
+            m_edgeLabels.append(edge.first);
+            m_edgeTargets.append(edge.second);
+        }
+    }
+
+    QQueue<int> queue;
+    for (const auto& edge : children[0]) {
+        m_nodes[edge.second].fail = 0;
+        queue.enqueue(edge.second);
+    }
+
+    while (!queue.isEmpty()) {
+        int node = queue.dequeue();
+        for (const auto& edge : children[node]) {
+            int target = edge.second;
+            int fail = m_nodes[node].fail;
+            while (fail != 0 && child(fail, edge.first) < 0) {
+                fail = m_nodes[fail].fail;
+            }
+            int candidate = child(fail, edge.first);
+            m_nodes[target].fail = (candidate >= 0 && candidate != target) ? candidate : 0;
+
+            const Node& failNode = m_nodes[m_nodes[target].fail];
+            m_nodes[target].outputLink = failNode.output >= 0 ? m_nodes[target].fail : failNode.outputLink;
+            queue.enqueue(target);
+        }
+    }
+}
+
+int SystemNameMatcher::child(int node, char16_t c) const
+{
+    auto begin = m_edgeLabels.constBegin() + m_nodes[node].edgeBegin;
+    auto end = m_edgeLabels.constBegin() + m_nodes[node].edgeEnd;
+    auto it = std::lower_bound(begin, end, c);
+    if (it == end || *it != c) {
+        return -1;
+    }
+    return m_edgeTargets[static_cast<int>(it - m_edgeLabels.constBegin())];
+}
+
+int SystemNameMatcher::step(int state, char16_t c) const
+{
+    while (true) {
+        int next = child(state, c);
+        if (next >= 0) {
+            return next;
+        }
+        if (state == 0) {
+            return 0;
+        }
+        state = m_nodes[state].fail;
+    }
+}
+
+bool SystemNameMatcher::isNameChar(QChar c)
+{
+    return c.isLetterOrNumber() || c == '-';
+}
+
+QVector<int> SystemNameMatcher::findAll(const QString& text) const
+{
+    struct Match {
+        int start;
+        int end;
+        int pattern;
+    };
+
+    QVector<int> result;
+    if (m_nodes.isEmpty() || text.isEmpty()) {
+        return result;
+    }
+
+    const QString lowered = text.toLower();
+    const int length = lowered.size();
+
+    QVector<Match> matches;
+    int state = 0;
+    for (int i = 0; i < length; ++i) {
+        state = step(state, lowered[i].unicode());
+
+        bool endsAtBoundary = (i + 1 == length) || !isNameChar(lowered[i + 1]);
+        if (!endsAtBoundary) {
+            continue;
+        }
+
+        int node = m_nodes[state].output >= 0 ? state : m_nodes[state].outputLink;
+        while (node > 0) {
+            int pattern = m_nodes[node].output;
+            int start = i - m_patternLengths[pattern] + 1;
+            if (start == 0 || !isNameChar(lowered[start - 1])) {
+                matches.append({start, i, pattern});
+            }
+            node = m_nodes[node].outputLink;
+        }
+    }
+
+    std::sort(matches.begin(), matches.end(), [](const Match& a, const Match& b) {
+        if (a.start != b.start) {
+            return a.start < b.start;
+        }
+        return a.end > b.end;
+    });
+
+    int lastEnd = -1;
+    for (const Match& m : matches) {
+        if (m.start > lastEnd && !result.contains(m.pattern)) {
+            result.append(m.pattern);
+            lastEnd = m.end;
+        }
+    }
+    return result;
+}
@@ -1,13 +1,12 @@
 #include "thumbnailwidget.h"
+#include "logging.h"
 #include "config.h"
+#include "windowsystem.h"
 #include <QMouseEvent>
 #include <QPainter>
 #include <QDebug>
 #include <QScreen>
 #include <QApplication>
-#include <dwmapi.h>
-
-#pragma comment(lib, "dwmapi.lib")
 
 ThumbnailWidget::ThumbnailWidget(quintptr windowId, const QString& title, QWidget *parent)
     : QWidget(parent)
@@ -44,6 +43,8 @@ ThumbnailWidget::ThumbnailWidget(quintptr windowId, const QString& title, QWidge
             m_overlayWidget->setCombatEventState(false, QString());
         }
     });
+    
+    connect(&Config::instance(), &Config::settingsChanged, this, &ThumbnailWidget::onConfigChanged);
 }
 
 ThumbnailWidget::~ThumbnailWidget()
@@ -88,6 +89,18 @@ void ThumbnailWidget::setSystemName(const QString& systemName)
     }
 }
 
+void ThumbnailWidget::setJumpDistance(int jumps)
+{
+    if (m_jumpDistance == jumps) {
+        return;
+    }
+    
+    m_jumpDistance = jumps;
+    if (Config::instance().showJumpDistance()) {
+        updateOverlays();
+    }
+}
+
 void ThumbnailWidget::setCombatMessage(const QString& message, const QString& eventType)
 {
     if (m_combatMessage == message && m_combatEventType == eventType) {
@@ -112,6 +125,10 @@ void ThumbnailWidget::setCombatMessage(const QString& message, const QString& ev
 
 void ThumbnailWidget::setActive(bool active)
 {
+    if (m_isActive == active) {
+        return;
+    }
+    
     m_isActive = active;
     if (m_overlayWidget) {
         m_overlayWidget->setActiveState(active);
@@ -121,16 +138,17 @@ void ThumbnailWidget::setActive(bool active)
 void ThumbnailWidget::updateOverlays()
 {
     const Config& cfg = Config::instance();
+    const Config::Values values = cfg.values();
     m_overlays.clear();
     
-    if (cfg.showCharacterName()) {
+    if (values.get<Config::Setting::ShowCharacterName>()) {
         if (!m_characterName.isEmpty()) {
-            OverlayPosition pos = static_cast<OverlayPosition>(cfg.characterNamePosition());
-            QFont characterFont = cfg.characterNameFont();
+            OverlayPosition pos = static_cast<OverlayPosition>(values.get<Config::Setting::CharacterNamePosition>());
+            QFont characterFont = values.get<Config::Setting::CharacterNameFont>();
             characterFont.setBold(true);
             OverlayElement charElement(
                 m_characterName,
-                cfg.characterNameColor(),
+                values.get<Config::Setting::CharacterNameColor>(),
                 pos,
                 true,
                 characterFont
@@ -139,14 +157,18 @@ void ThumbnailWidget::updateOverlays()
         }
     }
     
-    if (cfg.showSystemName()) {
+    if (values.get<Config::Setting::ShowSystemName>()) {
         if (!m_systemName.isEmpty()) {
-            OverlayPosition pos = static_cast<OverlayPosition>(cfg.systemNamePosition());
-            QFont systemFont = cfg.systemNameFont();
+            OverlayPosition pos = static_cast<OverlayPosition>(values.get<Config::Setting::SystemNamePosition>());
+            QFont systemFont = values.get<Config::Setting::SystemNameFont>();
             systemFont.setBold(true);
+            QString systemText = m_systemName;
+            if (m_jumpDistance >= 0 && values.get<Config::Setting::ShowJumpDistance>()) {
+                systemText = QString("%1 (%2j)").arg(m_systemName).arg(m_jumpDistance);
+            }
             OverlayElement sysElement(
-                m_systemName,
-                cfg.systemNameColor(),
+                systemText,
+                values.get<Config::Setting::SystemNameColor>(),
                 pos,
                 true,
                 systemFont
@@ -155,18 +177,21 @@ void ThumbnailWidget::updateOverlays()
         }
     }
     
-    if (!m_combatMessage.isEmpty() && cfg.showCombatMessages()) {
-        OverlayPosition pos = static_cast<OverlayPosition>(cfg.combatMessagePosition());
+    // Intel alerts share the combat message slot but have their own toggle
+    const bool messageEnabled = m_combatEventType == Config::INTEL_EVENT_TYPE
+        ? values.get<Config::Setting::ShowIntelAlerts>()
+        : values.get<Config::Setting::ShowCombatMessages>();
+    if (!m_combatMessage.isEmpty() && messageEnabled) {
+        OverlayPosition pos = static_cast<OverlayPosition>(values.get<Config::Setting::CombatMessagePosition>());
         
         QColor messageColor = cfg.combatEventColor(m_combatEventType);
         
-        QFont combatFont = cfg.combatMessageFont();
         OverlayElement combatElement(
             m_combatMessage,
             messageColor,
             pos,
             true,
-            combatFont
+            values.get<Config::Setting::CombatMessageFont>()
         );
         m_overlays.append(combatElement);
     }
@@ -174,6 +199,38 @@ void ThumbnailWidget::updateOverlays()
     updateOverlayWidget();
 }
 
+void ThumbnailWidget::onConfigChanged(Config::ChangeGroups groups, const Config::SettingSet& changed)
+{
+    const Config& cfg = Config::instance();
+    auto settingChanged = [&changed](Config::Setting setting) {
+        return changed.test(static_cast<size_t>(setting));
+    };
+    
+    if (settingChanged(Config::Setting::ThumbnailWidth) || settingChanged(Config::Setting::ThumbnailHeight)) {
+        QSize newSize(cfg.thumbnailWidth(), cfg.thumbnailHeight());
+        if (size() != newSize) {
+            setFixedSize(newSize);
+        }
+    }
+    
+    if (settingChanged(Config::Setting::ThumbnailOpacity)) {
+        setWindowOpacity(cfg.thumbnailOpacity() / 100.0);
+    }
+    
+    if (settingChanged(Config::Setting::AlwaysOnTop)) {
+        updateWindowFlags(cfg.alwaysOnTop());
+    }
+    
+    if (settingChanged(Config::Setting::RefreshInterval)) {
+        m_updateTimer->setInterval(cfg.refreshInterval());
+    }
+    
+    // setOverlays() only dirties the overlay cache when the elements differ
+    if (groups & (Config::OverlayChanges | Config::CombatMessageChanges)) {
+        updateOverlays();
+    }
+}
+
 void ThumbnailWidget::updateOverlayWidget()
 {
     if (m_overlayWidget) {
@@ -190,148 +247,39 @@ void ThumbnailWidget::forceOverlayRender()
     }
 }
 
-QPoint ThumbnailWidget::snapPosition(const QPoint& pos, const QVector<ThumbnailWidget*>& otherThumbnails)
+void ThumbnailWidget::buildSnapIndex(bool includeThumbnails)
 {
+    m_snapIndex.clear();
+    
     const Config& cfg = Config::instance();
     if (!cfg.enableSnapping()) {
-        return pos;
-    }
-    
-    int snapDist = cfg.snapDistance();
-    QPoint snappedPos = pos;
-    
-    QScreen* screen = QApplication::screenAt(pos);
-    if (!screen) {
-        screen = QApplication::primaryScreen();
-    }
-    QRect screenGeom = screen->availableGeometry();
-    
-    int closestXDist = snapDist;
-    int closestYDist = snapDist;
-    int snappedX = pos.x();
-    int snappedY = pos.y();
-    
-    QRect thisRect(pos.x(), pos.y(), width(), height());
-    
-    int distToLeft = qAbs(pos.x() - screenGeom.left());
-    int distToRight = qAbs(pos.x() + width() - screenGeom.right());
-    
-    if (distToLeft < closestXDist) {
-        closestXDist = distToLeft;
-        snappedX = screenGeom.left();
-    }
-    if (distToRight < closestXDist) {
-        closestXDist = distToRight;
-        snappedX = screenGeom.right() - width();
-    }
-    
-    int distToTop = qAbs(pos.y() - screenGeom.top());
-    int distToBottom = qAbs(pos.y() + height() - screenGeom.bottom());
-    
-    if (distToTop < closestYDist) {
-        closestYDist = distToTop;
-        snappedY = screenGeom.top();
-    }
-    if (distToBottom < closestYDist) {
-        closestYDist = distToBottom;
-        snappedY = screenGeom.bottom() - height();
+        return;
     }
     
-    for (const ThumbnailWidget* other : otherThumbnails) {
-        if (other == this || !other->isVisible()) {
-            continue;
-        }
-        
-        QRect otherRect = other->geometry();
-        
-        QRect expandedThisRect = thisRect.adjusted(-snapDist, -snapDist, snapDist, snapDist);
-        if (!expandedThisRect.intersects(otherRect)) {
-            continue;
-        }
-        
-        bool verticalOverlap = !(thisRect.bottom() < otherRect.top() - snapDist || 
-                                 thisRect.top() > otherRect.bottom() + snapDist);
-        
-        if (verticalOverlap) {
-            int targetX = otherRect.right() + 1;
-            int distLeftToRight = qAbs(thisRect.left() - targetX);
-            if (distLeftToRight <= closestXDist) {
-                closestXDist = distLeftToRight;
-                snappedX = targetX;
-            }
-            
-            targetX = otherRect.left() - width();
-            int distRightToLeft = qAbs(thisRect.left() - targetX);
-            if (distRightToLeft <= closestXDist) {
-                closestXDist = distRightToLeft;
-                snappedX = targetX;
-            }
-        }
-        
-        bool horizontalOverlap = !(thisRect.right() < otherRect.left() - snapDist || 
-                                   thisRect.left() > otherRect.right() + snapDist);
-        
-        if (horizontalOverlap) {
-            int targetY = otherRect.bottom() + 1;
-            int distTopToBottom = qAbs(thisRect.top() - targetY);
-            if (distTopToBottom <= closestYDist) {
-                closestYDist = distTopToBottom;
-                snappedY = targetY;
-            }
-            
-            targetY = otherRect.top() - height();
-            int distBottomToTop = qAbs(thisRect.top() - targetY);
-            if (distBottomToTop <= closestYDist) {
-                closestYDist = distBottomToTop;
-                snappedY = targetY;
-            }
-        }
-        
-        QRect potentialRect(snappedX, pos.y(), width(), height());
-        bool isSideBySide = (potentialRect.right() + 1 == otherRect.left() || 
-                            potentialRect.left() == otherRect.right() + 1 ||
-                            qAbs(potentialRect.right() - (otherRect.left() - 1)) <= 1 ||
-                            qAbs(potentialRect.left() - (otherRect.right() + 1)) <= 1);
-        
-        if (isSideBySide) {
-            int distTopToTop = qAbs(thisRect.top() - otherRect.top());
-            if (distTopToTop <= closestYDist) {
-                closestYDist = distTopToTop;
-                snappedY = otherRect.top();
-            }
-            
-            int distBottomToBottom = qAbs(thisRect.bottom() - otherRect.bottom());
-            if (distBottomToBottom <= closestYDist) {
-                closestYDist = distBottomToBottom;
-                snappedY = otherRect.bottom() - height() + 1;
-            }
-        }
-        
-        potentialRect = QRect(pos.x(), snappedY, width(), height());
-        bool isStackedVertically = (potentialRect.bottom() + 1 == otherRect.top() || 
-                                   potentialRect.top() == otherRect.bottom() + 1 ||
-                                   qAbs(potentialRect.bottom() - (otherRect.top() - 1)) <= 1 ||
-                                   qAbs(potentialRect.top() - (otherRect.bottom() + 1)) <= 1);
-        
-        if (isStackedVertically) {
-            int distLeftToLeft = qAbs(thisRect.left() - otherRect.left());
-            if (distLeftToLeft <= closestXDist) {
-                closestXDist = distLeftToLeft;
-                snappedX = otherRect.left();
-            }
-            
-            int distRightToRight = qAbs(thisRect.right() - otherRect.right());
-            if (distRightToRight <= closestXDist) {
-                closestXDist = distRightToRight;
-                snappedX = otherRect.right() - width() + 1;
+    QVector<QRect> others;
+    if (includeThumbnails) {
+        others.reserve(m_otherThumbnails.size());
+        for (const ThumbnailWidget* other : m_otherThumbnails) {
+            if (other != this && other->isVisible()) {
+                others.append(other->geometry());
             }
         }
     }
     
-    snappedPos.setX(snappedX);
-    snappedPos.setY(snappedY);
+    QVector<QRect> screens;
+    for (QScreen* screen : QApplication::screens()) {
+        screens.append(screen->availableGeometry());
+    }
     
-    return snappedPos;
+    m_snapIndex.build(others, screens, size(), cfg.snapDistance());
+}
+
+QPoint ThumbnailWidget::snapPosition(const QPoint& pos) const
+{
+    if (m_snapIndex.isEmpty()) {
+        return pos;
+    }
+    return m_snapIndex.snap(pos);
 }
 
 void ThumbnailWidget::paintEvent(QPaintEvent *event)
@@ -374,6 +322,8 @@ void ThumbnailWidget::mousePressEvent(QMouseEvent *event)
             m_isDragging = true;
             m_groupDragStartPos = pos();
             setCursor(Qt::ClosedHandCursor);
+            // The rest of the group moves along, only screen edges stay put
+            buildSnapIndex(false);
             
             if (m_updateTimer->isActive()) {
                 m_updateTimer->stop();
@@ -394,6 +344,7 @@ void ThumbnailWidget::mousePressEvent(QMouseEvent *event)
         m_dragPosition = event->globalPosition().toPoint() - frameGeometry().topLeft();
         m_isDragging = true;
         setCursor(Qt::ClosedHandCursor);
+        buildSnapIndex(true);
         
         if (m_updateTimer->isActive()) {
             m_updateTimer->stop();
@@ -421,7 +372,7 @@ void ThumbnailWidget::mouseMoveEvent(QMouseEvent *event)
         if (m_isGroupDragging) {
             QPoint newPos = event->globalPosition().toPoint() - m_dragPosition;
             
-            newPos = snapPosition(newPos, m_otherThumbnails);
+            newPos = snapPosition(newPos);
             
             QPoint delta = newPos - m_groupDragStartPos;
             
@@ -441,6 +392,7 @@ void ThumbnailWidget::mouseMoveEvent(QMouseEvent *event)
         if (!m_isDragging && (qAbs(delta.x()) > 5 || qAbs(delta.y()) > 5)) {
             m_isDragging = true;
             setCursor(Qt::ClosedHandCursor);
+            buildSnapIndex(true);
             
             if (m_updateTimer->isActive()) {
                 m_updateTimer->stop();
@@ -453,7 +405,7 @@ void ThumbnailWidget::mouseMoveEvent(QMouseEvent *event)
         
         if (m_isDragging) {
             QPoint newPos = event->globalPosition().toPoint() - m_dragPosition;
-            newPos = snapPosition(newPos, m_otherThumbnails);
+            newPos = snapPosition(newPos);
             
             if (newPos != pos()) {
                 move(newPos);
@@ -467,7 +419,7 @@ void ThumbnailWidget::mouseMoveEvent(QMouseEvent *event)
         }
     } else if (event->buttons() & Qt::RightButton && m_isDragging) {
         QPoint newPos = event->globalPosition().toPoint() - m_dragPosition;
-        newPos = snapPosition(newPos, m_otherThumbnails);
+        newPos = snapPosition(newPos);
         
         if (newPos != pos()) {
             move(newPos);
@@ -571,25 +523,20 @@ void ThumbnailWidget::setupDwmThumbnail()
         return;
     }
     
-    HWND sourceWindow = reinterpret_cast<HWND>(m_windowId);
-    HWND destWindow = reinterpret_cast<HWND>(winId());
-    
-    BOOL enabled = TRUE;
-    DwmEnableBlurBehindWindow(destWindow, nullptr);
+    WindowId sourceWindow = m_windowId;
+    WindowId destWindow = WindowId(winId());
     
-    HRESULT hr = DwmRegisterThumbnail(destWindow, sourceWindow, &m_dwmThumbnail);
-    if (SUCCEEDED(hr)) {
+    m_dwmThumbnail = WindowSystem::instance().registerThumbnail(destWindow, sourceWindow);
+    if (m_dwmThumbnail) {
         updateDwmThumbnail();
-    } else {
-        qDebug() << "Failed to register DWM thumbnail:" << hr;
     }
 }
 
 void ThumbnailWidget::cleanupDwmThumbnail()
 {
     if (m_dwmThumbnail) {
-        DwmUnregisterThumbnail(m_dwmThumbnail);
-        m_dwmThumbnail = nullptr;
+        WindowSystem::instance().unregisterThumbnail(m_dwmThumbnail);
+        m_dwmThumbnail = 0;
     }
 }
 
@@ -599,38 +546,13 @@ void ThumbnailWidget::updateDwmThumbnail()
         return;
     }
     
-    
-    HWND sourceWindow = reinterpret_cast<HWND>(m_windowId);
-    RECT sourceRect;
-    if (!GetClientRect(sourceWindow, &sourceRect)) {
-        return;
-    }
-    
-    int sourceWidth = sourceRect.right - sourceRect.left;
-    int sourceHeight = sourceRect.bottom - sourceRect.top;
-    
-    if (sourceWidth <= 0 || sourceHeight <= 0) {
+    WindowSystem& windowSystem = WindowSystem::instance();
+    QSize sourceSize = windowSystem.clientSize(m_windowId);
+    if (sourceSize.width() <= 0 || sourceSize.height() <= 0) {
         return;
     }
     
-    DWM_THUMBNAIL_PROPERTIES props = {};
-    props.dwFlags = DWM_TNP_RECTSOURCE | DWM_TNP_RECTDESTINATION | DWM_TNP_VISIBLE | DWM_TNP_OPACITY | DWM_TNP_SOURCECLIENTAREAONLY;
-    props.fVisible = TRUE;
-    props.opacity = 255; 
-    props.fSourceClientAreaOnly = TRUE;
-    
-    props.rcSource.left = 0;
-    props.rcSource.top = 0;
-    props.rcSource.right = sourceWidth;
-    props.rcSource.bottom = sourceHeight;
-    
-    props.rcDestination.left = 0;
-    props.rcDestination.top = 0;
-    props.rcDestination.right = width();
-    props.rcDestination.bottom = height();
-    
-    DwmUpdateThumbnailProperties(m_dwmThumbnail, &props);
-    
+    windowSystem.updateThumbnail(m_dwmThumbnail, QRect(QPoint(0, 0), sourceSize), rect());
 }
 
 void ThumbnailWidget::resizeEvent(QResizeEvent *event)
@@ -643,6 +565,14 @@ void ThumbnailWidget::resizeEvent(QResizeEvent *event)
     updateDwmThumbnail();
 }
 
+WindowId ThumbnailWidget::overlayWindow() const
+{
+    if (!m_overlayWidget || !m_overlayWidget->isVisible()) {
+        return 0;
+    }
+    return WindowId(m_overlayWidget->winId());
+}
+
 void ThumbnailWidget::moveEvent(QMoveEvent *event)
 {
     QWidget::moveEvent(event);
@@ -690,6 +620,8 @@ OverlayWidget::OverlayWidget(QWidget *parent)
         }
         update();  
     });
+    
+    connect(&Config::instance(), &Config::settingsChanged, this, &OverlayWidget::onConfigChanged);
 }
 
 void OverlayWidget::setOverlays(const QVector<OverlayElement>& overlays)
@@ -710,7 +642,7 @@ void OverlayWidget::setOverlays(const QVector<OverlayElement>& overlays)
 
     m_overlays = overlays;
     m_overlayDirty = true;  
-    qDebug() << "OverlayWidget::setOverlays - overlays changed, marking dirty (count=" << m_overlays.size() << ")";
+    qCDebug(lcOverlay) << "OverlayWidget::setOverlays - overlays changed, marking dirty (count=" << m_overlays.size() << ")";
     update();
 }
 
@@ -768,6 +700,19 @@ void OverlayWidget::updateWindowFlags(bool alwaysOnTop)
     }
 }
 
+void OverlayWidget::onConfigChanged(Config::ChangeGroups groups, const Config::SettingSet& changed)
+{
+    // Text elements arrive through setOverlays(), only the cached background
+    // and the live-painted borders depend on settings directly
+    if (changed.test(static_cast<size_t>(Config::Setting::ShowOverlayBackground)) ||
+        changed.test(static_cast<size_t>(Config::Setting::OverlayBackgroundColor)) ||
+        changed.test(static_cast<size_t>(Config::Setting::OverlayBackgroundOpacity))) {
+        invalidateCache();
+    } else if (groups & Config::BorderChanges) {
+        update();
+    }
+}
+
 void OverlayWidget::invalidateCache()
 {
     m_overlayDirty = true;
@@ -783,9 +728,11 @@ void OverlayWidget::paintEvent(QPaintEvent *event)
     
     drawOverlays(painter);
     
+    // Pinned once so the reads below are plain references into one snapshot
     const Config& cfg = Config::instance();
+    const Config::Values values = cfg.values();
     
-    bool highlightEnabled = cfg.highlightActiveWindow();
+    bool highlightEnabled = values.get<Config::Setting::HighlightActive>();
     bool configDialogOpen = cfg.isConfigDialogOpen();
     bool shouldDrawActiveBorder = highlightEnabled && (m_isActive || configDialogOpen);
     
@@ -794,7 +741,7 @@ void OverlayWidget::paintEvent(QPaintEvent *event)
     
     if (shouldDrawCombatBorder) {
         QColor borderColor = cfg.combatEventColor(m_combatEventType);
-        int borderWidth = cfg.highlightBorderWidth();
+        int borderWidth = values.get<Config::Setting::HighlightBorderWidth>();
         
         QPen pen(borderColor, borderWidth);
         pen.setStyle(Qt::DashLine);
@@ -810,10 +757,10 @@ void OverlayWidget::paintEvent(QPaintEvent *event)
     } else if (shouldDrawActiveBorder) {
         QColor borderColor = cfg.getCharacterBorderColor(m_characterName);
         if (!borderColor.isValid()) {
-            borderColor = cfg.highlightColor();
+            borderColor = values.get<Config::Setting::HighlightColor>();
         }
         
-        int borderWidth = cfg.highlightBorderWidth();
+        int borderWidth = values.get<Config::Setting::HighlightBorderWidth>();
         QPen pen(borderColor, borderWidth);
         pen.setJoinStyle(Qt::MiterJoin);  
         painter.setPen(pen);
@@ -836,8 +783,8 @@ void OverlayWidget::renderOverlaysToCache()
     
     int positionOffsets[6] = {0};  
     
-    const Config& cfg = Config::instance();
-    const bool showBg = cfg.showOverlayBackground();
+    const Config::Values values = Config::instance().values();
+    const bool showBg = values.get<Config::Setting::ShowOverlayBackground>();
     
     for (auto& overlay : m_overlays) {
         if (!overlay.enabled) continue;
@@ -879,8 +826,8 @@ void OverlayWidget::renderOverlaysToCache()
         positionOffsets[posIdx] = offset + metrics.height() + (showBg ? 6 : 2);
         
         if (showBg) {
-            QColor bgColor = cfg.overlayBackgroundColor();
-            bgColor.setAlpha(cfg.overlayBackgroundOpacity() * 255 / 100);  
+            QColor bgColor = values.get<Config::Setting::OverlayBackgroundColor>();
+            bgColor.setAlpha(values.get<Config::Setting::OverlayBackgroundOpacity>() * 255 / 100);  
             cachePainter.fillRect(textRect.adjusted(-3, -2, 3, 2), bgColor);
         }
         
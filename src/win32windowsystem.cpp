@@ -0,0 +1,411 @@
+#include "win32windowsystem.h"
+#include "logging.h"
+#include <QCoreApplication>
+#include <QWinEventNotifier>
+#include <dwmapi.h>
+#include <psapi.h>
+
+Win32WindowSystem* Win32WindowSystem::s_hookOwner = nullptr;
+
+Win32WindowSystem::Win32WindowSystem(QObject *parent)
+    : WindowSystem(parent)
+{
+}
+
+Win32WindowSystem::~Win32WindowSystem()
+{
+    removeHooks();
+
+    if (m_hotkeyFilterInstalled && QCoreApplication::instance()) {
+        QCoreApplication::instance()->removeNativeEventFilter(this);
+    }
+
+    for (auto it = m_exitNotifiers.begin(); it != m_exitNotifiers.end(); ++it) {
+        HANDLE hProcess = it.value()->handle();
+        delete it.value();
+        CloseHandle(hProcess);
+    }
+    m_exitNotifiers.clear();
+}
+
+BOOL CALLBACK Win32WindowSystem::enumWindowsProc(HWND hwnd, LPARAM lParam)
+{
+    auto* windows = reinterpret_cast<QVector<WindowId>*>(lParam);
+    windows->append(toWindowId(hwnd));
+    return TRUE;
+}
+
+QVector<WindowId> Win32WindowSystem::topLevelWindows() const
+{
+    QVector<WindowId> windows;
+    windows.reserve(256);
+    EnumWindows(enumWindowsProc, reinterpret_cast<LPARAM>(&windows));
+    return windows;
+}
+
+bool Win32WindowSystem::isWindow(WindowId window) const
+{
+    return window && IsWindow(toHwnd(window));
+}
+
+bool Win32WindowSystem::isVisible(WindowId window) const
+{
+    return IsWindowVisible(toHwnd(window));
+}
+
+bool Win32WindowSystem::isMinimized(WindowId window) const
+{
+    return IsIconic(toHwnd(window));
+}
+
+QString Win32WindowSystem::windowTitle(WindowId window) const
+{
+    wchar_t title[256];
+    int length = GetWindowTextW(toHwnd(window), title, sizeof(title) / sizeof(wchar_t));
+    if (length > 0) {
+        return QString::fromWCharArray(title, length);
+    }
+    return QString();
+}
+
+quint32 Win32WindowSystem::processId(WindowId window) const
+{
+    DWORD processId = 0;
+    GetWindowThreadProcessId(toHwnd(window), &processId);
+    return processId;
+}
+
+QString Win32WindowSystem::processName(quint32 processId) const
+{
+    QString processName;
+    HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, FALSE, processId);
+    if (hProcess) {
+        wchar_t processNameBuffer[MAX_PATH];
+        if (GetModuleBaseNameW(hProcess, NULL, processNameBuffer, MAX_PATH)) {
+            processName = QString::fromWCharArray(processNameBuffer);
+        }
+        CloseHandle(hProcess);
+    }
+    return processName;
+}
+
+qint64 Win32WindowSystem::processCreationTime(quint32 processId) const
+{
+    qint64 creationTime = 0;
+    HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION, FALSE, processId);
+    if (hProcess) {
+        FILETIME createTime, exitTime, kernelTime, userTime;
+        if (GetProcessTimes(hProcess, &createTime, &exitTime, &kernelTime, &userTime)) {
+            ULARGE_INTEGER uli;
+            uli.LowPart = createTime.dwLowDateTime;
+            uli.HighPart = createTime.dwHighDateTime;
+            creationTime = (uli.QuadPart / 10000) - 11644473600000LL;
+        }
+        CloseHandle(hProcess);
+    }
+    return creationTime;
+}
+
+bool Win32WindowSystem::watchProcessExit(quint32 processId)
+{
+    if (m_exitNotifiers.contains(processId)) {
+        return true;
+    }
+
+    HANDLE hProcess = OpenProcess(SYNCHRONIZE, FALSE, processId);
+    if (!hProcess) {
+        return false;
+    }
+
+    auto* notifier = new QWinEventNotifier(hProcess, this);
+    connect(notifier, &QWinEventNotifier::activated, this, [this, processId]() {
+        onProcessExited(processId);
+    });
+    m_exitNotifiers.insert(processId, notifier);
+    return true;
+}
+
+void Win32WindowSystem::unwatchProcessExit(quint32 processId)
+{
+    QWinEventNotifier* notifier = m_exitNotifiers.take(processId);
+    if (!notifier) {
+        return;
+    }
+
+    HANDLE hProcess = notifier->handle();
+    notifier->setEnabled(false);
+    notifier->deleteLater();
+    CloseHandle(hProcess);
+}
+
+void Win32WindowSystem::onProcessExited(quint32 processId)
+{
+    if (!m_exitNotifiers.contains(processId)) {
+        return;
+    }
+
+    // Receivers drop the ID before the handle closes and the system may hand it out again
+    emit processExited(processId);
+    unwatchProcessExit(processId);
+}
+
+WindowId Win32WindowSystem::foregroundWindow() const
+{
+    return toWindowId(GetForegroundWindow());
+}
+
+bool Win32WindowSystem::setForegroundWindow(WindowId window)
+{
+    bool result = SetForegroundWindow(toHwnd(window));
+    SetFocus(toHwnd(window));
+    return result;
+}
+
+void Win32WindowSystem::restore(WindowId window, bool wait)
+{
+    if (wait) {
+        ShowWindow(toHwnd(window), SW_RESTORE);
+    } else {
+        ShowWindowAsync(toHwnd(window), SW_RESTORE);
+    }
+}
+
+void Win32WindowSystem::restoreBehind(WindowId window, WindowId insertAfter)
+{
+    // Both are queued to the window's thread, so the z-order lands after the restore
+    HWND hwnd = toHwnd(window);
+    ShowWindowAsync(hwnd, SW_SHOWNOACTIVATE);
+    SetWindowPos(hwnd, toHwnd(insertAfter), 0, 0, 0, 0,
+                 SWP_NOMOVE | SWP_NOSIZE | SWP_NOACTIVATE | SWP_ASYNCWINDOWPOS);
+}
+
+void Win32WindowSystem::minimize(WindowId window)
+{
+    // Works even when the owning thread is hung
+    ShowWindowAsync(toHwnd(window), SW_FORCEMINIMIZE);
+}
+
+void Win32WindowSystem::close(WindowId window)
+{
+    PostMessage(toHwnd(window), WM_CLOSE, 0, 0);
+}
+
+QRect Win32WindowSystem::windowRect(WindowId window) const
+{
+    RECT rect;
+    if (!GetWindowRect(toHwnd(window), &rect)) {
+        return QRect();
+    }
+    return QRect(rect.left, rect.top, rect.right - rect.left, rect.bottom - rect.top);
+}
+
+bool Win32WindowSystem::setWindowRect(WindowId window, const QRect& rect)
+{
+    return SetWindowPos(toHwnd(window), nullptr, rect.x(), rect.y(), rect.width(), rect.height(),
+                        SWP_NOZORDER | SWP_NOACTIVATE);
+}
+
+bool Win32WindowSystem::moveWindows(const QVector<WindowMove>& moves)
+{
+    if (moves.isEmpty()) {
+        return true;
+    }
+
+    HDWP batch = BeginDeferWindowPos(moves.size());
+    if (!batch) {
+        qCDebug(lcWindow) << "WindowSystem: BeginDeferWindowPos failed:" << GetLastError();
+        return false;
+    }
+
+    for (const WindowMove& move : moves) {
+        // A failed entry frees the whole batch, nothing has moved yet
+        batch = DeferWindowPos(batch, toHwnd(move.window), nullptr, move.position.x(), move.position.y(), 0, 0,
+                               SWP_NOSIZE | SWP_NOZORDER | SWP_NOACTIVATE);
+        if (!batch) {
+            qCDebug(lcWindow) << "WindowSystem: DeferWindowPos failed:" << GetLastError();
+            return false;
+        }
+    }
+    return EndDeferWindowPos(batch);
+}
+
+QSize Win32WindowSystem::clientSize(WindowId window) const
+{
+    RECT rect;
+    if (!GetClientRect(toHwnd(window), &rect)) {
+        return QSize();
+    }
+    return QSize(rect.right - rect.left, rect.bottom - rect.top);
+}
+
+WindowSystem::ThumbnailSurface Win32WindowSystem::registerThumbnail(WindowId destination, WindowId source)
+{
+    DwmEnableBlurBehindWindow(toHwnd(destination), nullptr);
+
+    HTHUMBNAIL thumbnail = nullptr;
+    HRESULT hr = DwmRegisterThumbnail(toHwnd(destination), toHwnd(source), &thumbnail);
+    if (FAILED(hr)) {
+        qCDebug(lcOverlay) << "Failed to register DWM thumbnail:" << hr;
+        return 0;
+    }
+    return reinterpret_cast<ThumbnailSurface>(thumbnail);
+}
+
+void Win32WindowSystem::unregisterThumbnail(ThumbnailSurface surface)
+{
+    if (surface) {
+        DwmUnregisterThumbnail(reinterpret_cast<HTHUMBNAIL>(surface));
+    }
+}
+
+bool Win32WindowSystem::updateThumbnail(ThumbnailSurface surface, const QRect& sourceRect, const QRect& destinationRect)
+{
+    if (!surface) {
+        return false;
+    }
+
+    DWM_THUMBNAIL_PROPERTIES props = {};
+    props.dwFlags = DWM_TNP_RECTSOURCE | DWM_TNP_RECTDESTINATION | DWM_TNP_VISIBLE | DWM_TNP_OPACITY | DWM_TNP_SOURCECLIENTAREAONLY;
+    props.fVisible = TRUE;
+    props.opacity = 255;
+    props.fSourceClientAreaOnly = TRUE;
+
+    props.rcSource.left = sourceRect.left();
+    props.rcSource.top = sourceRect.top();
+    props.rcSource.right = sourceRect.left() + sourceRect.width();
+    props.rcSource.bottom = sourceRect.top() + sourceRect.height();
+
+    props.rcDestination.left = destinationRect.left();
+    props.rcDestination.top = destinationRect.top();
+    props.rcDestination.right = destinationRect.left() + destinationRect.width();
+    props.rcDestination.bottom = destinationRect.top() + destinationRect.height();
+
+    return SUCCEEDED(DwmUpdateThumbnailProperties(reinterpret_cast<HTHUMBNAIL>(surface), &props));
+}
+
+bool Win32WindowSystem::setWindowEventsEnabled(bool enabled)
+{
+    if (!enabled) {
+        removeHooks();
+        return true;
+    }
+
+    if (m_foregroundHook) {
+        return true;
+    }
+
+    if (s_hookOwner && s_hookOwner != this) {
+        qCWarning(lcWindow) << "WindowSystem: Window events already enabled on another backend";
+        return false;
+    }
+    s_hookOwner = this;
+
+    // Our own windows never become a client, so their events are skipped
+    const DWORD flags = WINEVENT_OUTOFCONTEXT | WINEVENT_SKIPOWNPROCESS;
+    m_foregroundHook = SetWinEventHook(EVENT_SYSTEM_FOREGROUND, EVENT_SYSTEM_FOREGROUND,
+                                       nullptr, winEventProc, 0, 0, flags);
+    m_createHook = SetWinEventHook(EVENT_OBJECT_CREATE, EVENT_OBJECT_CREATE,
+                                   nullptr, winEventProc, 0, 0, flags);
+    m_destroyHook = SetWinEventHook(EVENT_OBJECT_DESTROY, EVENT_OBJECT_DESTROY,
+                                    nullptr, winEventProc, 0, 0, flags);
+    m_showHook = SetWinEventHook(EVENT_OBJECT_SHOW, EVENT_OBJECT_SHOW,
+                                 nullptr, winEventProc, 0, 0, flags);
+    m_nameChangeHook = SetWinEventHook(EVENT_OBJECT_NAMECHANGE, EVENT_OBJECT_NAMECHANGE,
+                                       nullptr, winEventProc, 0, 0, flags);
+
+    if (!m_foregroundHook || !m_createHook || !m_destroyHook || !m_showHook || !m_nameChangeHook) {
+        qCWarning(lcWindow) << "WindowSystem: Failed to install window event hooks";
+        removeHooks();
+        return false;
+    }
+    return true;
+}
+
+bool Win32WindowSystem::registerHotkey(int id, quint32 modifiers, quint32 keyCode)
+{
+    if (!m_hotkeyFilterInstalled && QCoreApplication::instance()) {
+        QCoreApplication::instance()->installNativeEventFilter(this);
+        m_hotkeyFilterInstalled = true;
+    }
+
+    // The HotkeyModifier flags are the MOD_ values, they pass straight through
+    return RegisterHotKey(nullptr, id, modifiers, keyCode);
+}
+
+void Win32WindowSystem::unregisterHotkey(int id)
+{
+    UnregisterHotKey(nullptr, id);
+}
+
+bool Win32WindowSystem::nativeEventFilter(const QByteArray& eventType, void* message, qintptr* result)
+{
+    Q_UNUSED(eventType);
+    Q_UNUSED(result);
+
+    // Thread messages have no window to dispatch to, so they are never consumed
+    const MSG* msg = static_cast<const MSG*>(message);
+    if (msg->message == WM_HOTKEY) {
+        emit hotkeyPressed(static_cast<int>(msg->wParam));
+    }
+    return false;
+}
+
+void Win32WindowSystem::removeHooks()
+{
+    for (HWINEVENTHOOK* hook : { &m_foregroundHook, &m_createHook, &m_destroyHook, &m_showHook, &m_nameChangeHook }) {
+        if (*hook) {
+            UnhookWinEvent(*hook);
+            *hook = nullptr;
+        }
+    }
+
+    if (s_hookOwner == this) {
+        s_hookOwner = nullptr;
+    }
+}
+
+void CALLBACK Win32WindowSystem::winEventProc(HWINEVENTHOOK hWinEventHook, DWORD event, HWND hwnd,
+                                              LONG idObject, LONG idChild, DWORD dwEventThread, DWORD dwmsEventTime)
+{
+    Q_UNUSED(hWinEventHook);
+    Q_UNUSED(dwEventThread);
+    Q_UNUSED(dwmsEventTime);
+
+    if (!s_hookOwner) {
+        return;
+    }
+
+    WindowId windowId = toWindowId(hwnd);
+    if (event == EVENT_SYSTEM_FOREGROUND) {
+        emit s_hookOwner->windowEvent(Event::Foreground, windowId);
+        return;
+    }
+
+    // Object events fire for every control, caret and cursor, only whole windows matter
+    if (idObject != OBJID_WINDOW || idChild != CHILDID_SELF) {
+        return;
+    }
+
+    if (event == EVENT_OBJECT_DESTROY) {
+        emit s_hookOwner->windowEvent(Event::Destroyed, windowId);
+        return;
+    }
+
+    if (GetAncestor(hwnd, GA_PARENT) != GetDesktopWindow()) {
+        return;
+    }
+
+    switch (event) {
+    case EVENT_OBJECT_CREATE:
+        emit s_hookOwner->windowEvent(Event::Created, windowId);
+        break;
+    case EVENT_OBJECT_SHOW:
+        emit s_hookOwner->windowEvent(Event::Shown, windowId);
+        break;
+    case EVENT_OBJECT_NAMECHANGE:
+        emit s_hookOwner->windowEvent(Event::NameChanged, windowId);
+        break;
+    default:
+        break;
+    }
+}
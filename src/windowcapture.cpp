@@ -1,169 +1,195 @@
 #include "windowcapture.h"
+#include "windowsystem.h"
 #include "config.h"
 #include <QDebug>
-#include <dwmapi.h>
-#include <psapi.h>
 
 static const QString EVEOPREVIEW_PROCESS = QStringLiteral("eveapmpreview");
 
-WindowCapture::WindowCapture()
+namespace {
+
+struct ProcessInfo {
+    QString name;
+    qint64 creationTime = 0;
+    bool allowed = false;
+    bool exitWatched = false;
+    quint64 lastSeen = 0;
+};
+
+// Shared by every WindowCapture, all of which live on the GUI thread. A
+// process is looked up once, then found by PID: while its exit is watched
+// the PID can't be reused, so the PID and creation time keep naming the same
+// process until processExited() drops the entry.
+struct ProcessCache {
+    QHash<quint32, ProcessInfo> processes;
+    QStringList classifiedFor;
+    quint64 enumeration = 0;
+    bool connected = false;
+};
+
+ProcessCache& processCache()
 {
+    static ProcessCache cache;
+    if (!cache.connected) {
+        WindowSystem& windowSystem = WindowSystem::instance();
+        QObject::connect(&windowSystem, &WindowSystem::processExited, &windowSystem, [](quint32 processId) {
+            processCache().processes.remove(processId);
+        });
+        cache.connected = true;
+    }
+    return cache;
 }
 
-WindowCapture::~WindowCapture()
+bool isAllowedProcess(const QString& processName, const QStringList& allowedProcessNames)
 {
+    if (processName.isEmpty() || processName.contains(EVEOPREVIEW_PROCESS, Qt::CaseInsensitive)) {
+        return false;
+    }
+    
+    for (const QString& allowedName : allowedProcessNames) {
+        if (processName.compare(allowedName, Qt::CaseInsensitive) == 0) {
+            return true;
+        }
+    }
+    return false;
 }
 
-QVector<WindowInfo> WindowCapture::getEVEWindows()
+const ProcessInfo& lookupProcess(ProcessCache& cache, quint32 processId)
 {
-    static int cleanupCounter = 0;
-    if (++cleanupCounter >= 10) {
-        cleanupCounter = 0;
-        
-        if (!m_cleanupIteratorInitialized || m_cleanupIterator == m_processNameCache.end()) {
-            m_cleanupIterator = m_processNameCache.begin();
-            m_cleanupIteratorInitialized = true;
-        }
-        
-        int entriesToCheck = 10;
-        while (entriesToCheck > 0 && m_cleanupIterator != m_processNameCache.end()) {
-            if (!IsWindow(m_cleanupIterator.key())) {
-                m_cleanupIterator = m_processNameCache.erase(m_cleanupIterator);
-            } else {
-                ++m_cleanupIterator;
-            }
-            --entriesToCheck;
-        }
-        
-        if (m_cleanupIterator == m_processNameCache.end()) {
-            m_cleanupIterator = m_processNameCache.begin();
+    static const ProcessInfo unreadable;
+    
+    auto it = cache.processes.find(processId);
+    if (it == cache.processes.end()) {
+        WindowSystem& windowSystem = WindowSystem::instance();
+        ProcessInfo info;
+        info.name = windowSystem.processName(processId);
+        // Elevated processes can't be read, and one that is still starting
+        // may not have its module list yet, so neither is remembered
+        if (info.name.isEmpty()) {
+            return unreadable;
         }
+        info.creationTime = windowSystem.processCreationTime(processId);
+        info.allowed = isAllowedProcess(info.name, cache.classifiedFor);
+        info.exitWatched = windowSystem.watchProcessExit(processId);
+        it = cache.processes.insert(processId, info);
     }
-    
-    QVector<WindowInfo> windows;
-    windows.reserve(40); 
-    EnumWindows(enumWindowsProc, reinterpret_cast<LPARAM>(&windows));
-    return windows;
+    it->lastSeen = cache.enumeration;
+    return it.value();
+}
+
 }
 
-BOOL CALLBACK WindowCapture::enumWindowsProc(HWND hwnd, LPARAM lParam)
+WindowCapture::WindowCapture()
 {
-    auto* windows = reinterpret_cast<QVector<WindowInfo>*>(lParam);
-    WindowCapture capture;
-    
-    QString title, processName;
-    if (capture.isEVEWindow(hwnd, title, processName)) {
-        qint64 creationTime = capture.getProcessCreationTime(hwnd);
-        windows->append(WindowInfo(hwnd, title, processName, creationTime));
+}
+
+WindowCapture::~WindowCapture()
+{
+}
+
+static void refreshClassification(ProcessCache& cache)
+{
+    const QStringList allowedProcessNames = Config::instance().processNames();
+    if (allowedProcessNames != cache.classifiedFor) {
+        cache.classifiedFor = allowedProcessNames;
+        for (ProcessInfo& info : cache.processes) {
+            info.allowed = isAllowedProcess(info.name, allowedProcessNames);
+        }
     }
-    
-    return TRUE;
 }
 
-bool WindowCapture::isEVEWindow(HWND hwnd, QString& title, QString& processName)
+static bool captureClientWindow(ProcessCache& cache, WindowId hwnd, WindowInfo& window)
 {
-    if (!IsWindowVisible(hwnd)) {
+    WindowSystem& windowSystem = WindowSystem::instance();
+    
+    if (!windowSystem.isVisible(hwnd)) {
         return false;
     }
     
-    title = getWindowTitle(hwnd);
-    if (title.isEmpty()) {
+    quint32 processId = windowSystem.processId(hwnd);
+    if (processId == 0) {
         return false;
     }
     
-    processName = getProcessName(hwnd);
-    
-    if (processName.toLower().contains(EVEOPREVIEW_PROCESS)) {
+    // Classified before the title is read, which is a message round trip
+    // to the owning thread
+    const ProcessInfo& process = lookupProcess(cache, processId);
+    if (!process.allowed) {
         return false;
     }
     
-    QStringList allowedProcessNames = Config::instance().processNames();
-    for (const QString& allowedName : allowedProcessNames) {
-        if (processName.compare(allowedName, Qt::CaseInsensitive) == 0) {
-            return true;
-        }
+    QString title = windowSystem.windowTitle(hwnd);
+    if (title.isEmpty()) {
+        return false;
     }
     
-    return false;
+    window = WindowInfo(hwnd, title, process.name, process.creationTime);
+    return true;
 }
 
-QString WindowCapture::getWindowTitle(HWND hwnd)
-{
-    wchar_t title[256];
-    int length = GetWindowTextW(hwnd, title, sizeof(title) / sizeof(wchar_t));
-    if (length > 0) {
-        return QString::fromWCharArray(title, length);
-    }
-    return QString();
-}
-
-QString WindowCapture::getProcessName(HWND hwnd)
+QVector<WindowInfo> WindowCapture::getEVEWindows()
 {
-    auto it = m_processNameCache.find(hwnd);
-    if (it != m_processNameCache.end()) {
-        return it.value();
-    }
+    WindowSystem& windowSystem = WindowSystem::instance();
+    ProcessCache& cache = processCache();
+    ++cache.enumeration;
+    refreshClassification(cache);
     
-    DWORD processId = 0;
-    GetWindowThreadProcessId(hwnd, &processId);
+    QVector<WindowInfo> windows;
+    windows.reserve(40); 
+    const QVector<WindowId> topLevelWindows = windowSystem.topLevelWindows();
+    for (WindowId hwnd : topLevelWindows) {
+        WindowInfo window;
+        if (captureClientWindow(cache, hwnd, window)) {
+            windows.append(std::move(window));
+        }
+    }
     
-    QString processName;
-    HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, FALSE, processId);
-    if (hProcess) {
-        wchar_t processNameBuffer[MAX_PATH];
-        if (GetModuleBaseNameW(hProcess, NULL, processNameBuffer, MAX_PATH)) {
-            processName = QString::fromWCharArray(processNameBuffer);
+    // Processes that couldn't be watched send no exit event, forget them
+    // once they stop showing windows so a reused PID is looked up again
+    for (auto it = cache.processes.begin(); it != cache.processes.end();) {
+        if (!it->exitWatched && it->lastSeen != cache.enumeration) {
+            it = cache.processes.erase(it);
+        } else {
+            ++it;
         }
-        CloseHandle(hProcess);
     }
     
-    m_processNameCache.insert(hwnd, processName);
-    return processName;
+    return windows;
 }
 
-qint64 WindowCapture::getProcessCreationTime(HWND hwnd)
+bool WindowCapture::captureWindow(WindowId hwnd, WindowInfo& window)
 {
-    DWORD processId = 0;
-    GetWindowThreadProcessId(hwnd, &processId);
-    
-    qint64 creationTime = 0;
-    HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION, FALSE, processId);
-    if (hProcess) {
-        FILETIME createTime, exitTime, kernelTime, userTime;
-        if (GetProcessTimes(hProcess, &createTime, &exitTime, &kernelTime, &userTime)) {
-            ULARGE_INTEGER uli;
-            uli.LowPart = createTime.dwLowDateTime;
-            uli.HighPart = createTime.dwHighDateTime;
-            creationTime = (uli.QuadPart / 10000) - 11644473600000LL;
-        }
-        CloseHandle(hProcess);
-    }
-    
-    return creationTime;
+    ProcessCache& cache = processCache();
+    refreshClassification(cache);
+    return captureClientWindow(cache, hwnd, window);
+}
+
+QString WindowCapture::getWindowTitle(WindowId hwnd)
+{
+    return WindowSystem::instance().windowTitle(hwnd);
 }
 
-void WindowCapture::activateWindow(HWND hwnd)
+void WindowCapture::activateWindow(WindowId hwnd)
 {
-    if (!hwnd || !IsWindow(hwnd)) {
+    WindowSystem& windowSystem = WindowSystem::instance();
+    if (!windowSystem.isWindow(hwnd)) {
         return;
     }
     
-    if (IsIconic(hwnd)) {
-        ShowWindow(hwnd, SW_RESTORE);
+    if (windowSystem.isMinimized(hwnd)) {
+        windowSystem.restore(hwnd, true);
     }
     
-    SetForegroundWindow(hwnd);
-    SetFocus(hwnd);
+    windowSystem.setForegroundWindow(hwnd);
 }
 
 void WindowCapture::clearCache()
 {
-    auto it = m_processNameCache.begin();
-    while (it != m_processNameCache.end()) {
-        if (!IsWindow(it.key())) {
-            it = m_processNameCache.erase(it);
-        } else {
-            ++it;
+    ProcessCache& cache = processCache();
+    WindowSystem& windowSystem = WindowSystem::instance();
+    for (auto it = cache.processes.constBegin(); it != cache.processes.constEnd(); ++it) {
+        if (it->exitWatched) {
+            windowSystem.unwatchProcessExit(it.key());
         }
     }
+    cache.processes.clear();
 }
@@ -0,0 +1,29 @@
+#include "windowsystem.h"
+#ifdef Q_OS_WIN
+#include "win32windowsystem.h"
+#endif
+
+static WindowSystem* s_backendOverride = nullptr;
+
+WindowSystem::WindowSystem(QObject *parent)
+    : QObject(parent)
+{
+}
+
+WindowSystem& WindowSystem::instance()
+{
+    if (s_backendOverride) {
+        return *s_backendOverride;
+    }
+#ifdef Q_OS_WIN
+    static Win32WindowSystem nativeBackend;
+    return nativeBackend;
+#else
+    qFatal("WindowSystem: No native backend on this platform, call setInstance() first");
+#endif
+}
+
+void WindowSystem::setInstance(WindowSystem* backend)
+{
+    s_backendOverride = backend;
+}
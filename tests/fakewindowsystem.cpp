@@ -0,0 +1,345 @@
+#include "fakewindowsystem.h"
+#include <algorithm>
+
+namespace {
+
+constexpr qint64 FIRST_CREATION_TIME = 1700000000000LL;
+constexpr int CLIENTS_PER_ROW = 10;
+const QSize CLIENT_SIZE(1280, 720);
+
+}
+
+FakeWindowSystem::FakeWindowSystem(QObject *parent)
+    : WindowSystem(parent)
+{
+}
+
+void FakeWindowSystem::reset()
+{
+    m_windows.clear();
+    m_zOrder.clear();
+    m_processes.clear();
+    m_watched.clear();
+    m_thumbnails.clear();
+    m_foreground = 0;
+    m_nextWindow = 0x10000;
+    m_nextProcessId = 1000;
+    m_nextThumbnail = 1;
+    m_processLookups = 0;
+}
+
+QVector<WindowId> FakeWindowSystem::addClients(int count)
+{
+    QVector<WindowId> clients;
+    clients.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        WindowId window = addWindow(QString("EVE - Pilot %1").arg(i, 3, 10, QChar('0')), CLIENT_PROCESS_NAME);
+        const QPoint position((i % CLIENTS_PER_ROW) * 40, (i / CLIENTS_PER_ROW) * 40);
+        m_windows[window].rect = QRect(position, CLIENT_SIZE);
+        clients.prepend(window);
+    }
+    return clients;
+}
+
+WindowId FakeWindowSystem::addWindow(const QString& title, const QString& processName, quint32 processId)
+{
+    if (processId == 0 || !m_processes.contains(processId)) {
+        if (processId == 0) {
+            processId = m_nextProcessId++;
+        }
+        Process process;
+        process.name = processName;
+        process.creationTime = FIRST_CREATION_TIME + processId;
+        m_processes.insert(processId, process);
+    }
+
+    const WindowId window = m_nextWindow;
+    m_nextWindow += 0x10;
+
+    Window created;
+    created.title = title;
+    created.processId = processId;
+    created.rect = QRect(QPoint(0, 0), CLIENT_SIZE);
+    m_windows.insert(window, created);
+    m_zOrder.prepend(window);
+
+    notify(Event::Created, window);
+    notify(Event::Shown, window);
+    return window;
+}
+
+void FakeWindowSystem::setTitle(WindowId window, const QString& title)
+{
+    auto it = m_windows.find(window);
+    if (it != m_windows.end()) {
+        it->title = title;
+        notify(Event::NameChanged, window);
+    }
+}
+
+void FakeWindowSystem::setVisible(WindowId window, bool visible)
+{
+    auto it = m_windows.find(window);
+    if (it != m_windows.end()) {
+        it->visible = visible;
+        if (visible) {
+            notify(Event::Shown, window);
+        }
+    }
+}
+
+void FakeWindowSystem::destroyWindow(WindowId window)
+{
+    if (m_windows.remove(window) == 0) {
+        return;
+    }
+    m_zOrder.removeOne(window);
+    for (auto it = m_thumbnails.begin(); it != m_thumbnails.end();) {
+        if (it.value() == window) {
+            it = m_thumbnails.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    if (m_foreground == window) {
+        m_foreground = m_zOrder.isEmpty() ? 0 : m_zOrder.first();
+        notify(Event::Foreground, m_foreground);
+    }
+    notify(Event::Destroyed, window);
+}
+
+void FakeWindowSystem::exitProcess(quint32 processId)
+{
+    const QVector<WindowId> windows = m_zOrder;
+    for (WindowId window : windows) {
+        if (m_windows.value(window).processId == processId) {
+            destroyWindow(window);
+        }
+    }
+    m_processes.remove(processId);
+    if (m_watched.remove(processId)) {
+        emit processExited(processId);
+    }
+}
+
+bool FakeWindowSystem::press(quint32 modifiers, quint32 keyCode)
+{
+    for (auto it = m_hotkeys.constBegin(); it != m_hotkeys.constEnd(); ++it) {
+        if (it->modifiers == modifiers && it->keyCode == keyCode) {
+            emit hotkeyPressed(it.key());
+            return true;
+        }
+    }
+    return false;
+}
+
+int FakeWindowSystem::thumbnailCount(WindowId source) const
+{
+    return int(std::count(m_thumbnails.cbegin(), m_thumbnails.cend(), source));
+}
+
+const FakeWindowSystem::Window* FakeWindowSystem::window(WindowId window) const
+{
+    auto it = m_windows.constFind(window);
+    return it != m_windows.constEnd() ? &it.value() : nullptr;
+}
+
+QVector<WindowId> FakeWindowSystem::topLevelWindows() const
+{
+    return m_zOrder;
+}
+
+bool FakeWindowSystem::isWindow(WindowId window) const
+{
+    return m_windows.contains(window);
+}
+
+bool FakeWindowSystem::isVisible(WindowId window) const
+{
+    auto it = m_windows.constFind(window);
+    return it != m_windows.constEnd() && it->visible;
+}
+
+bool FakeWindowSystem::isMinimized(WindowId window) const
+{
+    return m_windows.value(window).minimized;
+}
+
+QString FakeWindowSystem::windowTitle(WindowId window) const
+{
+    return m_windows.value(window).title;
+}
+
+quint32 FakeWindowSystem::processId(WindowId window) const
+{
+    return m_windows.value(window).processId;
+}
+
+QString FakeWindowSystem::processName(quint32 processId) const
+{
+    ++m_processLookups;
+    return m_processes.value(processId).name;
+}
+
+qint64 FakeWindowSystem::processCreationTime(quint32 processId) const
+{
+    return m_processes.value(processId).creationTime;
+}
+
+bool FakeWindowSystem::watchProcessExit(quint32 processId)
+{
+    if (!m_processes.contains(processId)) {
+        return false;
+    }
+    m_watched.insert(processId);
+    return true;
+}
+
+void FakeWindowSystem::unwatchProcessExit(quint32 processId)
+{
+    m_watched.remove(processId);
+}
+
+WindowId FakeWindowSystem::foregroundWindow() const
+{
+    return m_foreground;
+}
+
+bool FakeWindowSystem::setForegroundWindow(WindowId window)
+{
+    if (!m_windows.contains(window)) {
+        return false;
+    }
+    raise(window);
+    m_foreground = window;
+    notify(Event::Foreground, window);
+    return true;
+}
+
+void FakeWindowSystem::restore(WindowId window, bool wait)
+{
+    Q_UNUSED(wait);
+    auto it = m_windows.find(window);
+    if (it != m_windows.end()) {
+        it->minimized = false;
+        it->visible = true;
+    }
+}
+
+void FakeWindowSystem::restoreBehind(WindowId window, WindowId insertAfter)
+{
+    auto it = m_windows.find(window);
+    if (it == m_windows.end()) {
+        return;
+    }
+    it->minimized = false;
+    it->visible = true;
+    m_zOrder.removeOne(window);
+    const qsizetype above = m_zOrder.indexOf(insertAfter);
+    m_zOrder.insert(above < 0 ? 0 : above + 1, window);
+}
+
+void FakeWindowSystem::minimize(WindowId window)
+{
+    auto it = m_windows.find(window);
+    if (it != m_windows.end()) {
+        it->minimized = true;
+    }
+}
+
+void FakeWindowSystem::close(WindowId window)
+{
+    destroyWindow(window);
+}
+
+QRect FakeWindowSystem::windowRect(WindowId window) const
+{
+    return m_windows.value(window).rect;
+}
+
+bool FakeWindowSystem::setWindowRect(WindowId window, const QRect& rect)
+{
+    auto it = m_windows.find(window);
+    if (it == m_windows.end()) {
+        return false;
+    }
+    it->rect = rect;
+    return true;
+}
+
+bool FakeWindowSystem::moveWindows(const QVector<WindowMove>& moves)
+{
+    bool allMoved = true;
+    for (const WindowMove& move : moves) {
+        auto it = m_windows.find(move.window);
+        if (it == m_windows.end()) {
+            allMoved = false;
+            continue;
+        }
+        it->rect.moveTopLeft(move.position);
+    }
+    return allMoved;
+}
+
+QSize FakeWindowSystem::clientSize(WindowId window) const
+{
+    return m_windows.value(window).rect.size();
+}
+
+WindowSystem::ThumbnailSurface FakeWindowSystem::registerThumbnail(WindowId destination, WindowId source)
+{
+    if (!m_windows.contains(source) || destination == 0) {
+        return 0;
+    }
+    const ThumbnailSurface surface = m_nextThumbnail++;
+    m_thumbnails.insert(surface, source);
+    return surface;
+}
+
+void FakeWindowSystem::unregisterThumbnail(ThumbnailSurface surface)
+{
+    m_thumbnails.remove(surface);
+}
+
+bool FakeWindowSystem::updateThumbnail(ThumbnailSurface surface, const QRect& sourceRect, const QRect& destinationRect)
+{
+    Q_UNUSED(sourceRect);
+    Q_UNUSED(destinationRect);
+    return m_thumbnails.contains(surface);
+}
+
+bool FakeWindowSystem::setWindowEventsEnabled(bool enabled)
+{
+    m_eventsEnabled = enabled;
+    return true;
+}
+
+bool FakeWindowSystem::registerHotkey(int id, quint32 modifiers, quint32 keyCode)
+{
+    // Like RegisterHotKey, a combination can only be held once
+    for (const Hotkey& hotkey : m_hotkeys) {
+        if (hotkey.modifiers == modifiers && hotkey.keyCode == keyCode) {
+            return false;
+        }
+    }
+    m_hotkeys.insert(id, Hotkey{ modifiers, keyCode });
+    return true;
+}
+
+void FakeWindowSystem::unregisterHotkey(int id)
+{
+    m_hotkeys.remove(id);
+}
+
+void FakeWindowSystem::raise(WindowId window)
+{
+    m_zOrder.removeOne(window);
+    m_zOrder.prepend(window);
+}
+
+void FakeWindowSystem::notify(Event event, WindowId window)
+{
+    if (m_eventsEnabled) {
+        emit windowEvent(event, window);
+    }
+}
@@ -0,0 +1,118 @@
+#ifndef FAKEWINDOWSYSTEM_H
+#define FAKEWINDOWSYSTEM_H
+
+#include "windowsystem.h"
+#include <QHash>
+#include <QSet>
+#include <QVector>
+
+// Scripted in-memory backend. Windows, processes and hotkeys only change
+// when a test says so, and ids, PIDs and creation times are handed out in
+// order, so every run sees the same desktop.
+class FakeWindowSystem : public WindowSystem
+{
+    Q_OBJECT
+
+public:
+    static constexpr const char* CLIENT_PROCESS_NAME = "exefile.exe";
+
+    struct Window {
+        QString title;
+        quint32 processId = 0;
+        QRect rect;
+        bool visible = true;
+        bool minimized = false;
+    };
+
+    struct Hotkey {
+        quint32 modifiers = 0;
+        quint32 keyCode = 0;
+    };
+
+    explicit FakeWindowSystem(QObject *parent = nullptr);
+
+    // Back to an empty desktop with the first ids, hotkeys stay registered
+    void reset();
+
+    // count EVE clients titled "EVE - Pilot NNN", each in its own process,
+    // tiled 10 to a row. Returns them in z-order.
+    QVector<WindowId> addClients(int count);
+    // A window in a new process, or in processId when it is already running
+    WindowId addWindow(const QString& title, const QString& processName, quint32 processId = 0);
+    void setTitle(WindowId window, const QString& title);
+    void setVisible(WindowId window, bool visible);
+    void destroyWindow(WindowId window);
+    // Destroys the process's windows, then reports the exit if it was watched
+    void exitProcess(quint32 processId);
+
+    // Emits hotkeyPressed() for the registered combination, false if none
+    bool press(quint32 modifiers, quint32 keyCode);
+
+    const Window* window(WindowId window) const;
+    int hotkeyCount() const { return int(m_hotkeys.size()); }
+    int thumbnailCount() const { return int(m_thumbnails.size()); }
+    // Registered thumbnails showing source
+    int thumbnailCount(WindowId source) const;
+    bool isWatched(quint32 processId) const { return m_watched.contains(processId); }
+    // processName() calls so far, to tell cached lookups from fresh ones
+    int processLookups() const { return m_processLookups; }
+
+    QVector<WindowId> topLevelWindows() const override;
+    bool isWindow(WindowId window) const override;
+    bool isVisible(WindowId window) const override;
+    bool isMinimized(WindowId window) const override;
+    QString windowTitle(WindowId window) const override;
+
+    quint32 processId(WindowId window) const override;
+    QString processName(quint32 processId) const override;
+    qint64 processCreationTime(quint32 processId) const override;
+    bool watchProcessExit(quint32 processId) override;
+    void unwatchProcessExit(quint32 processId) override;
+
+    WindowId foregroundWindow() const override;
+    bool setForegroundWindow(WindowId window) override;
+    void restore(WindowId window, bool wait) override;
+    void restoreBehind(WindowId window, WindowId insertAfter) override;
+    void minimize(WindowId window) override;
+    void close(WindowId window) override;
+
+    QRect windowRect(WindowId window) const override;
+    bool setWindowRect(WindowId window, const QRect& rect) override;
+    bool moveWindows(const QVector<WindowMove>& moves) override;
+    QSize clientSize(WindowId window) const override;
+
+    ThumbnailSurface registerThumbnail(WindowId destination, WindowId source) override;
+    void unregisterThumbnail(ThumbnailSurface surface) override;
+    bool updateThumbnail(ThumbnailSurface surface, const QRect& sourceRect, const QRect& destinationRect) override;
+
+    bool setWindowEventsEnabled(bool enabled) override;
+
+    bool registerHotkey(int id, quint32 modifiers, quint32 keyCode) override;
+    void unregisterHotkey(int id) override;
+
+private:
+    struct Process {
+        QString name;
+        qint64 creationTime = 0;
+    };
+
+    void raise(WindowId window);
+    void notify(Event event, WindowId window);
+
+    QHash<WindowId, Window> m_windows;
+    // Topmost first, as the native enumeration returns them
+    QVector<WindowId> m_zOrder;
+    QHash<quint32, Process> m_processes;
+    QSet<quint32> m_watched;
+    QHash<int, Hotkey> m_hotkeys;
+    QHash<ThumbnailSurface, WindowId> m_thumbnails;
+
+    WindowId m_foreground = 0;
+    WindowId m_nextWindow = 0x10000;
+    quint32 m_nextProcessId = 1000;
+    ThumbnailSurface m_nextThumbnail = 1;
+    bool m_eventsEnabled = false;
+    mutable int m_processLookups = 0;
+};
+
+#endif
@@ -0,0 +1,355 @@
+#include "fakewindowsystem.h"
+#include "clienttracker.h"
+#include "config.h"
+#include "hotkeymanager.h"
+#include "windowcapture.h"
+#include <QTemporaryDir>
+#include <QtTest>
+#include <algorithm>
+#include <memory>
+
+namespace {
+
+constexpr int CLIENT_COUNT = 100;
+// Any destination does, the fake only needs one to be given
+constexpr WindowId THUMBNAIL_WINDOW = 1;
+const QString NOT_LOGGED_IN_TEXT = QStringLiteral("Not Logged In");
+const QString EVEN_GROUP = QStringLiteral("Even");
+const QString TENS_GROUP = QStringLiteral("Tens");
+
+QString pilotName(int index)
+{
+    return QString("Pilot %1").arg(index, 3, 10, QChar('0'));
+}
+
+// Stands in for ThumbnailWidget. It registers a thumbnail of its client the
+// way the widget does and keeps what the tracker last told it.
+class FakeThumbnail : public ClientThumbnail
+{
+public:
+    FakeThumbnail(const WindowInfo& window, const QString& displayName)
+        : source(window.handle)
+        , title(window.title)
+        , characterName(displayName)
+        , m_surface(WindowSystem::instance().registerThumbnail(THUMBNAIL_WINDOW, window.handle))
+    {
+        ++s_live;
+    }
+
+    ~FakeThumbnail() override
+    {
+        WindowSystem::instance().unregisterThumbnail(m_surface);
+        --s_live;
+    }
+
+    void setTitle(const QString& value) override { title = value; }
+    void setCharacterName(const QString& value) override { characterName = value; }
+    void setSystemName(const QString& value) override { systemName = value; }
+    void placeAt(const QPoint& value) override { position = value; placed = true; }
+    void dispose() override { delete this; }
+
+    static int live() { return s_live; }
+
+    WindowId source;
+    QString title;
+    QString characterName;
+    QString systemName;
+    QPoint position;
+    bool placed = false;
+
+private:
+    WindowSystem::ThumbnailSurface m_surface;
+    static inline int s_live = 0;
+};
+
+// Function static so it outlives Config, whose destructor still saves
+QTemporaryDir& configDirectory()
+{
+    static QTemporaryDir directory;
+    return directory;
+}
+
+}
+
+class ClientTrackerTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void cleanup();
+
+    void tracksLogins();
+    void followsScriptedSession();
+    void reconcileCatchesMissedEvents();
+
+private:
+    // Logs in CLIENT_COUNT pilots, returned by pilot number
+    QVector<WindowId> loginClients();
+    void addCycleGroup(const QString& name, const QVector<int>& pilots, bool includeNotLoggedIn, bool noLoop);
+    FakeThumbnail* thumbnailOf(WindowId window) const;
+    QVector<WindowId> cycleWindows(const QString& groupName) const;
+    // Every tracked client has exactly one registered thumbnail, showing its current title
+    void verifyThumbnails() const;
+
+    FakeWindowSystem m_windowSystem;
+    std::unique_ptr<WindowCapture> m_windowCapture;
+    std::unique_ptr<HotkeyManager> m_hotkeys;
+    std::unique_ptr<ClientTracker> m_tracker;
+};
+
+void ClientTrackerTest::initTestCase()
+{
+    QVERIFY(configDirectory().isValid());
+    Config::setBaseDirectory(configDirectory().path());
+    WindowSystem::setInstance(&m_windowSystem);
+
+    Config& cfg = Config::instance();
+    cfg.setShowNotLoggedInClients(true);
+    cfg.setShowNotLoggedInOverlay(true);
+    cfg.setSaveClientLocation(false);
+    cfg.setPreRestoreCount(2);
+}
+
+void ClientTrackerTest::cleanupTestCase()
+{
+    WindowCapture().clearCache();
+    WindowSystem::setInstance(nullptr);
+}
+
+void ClientTrackerTest::init()
+{
+    WindowCapture().clearCache();
+    m_windowSystem.reset();
+    m_windowSystem.setWindowEventsEnabled(true);
+
+    m_windowCapture = std::make_unique<WindowCapture>();
+    m_hotkeys = std::make_unique<HotkeyManager>();
+    m_tracker = std::make_unique<ClientTracker>(*m_windowCapture, *m_hotkeys,
+        [](const WindowInfo& window, const QString& displayName) { return new FakeThumbnail(window, displayName); });
+}
+
+void ClientTrackerTest::cleanup()
+{
+    m_tracker.reset();
+    m_hotkeys.reset();
+    m_windowCapture.reset();
+    QCOMPARE(FakeThumbnail::live(), 0);
+    QCOMPARE(m_windowSystem.thumbnailCount(), 0);
+}
+
+QVector<WindowId> ClientTrackerTest::loginClients()
+{
+    QVector<WindowId> pilots = m_windowSystem.addClients(CLIENT_COUNT);
+    std::reverse(pilots.begin(), pilots.end());
+    return pilots;
+}
+
+void ClientTrackerTest::addCycleGroup(const QString& name, const QVector<int>& pilots, bool includeNotLoggedIn, bool noLoop)
+{
+    CycleGroup group(name);
+    for (int pilot : pilots) {
+        group.characterNames.append(pilotName(pilot));
+    }
+    group.includeNotLoggedIn = includeNotLoggedIn;
+    group.noLoop = noLoop;
+    m_hotkeys->createCycleGroup(group);
+}
+
+FakeThumbnail* ClientTrackerTest::thumbnailOf(WindowId window) const
+{
+    return static_cast<FakeThumbnail*>(m_tracker->clients().thumbnailFor(window));
+}
+
+QVector<WindowId> ClientTrackerTest::cycleWindows(const QString& groupName) const
+{
+    QVector<WindowId> windows;
+    for (ClientSlot slot : m_tracker->cycleClients(groupName)) {
+        windows.append(m_tracker->clients().window(slot));
+    }
+    return windows;
+}
+
+void ClientTrackerTest::verifyThumbnails() const
+{
+    const ClientRegistry& clients = m_tracker->clients();
+    QCOMPARE(FakeThumbnail::live(), clients.size());
+    QCOMPARE(m_windowSystem.thumbnailCount(), clients.size());
+    for (ClientSlot slot : clients.clients()) {
+        const WindowId window = clients.window(slot);
+        const FakeThumbnail* thumbnail = static_cast<const FakeThumbnail*>(clients.thumbnail(slot));
+        QCOMPARE(thumbnail->source, window);
+        QCOMPARE(thumbnail->title, m_windowSystem.windowTitle(window));
+        QCOMPARE(clients.title(slot), thumbnail->title);
+        QCOMPARE(m_windowSystem.thumbnailCount(window), 1);
+        QVERIFY(thumbnail->placed);
+    }
+}
+
+void ClientTrackerTest::tracksLogins()
+{
+    const QVector<WindowId> pilots = loginClients();
+    const ClientRegistry& clients = m_tracker->clients();
+
+    QCOMPARE(clients.size(), CLIENT_COUNT);
+    for (int i = 0; i < CLIENT_COUNT; ++i) {
+        const ClientSlot slot = clients.slotFor(pilots[i]);
+        QVERIFY(slot != ClientRegistry::INVALID_SLOT);
+        QCOMPARE(clients.clients()[i], slot);
+        QVERIFY(clients.kind(slot) == ClientRegistry::Kind::LoggedIn);
+        QCOMPARE(clients.characterName(slot), pilotName(i));
+        QCOMPARE(clients.slotFor(CharacterRegistry::instance().find(pilotName(i))), slot);
+        QCOMPARE(thumbnailOf(pilots[i])->characterName, pilotName(i));
+    }
+    verifyThumbnails();
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+
+    // The reconcile agrees with what the events built
+    m_tracker->refresh();
+    QCOMPARE(clients.size(), CLIENT_COUNT);
+    verifyThumbnails();
+}
+
+void ClientTrackerTest::followsScriptedSession()
+{
+    const QVector<WindowId> pilots = loginClients();
+    const ClientRegistry& clients = m_tracker->clients();
+
+    QVector<int> evenPilots;
+    for (int i = 0; i < CLIENT_COUNT; i += 2) {
+        evenPilots.append(i);
+    }
+    addCycleGroup(EVEN_GROUP, evenPilots, true, false);
+    QCOMPARE(cycleWindows(EVEN_GROUP).size(), CLIENT_COUNT / 2);
+
+    // By pilot number: 1 logs out, 2 switches character, 3 closes and 4
+    // logs out and back in. The rest stay.
+    for (int i = 0; i < CLIENT_COUNT; ++i) {
+        switch (i % 10) {
+        case 1:
+            m_windowSystem.setTitle(pilots[i], "EVE");
+            break;
+        case 2:
+            m_windowSystem.setTitle(pilots[i], QString("EVE - Renamed %1").arg(i, 3, 10, QChar('0')));
+            break;
+        case 3:
+            m_windowSystem.destroyWindow(pilots[i]);
+            break;
+        case 4:
+            m_windowSystem.setTitle(pilots[i], "EVE");
+            m_windowSystem.setTitle(pilots[i], QString("EVE - %1").arg(pilotName(i)));
+            break;
+        }
+    }
+
+    QCOMPARE(clients.size(), CLIENT_COUNT - CLIENT_COUNT / 10);
+    QCOMPARE(clients.notLoggedInClients().size(), CLIENT_COUNT / 10);
+    QVector<WindowId> expectedCycle;
+    QVector<WindowId> loggedOut;
+    for (int i = 0; i < CLIENT_COUNT; ++i) {
+        const ClientSlot slot = clients.slotFor(pilots[i]);
+        const CharacterId pilot = CharacterRegistry::instance().find(pilotName(i));
+        switch (i % 10) {
+        case 1:
+            QVERIFY(clients.kind(slot) == ClientRegistry::Kind::NotLoggedIn);
+            QVERIFY(clients.characterName(slot).isEmpty());
+            QCOMPARE(clients.slotFor(pilot), ClientRegistry::INVALID_SLOT);
+            QCOMPARE(thumbnailOf(pilots[i])->characterName, NOT_LOGGED_IN_TEXT);
+            loggedOut.append(pilots[i]);
+            break;
+        case 2:
+            QCOMPARE(clients.characterName(slot), QString("Renamed %1").arg(i, 3, 10, QChar('0')));
+            QCOMPARE(clients.slotFor(pilot), ClientRegistry::INVALID_SLOT);
+            QCOMPARE(thumbnailOf(pilots[i])->characterName, clients.characterName(slot));
+            break;
+        case 3:
+            QCOMPARE(slot, ClientRegistry::INVALID_SLOT);
+            QCOMPARE(m_windowSystem.thumbnailCount(pilots[i]), 0);
+            break;
+        default:
+            QCOMPARE(clients.characterName(slot), pilotName(i));
+            QCOMPARE(clients.slotFor(pilot), slot);
+            QCOMPARE(thumbnailOf(pilots[i])->characterName, pilotName(i));
+            if (i % 2 == 0) {
+                expectedCycle.append(pilots[i]);
+            }
+            break;
+        }
+    }
+    verifyThumbnails();
+
+    // Group members in group order, then every not logged in client
+    expectedCycle += loggedOut;
+    QCOMPARE(cycleWindows(EVEN_GROUP), expectedCycle);
+
+    for (int step = 0; step <= expectedCycle.size(); ++step) {
+        QCOMPARE(m_tracker->cycleForward(EVEN_GROUP), expectedCycle[step % expectedCycle.size()]);
+    }
+    QVERIFY(m_tracker->preRestoreTargets(expectedCycle.first()) == QSet<WindowId>({expectedCycle[1], expectedCycle.last()}));
+    QCOMPARE(m_tracker->cycleBackward(EVEN_GROUP), expectedCycle.last());
+
+    for (int step = 0; step <= loggedOut.size(); ++step) {
+        QCOMPARE(m_tracker->cycleNotLoggedInForward(), loggedOut[step % loggedOut.size()]);
+    }
+
+    // A client for a pilot whose window switched away rejoins the group in
+    // its place, in a slot a closed client freed
+    const WindowId returning = m_windowSystem.addWindow(QString("EVE - %1").arg(pilotName(2)),
+                                                        FakeWindowSystem::CLIENT_PROCESS_NAME);
+    QVERIFY(clients.slotFor(returning) < CLIENT_COUNT);
+    expectedCycle.insert(1, returning);
+    QCOMPARE(cycleWindows(EVEN_GROUP), expectedCycle);
+    verifyThumbnails();
+
+    m_tracker->refresh();
+    QCOMPARE(clients.size(), CLIENT_COUNT - CLIENT_COUNT / 10 + 1);
+    QCOMPARE(cycleWindows(EVEN_GROUP), expectedCycle);
+    verifyThumbnails();
+}
+
+void ClientTrackerTest::reconcileCatchesMissedEvents()
+{
+    const QVector<WindowId> pilots = loginClients();
+    const ClientRegistry& clients = m_tracker->clients();
+
+    QVector<int> tensAndThrees;
+    for (int i = 0; i < CLIENT_COUNT; i += 10) {
+        tensAndThrees << i << i + 3;
+    }
+    addCycleGroup(TENS_GROUP, tensAndThrees, false, true);
+
+    m_windowSystem.setWindowEventsEnabled(false);
+    for (int i = 0; i < CLIENT_COUNT; ++i) {
+        if (i % 10 == 1) {
+            m_windowSystem.setTitle(pilots[i], "EVE");
+        } else if (i % 10 == 3) {
+            m_windowSystem.destroyWindow(pilots[i]);
+        }
+    }
+    QCOMPARE(clients.size(), CLIENT_COUNT);
+    QCOMPARE(FakeThumbnail::live(), CLIENT_COUNT);
+
+    m_tracker->refresh();
+    QCOMPARE(clients.size(), CLIENT_COUNT - CLIENT_COUNT / 10);
+    QCOMPARE(clients.notLoggedInClients().size(), CLIENT_COUNT / 10);
+    verifyThumbnails();
+
+    QVector<WindowId> tens;
+    for (int i = 0; i < CLIENT_COUNT; i += 10) {
+        tens.append(pilots[i]);
+    }
+    QCOMPARE(cycleWindows(TENS_GROUP), tens);
+
+    // No loop, so the cycle stops at the last client
+    for (WindowId window : tens) {
+        QCOMPARE(m_tracker->cycleForward(TENS_GROUP), window);
+    }
+    QCOMPARE(m_tracker->cycleForward(TENS_GROUP), WindowId(0));
+}
+
+QTEST_MAIN(ClientTrackerTest)
+#include "tst_clienttracker.moc"
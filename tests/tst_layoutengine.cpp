@@ -0,0 +1,304 @@
+#include "layoutengine.h"
+#include <QtTest>
+#include <algorithm>
+
+namespace {
+
+constexpr int CLIENT_COUNT = 200;
+const QSize THUMBNAIL_SIZE(240, 135);
+const QRect PRIMARY_SCREEN(0, 0, 1920, 1080);
+// Room for exactly 2 x 2 thumbnails at the default margin
+const QRect SMALL_SCREEN(0, 0, 510, 300);
+const QRect SMALL_LEFT_SCREEN(-520, -100, 510, 300);
+
+LayoutEngine::Parameters parametersFor(LayoutEngine::Strategy strategy, const QVector<QRect>& screens)
+{
+    LayoutEngine::Parameters parameters;
+    parameters.strategy = strategy;
+    parameters.thumbnailSize = THUMBNAIL_SIZE;
+    parameters.screens = screens;
+    parameters.notLoggedInOrigin = QPoint(10, 900);
+    return parameters;
+}
+
+QVector<LayoutEngine::Item> itemsFor(int count)
+{
+    return QVector<LayoutEngine::Item>(count);
+}
+
+bool insideAnyScreen(const QRect& rect, const QVector<QRect>& screens)
+{
+    return std::any_of(screens.cbegin(), screens.cend(), [&rect](const QRect& screen) {
+        return screen.contains(rect);
+    });
+}
+
+}
+
+class LayoutEngineTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void emptyInput();
+
+    void gridFillsRowsOnPrimary();
+    void gridStartsRowPerGroup();
+    void gridWrapsPastBottom();
+
+    void monitorColumnsFillEachScreen();
+    void monitorColumnsStartColumnPerGroup();
+
+    void packAroundSavedSkipsSavedCells();
+    void packAroundSavedUsesEveryScreen();
+    void packAroundSavedOverlapsWhenFull();
+    void packAroundSavedKeepsOthersWhenSaved();
+
+    void keepsSavedPositionOnAnyScreen();
+    void replacesOffScreenSavedPosition();
+    void stacksNotLoggedIn_data();
+    void stacksNotLoggedIn();
+
+    void twoHundredClientsDoNotOverlap_data();
+    void twoHundredClientsDoNotOverlap();
+};
+
+void LayoutEngineTest::emptyInput()
+{
+    const auto parameters = parametersFor(LayoutEngine::Strategy::Grid, { PRIMARY_SCREEN });
+    QVERIFY(LayoutEngine::layout({}, parameters).isEmpty());
+
+    // Without screens a single cell-sized screen is assumed
+    const auto noScreens = parametersFor(LayoutEngine::Strategy::PackAroundSaved, {});
+    const QVector<QRect> rects = LayoutEngine::layout(itemsFor(1), noScreens);
+    QCOMPARE(rects, QVector<QRect>({ QRect(QPoint(10, 10), THUMBNAIL_SIZE) }));
+}
+
+void LayoutEngineTest::gridFillsRowsOnPrimary()
+{
+    const auto parameters = parametersFor(LayoutEngine::Strategy::Grid, { PRIMARY_SCREEN, SMALL_LEFT_SCREEN });
+    const QVector<QRect> rects = LayoutEngine::layout(itemsFor(8), parameters);
+
+    // Seven 250 px steps fit across 1920 px
+    for (int i = 0; i < 7; ++i) {
+        QCOMPARE(rects[i], QRect(QPoint(10 + i * 250, 10), THUMBNAIL_SIZE));
+    }
+    QCOMPARE(rects[7], QRect(QPoint(10, 155), THUMBNAIL_SIZE));
+}
+
+void LayoutEngineTest::gridStartsRowPerGroup()
+{
+    QVector<LayoutEngine::Item> items = itemsFor(4);
+    items[0].group = 1;
+    items[1].group = 0;
+    items[2].group = 1;
+    items[3].group = 0;
+    const auto parameters = parametersFor(LayoutEngine::Strategy::Grid, { PRIMARY_SCREEN });
+    const QVector<QRect> rects = LayoutEngine::layout(items, parameters);
+
+    // Group 0 first in caller order, then group 1 on the next row
+    QCOMPARE(rects[1].topLeft(), QPoint(10, 10));
+    QCOMPARE(rects[3].topLeft(), QPoint(260, 10));
+    QCOMPARE(rects[0].topLeft(), QPoint(10, 155));
+    QCOMPARE(rects[2].topLeft(), QPoint(260, 155));
+}
+
+void LayoutEngineTest::gridWrapsPastBottom()
+{
+    const auto parameters = parametersFor(LayoutEngine::Strategy::Grid, { SMALL_SCREEN });
+    const QVector<QRect> rects = LayoutEngine::layout(itemsFor(5), parameters);
+
+    QCOMPARE(rects[3].topLeft(), QPoint(260, 155));
+    QCOMPARE(rects[4].topLeft(), QPoint(10, 10));
+}
+
+void LayoutEngineTest::monitorColumnsFillEachScreen()
+{
+    const QVector<QRect> screens = { SMALL_SCREEN, SMALL_LEFT_SCREEN };
+    const auto parameters = parametersFor(LayoutEngine::Strategy::MonitorColumns, screens);
+    const QVector<QRect> rects = LayoutEngine::layout(itemsFor(9), parameters);
+
+    QCOMPARE(rects[0].topLeft(), QPoint(10, 10));
+    QCOMPARE(rects[1].topLeft(), QPoint(10, 155));
+    QCOMPARE(rects[2].topLeft(), QPoint(260, 10));
+    QCOMPARE(rects[3].topLeft(), QPoint(260, 155));
+    // Then the screen left of the primary, which has negative coordinates
+    QCOMPARE(rects[4].topLeft(), QPoint(-510, -90));
+    QCOMPARE(rects[5].topLeft(), QPoint(-510, 55));
+    QCOMPARE(rects[7].topLeft(), QPoint(-260, 55));
+    // And round to the primary again
+    QCOMPARE(rects[8].topLeft(), QPoint(10, 10));
+    for (int i = 0; i < 8; ++i) {
+        QVERIFY2(insideAnyScreen(rects[i], screens), qPrintable(QString::number(i)));
+    }
+}
+
+void LayoutEngineTest::monitorColumnsStartColumnPerGroup()
+{
+    QVector<LayoutEngine::Item> items = itemsFor(3);
+    items[2].group = 1;
+    const auto parameters = parametersFor(LayoutEngine::Strategy::MonitorColumns, { PRIMARY_SCREEN });
+    const QVector<QRect> rects = LayoutEngine::layout(items, parameters);
+
+    QCOMPARE(rects[0].topLeft(), QPoint(10, 10));
+    QCOMPARE(rects[1].topLeft(), QPoint(10, 155));
+    QCOMPARE(rects[2].topLeft(), QPoint(260, 10));
+}
+
+void LayoutEngineTest::packAroundSavedSkipsSavedCells()
+{
+    QVector<LayoutEngine::Item> items = itemsFor(3);
+    items[2].savedPosition = QPoint(20, 20);
+    const auto parameters = parametersFor(LayoutEngine::Strategy::PackAroundSaved, { PRIMARY_SCREEN });
+    const QVector<QRect> rects = LayoutEngine::layout(items, parameters);
+
+    QCOMPARE(rects[2].topLeft(), QPoint(20, 20));
+    // Only the first cell intersects the saved thumbnail
+    QCOMPARE(rects[0].topLeft(), QPoint(260, 10));
+    QCOMPARE(rects[1].topLeft(), QPoint(510, 10));
+}
+
+void LayoutEngineTest::packAroundSavedUsesEveryScreen()
+{
+    const QVector<QRect> screens = { SMALL_SCREEN, SMALL_LEFT_SCREEN };
+    QVector<LayoutEngine::Item> items = itemsFor(6);
+    items[5].savedPosition = QPoint(-510, -90);
+    const auto parameters = parametersFor(LayoutEngine::Strategy::PackAroundSaved, screens);
+    const QVector<QRect> rects = LayoutEngine::layout(items, parameters);
+
+    QCOMPARE(rects[3].topLeft(), QPoint(260, 155));
+    QCOMPARE(rects[4].topLeft(), QPoint(-260, -90));
+    QCOMPARE(rects[5].topLeft(), QPoint(-510, -90));
+}
+
+void LayoutEngineTest::packAroundSavedOverlapsWhenFull()
+{
+    const auto parameters = parametersFor(LayoutEngine::Strategy::PackAroundSaved, { SMALL_SCREEN });
+    const QVector<QRect> rects = LayoutEngine::layout(itemsFor(6), parameters);
+
+    QCOMPARE(rects[3].topLeft(), QPoint(260, 155));
+    QCOMPARE(rects[4].topLeft(), QPoint(10, 10));
+    QCOMPARE(rects[5].topLeft(), QPoint(260, 10));
+}
+
+void LayoutEngineTest::packAroundSavedKeepsOthersWhenSaved()
+{
+    const QVector<QRect> screens = { PRIMARY_SCREEN, SMALL_LEFT_SCREEN };
+    const auto parameters = parametersFor(LayoutEngine::Strategy::PackAroundSaved, screens);
+    QVector<LayoutEngine::Item> items = itemsFor(CLIENT_COUNT / 4);
+    const QVector<QRect> before = LayoutEngine::layout(items, parameters);
+
+    // Saving where a thumbnail already is must not move any of the others,
+    // so a re-layout after a drag repositions nothing
+    for (int i = 0; i < items.size(); i += 7) {
+        items[i].savedPosition = before[i].topLeft();
+    }
+    QCOMPARE(LayoutEngine::layout(items, parameters), before);
+}
+
+void LayoutEngineTest::keepsSavedPositionOnAnyScreen()
+{
+    const QVector<QRect> screens = { PRIMARY_SCREEN, SMALL_LEFT_SCREEN };
+    QVector<LayoutEngine::Item> items = itemsFor(3);
+    items[0].savedPosition = QPoint(-400, -50);
+    // Partly off the primary still counts as on screen
+    items[1].savedPosition = QPoint(1800, 1000);
+    items[2].notLoggedIn = true;
+    items[2].savedPosition = QPoint(500, 500);
+
+    for (auto strategy : { LayoutEngine::Strategy::Grid, LayoutEngine::Strategy::MonitorColumns,
+                           LayoutEngine::Strategy::PackAroundSaved }) {
+        const QVector<QRect> rects = LayoutEngine::layout(items, parametersFor(strategy, screens));
+        QCOMPARE(rects[0].topLeft(), QPoint(-400, -50));
+        QCOMPARE(rects[1].topLeft(), QPoint(1800, 1000));
+        QCOMPARE(rects[2].topLeft(), QPoint(500, 500));
+    }
+}
+
+void LayoutEngineTest::replacesOffScreenSavedPosition()
+{
+    QVector<LayoutEngine::Item> items = itemsFor(2);
+    // A monitor that has since been unplugged
+    items[0].savedPosition = QPoint(3000, 200);
+    items[1].savedPosition = QPoint(-2000, 0);
+    const auto parameters = parametersFor(LayoutEngine::Strategy::Grid, { PRIMARY_SCREEN });
+    const QVector<QRect> rects = LayoutEngine::layout(items, parameters);
+
+    QCOMPARE(rects[0].topLeft(), QPoint(10, 10));
+    QCOMPARE(rects[1].topLeft(), QPoint(260, 10));
+    QVERIFY(!LayoutEngine::isOnScreen(QRect(QPoint(3000, 200), THUMBNAIL_SIZE), { PRIMARY_SCREEN }));
+    QVERIFY(LayoutEngine::isOnScreen(QRect(QPoint(-200, -100), THUMBNAIL_SIZE), { PRIMARY_SCREEN }));
+}
+
+void LayoutEngineTest::stacksNotLoggedIn_data()
+{
+    QTest::addColumn<int>("stackMode");
+    QTest::addColumn<QPoint>("second");
+
+    QTest::newRow("horizontal") << 0 << QPoint(260, 900);
+    QTest::newRow("vertical") << 1 << QPoint(10, 1045);
+    QTest::newRow("stacked") << 2 << QPoint(10, 900);
+}
+
+void LayoutEngineTest::stacksNotLoggedIn()
+{
+    QFETCH(int, stackMode);
+    QFETCH(QPoint, second);
+
+    QVector<LayoutEngine::Item> items = itemsFor(3);
+    items[0].notLoggedIn = true;
+    items[2].notLoggedIn = true;
+    auto parameters = parametersFor(LayoutEngine::Strategy::Grid, { PRIMARY_SCREEN });
+    parameters.notLoggedInStackMode = stackMode;
+    const QVector<QRect> rects = LayoutEngine::layout(items, parameters);
+
+    QCOMPARE(rects[0].topLeft(), QPoint(10, 900));
+    QCOMPARE(rects[2].topLeft(), second);
+    QCOMPARE(rects[1].topLeft(), QPoint(10, 10));
+}
+
+void LayoutEngineTest::twoHundredClientsDoNotOverlap_data()
+{
+    QTest::addColumn<int>("strategy");
+    QTest::addColumn<QVector<QRect>>("screens");
+
+    const QRect left(-2560, 0, 2560, 1440);
+    const QRect right(2560, -200, 2560, 1440);
+    const QRect primary(0, 0, 2560, 1440);
+    QTest::newRow("monitorColumns") << int(LayoutEngine::Strategy::MonitorColumns)
+                                    << QVector<QRect>({ primary, left, right });
+    QTest::newRow("packAroundSaved") << int(LayoutEngine::Strategy::PackAroundSaved)
+                                     << QVector<QRect>({ primary, left, right });
+}
+
+void LayoutEngineTest::twoHundredClientsDoNotOverlap()
+{
+    QFETCH(int, strategy);
+    QFETCH(QVector<QRect>, screens);
+
+    // Every fifth client has a saved position, a fifth of those off screen
+    QVector<LayoutEngine::Item> items = itemsFor(CLIENT_COUNT);
+    for (int i = 0; i < CLIENT_COUNT; i += 5) {
+        items[i].savedPosition = i % 25 == 0 ? QPoint(9000, 9000) : QPoint(screens[1].left() + 10 + (i % 50) * 50, 1200);
+        items[i].group = i % 3;
+    }
+    const auto parameters = parametersFor(LayoutEngine::Strategy(strategy), screens);
+    const QVector<QRect> rects = LayoutEngine::layout(items, parameters);
+
+    QCOMPARE(rects.size(), CLIENT_COUNT);
+    for (int i = 0; i < CLIENT_COUNT; ++i) {
+        QVERIFY2(insideAnyScreen(rects[i], screens) || items[i].savedPosition != QPoint(-1, -1),
+                 qPrintable(QString::number(i)));
+        if (items[i].savedPosition != QPoint(-1, -1)) {
+            continue;
+        }
+        for (int j = i + 1; j < CLIENT_COUNT; ++j) {
+            if (items[j].savedPosition == QPoint(-1, -1)) {
+                QVERIFY2(!rects[i].intersects(rects[j]), qPrintable(QString("%1 and %2").arg(i).arg(j)));
+            }
+        }
+    }
+}
+
+QTEST_MAIN(LayoutEngineTest)
+#include "tst_layoutengine.moc"
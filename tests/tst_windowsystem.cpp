@@ -0,0 +1,189 @@
+#include "fakewindowsystem.h"
+#include "config.h"
+#include "hotkeymanager.h"
+#include "windowcapture.h"
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QtTest>
+
+namespace {
+
+constexpr int CLIENT_COUNT = 100;
+constexpr quint32 KEY_A = 0x41;
+constexpr quint32 KEY_F12 = 0x7B;
+
+// Distinct bindings for up to 104 characters: A-Z with no modifier, then
+// with Ctrl, Alt and Shift
+HotkeyBinding bindingFor(int index)
+{
+    const int modifierSet = index / 26;
+    return HotkeyBinding(int(KEY_A) + index % 26, modifierSet == 1, modifierSet == 2, modifierSet == 3);
+}
+
+// Function static so it outlives Config, whose destructor still saves
+QTemporaryDir& configDirectory()
+{
+    static QTemporaryDir directory;
+    return directory;
+}
+
+}
+
+class WindowSystemTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+
+    void enumeratesOnlyClients();
+    void reusesProcessLookups();
+    void dropsExitedProcesses();
+    void activateRestoresMinimized();
+    void dispatchesCharacterHotkeys();
+    void suspendReleasesHotkeys();
+
+private:
+    FakeWindowSystem m_windowSystem;
+};
+
+void WindowSystemTest::initTestCase()
+{
+    QVERIFY(configDirectory().isValid());
+    Config::setBaseDirectory(configDirectory().path());
+    WindowSystem::setInstance(&m_windowSystem);
+
+    Config::instance().setHotkeysOnlyWhenEVEFocused(false);
+    Config::instance().setWildcardHotkeys(false);
+}
+
+void WindowSystemTest::cleanupTestCase()
+{
+    WindowCapture().clearCache();
+    WindowSystem::setInstance(nullptr);
+}
+
+void WindowSystemTest::init()
+{
+    WindowCapture().clearCache();
+    m_windowSystem.reset();
+}
+
+void WindowSystemTest::enumeratesOnlyClients()
+{
+    const QVector<WindowId> clients = m_windowSystem.addClients(CLIENT_COUNT);
+    m_windowSystem.addWindow("Untitled - Notepad", "notepad.exe");
+    m_windowSystem.addWindow("", FakeWindowSystem::CLIENT_PROCESS_NAME);
+    WindowId hidden = m_windowSystem.addWindow("EVE - Hidden", FakeWindowSystem::CLIENT_PROCESS_NAME);
+    m_windowSystem.setVisible(hidden, false);
+
+    const QVector<WindowInfo> windows = WindowCapture().getEVEWindows();
+    QCOMPARE(windows.size(), CLIENT_COUNT);
+    for (int i = 0; i < CLIENT_COUNT; ++i) {
+        QCOMPARE(windows[i].handle, clients[i]);
+        QCOMPARE(windows[i].id, quintptr(clients[i]));
+        QCOMPARE(windows[i].title, m_windowSystem.windowTitle(clients[i]));
+        QCOMPARE(windows[i].processName, QString(FakeWindowSystem::CLIENT_PROCESS_NAME));
+        QVERIFY(windows[i].creationTime > 0);
+    }
+}
+
+void WindowSystemTest::reusesProcessLookups()
+{
+    m_windowSystem.addClients(CLIENT_COUNT);
+    WindowCapture capture;
+
+    QCOMPARE(capture.getEVEWindows().size(), CLIENT_COUNT);
+    const int lookups = m_windowSystem.processLookups();
+    QCOMPARE(lookups, CLIENT_COUNT);
+
+    QCOMPARE(capture.getEVEWindows().size(), CLIENT_COUNT);
+    QCOMPARE(m_windowSystem.processLookups(), lookups);
+
+    WindowInfo window;
+    QVERIFY(capture.captureWindow(m_windowSystem.topLevelWindows().first(), window));
+    QCOMPARE(m_windowSystem.processLookups(), lookups);
+}
+
+void WindowSystemTest::dropsExitedProcesses()
+{
+    const QVector<WindowId> clients = m_windowSystem.addClients(CLIENT_COUNT);
+    WindowCapture capture;
+    QCOMPARE(capture.getEVEWindows().size(), CLIENT_COUNT);
+
+    const quint32 exited = m_windowSystem.processId(clients.first());
+    QVERIFY(m_windowSystem.isWatched(exited));
+    m_windowSystem.exitProcess(exited);
+    QCOMPARE(capture.getEVEWindows().size(), CLIENT_COUNT - 1);
+
+    // Once the exit is delivered the PID may name another process
+    m_windowSystem.addWindow("Untitled - Notepad", "notepad.exe", exited);
+    const int lookups = m_windowSystem.processLookups();
+    QCOMPARE(capture.getEVEWindows().size(), CLIENT_COUNT - 1);
+    QCOMPARE(m_windowSystem.processLookups(), lookups + 1);
+}
+
+void WindowSystemTest::activateRestoresMinimized()
+{
+    const QVector<WindowId> clients = m_windowSystem.addClients(CLIENT_COUNT);
+    const WindowId target = clients.last();
+    m_windowSystem.minimize(target);
+
+    WindowCapture::activateWindow(target);
+    QVERIFY(!m_windowSystem.isMinimized(target));
+    QCOMPARE(m_windowSystem.foregroundWindow(), target);
+    QCOMPARE(m_windowSystem.topLevelWindows().first(), target);
+
+    // Gone windows are left alone
+    m_windowSystem.destroyWindow(clients.first());
+    WindowCapture::activateWindow(clients.first());
+    QCOMPARE(m_windowSystem.foregroundWindow(), target);
+}
+
+void WindowSystemTest::dispatchesCharacterHotkeys()
+{
+    m_windowSystem.addClients(CLIENT_COUNT);
+    const int preexisting = m_windowSystem.hotkeyCount();
+    {
+        HotkeyManager hotkeys;
+        for (int i = 0; i < CLIENT_COUNT; ++i) {
+            hotkeys.setCharacterHotkey(QString("Pilot %1").arg(i, 3, 10, QChar('0')), bindingFor(i));
+        }
+        QVERIFY(m_windowSystem.hotkeyCount() >= preexisting + CLIENT_COUNT);
+
+        QSignalSpy pressed(&hotkeys, &HotkeyManager::characterHotkeyPressed);
+        for (int i = 0; i < CLIENT_COUNT; ++i) {
+            const HotkeyBinding binding = bindingFor(i);
+            QVERIFY(m_windowSystem.press(binding.getModifiers(), quint32(binding.keyCode)));
+        }
+        QCOMPARE(pressed.size(), CLIENT_COUNT);
+        for (int i = 0; i < CLIENT_COUNT; ++i) {
+            const CharacterId characterId = pressed[i].first().value<CharacterId>();
+            QCOMPARE(CharacterRegistry::instance().name(characterId), QString("Pilot %1").arg(i, 3, 10, QChar('0')));
+        }
+    }
+    QCOMPARE(m_windowSystem.hotkeyCount(), preexisting);
+}
+
+void WindowSystemTest::suspendReleasesHotkeys()
+{
+    HotkeyManager hotkeys;
+    hotkeys.setCharacterHotkey("Pilot 000", bindingFor(0));
+    const HotkeyBinding characterBinding = bindingFor(0);
+    const quint32 suspendModifiers = WindowSystem::HotkeyControl | WindowSystem::HotkeyAlt | WindowSystem::HotkeyShift;
+
+    QSignalSpy suspended(&hotkeys, &HotkeyManager::suspendedChanged);
+    QVERIFY(m_windowSystem.press(suspendModifiers, KEY_F12));
+    QCOMPARE(suspended.size(), 1);
+    QVERIFY(hotkeys.isSuspended());
+    QVERIFY(!m_windowSystem.press(characterBinding.getModifiers(), quint32(characterBinding.keyCode)));
+
+    QVERIFY(m_windowSystem.press(suspendModifiers, KEY_F12));
+    QVERIFY(!hotkeys.isSuspended());
+    QVERIFY(m_windowSystem.press(characterBinding.getModifiers(), quint32(characterBinding.keyCode)));
+}
+
+QTEST_MAIN(WindowSystemTest)
+#include "tst_windowsystem.moc"